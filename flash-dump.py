@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+#
+# Timonel flash dump decoder
+# ..........................................................................
+# Rebuilds a Tiny85 flash image from the binary dump the master streams on
+# its console with 'm' (see include/flash-dump.h). Console text around the
+# frames is ignored; every chunk is checked against its CRC-16 and the
+# whole image against the CRC in the end frame. The dump can be captured
+# live from the master's serial port (pyserial, sends the 'm' key) or
+# decoded from a raw capture file.
+#
+# Usage:
+#   flash-dump.py --port /dev/ttyUSB0 -o backup.hex
+#   flash-dump.py --port /dev/ttyUSB0 --hexdump
+#   flash-dump.py --input capture.raw -o backup.bin
+# ..........................................................................
+#
+
+import argparse
+import os
+import sys
+import time
+
+DUMP_VERSION = 1
+DUMP_SYNC = b"\xa5T"
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT (poly 0x1021), same as Crc16() on the master."""
+    for value in data:
+        crc ^= value << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def frames(stream):
+    """Yields (type, payload) for every frame with a good CRC, (None, offset) for a broken one."""
+    i = 0
+    while True:
+        i = stream.find(DUMP_SYNC, i)
+        if i < 0 or i + 4 > len(stream):
+            return
+        size = stream[i + 3]
+        end = i + 4 + size + 2
+        if end > len(stream):
+            return
+        body = stream[i + 2:i + 4 + size]
+        if crc16(body) == (stream[end - 2] | (stream[end - 1] << 8)):
+            yield chr(body[0]), bytes(body[2:])
+            i = end
+        else:
+            yield None, i
+            i += 1
+
+
+def decode(stream):
+    """Returns (start, image, problems)."""
+    start = size = None
+    memory = {}
+    problems = []
+    end_frame = None
+    for frame_type, payload in frames(stream):
+        if frame_type is None:
+            if start is not None:
+                problems.append("corrupted frame at capture offset %d" % payload)
+        elif frame_type == "H":
+            if payload[0] != DUMP_VERSION:
+                sys.exit("unsupported dump version %d" % payload[0])
+            start = payload[1] | (payload[2] << 8)
+            size = payload[3] | (payload[4] << 8)
+        elif frame_type == "D" and start is not None:
+            addr = payload[0] | (payload[1] << 8)
+            for offset, value in enumerate(payload[2:]):
+                memory[addr + offset] = value
+        elif frame_type == "E" and start is not None:
+            end_frame = payload
+            break
+    if start is None:
+        sys.exit("no dump header found")
+    image = bytes(memory.get(addr, 0xFF) for addr in range(start, start + size))
+    missing = [addr for addr in range(start, start + size) if addr not in memory]
+    if missing:
+        problems.append("%d bytes missing, first at 0x%04X" % (len(missing), missing[0]))
+    if end_frame is None:
+        problems.append("no end frame, the dump was cut short")
+    else:
+        if end_frame[2] != 0:
+            problems.append("master reported I2C error %d" % end_frame[2])
+        if not missing and crc16(image) != (end_frame[3] | (end_frame[4] << 8)):
+            problems.append("image CRC mismatch")
+    return start, image, problems
+
+
+def capture(port, baud, timeout):
+    import serial  # pyserial, only needed for live captures
+
+    stream = bytearray()
+    with serial.Serial(port, baud, timeout=0.2) as console:
+        console.reset_input_buffer()
+        console.write(b"m")
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            stream += console.read(4096)
+            last = stream.rfind(DUMP_SYNC + b"E")
+            if last >= 0 and len(stream) >= last + 4 + 5 + 2:
+                break
+    return bytes(stream)
+
+
+def write_hex(path, start, image):
+    with open(path, "w") as hex_file:
+        for offset in range(0, len(image), 16):
+            record = bytes([min(16, len(image) - offset), ((start + offset) >> 8) & 0xFF, (start + offset) & 0xFF, 0])
+            record += image[offset:offset + 16]
+            hex_file.write(":%s%02X\n" % (record.hex().upper(), -sum(record) & 0xFF))
+        hex_file.write(":00000001FF\n")
+
+
+def hexdump(start, image):
+    for offset in range(0, len(image), 32):
+        print("Addr 0x%04X: %s" % (start + offset, " ".join("%02X" % value for value in image[offset:offset + 32])))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Timonel flash dump decoder")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="master serial port, the dump is requested with 'm'")
+    source.add_argument("--input", help="raw console capture holding a dump")
+    parser.add_argument("--baud", type=int, default=115200, help="serial speed (default: 115200)")
+    parser.add_argument("--timeout", type=float, default=10, help="capture time limit in seconds (default: 10)")
+    parser.add_argument("-o", "--output", help="flash image, Intel HEX if it ends in .hex, binary otherwise")
+    parser.add_argument("--hexdump", action="store_true", help="print the image like the old text dump")
+    args = parser.parse_args()
+
+    if args.port:
+        stream = capture(args.port, args.baud, args.timeout)
+    else:
+        with open(args.input, "rb") as capture_file:
+            stream = capture_file.read()
+    start, image, problems = decode(stream)
+    if args.hexdump:
+        hexdump(start, image)
+    if args.output:
+        if os.path.splitext(args.output)[1].lower() == ".hex":
+            write_hex(args.output, start, image)
+        else:
+            with open(args.output, "wb") as bin_file:
+                bin_file.write(image)
+    for problem in problems:
+        print("flash-dump: %s" % problem, file=sys.stderr)
+    print("flash-dump: %d bytes from 0x%04X, CRC-16 %04X%s" % (len(image), start, crc16(image), ", BAD" if problems else ""),
+          file=sys.stderr)
+    sys.exit(1 if problems else 0)
+
+
+if __name__ == "__main__":
+    main()
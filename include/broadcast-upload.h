@@ -0,0 +1,65 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: broadcast-upload.h (Header)
+  ............................................................................
+  Broadcast upload: one image to every Timonel device of the bus at once
+  through the I2C general call, then each device is read back and patched.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_BROADCAST_UPLOAD_H
+#define TIMONEL_MSS_BROADCAST_UPLOAD_H
+
+#include <TimonelTwiM.h>
+
+#include "payload-stream.h"
+
+// Broadcast upload: one image to every Timonel device of the console bus
+// at once. The erase, the page address and every WRITPAGE packet go out
+// a single time to the I2C general call address (0), so the bus time no
+// longer grows with the device count. A general call write has no reply:
+// the per-packet checksums are not confirmed, so each device is then read
+// back (READFLSH) and only its pages that differ are sent again to it
+// alone, or the device is erased and flashed on its own if they can't be
+// patched in place.
+// The Tiny85s must run a Timonel build that also takes the general call
+// in bootloader mode. Devices that don't miss the broadcast but are still
+// flashed, one by one, by the verification pass.
+// Stock Timonel doesn't take the general call and no feature bit tells
+// whether a device does, while every general call listener on the bus
+// gets the DELFLASH and WRITPAGE sent there. So the feature is only built
+// with -D BROADCAST_UPLOAD, off by default, and 'g' isn't in the console
+// otherwise: only build it for a bus whose devices are all known to run
+// such a Timonel build.
+
+#define BROADCAST_ADDR 0x00          // I2C general call address
+#define BROADCAST_DEVICES 16         // Devices flashed together at most
+#define BROADCAST_REAPPEAR_MS 1000   // A device must answer again this long after its flash deletion delay (ms)
+#define BROADCAST_POLL_MS 8          // Poll interval while the devices come back (ms)
+
+// One device's outcome
+struct BroadcastDevice {
+    uint8_t address = 0;
+    uint8_t error = 0;          /* First error, 0 if flashed */
+    uint16_t pages_resent = 0;  /* Pages sent to this device alone */
+    bool erased_again = false;  /* Its pages couldn't be patched: erased and flashed on its own */
+    bool verified = false;      /* Read back, the pages that differed were sent again */
+};
+
+// Broadcast upload outcome
+struct BroadcastReport {
+    uint8_t devices = 0;
+    uint16_t pages = 0;         /* Image pages broadcast */
+    uint32_t broadcast_ms = 0;  /* Erase and page broadcast */
+    uint32_t verify_ms = 0;     /* Readback and repairs */
+    BroadcastDevice device[BROADCAST_DEVICES];
+};
+
+// Prototypes
+uint8_t FindBootloaders(uint8_t *addresses, const uint8_t max_count);
+uint8_t BroadcastUpload(PageSource *source, const uint8_t *addresses, const uint8_t count, BroadcastReport *report);
+
+#endif  // TIMONEL_MSS_BROADCAST_UPLOAD_H
@@ -0,0 +1,30 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bus-commands.h (Header)
+  ............................................................................
+  Console commands on the I2C link: clock and packet size negotiation,
+  performance counters and the I2C trace.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_BUS_COMMANDS_H
+#define TIMONEL_MSS_BUS_COMMANDS_H
+
+#include <Arduino.h>
+#include <TimonelTwiM.h>
+
+// Run from the console dispatch tables (see RunCommand): 't' and the
+// trace key in both running modes, 'c' in bootloader mode.
+
+// Prototypes
+void NegotiateLink(void);
+void NegotiateAndPrint(Timonel *timonel);
+void NegotiatePacketsAndPrint(Timonel *timonel);
+void PrintPerfStats(void);
+void PrintMillis(const uint64_t us);
+void PrintTrace(void);
+
+#endif  // TIMONEL_MSS_BUS_COMMANDS_H
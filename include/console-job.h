@@ -0,0 +1,63 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: console-job.h (Header)
+  ............................................................................
+  Console jobs: long commands (flash deletion, upload) run as jobs and the
+  console stays live meanwhile. The engine loop lives here too.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_CONSOLE_JOB_H
+#define TIMONEL_MSS_CONSOLE_JOB_H
+
+#include <Arduino.h>
+
+// Console jobs: a command that keeps the device busy for a while (flash
+// deletion, firmware upload) runs as a job and the console stays live
+// meanwhile. The engine steps a deletion on every pass instead of waiting
+// for it; the upload serves the console from its packet and page write
+// delays (see payload-stream.h) and between pages. While a job runs, its
+// progress is shown in place, '?' prints how far it got and 'q' asks it
+// to stop: an upload stops before its next page and keeps the pages it
+// confirmed, so 'w' goes on from them (see upload-checkpoint.h). Other
+// keys are dropped until the job ends.
+// With no job running JobService does nothing, the host link, TCP ingest
+// and multi-slave paths upload exactly as before.
+// The engine loop lives here too: EngineLoop hands each key to the job,
+// the prompt waiting for it or RunCommand, and steps the erase job.
+
+#define ERR_CANCELLED 12       // The command was cancelled from the console
+#define JOB_POLL_US 5000       // The console is looked at this often while a job waits on the device (us)
+#define JOB_PROGRESS_MS 100    // Shortest interval between two in-place progress updates (ms)
+#define JOB_STATUS_KEY '?'     // Prints the job progress
+#define JOB_CANCEL_KEY 'q'     // Stops the job, if it can be stopped
+
+// The job running from the console
+struct ConsoleJob {
+    const char *name = nullptr;        /* nullptr: no job */
+    Stream *console = nullptr;
+    uint16_t done = 0;                 /* Pages done so far */
+    uint16_t total = 0;                /* Pages to do, 0 if unknown: no in-place progress */
+    bool cancellable = false;
+    bool cancel = false;               /* 'q' was pressed */
+    unsigned long start_ms = 0;
+    unsigned long polled_us = 0;       /* Last look at the console */
+    unsigned long shown_ms = 0;        /* Last in-place progress update */
+    uint8_t shown_percent = 0;
+    uint16_t queries = 0;              /* '?' answered */
+};
+
+// Prototypes
+void JobBegin(Stream *console, const char *name, const uint16_t total, const bool cancellable);
+void JobProgress(const uint16_t done);
+bool JobActive(void);
+bool JobCancelled(void);
+void JobKey(const char key);
+void JobService(void);
+void JobEnd(void);
+const ConsoleJob &JobGet(void);
+
+#endif  // TIMONEL_MSS_CONSOLE_JOB_H
@@ -0,0 +1,56 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: console-ring.h (Header)
+  ............................................................................
+  Console seen from the I2C engine task in DUAL_CORE builds: an output
+  ring and an input key queue, drained and fed by the console task.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_CONSOLE_RING_H
+#define TIMONEL_MSS_CONSOLE_RING_H
+
+#include <Arduino.h>
+
+#include "spsc-queue.h"
+
+// Console seen from the I2C engine task when built with DUAL_CORE: the
+// engine prints into an output ring and reads keys from an input queue,
+// both lock-free SPSC queues; the console task drains the ring into the
+// UART as fast as its TX buffer takes it and feeds the typed keys in.
+// Printing never waits for the UART, only for a full ring (counted as a
+// stall), and long I2C operations don't keep keystrokes or output from
+// moving on the other core.
+
+#define CONSOLE_OUT_SIZE 2048  // Output ring (bytes), at least a binary dump frame burst
+#define CONSOLE_IN_SIZE 64     // Typed keys waiting for the engine
+#define CONSOLE_CHUNK 64       // Bytes moved per UART write
+
+class ConsoleRing : public Stream {
+   public:
+    // Engine task side
+    using Print::write;
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t size);
+    int availableForWrite(void) { return CONSOLE_OUT_SIZE - out_.Size(); }
+    void flush(void);
+    int available(void) { return in_.Size(); }
+    int read(void);
+    int peek(void);
+    uint32_t GetStalls(void) const { return stalls_.load(std::memory_order_relaxed); }
+    // Console task side: keys in, output out, returns the bytes moved
+    uint32_t Service(HardwareSerial *serial);
+
+   private:
+    SpscQueue<uint8_t, CONSOLE_OUT_SIZE> out_;
+    SpscQueue<uint8_t, CONSOLE_IN_SIZE> in_;
+    std::atomic<uint32_t> stalls_{0};
+};
+
+// Prototypes
+void ConsoleTask(void *console_ring);
+
+#endif  // TIMONEL_MSS_CONSOLE_RING_H
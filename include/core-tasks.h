@@ -0,0 +1,38 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: core-tasks.h (Header)
+  ............................................................................
+  Tasks pinned to a core: FreeRTOS tasks on the ESP32, std::thread on the
+  host. DUAL_CORE runs the I2C engine and the console on their own cores.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_CORE_TASKS_H
+#define TIMONEL_MSS_CORE_TASKS_H
+
+#include <stdint.h>
+
+// Tasks pinned to a core: FreeRTOS tasks on the ESP32, plain std::thread
+// on the host (the core is not pinned there) so the code around them can
+// be stress-tested on Linux. With DUAL_CORE the I2C engine (every Timonel
+// command) runs alone on ENGINE_CORE, while the console task on
+// CONSOLE_CORE moves keystrokes and output between the UART and the
+// engine through lock-free queues (see console-ring.h).
+
+#define ENGINE_CORE 0          // I2C engine task core (the Arduino loop runs on core 1)
+#define CONSOLE_CORE 1         // Console task core
+#define ENGINE_STACK 8192      // Engine task stack (bytes): it runs the whole command set
+#define CONSOLE_STACK 3072     // Console task stack (bytes)
+#define ENGINE_PRIORITY 2
+#define CONSOLE_PRIORITY 1
+
+typedef void (*TaskEntry)(void *arg);
+
+// Prototypes
+bool StartTask(TaskEntry entry, const char *name, const uint32_t stack_size, void *arg, const uint8_t priority, const uint8_t core);
+void TaskPause(void);
+
+#endif  // TIMONEL_MSS_CORE_TASKS_H
@@ -0,0 +1,72 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: device-cache.h (Header)
+  ............................................................................
+  Device state cache: Timonel status, device settings and liveness, kept
+  until an operation that changes them.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_DEVICE_CACHE_H
+#define TIMONEL_MSS_DEVICE_CACHE_H
+
+#include <TimonelTwiM.h>
+
+#include "reconnect.h"
+
+// Device state cache: Timonel status, device settings and liveness. The
+// console used to rediscover the device and query its status on every key
+// press; now the status is queried once and kept until an operation that
+// changes it (erase, write, run, reset). Only the application start moves
+// on erase and write, so the features used by the menu stay cached. A
+// failed query is not kept. An address probe every CACHE_ALIVE_MS, run
+// from the idle loop, tells when the device went away; while a bootloader
+// status is cached, the probe reads the status too and drops the cache
+// when the signature, version, features or bootloader start differ (or
+// the application start, while it is known): another board answering at
+// the same address. A board with the same bootloader build and flash
+// passes it, a reset or mode switch from the console drops the cache
+// anyway. Every I2C transaction answered from the
+// cache is counted as saved. Every invalidation starts a new generation,
+// for caches built on this one (see eeprom-mirror.h).
+
+#define CACHE_ALIVE_MS 2000  // Background liveness probe period (ms)
+#define QUERY_TRANSACTIONS 2 // A status or settings query: command write + reply read
+#define AVR_SIGNATURE_0 0x1E // First signature byte of every AVR, a settings read that failed leaves 0
+
+class DeviceCache {
+   public:
+    Timonel::Status GetStatus(Timonel *timonel, const bool need_app_start = true);
+    Timonel::DevSettings GetDevSettings(Timonel *timonel);
+    void Invalidate(void);         // New device object, mode switch or reset
+    void InvalidateAppStart(void); // Flash erased or written
+    bool CheckAlive(Timonel *timonel);
+    void Poll(Timonel *timonel);
+    bool IsLost(void) const { return lost_; }
+    void SetEnabled(const bool enabled) { enabled_ = enabled; }
+    void StartCommand(void) { saved_command_ = 0; }
+    uint16_t GetSavedCommand(void) const { return saved_command_; }
+    uint32_t GetSavedTotal(void) const { return saved_total_; }
+    uint32_t GetPollProbes(void) const { return poll_probes_; }
+    uint32_t GetSwaps(void) const { return swaps_; }
+    uint32_t GetGeneration(void) const { return generation_; }
+
+   private:
+    void Saved(const uint8_t transactions);
+    bool SameDevice(Timonel *timonel);
+    Timonel::Status status_;
+    Timonel::DevSettings settings_;
+    bool status_valid_ = false, app_start_valid_ = false, settings_valid_ = false;
+    bool enabled_ = true, lost_ = false;
+    unsigned long last_alive_ = 0;
+    uint16_t saved_command_ = 0;
+    uint32_t saved_total_ = 0;
+    uint32_t poll_probes_ = 0; /* Background probe and identity transactions, the price of the saved ones */
+    uint32_t swaps_ = 0;       /* Probes that found another device at the address */
+    uint32_t generation_ = 0;  /* Invalidations so far */
+};
+
+#endif  // TIMONEL_MSS_DEVICE_CACHE_H
@@ -0,0 +1,36 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: eeprom-commands.h (Header)
+  ............................................................................
+  Console commands on the device EEPROM: byte read and write through the
+  mirror, flush, and image save and load.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_EEPROM_COMMANDS_H
+#define TIMONEL_MSS_EEPROM_COMMANDS_H
+
+#include <Arduino.h>
+
+// Bootloader mode commands, run from the console dispatch table (see
+// RunCommand) when the bootloader has EEPROM access. Pending mirror bytes
+// are flushed before any other command (FlushEeprom), since it may reset
+// the device or switch its mode.
+
+// Prototypes
+void AskEepromAddr(void);
+void SetEepromAddr(const uint16_t word);
+void WriteEepromByte(const uint16_t word);
+void ShowEeprom(void);
+void FlushPendingEeprom(void);
+void SaveEepromImage(void);
+void PickEepromImage(void);
+void LoadEepromImage(const uint16_t word);
+void PrintEepromFile(const uint8_t index, const char *name, const size_t size);
+uint8_t FlushEeprom(const bool asked);
+void ReportEepromDropped(void);
+
+#endif  // TIMONEL_MSS_EEPROM_COMMANDS_H
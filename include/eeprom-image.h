@@ -0,0 +1,71 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: eeprom-image.h (Header)
+  ............................................................................
+  Device EEPROM block transfers and binary images on LittleFS.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_EEPROM_IMAGE_H
+#define TIMONEL_MSS_EEPROM_IMAGE_H
+
+#include <LittleFS.h>
+#include <TimonelTwiM.h>
+
+#include "timonel-ext-cmd.h"
+
+// Device EEPROM block transfers and binary images. Built with
+// EEPROM_BLOCKS_EXPERIMENTAL (see timonel-ext-cmd.h), bootloaders that
+// report EEPROM_BLOCKS move up to a packet of EEPROM bytes per command
+// (READEEBK, WRITEEBK, in the sizes negotiated for the device, see
+// packet-size.h, checksummed like READFLSH and WRITPAGE); otherwise, and
+// with released Timonel builds, the one-byte READEEPR and WRITEEPR
+// commands are used. The WRITEEBK reply is ready once the block is in
+// EEPROM.
+// Programming an image reads the EEPROM first and only writes
+// the bytes that change (each one costs ~3.4 ms of EEPROM write time on
+// the Tiny85), then reads it back to verify. Images are raw binary files
+// under /eeprom on the LittleFS partition.
+
+#define EEPROM_DIR "/eeprom"
+#define EEPROM_EXPORT_PATH EEPROM_DIR "/export.bin"
+#define EEPROM_CHUNK 64       // Bytes compared and verified at a time
+#define EEPROM_IMAGE_MAX 512  // Tiny85 EEPROM size
+
+#define ERR_EEPROM_VERIFY 10  // EEPROM readback differs from the image
+#define ERR_EEPROM_IMAGE 11   // EEPROM image file missing, unreadable or too big
+
+// EEPROM programming outcome
+struct EepromReport {
+    uint16_t bytes = 0;          /* Image size */
+    uint16_t bytes_written = 0;  /* Bytes that differed and were written */
+    uint16_t bytes_read = 0;     /* Bytes read to compare and verify */
+    uint16_t commands = 0;       /* EEPROM commands sent */
+    bool blocks = false;         /* Block commands used */
+};
+
+// EEPROM reads and writes with the largest transfers the device supports
+class EepromTransfer {
+   public:
+    EepromTransfer(Timonel *timonel, const Timonel::Status &status);
+    bool UsesBlocks(void) const { return blocks_; }
+    uint16_t GetCommands(void) const { return commands_; }
+    uint8_t Read(const uint16_t eeprom_addr, uint8_t *data, const uint16_t size);
+    uint8_t Write(const uint16_t eeprom_addr, const uint8_t *data, const uint16_t size);
+    uint8_t Program(const uint16_t eeprom_addr, const uint8_t *data, const uint16_t size, EepromReport *report);
+
+   private:
+    Timonel *timonel_;
+    bool blocks_;
+    uint8_t rx_packet_; /* READEEBK block size, see packet-size.h */
+    uint16_t commands_ = 0;
+};
+
+// Prototypes
+uint8_t EepromExport(EepromTransfer *eeprom, const char *path, const uint16_t size);
+uint8_t EepromImport(EepromTransfer *eeprom, const char *path, const uint16_t max_size, EepromReport *report);
+
+#endif  // TIMONEL_MSS_EEPROM_IMAGE_H
@@ -0,0 +1,76 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: eeprom-mirror.h (Header)
+  ............................................................................
+  Write-back mirror of the device EEPROM: reads and writes go to the
+  mirror, dirty runs are flushed in block writes.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_EEPROM_MIRROR_H
+#define TIMONEL_MSS_EEPROM_MIRROR_H
+
+#include "device-cache.h"
+#include "eeprom-image.h"
+
+// Write-back mirror of the device EEPROM. The first read or write of a
+// session loads the whole EEPROM once (block reads); after that 'o' is
+// answered from the mirror and 'p' only changes the mirror, marking the
+// bytes that now differ from the device as dirty. Writing a byte back to
+// the value the device holds clears it again, and a byte written many
+// times is sent once. Flush ('n', or before any other command, which may
+// reset the device or switch its mode) sends each run of consecutive
+// dirty bytes in as few block writes as the packet size allows, then
+// reads the run back to verify it. Clean bytes between two runs are never
+// sent along: each one would cost an EEPROM write (~3.4 ms on the Tiny85),
+// more than a command of its own.
+// The mirror follows the device cache: once that is invalidated (reset,
+// mode switch, device lost or replaced) the mirror is dropped and loaded
+// again on its next use, and dirty bytes still pending then are dropped
+// with it (the device they were meant for may be gone) and reported.
+
+// Mirror counters since boot
+struct MirrorStats {
+    uint32_t loads = 0;          /* Whole EEPROM reads */
+    uint32_t local_reads = 0;    /* Bytes read from the mirror */
+    uint32_t writes = 0;         /* Bytes written to the mirror */
+    uint32_t absorbed = 0;       /* Written bytes that never reached the device: unchanged, rewritten or reverted */
+    uint32_t flushed = 0;        /* Bytes written to the device */
+    uint32_t runs = 0;           /* Runs of dirty bytes flushed */
+    uint32_t dropped = 0;        /* Dirty bytes lost to a device reset */
+};
+
+// Class EepromMirror: the device EEPROM on the master, written back on Flush
+class EepromMirror {
+   public:
+    EepromMirror(DeviceCache *cache, const uint16_t size);
+    uint8_t Read(EepromTransfer *eeprom, const uint16_t eeprom_addr, uint8_t *data, const uint16_t size);
+    uint8_t Write(EepromTransfer *eeprom, const uint16_t eeprom_addr, const uint8_t *data, const uint16_t size);
+    uint8_t Flush(EepromTransfer *eeprom, EepromReport *report);
+    void Invalidate(void);
+    bool IsLoaded(void);
+    bool IsDirty(const uint16_t eeprom_addr) const { return (dirty_[eeprom_addr >> 3] >> (eeprom_addr & 7)) & true; }
+    uint16_t GetDirty(void) const { return dirty_count_; }
+    uint16_t GetSize(void) const { return size_; }
+    uint16_t TakeDropped(void);
+    const MirrorStats &GetStats(void) const { return stats_; }
+
+   private:
+    uint8_t Load(EepromTransfer *eeprom);
+    void SetDirty(const uint16_t eeprom_addr, const bool dirty);
+    DeviceCache *cache_;
+    uint16_t size_;
+    bool loaded_ = false;
+    uint32_t generation_ = 0;   /* Device cache generation the mirror was loaded in */
+    uint8_t device_[EEPROM_IMAGE_MAX];   /* What the device holds */
+    uint8_t image_[EEPROM_IMAGE_MAX];    /* What it will hold after the flush */
+    uint8_t dirty_[EEPROM_IMAGE_MAX / 8] = {0};
+    uint16_t dirty_count_ = 0;
+    uint16_t dropped_ = 0;      /* Dirty bytes dropped, not reported yet */
+    MirrorStats stats_;
+};
+
+#endif  // TIMONEL_MSS_EEPROM_MIRROR_H
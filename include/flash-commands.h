@@ -0,0 +1,34 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: flash-commands.h (Header)
+  ............................................................................
+  Console commands on the device flash: erase, payload selection, upload,
+  differential upload and dump.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_FLASH_COMMANDS_H
+#define TIMONEL_MSS_FLASH_COMMANDS_H
+
+#include <Arduino.h>
+
+// Bootloader mode commands, run from the console dispatch table (see
+// RunCommand). The ones asking for a number go on in the Set/Select
+// function once the line is typed (see AnswerPrompt).
+
+// Prototypes
+void EraseFlash(void);
+void ErasePages(void);
+void AskPageAddr(void);
+void SetPageAddr(const uint16_t word);
+void PickPayload(void);
+void SelectPayload(const uint16_t word);
+void PrintPayloadFile(const uint8_t index, const char *name, const size_t size);
+void UploadSelected(void);
+void UploadChanged(void);
+void DumpFlash(void);
+
+#endif  // TIMONEL_MSS_FLASH_COMMANDS_H
@@ -0,0 +1,57 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: flash-dump.h (Header)
+  ............................................................................
+  Binary flash dump streamed over the serial console as CRC-checked
+  frames, decoded on the host by flash-dump.py.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_FLASH_DUMP_H
+#define TIMONEL_MSS_FLASH_DUMP_H
+
+#include <TimonelTwiM.h>
+
+// Binary flash dump streamed over the serial console. The text hexdump
+// spends ~3 console characters per flash byte and the 115200 bps UART,
+// not I2C, sets its pace; here the flash goes out as framed binary
+// chunks, each one with its own CRC, decoded on the host by
+// flash-dump.py (.bin, .hex or a hexdump). While a frame drains from
+// the UART TX buffer, the next chunk is already being read over I2C.
+//
+// Frame: 0xA5 'T' type length payload[length] crc16 (LE, CRC-16/CCITT
+// over type, length and payload). Types:
+//   'H' header: version, start (LE16), size (LE16), chunk size
+//   'D' data:   flash address (LE16), data
+//   'E' end:    chunks sent (LE16), error code, CRC-16 of all the data (LE16)
+// Anything outside the frames (console text) is skipped by the decoder.
+
+#define DUMP_VERSION 1
+#define DUMP_SYNC_0 0xA5
+#define DUMP_SYNC_1 'T'
+#define DUMP_HEADER 'H'
+#define DUMP_DATA 'D'
+#define DUMP_END 'E'
+#define DUMP_CHUNK SPM_PAGESIZE              // Flash bytes per data frame
+#define DUMP_FRAME_MAX (DUMP_CHUNK + 2 + 6)  // Address, sync, type, length and CRC
+#define DUMP_TX_BUFFER 1024                  // Serial TX buffer that lets frames drain during I2C reads
+
+// Flash dump outcome
+struct DumpReport {
+    uint16_t chunks = 0;           /* Data frames sent */
+    uint32_t bytes_sent = 0;       /* Serial bytes, framing included */
+    uint32_t total_us = 0;         /* Whole dump */
+    uint32_t i2c_us = 0;           /* Reading flash */
+    uint32_t serial_wait_us = 0;   /* Blocked on a full serial TX buffer */
+    uint16_t crc = 0xFFFF;         /* CRC-16 of the flash data */
+};
+
+// Prototypes
+uint16_t Crc16(uint16_t crc, const uint8_t *data, const uint16_t size);
+uint8_t StreamFlash(Timonel *timonel, Print *out, const uint16_t flash_addr, const uint16_t size, DumpReport *report,
+                    const bool overlap = true);
+
+#endif  // TIMONEL_MSS_FLASH_DUMP_H
@@ -0,0 +1,85 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: flash-sync.h (Header)
+  ............................................................................
+  Flash readback, differential, verified and resumable uploads.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_FLASH_SYNC_H
+#define TIMONEL_MSS_FLASH_SYNC_H
+
+#include <TimonelTwiM.h>
+
+#include "payload-stream.h"
+#include "upload-checkpoint.h"
+
+// Flash readback and differential upload: the device flash is read back
+// page by page (READFLSH) and compared with the payload, then only the
+// pages that differ are written again.
+// Verified upload: every page written is read back and its CRC-16 compared
+// with the payload's. Page k is read once its page write delay is over,
+// before page k+1 is sent, so the readback adds to the upload time as a
+// full readback afterwards would; what it saves is the rest of an upload
+// that fails. Experimental, off by default: built with VERIFY_OVERLAP,
+// page k is read during the packet and page write delays of page k+1
+// instead, so only the last page is read after the upload. That sends
+// READFLSH while the page buffer is half filled or the SPM write runs,
+// which is only tested against the simulator.
+// Page 0 is checked as Timonel leaves it: the reset vector jumps to the
+// bootloader and the application's own vector is in the trampoline.
+// Between reads, the device's transaction errors are checked against the
+// clock fallback threshold (see twi-clock.h).
+// Resumable upload: a verified upload whose confirmed pages are recorded
+// as it goes, and that skips the ones an earlier attempt of the same
+// payload confirmed once they are read back and found still there (see
+// upload-checkpoint.h).
+// When the payload has a build-time manifest (payload-manifest.h), the
+// page CRCs and the expected trampoline come from it, and a payload that
+// would overlap the bootloader is refused before anything is written.
+// A console job (console-job.h) is served from the write delays and can
+// stop an upload between two pages.
+
+#define MAX_FLASH_PAGES (MCU_TOTAL_MEM / SPM_PAGESIZE)
+#define ERR_VERIFY 10  // Flash readback differs from the payload
+#define ERR_NO_ROOM 11  // The payload overlaps the bootloader or its trampoline page
+#define ERR_NEEDS_ERASE 15  // A failed upload left a page that can't be written over, erase before uploading
+#define READ_RETRIES 2  // A READFLSH packet with a bus or checksum error is read again this many times
+
+// Differential upload outcome
+struct DiffReport {
+    uint16_t pages = 0;          /* Payload pages compared */
+    uint16_t pages_written = 0;  /* Pages that differed and were rewritten */
+    uint16_t bytes_read = 0;     /* Flash bytes read back to compare */
+    bool needs_erase = false;    /* Some page can't be rewritten in place (no FORCE_ERASE_PG) */
+    bool full_upload = false;    /* No readback available, the whole payload was sent */
+};
+
+// Verified upload outcome
+struct VerifyReport {
+    uint16_t pages = 0;                /* Pages written */
+    uint16_t pages_verified = 0;       /* Pages read back and compared */
+    uint16_t first_bad_page = 0xFFFF;  /* Flash address of the first page that differs, 0xFFFF if none */
+    bool readback = false;             /* The bootloader has READFLSH, pages were checked */
+    uint32_t readback_us = 0;          /* Time reading back, overlapped or not */
+    uint32_t tail_us = 0;              /* Readback left after the last page was written */
+    uint16_t resumed = 0;              /* Pages confirmed by an earlier attempt, not written again */
+    uint16_t confirmed = 0;            /* Pages confirmed so far, by earlier attempts too */
+    bool checkpointed = false;         /* Confirmed pages are recorded, a retry goes on from them */
+};
+
+// Prototypes
+uint8_t ReadFlash(Timonel *timonel, const uint16_t flash_addr, uint8_t *data, const uint16_t data_size,
+                  const uint8_t retries = READ_RETRIES);
+uint16_t TrampolineFor(const uint8_t *reset_vector, const uint16_t bootloader_start);
+uint16_t ManifestAppStart(const ImageManifest &manifest, const uint16_t bootloader_start);
+bool PayloadFits(const ImageManifest &manifest, const Timonel::Status &sts);
+uint8_t UploadDifferential(Timonel *timonel, PageSource *source, DiffReport *report);
+uint8_t UploadVerified(Timonel *timonel, PageSource *source, const Timonel::Status &sts, VerifyReport *report,
+                       UploadCheckpoint *checkpoint = nullptr);
+uint8_t UploadResumable(Timonel *timonel, PageSource *source, const Timonel::Status &sts, VerifyReport *report);
+
+#endif  // TIMONEL_MSS_FLASH_SYNC_H
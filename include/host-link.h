@@ -0,0 +1,153 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: host-link.h (Header)
+  ............................................................................
+  Framed binary protocol for scripted flashing from a host
+  (timonel-host.py).
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_HOST_LINK_H
+#define TIMONEL_MSS_HOST_LINK_H
+
+#include <Arduino.h>
+#include <TimonelTwiM.h>
+
+#include "device-cache.h"
+#include "reconnect.h"
+
+// Framed binary protocol for scripted flashing from a host (timonel-host.py).
+// A zero byte typed at the menu starts a session; it ends with QUIT or
+// after HOST_IDLE_MS without frames, back to the menu.
+//
+// Frame on the wire: 0x00 COBS(body) 0x00, body = version, opcode,
+// request id, payload, CRC-16/CCITT of all the previous (LE). Replies
+// carry the request opcode | HOST_REPLY, the same id and a status byte
+// before their data. Frames that fail COBS or CRC get a HOST_NAK reply
+// and are otherwise ignored; a request repeated with the same id and
+// opcode (the host lost the reply) gets the same reply again without
+// running twice. Page writes already done are acknowledged, not redone.
+// Every request but 'H', 'P' and 'Q' needs the device in bootloader mode.
+//
+// Requests (payload -> reply data), LE16 addresses and sizes:
+//   'H' hello                         -> version, app mode, TWI address, window, page size, data max,
+//                                        flash size16, features, ext features, bootloader start16, version major, minor
+//   'E' erase                         -> -
+//   'B' upload begin: addr16, size16  -> -
+//   'W' page: addr16, data            -> addr16
+//   'F' upload finish: crc16          -> crc16 of the pages received
+//   'V' verify: addr16, size16, crc16, reset vector[2] -> crc16 of the device flash
+//   'D' flash read: addr16, size      -> addr16, data
+//   'r' EEPROM read: addr16, size     -> addr16, data
+//   'w' EEPROM write: addr16, data    -> bytes changed
+//   'R' run application               -> TWI address, app mode
+//   'P' performance counters: op, part -> op, op count, then LE32 values (see perf-stats.h)
+//                                        part 0: bucket count, first bucket shift, calls, errors, retries,
+//                                                bytes, total us (LE64), min us, max us
+//                                        part 1: histogram, calls per bucket
+//   'Q' quit                          -> -
+//
+// Uploads are pipelined: the host may keep HOST_SLOTS page frames in
+// flight. While page N is written over I2C, the inter-packet and SPM
+// page write delays keep draining the serial port, so page N+1 is
+// already decoded in the second slot when page N completes.
+
+#define HOST_VERSION 1
+#define HOST_DELIMITER 0x00
+#define HOST_DATA_MAX SPM_PAGESIZE                                      // Data bytes per page, read or EEPROM frame
+#define HOST_FRAME_MAX (HOST_DATA_MAX + 8)                              // Header, status, address, data and CRC
+#define HOST_ENCODED_MAX (HOST_FRAME_MAX + (HOST_FRAME_MAX / 254) + 1)  // COBS overhead
+#define HOST_SLOTS 2                                                    // Request frames decoded ahead: the upload window
+#define HOST_IDLE_MS 10000                                              // Back to the menu after this long without frames
+#define HOST_POLL_US 100                                                // Serial polling step while idle
+
+// Opcodes
+#define HOST_HELLO 'H'
+#define HOST_ERASE 'E'
+#define HOST_BEGIN 'B'
+#define HOST_PAGE 'W'
+#define HOST_FINISH 'F'
+#define HOST_VERIFY 'V'
+#define HOST_READ 'D'
+#define HOST_EE_READ 'r'
+#define HOST_EE_WRITE 'w'
+#define HOST_RUN 'R'
+#define HOST_PERF 'P'
+#define HOST_QUIT 'Q'
+#define HOST_NAK 'N'
+#define HOST_REPLY 0x80
+
+// Reply status: 0 is OK, TWI and command error codes pass through, protocol errors are these
+#define HOST_BAD_FRAME 0xE0    // COBS, CRC or length error
+#define HOST_BAD_VERSION 0xE1  // Protocol version not supported
+#define HOST_UNKNOWN 0xE2      // Unknown opcode
+#define HOST_BAD_ARGS 0xE3     // Address or size out of range
+#define HOST_SEQUENCE 0xE4     // Page out of order or no upload begun
+#define HOST_BAD_MODE 0xE5     // Not possible in the current device mode
+#define HOST_UNSUPPORTED 0xE6  // The bootloader lacks the feature
+#define HOST_BAD_IMAGE 0xE7    // Upload CRC or size differs from the host's
+#define HOST_MISMATCH 0xE8     // Verify CRC differs
+
+// What a session (or a TCP ingest job) works on, owned by the application
+struct HostTarget {
+    Timonel **timonel;   /* Device object, rebuilt in place after a mode switch */
+    bool *app_mode;      /* The device runs its application */
+    DeviceCache *cache;  /* Status and liveness of the device */
+    uint8_t sda;
+    uint8_t scl;
+};
+
+// Session counters
+struct HostStats {
+    uint32_t frames_rx = 0;   /* Request frames, bad ones included */
+    uint32_t frames_tx = 0;   /* Replies */
+    uint32_t bad_frames = 0;  /* Answered with HOST_NAK */
+    uint32_t repeats = 0;     /* Repeated requests answered from the last reply or already written pages */
+    uint32_t pages = 0;       /* Pages written */
+    uint32_t overlapped = 0;  /* Request frames decoded while a page was being written */
+};
+
+class HostLink {
+   public:
+    HostLink(Stream *port, HostTarget *target);
+    void Serve(void);
+    const HostStats &GetStats(void) const { return stats_; }
+
+   private:
+    struct Slot {
+        uint8_t body[HOST_FRAME_MAX];
+        uint8_t size;
+    };
+    static void OnWait(void *host_link, const unsigned long remaining_us);
+    void Poll(void);
+    void Dispatch(const uint8_t *body, const uint8_t size);
+    uint8_t Run(const uint8_t opcode, const uint8_t *args, const uint8_t args_size, uint8_t *data, uint8_t *data_size);
+    uint8_t WritePage(const uint16_t addr, const uint8_t *data, const uint8_t size);
+    uint8_t Verify(const uint16_t addr, const uint16_t size, const uint8_t *reset_vector, uint16_t *crc);
+    void Reply(const uint8_t opcode, const uint8_t id, const uint8_t status, const uint8_t *data, const uint8_t size);
+    Stream *port_;
+    HostTarget *target_;
+    HostStats stats_;
+    Slot slots_[HOST_SLOTS];
+    uint8_t slot_head_ = 0, slot_count_ = 0;
+    uint8_t raw_[HOST_ENCODED_MAX];
+    uint8_t raw_size_ = 0;
+    bool raw_overflow_ = false;
+    bool writing_ = false, quit_ = false;
+    // Last reply, sent again for a repeated request
+    uint8_t last_reply_[HOST_ENCODED_MAX + 2];
+    uint8_t last_reply_size_ = 0, last_opcode_ = 0, last_id_ = 0;
+    // Upload in progress
+    bool upload_ = false;
+    uint16_t upload_start_ = 0, upload_end_ = 0, upload_next_ = 0, contiguous_addr_ = 0xFFFF, upload_crc_ = 0xFFFF;
+};
+
+// Prototypes
+uint8_t CobsEncode(const uint8_t *data, const uint8_t size, uint8_t *encoded);
+uint8_t CobsDecode(const uint8_t *encoded, const uint8_t size, uint8_t *data);
+uint8_t ReconnectTarget(HostTarget *target, const DeviceMode expect);
+
+#endif  // TIMONEL_MSS_HOST_LINK_H
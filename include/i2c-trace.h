@@ -0,0 +1,78 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: i2c-trace.h (Header)
+  ............................................................................
+  I2C transaction trace (build with I2C_TRACE), exported to the console
+  in the Chrome trace event format.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_I2C_TRACE_H
+#define TIMONEL_MSS_I2C_TRACE_H
+
+#include <Arduino.h>
+
+#include "perf-stats.h"
+
+// I2C transaction trace (build with I2C_TRACE): every transfer on either
+// controller goes to a ring of the last TRACE_EVENTS, with its start
+// (micros()), duration, bus, address, direction, length, result, SCL
+// rate and its first TRACE_DATA bytes. The operations timed by the
+// performance counters (page write, status query, ...) are recorded too,
+// so each transfer can be seen inside the operation it belongs to.
+// The NB libraries talk to TwoWire directly, so the recorder sits below
+// it: the build wraps the ESP32 I2C HAL calls at link time
+//     -D I2C_TRACE -Wl,--wrap=i2cWrite -Wl,--wrap=i2cRead
+// and the wrappers time the real calls. A record costs two micros()
+// reads, an atomic increment and a few stores, next to the hundreds of
+// microseconds of the shortest transfer at 400 kHz.
+// 'j' writes the trace to the console in the Chrome trace event format
+// (JSON), which chrome://tracing and ui.perfetto.dev open as is: one
+// track per bus, one for the operations, and the stretches a bus sat idle
+// (longer than TRACE_IDLE_US) marked. Then the ring starts over. Export
+// with the bus quiet: a transfer recorded meanwhile may come out torn.
+// native/bench-trace.cpp replays a trace against the simulated Tiny85 to
+// catch timing regressions.
+
+#ifndef TRACE_EVENTS
+#define TRACE_EVENTS 1024  // Events kept, the oldest are overwritten
+#endif  // TRACE_EVENTS
+#ifndef TRACE_DATA
+#define TRACE_DATA 4       // Bytes of each transfer kept: the command or reply code and its first operands
+#endif  // TRACE_DATA
+#define TRACE_IDLE_US 1000 // A bus gap longer than this is marked idle in the export
+#define TRACE_KEY 'j'      // Console: export the trace
+
+// What an event records
+enum TraceKind : uint8_t {
+    TRACE_WRITE,  /* Master to slave (a zero-length write is an address probe) */
+    TRACE_READ,   /* Slave to master */
+    TRACE_SPAN    /* An operation of the performance counters, "address" holds its PerfOp */
+};
+
+// One event of the ring
+struct TraceEvent {
+    uint32_t start_us;
+    uint32_t duration_us;
+    TraceKind kind;
+    uint8_t bus;
+    uint8_t address;
+    uint8_t result;    /* 0: ACKed (ESP_OK), 1: NACK (ESP_FAIL), 2: another HAL error (timeout) */
+    uint16_t length;   /* Bytes requested */
+    uint16_t khz;      /* SCL rate */
+    uint8_t data[TRACE_DATA];
+};
+
+// Prototypes
+void TraceSpan(const PerfOp op, const uint32_t start_us, const uint32_t duration_us, const bool failed);
+uint32_t TraceCount(void);
+uint32_t TraceLost(void);
+bool TraceGet(const uint32_t index, TraceEvent *event);
+void TraceClear(void);
+const char *TraceName(const TraceEvent &event, char *scratch);
+void TraceExport(Print *out);
+
+#endif  // TIMONEL_MSS_I2C_TRACE_H
@@ -0,0 +1,56 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: in-place.h (Header)
+  ............................................................................
+  Static storage for objects the command loop rebuilds over and over.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_IN_PLACE_H
+#define TIMONEL_MSS_IN_PLACE_H
+
+#include <stdint.h>
+
+#include <new>
+
+// Objects the command loop replaces over and over (the Timonel device
+// object after every mode switch, the bus scanner) live in static storage
+// and are rebuilt where they are, instead of going through the heap: a
+// master running for weeks doesn't fragment it, and a pointer handed out
+// once stays good after every rebuild.
+
+// Class InPlace: static storage for one T, built (and built again) there
+template <typename T>
+class InPlace {
+   public:
+    // Destroy the current object, if any, and construct a new one in the same storage
+    template <typename... Args>
+    T *Build(Args... args) {
+        Drop();
+        object_ = new (storage_) T(args...);
+        return object_;
+    }
+    void Drop(void) {
+        if (object_ != nullptr) {
+            object_->~T();
+            object_ = nullptr;
+        }
+    }
+    T *Get(void) const { return object_; }
+
+   private:
+    alignas(T) uint8_t storage_[sizeof(T)];
+    T *object_ = nullptr;
+};
+
+// Function Rebuild: destroy an object and construct it again at the same address
+template <typename T, typename... Args>
+T *Rebuild(T *object, Args... args) {
+    object->~T();
+    return new (object) T(args...);
+}
+
+#endif  // TIMONEL_MSS_IN_PLACE_H
@@ -0,0 +1,126 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: line-flash.h (Header)
+  ............................................................................
+  Production line mode: the master runs headless and flashes every board
+  put in the fixture, one log line per board.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_LINE_FLASH_H
+#define TIMONEL_MSS_LINE_FLASH_H
+
+#include <Arduino.h>
+
+#include "payload-store.h"
+
+// Production line mode: the master runs headless and flashes every board
+// put in the fixture. No logo, screen clearing, menus or prompts: when a
+// board shows up it is brought to the bootloader, erased if it holds an
+// application, flashed and verified, started, and must answer SETIO1_1
+// with ACKIO1_1 (the LED blinks on a good board). Then the master waits
+// for it to be taken out and for the next one. Each board gets one log
+// line, PASS or FAIL with the stage that failed and the time every stage
+// took; every LINE_SUMMARY_UNITS boards a summary gives the units per
+// hour, on the line (swaps included) and flashing only.
+// The mode is built in with -D LINE_FLASH, or selected from the console
+// ('y'), which records it in NVS with the payload picked and restarts the
+// master. 'y' on the line goes back to the console (NVS selection only).
+// line-flash.cpp also runs the line: StepLine watches the fixture and
+// FlashLineUnit takes each board through the stages.
+
+#define LINE_NAMESPACE "tmnl-line"  // NVS namespace of the line mode selection
+#define LINE_VERSION 1              // Selection record layout version, others are ignored
+#define LINE_SCAN_MS 100            // Empty fixture: the bus is scanned this often (ms)
+#define LINE_POLL_MS 50             // Finished board: probed this often until it is taken out (ms)
+#define LINE_GONE_POLLS 3           // Probes unanswered in a row before a board counts as taken out
+#define LINE_SUMMARY_UNITS 10       // A summary line every this many boards
+#define LINE_EXIT_KEY 'y'           // Back to the console
+#define LINE_SUMMARY_KEY 't'        // Summary now
+#define ERR_NO_APP 13               // The application didn't start after the bootloader exit
+
+// Pipeline stages of a board
+enum LineStage : uint8_t {
+    LINE_DETECT,  /* Found, in bootloader mode (reset first if it ran an application) */
+    LINE_ERASE,   /* DELFLASH, only if it holds an application */
+    LINE_UPLOAD,  /* Pages written and read back */
+    LINE_VERIFY,  /* Readback left after the last page */
+    LINE_RUN,     /* EXITTMNL until the application answers */
+    LINE_CHECK,   /* SETIO1_1 answered with ACKIO1_1 */
+    LINE_STAGES
+};
+
+// Fixture state
+enum LineSocket : uint8_t {
+    SOCKET_EMPTY,   /* Waiting for a board */
+    SOCKET_DONE     /* Board flashed (or failed), waiting for it to be taken out */
+};
+
+// One board through the pipeline
+struct LineUnit {
+    uint32_t number = 0;
+    uint8_t address = 0;              /* Address it was found at */
+    bool erased = false;              /* It held an application */
+    uint16_t pages = 0;               /* Pages verified */
+    uint8_t error = 0;                /* 0: PASS */
+    LineStage failed = LINE_STAGES;   /* Stage that failed */
+    uint16_t bad_page = 0xFFFF;       /* First page that read back wrong */
+    uint32_t stage_us[LINE_STAGES] = {0};
+    uint32_t total_us = 0;
+    unsigned long start_ms = 0;       /* Found */
+    // "stage" took from "since_us" until now, the next one starts now
+    void EndStage(const LineStage stage, unsigned long *since_us) {
+        unsigned long now_us = micros();
+        stage_us[stage] = now_us - *since_us;
+        *since_us = now_us;
+    }
+};
+
+// The fixture, stepped by the engine
+struct LineFixture {
+    LineSocket socket = SOCKET_EMPTY;
+    uint8_t address = 0;        /* Board in the fixture */
+    unsigned long next_ms = 0;  /* Next scan or probe, not before */
+    uint8_t misses = 0;         /* Probes unanswered in a row */
+    uint32_t units = 0;         /* Boards found */
+};
+
+// Line mode selection kept in NVS
+struct LineSelection {
+    uint8_t version = LINE_VERSION;
+    bool enabled = false;
+    uint16_t flash_page_addr = 0;        /* Payload start address ('b') */
+    char payload[MAX_PAYLOAD_PATH] = ""; /* Payload file ('f'), empty: built-in payload.h */
+};
+
+// Class LineLog: the pass/fail log and the line statistics
+class LineLog {
+   public:
+    void Begin(Stream *log);
+    void Record(const LineUnit &unit);
+    void PrintSummary(void);
+    uint32_t GetUnits(void) const { return passed_ + failed_; }
+    uint32_t GetPassed(void) const { return passed_; }
+    uint32_t GetFailed(void) const { return failed_; }
+    uint32_t GetUnitsPerHour(void) const;
+    uint32_t GetFlashPerHour(void) const;
+    uint32_t GetStageAvgUs(const LineStage stage) const { return (passed_ != 0) ? (uint32_t)(stage_us_[stage] / passed_) : 0; }
+
+   private:
+    Stream *log_ = nullptr;
+    uint32_t passed_ = 0, failed_ = 0;
+    uint64_t stage_us_[LINE_STAGES] = {0}; /* Passed boards only */
+    uint64_t total_us_ = 0;                /* Passed boards only */
+    unsigned long first_ms_ = 0;           /* First board found */
+    unsigned long last_ms_ = 0;            /* Last board done */
+};
+
+// Prototypes
+bool LoadLineSelection(LineSelection *selection);
+bool SaveLineSelection(const LineSelection &selection);
+const char *LineStageName(const LineStage stage);
+
+#endif  // TIMONEL_MSS_LINE_FLASH_H
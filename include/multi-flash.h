@@ -0,0 +1,120 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: multi-flash.h (Header)
+  ............................................................................
+  Multi-slave flashing: every Timonel device on both I2C controllers gets
+  the same image, one worker task per bus.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_MULTI_FLASH_H
+#define TIMONEL_MSS_MULTI_FLASH_H
+
+#include <TimonelTwiM.h>
+#include <Wire.h>
+
+#include <atomic>
+
+#include "payload-stream.h"
+
+// Multi-slave flashing: every Timonel device found on the ESP32's two
+// I2C controllers (Wire on SDA/SCL, Wire1 on SDA_1/SCL_1) gets the same
+// image, one worker task per bus. The NB libraries always talk through
+// Wire, so each worker drives its controller with a TwiPort, sending the
+// same command sequence, packets and delays as TimonelTwiM: GETTMNLV,
+// DELFLASH, STPGADDR, WRITPAGE packets and, if asked, EXITTMNL.
+// Within a bus the devices are interleaved packet by packet: while one
+// device waits out its packet or page write delay, the next one gets
+// its packet, so a bus with several devices takes little more than the
+// slowest of them instead of their sum. Progress and the first error of
+// each device can be read at any time from another task.
+// The console commands that flash every device, 'x' (FlashAllDevices)
+// and 'g' (BroadcastAll, only built with BROADCAST_UPLOAD, see
+// broadcast-upload.h), are in multi-flash.cpp as well.
+
+#define MULTI_BUSES 2            // I2C controllers used
+#define MULTI_DEVICES 8          // Devices flashed per bus at most
+#define MULTI_REAPPEAR_MS 1000   // A device must answer again this long after its flash deletion delay (ms)
+#define MULTI_POLL_MS 8          // Poll interval while a device comes back (ms)
+#define MULTI_WORKER_STACK 4096  // Bus worker task stack (bytes)
+
+// Per device flashing steps
+enum SlaveStep : uint8_t {
+    STEP_FOUND,      /* Enumerated, not started */
+    STEP_ERASING,    /* DELFLASH sent, waiting for the device to answer again */
+    STEP_WRITING,    /* Sending the image packets */
+    STEP_DONE,       /* Flashed (and started if asked) */
+    STEP_FAILED      /* Gave up, see the error code */
+};
+
+// One device: written by its bus worker, read by anyone
+struct SlaveFlash {
+    uint8_t bus = 0;
+    uint8_t address = 0;
+    std::atomic<uint8_t> step{STEP_FOUND};
+    std::atomic<uint16_t> pages_done{0};
+    uint8_t error = 0;        /* First error (NbMicro/Timonel codes), valid once failed */
+    uint32_t elapsed_ms = 0;  /* Start to done or failure, valid once finished */
+    // Bus worker state
+    Timonel::Status status;
+    uint16_t offset = 0;           /* Next image byte to send */
+    unsigned long ready_at_us = 0; /* Not to be addressed before this (write delays) */
+    unsigned long start_us = 0, deadline_us = 0;
+    uint16_t polls = 0;            /* Status queries unanswered since the erase */
+};
+
+// Timonel commands on one I2C controller
+class TwiPort {
+   public:
+    TwiPort(TwoWire *wire = nullptr, const uint8_t sda = 0, const uint8_t scl = 0) : wire_(wire), sda_(sda), scl_(scl) {}
+    void Begin(void);
+    bool Probe(const uint8_t twi_addr);
+    uint8_t Command(const uint8_t twi_addr, const uint8_t *cmd, const uint8_t cmd_size, const uint8_t reply_code,
+                    uint8_t *reply = nullptr, const uint8_t reply_size = 0);
+    uint8_t QueryStatus(const uint8_t twi_addr, Timonel::Status *status);
+
+   private:
+    TwoWire *wire_;
+    uint8_t sda_, scl_;
+};
+
+class MultiFlash {
+   public:
+    MultiFlash(const uint8_t sda_0, const uint8_t scl_0, const uint8_t sda_1, const uint8_t scl_1);
+    uint8_t Enumerate(void);
+    bool Start(const uint8_t *image, const uint16_t image_size, const uint16_t start_addr, const bool run);
+    bool IsDone(void) const;
+    uint8_t GetCount(void) const { return count_[0] + count_[1]; }
+    uint8_t GetAppDevices(void) const { return app_devices_; }
+    SlaveFlash &GetDevice(const uint8_t ix) { return (ix < count_[0]) ? devices_[0][ix] : devices_[1][ix - count_[0]]; }
+    uint16_t GetPages(void) const { return (image_size_ + SPM_PAGESIZE - 1) / SPM_PAGESIZE; }
+    uint32_t GetElapsedMs(void) const;
+    static void Worker(void *bus_worker);
+
+   private:
+    struct BusWorker {
+        MultiFlash *owner;
+        uint8_t bus;
+        std::atomic<bool> running{false};
+        unsigned long start_us = 0, finish_us = 0;
+    };
+    void RunBus(BusWorker *worker);
+    bool Step(TwiPort *port, SlaveFlash *device);
+    void Fail(SlaveFlash *device, const uint8_t error);
+    TwiPort ports_[MULTI_BUSES];
+    BusWorker workers_[MULTI_BUSES];
+    SlaveFlash devices_[MULTI_BUSES][MULTI_DEVICES];
+    uint8_t count_[MULTI_BUSES] = {0};
+    uint8_t app_devices_ = 0;
+    const uint8_t *image_ = nullptr;
+    uint16_t image_size_ = 0, start_addr_ = 0;
+    bool run_ = false;
+};
+
+// Prototypes
+uint16_t LoadImage(PageSource *source, uint8_t *image, const uint16_t image_max, uint16_t *start_addr);
+
+#endif  // TIMONEL_MSS_MULTI_FLASH_H
@@ -0,0 +1,49 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: packet-size.h (Header)
+  ............................................................................
+  Negotiated packet sizes: the largest READFLSH packet each device sends
+  is found and kept per device.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_PACKET_SIZE_H
+#define TIMONEL_MSS_PACKET_SIZE_H
+
+#include <TimonelTwiM.h>
+
+// Negotiated packet sizes: SLV_PACKET_SIZE is what the master was built
+// with, the bootloader in the device may have been built with another.
+// Every READFLSH and READEEBK packet costs a command and a reply, so the
+// largest size a device sends is found per device and kept, like its
+// I2C clock (twi-clock.h): READFLSH packets of the sizes in
+// packet-size.cpp, up to the 32 bytes the NB libraries allow, are read at
+// address 0, largest first, and the first one with a good reply and
+// checksum is kept. A device without READFLSH keeps the compiled size.
+// The sizes are used for flash readback and EEPROM block reads.
+// Master-to-slave packets aren't negotiated: a command larger than the
+// Tiny85's TWI receive buffer may be taken in wrapped instead of being
+// refused, so WRITPAGE and WRITEEBK always send MST_PACKET_SIZE.
+
+#define PACKET_MAX 32    // Largest packet probed: the NB libraries' maximum (bytes)
+#define PACKET_SIZES 5   // Packet sizes probed, see packet-size.cpp
+#define PACKET_DEVICES 8         // Devices whose sizes are remembered
+
+// Packet size negotiation outcome
+struct PacketReport {
+    uint8_t rx_size = SLV_PACKET_SIZE;  /* Slave-to-master data bytes per READFLSH and READEEBK, kept for the device */
+    bool rx_probed = false;             /* READFLSH sizes were tried */
+    uint8_t probes = 0;                 /* Probe packets sent */
+    uint32_t probe_us = 0;              /* Time spent probing */
+};
+
+// Prototypes
+uint8_t NegotiatePackets(Timonel *timonel, const Timonel::Status &sts, PacketReport *report);
+bool PacketsKnown(const uint8_t twi_addr);
+uint8_t GetRxPacket(const uint8_t twi_addr);
+void ForgetPackets(void);
+
+#endif  // TIMONEL_MSS_PACKET_SIZE_H
@@ -0,0 +1,74 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: payload-manifest.h (Header)
+  ............................................................................
+  Payload manifest: what payload-gen.py works out about an image,
+  checked against the target at build time.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_PAYLOAD_MANIFEST_H
+#define TIMONEL_MSS_PAYLOAD_MANIFEST_H
+
+#include <TimonelTwiM.h>
+
+// Payload manifest: what payload-gen.py works out about an image when it
+// writes payload.h (start address, size, reset vector, fingerprint and
+// the CRC-16 of every flash page, padded with 0xFF). PayloadLayout checks
+// it against the target at build time (flash page boundary, room below
+// the Timonel trampoline page) and precomputes the application start
+// Timonel reports once it is flashed. Attached to a payload source, the
+// upload paths take the page CRCs and the fingerprint from the manifest
+// instead of hashing the image, and refuse a payload that doesn't fit
+// the device before writing anything.
+// The bootloader start the build is checked against is TIMONEL_START,
+// set it with "-D TIMONEL_START=0x..." for other Timonel builds.
+
+#ifndef TIMONEL_START
+#define TIMONEL_START 0x1A40  // Bootloader start of the Timonel build the payload must fit below
+#endif  // TIMONEL_START
+
+// Manifest of a payload image, as used at runtime
+struct ImageManifest {
+    uint16_t start;              /* Flash address of the first byte, page aligned */
+    uint16_t image_size;         /* Bytes */
+    uint16_t pages;              /* Flash pages, the last one padded with 0xFF */
+    uint16_t reset_vector;       /* First flash word (rjmp), 0xFFFF if the image isn't at 0 */
+    uint16_t application_start;  /* "Application start" Timonel reports with it flashed, for TIMONEL_START */
+    uint32_t fingerprint;        /* PayloadFingerprint of the image */
+    const uint16_t *page_crc;    /* CRC-16 of every page */
+};
+
+// Function TplJump: trampoline rjmp offset (12 bits) from the bootloader to the reset vector's target
+constexpr uint16_t TplJump(const uint16_t reset_vector, const uint16_t bootloader_start) {
+    return (uint16_t)((((reset_vector + 1) & 0xFFF) - (bootloader_start >> 1)) & 0xFFF);
+}
+
+// Function TrampolineOf: TrampolineFor (see flash-sync.h) for a reset vector word, at build time
+constexpr uint16_t TrampolineOf(const uint16_t reset_vector, const uint16_t bootloader_start) {
+    return (reset_vector == 0xFFFF) ? 0xFFFF
+                                    : (uint16_t)(((TplJump(reset_vector, bootloader_start) & 0xFF) << 8) |
+                                                 (0xC0 | (TplJump(reset_vector, bootloader_start) >> 8)));
+}
+
+// Build-time checks and values of a payload.h manifest
+template <uint16_t kStart, uint16_t kImageSize, uint16_t kResetVector, uint16_t kPages>
+struct PayloadLayout {
+    static_assert(kImageSize != 0, "payload.h: the image is empty");
+    static_assert((kStart % SPM_PAGESIZE) == 0, "payload.h: the image doesn't start on a flash page boundary");
+    static_assert(kPages == ((kImageSize + SPM_PAGESIZE - 1) / SPM_PAGESIZE), "payload.h: the page table doesn't match the image size");
+    static_assert((uint32_t)kStart + kImageSize <= MCU_TOTAL_MEM, "payload.h: the image doesn't fit the flash memory");
+    static_assert((uint32_t)kStart + kImageSize <= (TIMONEL_START - SPM_PAGESIZE), "payload.h: the image overlaps the Timonel trampoline page or bootloader");
+    static_assert((kStart != 0) || ((kResetVector & 0xF000) == 0xC000), "payload.h: the image doesn't start with a reset vector (rjmp)");
+
+    // Function Make: the runtime manifest, with what payload-gen.py hashed
+    static ImageManifest Make(const uint32_t fingerprint, const uint16_t *page_crc) {
+        return ImageManifest{kStart, kImageSize, kPages, (kStart == 0) ? kResetVector : (uint16_t)0xFFFF,
+                             (kStart == 0) ? TrampolineOf(kResetVector, TIMONEL_START) : (uint16_t)0xFFFF, fingerprint, page_crc};
+    }
+};
+
+#endif  // TIMONEL_MSS_PAYLOAD_MANIFEST_H
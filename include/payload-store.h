@@ -0,0 +1,70 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: payload-store.h (Header)
+  ............................................................................
+  Payload library on the LittleFS partition: Intel HEX and raw binary
+  files under /payloads, picked and flashed at runtime.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_PAYLOAD_STORE_H
+#define TIMONEL_MSS_PAYLOAD_STORE_H
+
+#include <LittleFS.h>
+
+#include "payload-stream.h"
+
+// Payload library on the LittleFS partition built from "data/" (pio run -t
+// uploadfs): Intel HEX and raw binary files under /payloads can be picked
+// and flashed at runtime. Files are streamed through a small read buffer
+// and handed out one flash page at a time, never loaded whole into RAM.
+// HEX images may start anywhere and have holes: bytes missing inside a
+// page are sent as 0xFF, pages without data are skipped.
+
+#define PAYLOAD_DIR "/payloads"
+#define MAX_PAYLOAD_PATH 64
+#define HEX_MAX_RECORD 255  // Intel HEX data bytes per record
+#define FILE_READ_BUFFER 128
+
+// Intel HEX (.hex) or raw binary (any other extension) payload file
+class FilePayload : public PageSource {
+   public:
+    bool Open(const char *path, const uint16_t bin_start_address = 0x0000);
+    void Close(void);
+    bool NextBlock(uint16_t *flash_addr, uint8_t **data, uint16_t *size);
+    void Rewind(void);
+    // Bytes handed out so far, the image size once a whole pass is done
+    uint16_t GetImageSize(void) { return image_size_; }
+    bool IsValid(void) const { return valid_; }
+    bool IsHex(void) const { return hex_; }
+
+   private:
+    int ReadByte(void);
+    int ReadHexByte(void);
+    bool ReadRecord(void);
+    bool NextHexPage(uint16_t *flash_addr, uint16_t *size);
+    File file_;
+    bool hex_ = false, valid_ = false, done_ = false;
+    uint16_t bin_start_address_ = 0;
+    uint16_t image_size_ = 0;
+    uint8_t read_buffer_[FILE_READ_BUFFER];
+    uint8_t read_ix_ = 0, read_size_ = 0;
+    uint32_t base_address_ = 0;                /* Extended segment/linear address */
+    uint32_t next_page_ = 0;                   /* HEX records must not go back before it */
+    uint32_t record_addr_ = 0;                 /* Address of the buffered record */
+    uint8_t record_size_ = 0, record_ix_ = 0;  /* Buffered record data bytes, next one to use */
+    uint8_t record_[HEX_MAX_RECORD];
+    uint8_t page_[SPM_PAGESIZE];
+};
+
+// Prototypes
+bool PayloadStoreBegin(void);
+uint8_t StoreList(const char *dir_path, const bool hex_files, void (*on_file)(const uint8_t index, const char *name, const size_t size));
+bool StorePath(const char *dir_path, const bool hex_files, const uint8_t index, char *path, const size_t path_size);
+uint8_t PayloadStoreList(void (*on_file)(const uint8_t index, const char *name, const size_t size));
+bool PayloadStorePath(const uint8_t index, char *path, const size_t path_size);
+
+#endif  // TIMONEL_MSS_PAYLOAD_STORE_H
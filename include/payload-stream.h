@@ -0,0 +1,111 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: payload-stream.h (Header)
+  ............................................................................
+  Payload sources for the upload paths, handed out one flash page at a
+  time, and the TPZ packed payload format.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_PAYLOAD_STREAM_H
+#define TIMONEL_MSS_PAYLOAD_STREAM_H
+
+#include <TimonelTwiM.h>
+
+#include "payload-manifest.h"
+
+// Payload sources for the upload paths. An image is handed out as blocks
+// that start on a flash page boundary, so a source can either expose a
+// whole array at once (raw payload) or produce it page by page from a
+// small fixed buffer (packed payload, files in payload-store.h). A source
+// can carry the build-time manifest of its image (payload-manifest.h).
+//
+// TPZ packed payload format (produced by payload-gen.py):
+//   'T' 'Z' version(1) flags image_size(LE16) start_addr(LE16), then
+//   LZSS groups: a control byte, LSB first, 1 = literal byte, 0 = match
+//   of two bytes: distance - 1 (1..256 back) and length - 3 (3..258).
+//   With the "stored" flag the image follows as is: small AVR programs
+//   are dense, the generator stores them when LZSS doesn't pay off.
+
+#define TPZ_VERSION 1
+#define TPZ_HEADER_SIZE 8
+#define TPZ_WINDOW_SIZE 256  // Must stay 256, match distances are one byte
+#define TPZ_MIN_MATCH 3
+#define TPZ_STORED 0x01  // Flag: image not packed
+
+#define ERR_BAD_PAYLOAD 9  // Broken or truncated payload image
+
+#define WAIT_STEP_US 100  // Polling step while a WaitHook runs during write delays (us)
+
+// Payload image handed out in page-aligned blocks
+class PageSource {
+   public:
+    virtual ~PageSource() {}
+    // Next block: flash address, data and size. False when the image is done (or broken).
+    virtual bool NextBlock(uint16_t *flash_addr, uint8_t **data, uint16_t *size) = 0;
+    virtual void Rewind(void) = 0;
+    virtual uint16_t GetImageSize(void) = 0;
+    virtual bool IsValid(void) const { return true; }
+    // Manifest of the image, nullptr if it wasn't made at build time
+    const ImageManifest *GetManifest(void) const { return manifest_; }
+    void SetManifest(const ImageManifest *manifest) { manifest_ = manifest; }
+
+   protected:
+    const ImageManifest *manifest_ = nullptr;
+};
+
+// Plain byte array, handed out as a single block
+class RawPayload : public PageSource {
+   public:
+    RawPayload(uint8_t payload[], const uint16_t payload_size, const uint16_t start_address = 0x0000);
+    bool NextBlock(uint16_t *flash_addr, uint8_t **data, uint16_t *size);
+    void Rewind(void);
+    uint16_t GetImageSize(void) { return payload_size_; }
+
+   private:
+    uint8_t *payload_;
+    uint16_t payload_size_, start_address_;
+    bool done_ = false;
+};
+
+// TPZ packed array, unpacked one page at a time
+class PackedPayload : public PageSource {
+   public:
+    PackedPayload(const uint8_t packed[], const uint16_t packed_size, const uint16_t start_address = 0xFFFF);
+    bool NextBlock(uint16_t *flash_addr, uint8_t **data, uint16_t *size);
+    void Rewind(void);
+    uint16_t GetImageSize(void) { return image_size_; }
+    bool IsValid(void) const { return valid_; }
+    uint16_t Unpack(uint8_t *data, const uint16_t size);
+
+   private:
+    const uint8_t *packed_;
+    uint16_t packed_size_;
+    uint16_t image_size_ = 0, start_address_ = 0;
+    bool valid_ = false;
+    bool stored_ = false;
+    uint16_t src_ix_ = 0, out_count_ = 0;
+    uint8_t control_ = 0, control_bits_ = 0;
+    uint16_t match_left_ = 0;
+    uint8_t match_distance_ = 0;
+    uint8_t window_[TPZ_WINDOW_SIZE];
+    uint8_t window_ix_ = 0;
+    uint8_t page_[SPM_PAGESIZE];
+};
+
+// Work to do during the inter-packet and page write delays (e.g. keep draining the serial port),
+// "remaining_us" is how much of the current delay is left. A running console job is served in
+// these delays too, hook or not (see console-job.h).
+typedef void (*WaitHook)(void *context, const unsigned long remaining_us);
+
+// Prototypes
+uint8_t WritePages(Timonel *timonel, const uint8_t *data, const uint16_t data_size, WaitHook on_wait = nullptr,
+                   void *context = nullptr);
+uint8_t SendPageAddress(Timonel *timonel, const uint16_t page_addr);
+uint8_t UploadAt(Timonel *timonel, uint8_t *data, const uint16_t data_size, const uint16_t flash_addr);
+uint8_t UploadPages(Timonel *timonel, PageSource *source);
+
+#endif  // TIMONEL_MSS_PAYLOAD_STREAM_H
@@ -0,0 +1,77 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: perf-stats.h (Header)
+  ............................................................................
+  Performance counters: calls, errors, retries, bytes, times and a latency
+  histogram for every timed I2C operation.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_PERF_STATS_H
+#define TIMONEL_MSS_PERF_STATS_H
+
+#include <Arduino.h>
+
+#include <atomic>
+
+// Performance counters: every page write (UploadApplication, WritePages),
+// flash deletion, status query, bus scan, device reconnect and direct
+// command transaction (TwiCmdXmit and its multi-slave counterpart) is
+// timed with micros() and counted: calls, errors, retries (polls until a
+// device answered), bytes moved, total, slowest and fastest time, and a
+// latency histogram with power-of-two buckets. A page write contains
+// command transactions, both are counted.
+// Everything is in static storage and updated with relaxed atomics, so the
+// engine, multi-slave workers and ingest task can record at once; a call
+// costs two micros() reads and a few increments, next to the millisecond
+// of bus time of the smallest transaction. Counters run since boot.
+// 't' prints the summary, the host link 'P' request returns the raw
+// counters of an operation (see host-link.h).
+
+#define PERF_BUCKETS 16       // Latency histogram buckets
+#define PERF_BUCKET_SHIFT 7   // The first bucket holds times below 2^7 us, each next one doubles, the last has the rest
+
+// Operations timed
+enum PerfOp {
+    PERF_UPLOAD,     /* Page writes: UploadApplication, WritePages */
+    PERF_DELETE,     /* DeleteApplication */
+    PERF_STATUS,     /* GetStatus (GETTMNLV) */
+    PERF_SCAN,       /* ScanBus */
+    PERF_RECONNECT,  /* FindDevice: until the device answers after a mode switch */
+    PERF_XMIT,       /* Command transactions: TwiCmdXmit */
+    PERF_OPS
+};
+
+// One operation's counters
+struct PerfCounter {
+    std::atomic<uint32_t> calls;
+    std::atomic<uint32_t> errors;
+    std::atomic<uint32_t> retries;
+    std::atomic<uint32_t> bytes;
+    std::atomic<uint64_t> total_us;
+    std::atomic<uint32_t> min_us;  /* 0 = no call yet, times are stored + 1 */
+    std::atomic<uint32_t> max_us;
+    std::atomic<uint32_t> histogram[PERF_BUCKETS];
+};
+
+// Times an operation from its construction to Stop
+class PerfTimer {
+   public:
+    explicit PerfTimer(const PerfOp op) : op_(op), start_us_(micros()) {}
+    uint8_t Stop(const uint8_t errors, const uint32_t bytes = 0, const uint32_t retries = 0);
+
+   private:
+    PerfOp op_;
+    unsigned long start_us_;
+};
+
+// Prototypes
+void PerfRecord(const PerfOp op, const uint32_t elapsed_us, const bool failed, const uint32_t bytes, const uint32_t retries);
+const PerfCounter &PerfGet(const PerfOp op);
+const char *PerfName(const PerfOp op);
+uint32_t PerfBucketLimit(const uint8_t bucket);
+
+#endif  // TIMONEL_MSS_PERF_STATS_H
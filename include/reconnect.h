@@ -0,0 +1,64 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: reconnect.h (Header)
+  ............................................................................
+  Fast reconnect after mode switches: the last known addresses are probed
+  with a bounded backoff before any bus scan.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_RECONNECT_H
+#define TIMONEL_MSS_RECONNECT_H
+
+#include <TwiBus.h>
+
+// Fast reconnect after mode switches: instead of sleeping a fixed time and
+// sweeping the whole bus, the last address seen for the expected running
+// mode is probed with a bounded exponential backoff (1 ms doubling up to
+// 8 ms). The other mode address is probed too after a short time (e.g.
+// 'r' without an application brings Timonel back), but a device may keep
+// answering there until its reset: a bootloader is only taken once it
+// answers GETTMNLV, an application after the baseline's fixed wait. A
+// bus scan, at a capped rate, is only made when the expected address is
+// still unknown or nothing answers within the probe window. The latency is measured from the call;
+// callers that print in between time it from the command instead.
+// A device found again by a scan, or at another address than before,
+// loses its upload checkpoint (see upload-checkpoint.h).
+// The bus scanner of the console controller is built once, in static
+// storage (see in-place.h).
+
+#define RECONNECT_POLL_MIN 1     // First poll interval (ms)
+#define RECONNECT_POLL_MAX 8     // Longest poll interval (ms)
+#define RECONNECT_CONFIRM_MS 20  // The other mode address isn't probed before this (ms)
+#define RECONNECT_GRACE_MS 250   // An application at its old address is only taken after this, as the fixed wait was (ms)
+#define RECONNECT_SCAN_MS 50     // At most one bus scan this often (ms)
+#define RECONNECT_PROBE_MS 1000  // Give up on the known addresses and scan after this time (ms)
+
+// Running mode expected after a switch
+enum DeviceMode {
+    MODE_ANY,
+    MODE_BOOTLOADER,
+    MODE_APPLICATION
+};
+
+// Mode switch outcome
+struct SwitchReport {
+    uint8_t address = 0;        /* Address the device answered at */
+    bool app_mode = false;      /* It answered as an application */
+    bool scanned = false;       /* A bus scan was needed to find it */
+    uint16_t polls = 0;         /* Poll rounds until it answered */
+    uint16_t probes = 0;        /* I2C address probes sent (scans included) */
+    uint32_t latency_us = 0;    /* Time until the device answered */
+    unsigned long found_us = 0; /* micros() when it answered */
+};
+
+// Prototypes
+bool ProbeAddress(const uint8_t twi_addr);
+uint8_t FindDevice(TwiBus *twi_bus, const DeviceMode expect, SwitchReport *report, void (*on_poll)(void) = nullptr);
+TwiBus *BusScanner(const uint8_t sda, const uint8_t scl);
+void ForgetDevice(void);
+
+#endif  // TIMONEL_MSS_RECONNECT_H
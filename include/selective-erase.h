@@ -0,0 +1,66 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: selective-erase.h (Header)
+  ............................................................................
+  Selective erase of the pages an application occupies, on bootloaders
+  built with FORCE_ERASE_PG.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_SELECTIVE_ERASE_H
+#define TIMONEL_MSS_SELECTIVE_ERASE_H
+
+#include <TimonelTwiM.h>
+
+#include "payload-manifest.h"
+
+// Selective erase: DELFLASH erases every page up to the bootloader and
+// resets the device, however small the application is. Timonel has no
+// command to erase one page, but a bootloader built with FORCE_ERASE_PG
+// erases each page before writing it, so writing 0xFF pages over the
+// application erases those pages only. Page 0 goes first: Timonel points
+// its reset vector at the bootloader and rewrites the trampoline, even
+// for a blank page 0. The trampoline page goes last, which clears the
+// application start Timonel reports.
+// The occupied pages start with the known extent: page 0, the pages of
+// the payload manifest when the device holds that payload (its
+// application start matches) and those an upload checkpoint of it
+// confirmed. With READFLSH the pages past it are read up to the first
+// blank one, which ends the image: pages past a blank one are left, 'e'
+// erases those. Without READFLSH the known extent is erased and the rest
+// isn't checked: the report says the erase is partial.
+// Writing a page costs its packets, the page erase and write (the reply
+// to the last packet waits for them) and DLY_FLASH_PG. DELFLASH erases
+// every page and resets the device, DLY_DEL_APP at least: unless the pages
+// to erase and the reads take clearly less at the current clock (by an
+// eighth), nothing is written and ERR_NO_SELECTIVE asks for DELFLASH.
+// Needs FORCE_ERASE_PG, F_CMD_SETPGADDR and F_APP_USE_TPL_PG, a device
+// that reports an application start, and READFLSH or a matching manifest.
+// Otherwise CanEraseSelective is false and DELFLASH it is.
+
+#define ERR_NO_SELECTIVE 14  // The device can't be erased page by page, or DELFLASH is faster
+#define SPM_ERASE_US 4500    // Tiny85 SPM page erase, as long as a page write (us)
+#define DELFLASH_RESET_US 68000  // Tiny85 reset after DELFLASH, until the bootloader answers (SUT 14CK + 64 ms)
+
+// Selective erase outcome
+struct EraseReport {
+    bool from_manifest = false;  /* The manifest's pages were taken as occupied */
+    bool partial = false;        /* Pages past the known extent weren't checked (no READFLSH) */
+    bool slower = false;         /* DELFLASH would be faster, nothing was written */
+    uint16_t extent_end = 0;     /* First flash address past the last page erased, the trampoline page aside */
+    uint16_t pages = 0;          /* Pages erased, the trampoline page included */
+    uint16_t pages_read = 0;     /* Pages read looking for occupied ones */
+    uint16_t full_pages = 0;     /* Pages a DELFLASH erases */
+    uint32_t estimate_us = 0;    /* Expected time of the page erases and reads */
+    uint32_t delflash_us = 0;    /* Expected time of a DELFLASH */
+    uint32_t erase_us = 0;
+};
+
+// Prototypes
+bool CanEraseSelective(const Timonel::Status &sts, const ImageManifest *manifest);
+uint8_t EraseOccupied(Timonel *timonel, const Timonel::Status &sts, const ImageManifest *manifest, EraseReport *report);
+
+#endif  // TIMONEL_MSS_SELECTIVE_ERASE_H
@@ -0,0 +1,93 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: spsc-queue.h (Header)
+  ............................................................................
+  Bounded lock-free single-producer / single-consumer queue.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_SPSC_QUEUE_H
+#define TIMONEL_MSS_SPSC_QUEUE_H
+
+#include <stdint.h>
+
+#include <atomic>
+
+// Bounded lock-free single-producer / single-consumer queue. One task
+// only pushes, another one only pops: the producer owns "head", the
+// consumer owns "tail", and each side publishes its index with a release
+// store that the other side reads with an acquire load, so no locks or
+// critical sections are needed on either core. Indexes run freely and
+// wrap, SIZE must be a power of two.
+
+template <typename T, uint32_t SIZE>
+class SpscQueue {
+    static_assert((SIZE != 0) && ((SIZE & (SIZE - 1)) == 0), "SpscQueue SIZE must be a power of two");
+
+   public:
+    // Producer side: false if the queue is full
+    bool Push(const T &item) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if ((head - tail_.load(std::memory_order_acquire)) == SIZE) {
+            return false;
+        }
+        items_[head & (SIZE - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    // Producer side: push as many items as fit, return how many
+    uint32_t Push(const T *items, const uint32_t count) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        uint32_t room = SIZE - (head - tail_.load(std::memory_order_acquire));
+        uint32_t pushed = (count < room) ? count : room;
+        for (uint32_t i = 0; i < pushed; i++) {
+            items_[(head + i) & (SIZE - 1)] = items[i];
+        }
+        head_.store(head + pushed, std::memory_order_release);
+        return pushed;
+    }
+    // Consumer side: false if the queue is empty
+    bool Pop(T *item) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) {
+            return false;
+        }
+        *item = items_[tail & (SIZE - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    // Consumer side: copy the oldest item without taking it, false if the queue is empty
+    bool Peek(T *item) const {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) {
+            return false;
+        }
+        *item = items_[tail & (SIZE - 1)];
+        return true;
+    }
+    // Consumer side: pop up to "max" items, return how many
+    uint32_t Pop(T *items, const uint32_t max) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        uint32_t queued = head_.load(std::memory_order_acquire) - tail;
+        uint32_t popped = (max < queued) ? max : queued;
+        for (uint32_t i = 0; i < popped; i++) {
+            items[i] = items_[(tail + i) & (SIZE - 1)];
+        }
+        tail_.store(tail + popped, std::memory_order_release);
+        return popped;
+    }
+    // Either side: a snapshot, exact only from the consumer (lower bound) or the producer (upper bound)
+    uint32_t Size(void) const { return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire); }
+    bool IsEmpty(void) const { return Size() == 0; }
+    static constexpr uint32_t Capacity(void) { return SIZE; }
+
+   private:
+    std::atomic<uint32_t> head_{0};  /* Next slot to write, producer owned */
+    std::atomic<uint32_t> tail_{0};  /* Next slot to read, consumer owned */
+    T items_[SIZE];
+};
+
+#endif  // TIMONEL_MSS_SPSC_QUEUE_H
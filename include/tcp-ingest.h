@@ -0,0 +1,136 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: tcp-ingest.h (Header)
+  ............................................................................
+  Firmware images over TCP (build with TCP_INGEST), queued as upload jobs
+  for the I2C engine.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_TCP_INGEST_H
+#define TIMONEL_MSS_TCP_INGEST_H
+
+#include <Arduino.h>
+#include <TimonelTwiM.h>
+#include <WiFi.h>
+
+#include "host-link.h"
+#include "spsc-queue.h"
+
+// Firmware images over TCP (build with TCP_INGEST): clients connect to
+// INGEST_PORT, send a header and the image, and get one text line back
+// per step. Complete, valid images become upload jobs on a bounded queue
+// the I2C engine takes them from, one at a time, between console
+// commands; the result goes back to the client that sent the image.
+//
+// Client request: "TMNL", version, flags (INGEST_RUN), start addr16,
+// size16, image crc16 (CRC-16/CCITT), all LE, then the image bytes.
+// Replies, one line each:
+//   "WAIT <queued>"            all image slots are taken, the image is not read yet
+//   "QUEUED <id> <ahead>"      received and valid, <ahead> jobs before it
+//   "DONE <id> <status> <ms>"  flashed and read back (status 0) or failed (TWI/command, ERR_VERIFY or HOST_ status)
+//   "ERR <reason>"             refused, the connection is closed
+//
+// Memory is static: INGEST_SLOTS image buffers and INGEST_CLIENTS
+// connections, nothing is allocated per client or per job. Images are
+// checked as they stream in (header, size, page alignment, reset vector
+// jump, running CRC), so a broken image never takes a queue place.
+// Backpressure: a client is only read while it owns an image slot and at
+// most INGEST_READ_CHUNK bytes per pass, so a burst of clients waits in
+// their TCP windows, a slow one just holds its own slot until
+// INGEST_TIMEOUT_MS without data, and none of them ever blocks the bus.
+// Slot indexes go to the engine and back through two SPSC queues: in
+// DUAL_CORE builds the ingest task runs next to the console task and
+// keeps receiving while the engine flashes.
+
+#define INGEST_PORT 6085
+#define INGEST_VERSION 1
+#define INGEST_HEADER_SIZE 12
+#define INGEST_CLIENTS 4               // Connections served at once, more are refused
+#define INGEST_SLOTS 3                 // Image buffers: one flashing, the rest receiving or queued
+#define INGEST_IMAGE_MAX MCU_TOTAL_MEM // Largest image accepted (bytes)
+#define INGEST_READ_CHUNK 256          // Bytes read from one client per pass, keeps them fair
+#define INGEST_TIMEOUT_MS 5000         // Drop a client that sends nothing for this long (ms)
+#define INGEST_RUN 0x01                // Header flag: run the application after the upload
+#define INGEST_STACK 4096              // Ingest task stack (bytes)
+
+// One upload job: written by the ingest side until queued, then read by the engine
+struct IngestJob {
+    uint32_t id = 0;
+    uint16_t start_addr = 0;
+    uint16_t size = 0;
+    bool run = false;
+    uint8_t status = 0;        /* Set by the engine: 0 or the first error */
+    uint32_t upload_ms = 0;    /* Set by the engine: time on the bus */
+    uint8_t image[INGEST_IMAGE_MAX];
+};
+
+// Server counters
+struct IngestStats {
+    uint32_t accepted = 0;   /* Connections taken */
+    uint32_t refused = 0;    /* Connections over INGEST_CLIENTS */
+    uint32_t invalid = 0;    /* Bad header, size, reset vector or CRC */
+    uint32_t timeouts = 0;   /* Clients dropped for not sending */
+    uint32_t waits = 0;      /* Clients told to wait for an image slot */
+    uint32_t queued = 0;     /* Jobs queued */
+    uint32_t done = 0;       /* Jobs flashed */
+    uint32_t failed = 0;     /* Jobs the engine could not complete */
+    uint32_t bytes = 0;      /* Image bytes received */
+    uint8_t peak_clients = 0;
+    uint8_t peak_queued = 0;
+};
+
+class TcpIngest {
+   public:
+    TcpIngest(void) : server_(INGEST_PORT, INGEST_CLIENTS) {}
+    // Ingest side (task or loop)
+    bool Begin(const uint16_t port = INGEST_PORT, const uint32_t timeout_ms = INGEST_TIMEOUT_MS);
+    uint32_t Service(void);
+    void End(void);
+    uint16_t GetPort(void) { return server_.port(); }
+    const IngestStats &GetStats(void) const { return stats_; }
+    // Engine side
+    IngestJob *TakeJob(void);
+    void FinishJob(IngestJob *job, const uint8_t status, const uint32_t upload_ms);
+    uint32_t GetQueued(void) const { return ready_.Size(); }
+
+   private:
+    enum ConnState { CONN_FREE, CONN_HEADER, CONN_WAIT_SLOT, CONN_BODY, CONN_QUEUED };
+    struct Conn {
+        WiFiClient client;
+        ConnState state = CONN_FREE;
+        uint8_t header[INGEST_HEADER_SIZE];
+        uint8_t header_size = 0;
+        int8_t slot = -1;
+        uint16_t start_addr = 0, size = 0, crc = 0, received = 0, running_crc = 0xFFFF;
+        bool run = false;
+        unsigned long last_data = 0;
+    };
+    uint32_t Accept(void);
+    uint32_t Finished(void);
+    uint32_t ServeConn(Conn *conn);
+    bool CheckHeader(Conn *conn);
+    bool ReserveSlot(Conn *conn);
+    void Reply(Conn *conn, const char *format, ...) __attribute__((format(printf, 3, 4)));
+    void Drop(Conn *conn, const char *reason);
+    WiFiServer server_;
+    uint32_t timeout_ms_ = INGEST_TIMEOUT_MS;
+    uint32_t next_id_ = 1;
+    IngestStats stats_;
+    Conn conns_[INGEST_CLIENTS];
+    IngestJob jobs_[INGEST_SLOTS];
+    bool slot_busy_[INGEST_SLOTS] = {false};  /* Ingest side: reserved until the engine hands it back */
+    int8_t slot_conn_[INGEST_SLOTS];          /* Ingest side: connection waiting for the result, -1 if gone */
+    SpscQueue<uint8_t, 4> ready_;             /* Ingest -> engine: queued slots */
+    SpscQueue<uint8_t, 4> done_;              /* Engine -> ingest: finished slots */
+    static_assert(INGEST_SLOTS <= 4, "The slot queues must hold every image slot");
+};
+
+// Prototypes
+uint8_t FlashIngestJob(HostTarget *target, IngestJob *job);
+void IngestTask(void *tcp_ingest);
+
+#endif  // TIMONEL_MSS_TCP_INGEST_H
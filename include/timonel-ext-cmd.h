@@ -0,0 +1,35 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: timonel-ext-cmd.h (Header)
+  ............................................................................
+  Block EEPROM codes (experimental, see EEPROM_BLOCKS_EXPERIMENTAL).
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_EXT_CMD_H
+#define TIMONEL_MSS_EXT_CMD_H
+
+#include <TimonelTwiM.h>
+
+// EEPROM block commands: READEEBK, WRITEEBK and the E_EEPROM_BLOCKS
+// extended feature bit aren't in any released Timonel, only the simulated
+// slave (lib/TimonelSim) has them, and a future Timonel could give these
+// codes or that bit to something else. The master only sends them when
+// built with -D EEPROM_BLOCKS_EXPERIMENTAL, off by default; otherwise the
+// EEPROM is always accessed with the one-byte READEEPR and WRITEEPR.
+#ifdef EEPROM_BLOCKS_EXPERIMENTAL
+#ifndef E_EEPROM_BLOCKS
+#define E_EEPROM_BLOCKS 6
+#endif
+#ifndef READEEBK
+#define READEEBK 0x8B  // Command: Read an EEPROM block
+#define ACKRDEBK 0x74  // Reply: EEPROM block follows
+#define WRITEEBK 0x8C  // Command: Write an EEPROM block
+#define ACKWTEBK 0x73  // Reply: EEPROM block written
+#endif  // READEEBK
+#endif  // EEPROM_BLOCKS_EXPERIMENTAL
+
+#endif  // TIMONEL_MSS_EXT_CMD_H
@@ -18,6 +18,13 @@
 #include <TimonelTwiM.h>
 #include <TwiBus.h>
 
+#include "device-cache.h"
+#include "eeprom-mirror.h"
+#include "in-place.h"
+#include "line-flash.h"
+#include "payload-store.h"
+#include "reconnect.h"
+
 // This software
 #define VER_DATE  "2023-08-22"
 #define VER_MAJOR 1
@@ -26,26 +33,133 @@
 #define AUTH_MAIL "gustavo.casanova@gmail.com"
 
 // Serial display settings
+#ifdef DUAL_CORE
+#include "console-ring.h"
+#define USE_SERIAL console_ring  // The engine task prints and reads keys through the console task
+extern ConsoleRing console_ring;
+#else
 #define USE_SERIAL Serial
+#endif  // DUAL_CORE
 #define SERIAL_BPS 115200
 
+// TCP firmware ingest: build with -D TCP_INGEST -D WIFI_SSID=\"...\" -D WIFI_PASSWORD=\"...\"
+#ifdef TCP_INGEST
+#include "tcp-ingest.h"
+#ifndef WIFI_SSID
+#define WIFI_SSID ""
+#endif  // WIFI_SSID
+#ifndef WIFI_PASSWORD
+#define WIFI_PASSWORD ""
+#endif  // WIFI_PASSWORD
+#endif  // TCP_INGEST
+
 // I2C pins
 #define SDA 2  // I2C SDA pin - ESP8266 2 - ESP32 21
 #define SCL 0  // I2C SCL pin - ESP8266 0 - ESP32 22
+// Second I2C controller pins (multi-slave flashing)
+#define SDA_1 4  // I2C SDA pin, bus 1 - ESP32 4
+#define SCL_1 5  // I2C SCL pin, bus 1 - ESP32 5
 
 // Upper EEPROM memory location
 #define EEPROM_TOP 0x1FF
 // Rotating bar delay
 #define ROTATION_DLY 60
-// Application mode switch delay
+// Master restart delay (lets the console output drain)
 #define MODE_SWITCH_DLY 250
+// Engine pause when a loop pass found nothing to do (ms)
+#define ENGINE_IDLE_MS 1
+
+// Console prompts: a command waiting for the number it asked for, it goes on when the line is typed
+enum Prompt : uint8_t {
+    PROMPT_NONE,
+    PROMPT_PAGE_ADDR,    /* 'b': flash page base address */
+    PROMPT_PAYLOAD,      /* 'f': payload number */
+    PROMPT_EEPROM_ADDR,  /* 'p': EEPROM address */
+    PROMPT_EEPROM_DATA,  /* 'p': byte to write there */
+    PROMPT_EEPROM_IMAGE  /* 'l': EEPROM image number */
+};
+
+// Flash deletion running from the console ('e', 'u' and 'd' when it can't patch pages): DELFLASH
+// is sent, its reply is read once the erase should be over and then the engine polls the device on
+// its next passes until it answers again
+struct EraseJob {
+    bool running = false;
+    bool replied = false;        /* AKDLFLSH read (or the device restarted before) */
+    bool then_upload = false;    /* 'd': upload the selected payload once the device is back */
+    unsigned long start_us = 0;  /* DELFLASH sent */
+    unsigned long probe_ms = 0;  /* Next reply read or poll, not before */
+    uint16_t polls = 0;
+};
+
+// Console command: the handler a key runs, looked up in the running mode's table by RunCommand
+struct ConsoleCommand {
+    char key;  /* Lower case, the upper case key runs it too */
+    void (*run)(void);
+};
+
+// Engine state, shared with the engine loop (console-job.cpp), the console commands (flash-commands.cpp,
+// eeprom-commands.cpp, bus-commands.cpp), line mode (line-flash.cpp) and multi-slave flashing (multi-flash.cpp)
+extern bool new_key;
+extern bool *p_app_mode;
+extern char key;
+extern uint16_t flash_page_addr;
+extern uint16_t eeprom_addr;
+extern char payload_file[MAX_PAYLOAD_PATH];
+extern Prompt prompt;
+extern uint8_t prompt_choices;
+extern EraseJob erase_job;
+extern bool line_mode;
+extern LineFixture line_fixture;
+extern LineLog line_log;
+extern Timonel *p_timonel;
+extern InPlace<Timonel> timonel_slot;
+extern DeviceCache device_cache;
+extern EepromMirror eeprom_mirror;
+#ifdef TCP_INGEST
+extern TcpIngest tcp_ingest;
+#endif  // TCP_INGEST
 
 // Prototypes
 void setup(void);
 void loop(void);
+void EngineSetup(void);
+bool EngineLoop(void);
+void EngineTask(void *param);
+void RunCommand(void);
+void StartBlink(void);
+void StopBlink(void);
+void ResetDevice(void);
+void ShowAppHelp(void);
+void RestartMaster(void);
+void ShowVersion(void);
+void RunApp(void);
+void FinishCommand(void);
+bool CommandPending(void);
+void AnswerPrompt(const uint16_t word);
+bool StartErase(const bool then_upload);
+bool StepErase(void);
+void FinishErase(const uint8_t cmd_errors);
+void LineSetup(const LineSelection &selection);
+bool StepLine(void);
+void FlashLineUnit(LineUnit *unit);
+void SelectLineMode(void);
+#ifdef TCP_INGEST
+void RunIngestJob(IngestJob *job);
+#endif  // TCP_INGEST
+void FlashAllDevices(void);
+#ifdef BROADCAST_UPLOAD
+void BroadcastAll(void);
+#endif  // BROADCAST_UPLOAD
+void ReconnectConsole(void);
 void ReadChar(void);
-uint16_t ReadWord(void);
-uint8_t DiscoverDevice(bool *p_app_mode, const uint8_t sda = 0, const uint8_t scl = 0);
+bool ReadWord(const char rc, uint16_t *word);
+PageSource *OpenSelectedPayload(FilePayload *file);
+PageSource *OpenPayload(PageSource *builtin, FilePayload *file);
+const ImageManifest *SelectedManifest(void);
+uint8_t DiscoverDevice(bool *p_app_mode, const uint8_t sda = 0, const uint8_t scl = 0, const DeviceMode expect = MODE_ANY,
+                       SwitchReport *report = nullptr, const bool quiet = false);
+void WaitingBar(void);
+void PrintSwitch(const SwitchReport &report);
 Timonel::Status PrintStatus(Timonel *timonel);
 void ShowHeader(const bool app_mode);
 void ShowMenu(const bool app_mode);
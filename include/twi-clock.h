@@ -0,0 +1,78 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: twi-clock.h (Header)
+  ............................................................................
+  Adaptive I2C clock: the fastest SCL rate a fixture carries is found per
+  device, and stepped down when the bus starts failing.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_TWI_CLOCK_H
+#define TIMONEL_MSS_TWI_CLOCK_H
+
+#include <TimonelTwiM.h>
+
+#include "flash-sync.h"
+
+// Adaptive I2C clock: the fastest SCL rate a fixture's wiring carries is
+// found per device by probing the rates in ascending order with a short
+// integrity test. Each round reads the bootloader status (GETTMNLV) and,
+// when available, a flash packet (READFLSH), and compares them byte by
+// byte with copies read at the standard 100 kHz rate. The first rate with
+// a NAK, a bad checksum or a different byte ends the probe, the last one
+// that passed is kept for the device.
+// A Tiny85 bootloader running on the plain 8 MHz RC oscillator is only
+// probed up to Fast-mode 400 kHz. Above that its USI needs the 16 MHz PLL
+// clock or the oscillator tweak Timonel applies with AUTO_CLK_TWEAK.
+// While uploading, the command transaction errors are watched (see
+// perf-stats.h). Too many of them in a window steps the clock down a rate,
+// and a verified upload that fails on the bus above the standard rate goes
+// on one rate lower from its last confirmed page (see upload-checkpoint.h),
+// or is erased and started over if the bootloader can't resume. The
+// device's packet sizes are negotiated before its first upload too (see
+// packet-size.h).
+// The bus is scanned and shared with other devices (multi-slave, general
+// call) at the standard rate only.
+
+#define CLOCK_BASE 100000         // Standard-mode SCL rate, every device and scan works at it (Hz)
+#define CLOCK_RC_CEILING 400000   // Fastest rate probed on a Tiny85 at 8 MHz (Hz)
+#define CLOCK_RATES 4             // SCL rates probed, see twi-clock.cpp
+#define CLOCK_PROBE_ROUNDS 8      // Integrity test rounds at each rate
+#define CLOCK_DEVICES 8           // Devices whose rate is remembered
+#define CLOCK_FAULT_WINDOW 64     // Command transactions an error rate is measured over
+#define CLOCK_FAULT_LIMIT 1       // More errors than this in a window step the clock down
+#define CLOCK_REAPPEAR_MS 1000    // A device must answer again this long after a flash deletion (ms)
+#define CLOCK_POLL_MS 8           // Poll interval while it comes back (ms)
+
+// One probed rate
+struct ClockProbe {
+    uint32_t hz = 0;
+    uint8_t rounds = 0;   /* Integrity test rounds passed */
+    uint8_t error = 0;    /* Error of the failed round, ERR_VERIFY if the data differed, 0 if all passed */
+};
+
+// Clock negotiation outcome
+struct ClockReport {
+    uint8_t probes = 0;                /* Rates tested above the base one */
+    ClockProbe probe[CLOCK_RATES];
+    uint32_t ceiling_hz = CLOCK_BASE;  /* Fastest rate the device CPU clock allows */
+    uint32_t chosen_hz = CLOCK_BASE;   /* Fastest reliable rate, kept for the device */
+    uint32_t probe_us = 0;             /* Time spent probing */
+    bool flash_test = false;           /* READFLSH packets were part of the test */
+};
+
+// Prototypes
+uint32_t NegotiateClock(Timonel *timonel, ClockReport *report);
+uint32_t GetDeviceClock(const uint8_t twi_addr);
+uint32_t SetDeviceClock(const uint8_t twi_addr);
+void SetBaseClock(void);
+void ForgetClocks(void);
+bool FallBackClock(const uint8_t twi_addr);
+void WatchClock(const uint8_t twi_addr);
+bool CheckClock(void);
+uint8_t UploadAdaptive(Timonel *timonel, PageSource *source, const Timonel::Status &sts, VerifyReport *report, uint8_t *fallbacks);
+
+#endif  // TIMONEL_MSS_TWI_CLOCK_H
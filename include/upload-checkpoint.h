@@ -0,0 +1,58 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: upload-checkpoint.h (Header)
+  ............................................................................
+  Upload checkpoints: the pages a verified upload confirmed are kept in
+  NVS, so a failed upload goes on from there.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_UPLOAD_CHECKPOINT_H
+#define TIMONEL_MSS_UPLOAD_CHECKPOINT_H
+
+#include <Arduino.h>
+
+#include "payload-stream.h"
+
+// Upload checkpoints: while a verified upload runs, the pages read back
+// and found right are recorded in NVS (ESP32 Preferences), keyed by the
+// slave address and tied to a fingerprint of the payload. An upload of
+// the same payload to the same address that failed, or was cut short by
+// a reset of either side, then goes on from the first page that wasn't
+// confirmed instead of starting over. The record is written every
+// CHECKPOINT_EVERY pages and when the upload fails, not after each page:
+// every write wears the NVS flash and takes milliseconds.
+// Before resuming, every confirmed page is read back and compared with
+// the payload: if one differs (the device was erased, swapped or flashed
+// with something else meanwhile), the checkpoint is dropped and the
+// upload starts from the first page. It is dropped too when the device
+// is found again by a bus scan, or lost (see reconnect.h, device-cache.h).
+// A page that failed is written again over itself: with FORCE_ERASE_PG
+// the bootloader erases it first, without it SPM can only clear bits, so
+// a page left half written that the payload can't be written over means
+// the device has to be erased (ERR_NEEDS_ERASE) instead of resumed.
+// Resuming needs the READFLSH and STPGADDR bootloader commands. The
+// checkpoint is removed once the whole payload is verified.
+
+#define CHECKPOINT_NAMESPACE "tmnl-upload"  // NVS namespace of the checkpoints
+#define CHECKPOINT_VERSION 3                // Record layout version, others are ignored
+#define CHECKPOINT_EVERY 8                  // Pages confirmed between two NVS writes
+
+// Upload progress of a payload on a device, in upload order
+struct UploadCheckpoint {
+    uint8_t version = CHECKPOINT_VERSION;
+    uint8_t twi_addr = 0;
+    uint32_t fingerprint = 0;     /* PayloadFingerprint of the payload */
+    uint16_t confirmed = 0;       /* Pages read back and found right, from the first one */
+};
+
+// Prototypes
+uint32_t PayloadFingerprint(PageSource *source);
+bool LoadCheckpoint(const uint8_t twi_addr, const uint32_t fingerprint, UploadCheckpoint *checkpoint);
+bool SaveCheckpoint(const UploadCheckpoint &checkpoint);
+void ClearCheckpoint(const uint8_t twi_addr);
+
+#endif  // TIMONEL_MSS_UPLOAD_CHECKPOINT_H
@@ -0,0 +1,243 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: Arduino.cpp (Stand-in library)
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "Arduino.h"
+
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+thread_local uint64_t SimClock::now_us_ = 0;
+
+HardwareSerial Serial;
+EspClass ESP;
+
+unsigned long millis(void) {
+    return (unsigned long)(SimClock::Now() / 1000);
+}
+
+unsigned long micros(void) {
+    return (unsigned long)SimClock::Now();
+}
+
+void delay(unsigned long ms) {
+    SimClock::Advance((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    SimClock::Advance(us);
+}
+
+void yield(void) {
+}
+
+// Class HardwareSerial: Initialize the console
+void HardwareSerial::begin(unsigned long baud_rate) {
+    baud_rate_ = baud_rate;
+    tx_empty_at_us_ = SimClock::Now();
+}
+
+// Class HardwareSerial: Return the amount of keystrokes waiting to be read
+int HardwareSerial::available(void) {
+    if (peer_ != nullptr) {
+        peer_->Idle(SimClock::Now());
+        Arrive();
+    }
+    if (use_stdin_ && rx_queue_.empty()) {
+        struct pollfd pfd = {STDIN_FILENO, POLLIN, 0};
+        char rx_char;
+        if ((poll(&pfd, 1, 1) > 0) && (::read(STDIN_FILENO, &rx_char, 1) == 1)) {
+            rx_queue_ += rx_char;
+        } else {
+            SimClock::Advance(1000); /* Idle polling: 1 ms per call, both real and virtual */
+        }
+    }
+    return rx_queue_.size();
+}
+
+// Class HardwareSerial: Read one keystroke, -1 if none
+int HardwareSerial::read(void) {
+    if (available() == 0) {
+        return -1;
+    }
+    uint8_t rx_char = rx_queue_[0];
+    rx_queue_.erase(0, 1);
+    return rx_char;
+}
+
+// Class HardwareSerial: Next keystroke without taking it, -1 if none
+int HardwareSerial::peek(void) {
+    return (available() > 0) ? (uint8_t)rx_queue_[0] : -1;
+}
+
+// Class HardwareSerial: RX buffer size
+size_t HardwareSerial::setRxBufferSize(size_t size) {
+    rx_buffer_size_ = size;
+    return size;
+}
+
+// Class HardwareSerial: Move the peer bytes already on the line into the RX buffer. Nothing was
+// read since they arrived, so a full buffer now was full then too: those bytes are overruns.
+void HardwareSerial::Arrive(void) {
+    const uint64_t now = SimClock::Now();
+    while (!rx_line_.empty() && (rx_line_.front().first <= now)) {
+        if (rx_queue_.size() < rx_buffer_size_) {
+            rx_queue_ += (char)rx_line_.front().second;
+        } else {
+            rx_overruns_++;
+        }
+        rx_line_.pop_front();
+    }
+}
+
+// Class HardwareSerial: Peer output, one byte per frame time once the line is free
+void HardwareSerial::Send(const uint8_t *data, size_t size, uint64_t not_before_us) {
+    const uint64_t byte_us = (10 * 1000000ULL) / baud_rate_;
+    uint64_t start = (not_before_us > SimClock::Now()) ? not_before_us : SimClock::Now();
+    if (rx_line_free_at_us_ < start) {
+        rx_line_free_at_us_ = start;
+    }
+    for (size_t i = 0; i < size; i++) {
+        rx_line_free_at_us_ += byte_us;
+        rx_line_.push_back(std::make_pair(rx_line_free_at_us_, data[i]));
+    }
+}
+
+// Class HardwareSerial: Plug a far end into the console
+void HardwareSerial::SetPeer(SerialPeer *peer) {
+    peer_ = peer;
+    rx_line_.clear();
+    rx_line_free_at_us_ = 0;
+    rx_overruns_ = 0;
+}
+
+// Class HardwareSerial: Free room in the TX FIFO and buffer
+int HardwareSerial::availableForWrite(void) {
+    const uint64_t byte_us = (10 * 1000000ULL) / baud_rate_;
+    uint64_t now = SimClock::Now();
+    uint64_t queued = (tx_empty_at_us_ > now) ? ((tx_empty_at_us_ - now + byte_us - 1) / byte_us) : 0;
+    uint64_t capacity = TX_FIFO_SIZE + tx_buffer_size_;
+    return (queued < capacity) ? (int)(capacity - queued) : 0;
+}
+
+// Class HardwareSerial: Software TX buffer size
+size_t HardwareSerial::setTxBufferSize(size_t size) {
+    tx_buffer_size_ = size;
+    return size;
+}
+
+// Class HardwareSerial: Write one byte, blocking while the TX FIFO (and buffer) is full
+size_t HardwareSerial::write(uint8_t data) {
+    const uint64_t byte_us = (10 * 1000000ULL) / baud_rate_; /* 8N1 frame: 10 bits */
+    const uint64_t capacity = TX_FIFO_SIZE + tx_buffer_size_;
+    uint64_t now = SimClock::Now();
+    if (tx_empty_at_us_ < now) {
+        tx_empty_at_us_ = now;
+    }
+    if ((tx_empty_at_us_ - now) >= (capacity * byte_us)) {
+        SimClock::AdvanceTo(tx_empty_at_us_ - ((capacity - 1) * byte_us));
+    }
+    tx_empty_at_us_ += byte_us;
+    tx_bytes_++;
+    if (echo_) {
+        fputc(data, stdout);
+    }
+    if (capture_ != nullptr) {
+        *capture_ += (char)data;
+    }
+    if (peer_ != nullptr) {
+        peer_->Received(data, tx_empty_at_us_);
+    }
+    return 1;
+}
+
+// Class HardwareSerial: Write a buffer
+size_t HardwareSerial::write(const uint8_t *data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        write(data[i]);
+    }
+    return size;
+}
+
+// Class Print: Write a buffer one byte at a time
+size_t Print::write(const uint8_t *data, size_t size) {
+    size_t written = 0;
+    while ((written < size) && (write(data[written]) == 1)) {
+        written++;
+    }
+    return written;
+}
+
+// Class Print: Write a string
+size_t Print::print(const char *str) {
+    return write((const uint8_t *)str, strlen(str));
+}
+
+// Class Print: Formatted write
+size_t Print::printf(const char *format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) {
+        return 0;
+    }
+    if ((size_t)length >= sizeof(buffer)) {
+        length = sizeof(buffer) - 1;
+    }
+    return write((const uint8_t *)buffer, length);
+}
+
+// Class HardwareSerial: Wait until the TX FIFO drains
+void HardwareSerial::flush(void) {
+    SimClock::AdvanceTo(tx_empty_at_us_);
+    if (echo_) {
+        fflush(stdout);
+    }
+}
+
+// Class HardwareSerial: Queue keystrokes as if typed on the console
+void HardwareSerial::Inject(const char *keys) {
+    rx_queue_ += keys;
+}
+
+// Class HardwareSerial: Keep a copy of the console output
+void HardwareSerial::SetCapture(std::string *capture) {
+    capture_ = capture;
+}
+
+// Class HardwareSerial: Enable or discard console output
+void HardwareSerial::SetEcho(bool echo) {
+    echo_ = echo;
+}
+
+static struct termios saved_termios;
+
+static void RestoreTerminal(void) {
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved_termios);
+}
+
+// Class HardwareSerial: Take keystrokes from the process stdin, a terminal is put in raw mode
+void HardwareSerial::SetStdin(bool use_stdin) {
+    use_stdin_ = use_stdin;
+    if (use_stdin_ && isatty(STDIN_FILENO) && (tcgetattr(STDIN_FILENO, &saved_termios) == 0)) {
+        struct termios raw_termios = saved_termios;
+        raw_termios.c_lflag &= ~(ICANON | ECHO);
+        raw_termios.c_iflag &= ~ICRNL; /* Enter arrives as CR, like on a serial terminal */
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw_termios);
+        atexit(RestoreTerminal);
+    }
+}
+
+// Class EspClass: There is no master to reboot on the host, just leave
+void EspClass::restart(void) {
+    Serial.flush();
+    exit(0);
+}
@@ -0,0 +1,148 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: Arduino.h (Header)
+  ............................................................................
+  Minimal Arduino core replacement for the PlatformIO "native"
+  environment, on a virtual clock and a modelled serial console.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_SIM_ARDUINO_H
+#define TIMONEL_SIM_ARDUINO_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <deque>
+#include <string>
+#include <utility>
+
+#include "SimClock.h"
+
+// Minimal Arduino core replacement for the PlatformIO "native" environment.
+// Time is virtual: millis(), micros() and delay() run on the simulator
+// clock, so I2C transfers, Tiny85 flash timings and console output all add
+// up deterministically. The serial console is backed by stdin/stdout and
+// models a 115200 bps UART with a hardware TX FIFO (plus the optional
+// ESP32 software TX buffer). A SerialPeer can stand at the other end of
+// the cable: it sees the master's output as it leaves the line and its
+// own bytes arrive at the line rate into a bounded RX buffer.
+
+typedef uint8_t byte;
+
+// ESP32 Arduino maps the "_P" variants straight to their RAM counterparts
+#define printf_P printf
+#define PSTR(s) (s)
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+
+// Minimal Arduino String (only what the demo uses)
+class String {
+   public:
+    String(const char *str = "") : str_(str) {}
+    String &operator=(const char *str) {
+        str_ = str;
+        return *this;
+    }
+    String &operator+=(const char *str) {
+        str_ += str;
+        return *this;
+    }
+    const char *c_str(void) const { return str_.c_str(); }
+    unsigned int length(void) const { return str_.length(); }
+
+   private:
+    std::string str_;
+};
+
+// Arduino Print: byte output plus the formatted helpers built on it
+class Print {
+   public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t data) = 0;
+    virtual size_t write(const uint8_t *data, size_t size);
+    virtual int availableForWrite(void) { return 0; }
+    virtual void flush(void) {}
+    size_t print(const char *str);
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+// Arduino Stream: Print plus byte input
+class Stream : public Print {
+   public:
+    virtual int available(void) = 0;
+    virtual int read(void) = 0;
+    virtual int peek(void) = 0;
+};
+
+// Far end of the serial cable, e.g. a host program in a loopback test
+class SerialPeer {
+   public:
+    virtual ~SerialPeer() {}
+    virtual void Received(const uint8_t data, const uint64_t at_us) = 0;  // A master byte left the line at "at_us"
+    virtual void Idle(const uint64_t now_us) {}                           // The master polled its input
+};
+
+// Serial console stand-in: stdout for output, stdin or injected keys for input
+class HardwareSerial : public Stream {
+   public:
+    void begin(unsigned long baud_rate);
+    int available(void);
+    int read(void);
+    int peek(void);
+    int availableForWrite(void);
+    size_t setTxBufferSize(size_t size);  // ESP32: software TX ring buffer on top of the FIFO, before begin()
+    size_t setRxBufferSize(size_t size);  // ESP32: RX ring buffer, bytes arriving when it's full are lost
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t size);
+    void flush(void);
+    // Simulator hooks
+    void Inject(const char *keys);             // Queue keystrokes as if typed on the console
+    void SetEcho(bool echo);                   // false: discard output (it is still timed)
+    void SetStdin(bool use_stdin);             // true: read keystrokes from the process stdin
+    void SetCapture(std::string *capture);     // Also append every byte written to "capture" (nullptr: stop)
+    void SetPeer(SerialPeer *peer);            // Connect a far end (nullptr: unplug, pending input is dropped)
+    void Send(const uint8_t *data, size_t size, uint64_t not_before_us = 0);  // Peer bytes, timed at the line rate
+    uint32_t GetTxBytes(void) const { return tx_bytes_; }
+    void ResetTxBytes(void) { tx_bytes_ = 0; }
+    uint32_t GetRxOverruns(void) const { return rx_overruns_; }
+
+   private:
+    void Arrive(void);
+    static const uint16_t TX_FIFO_SIZE = 128;  // ESP32 UART hardware FIFO
+    unsigned long baud_rate_ = 115200;
+    size_t tx_buffer_size_ = 0;
+    size_t rx_buffer_size_ = 256;
+    uint64_t tx_empty_at_us_ = 0;  // Virtual time when the TX FIFO drains
+    uint32_t tx_bytes_ = 0;
+    bool echo_ = true;
+    bool use_stdin_ = false;
+    std::string rx_queue_;
+    std::string *capture_ = nullptr;
+    SerialPeer *peer_ = nullptr;
+    std::deque<std::pair<uint64_t, uint8_t> > rx_line_;  // Peer bytes on the wire, with their arrival time
+    uint64_t rx_line_free_at_us_ = 0;
+    uint32_t rx_overruns_ = 0;
+};
+
+extern HardwareSerial Serial;
+
+// ESP object stand-in
+class EspClass {
+   public:
+    void restart(void);
+};
+
+extern EspClass ESP;
+
+#endif  // TIMONEL_SIM_ARDUINO_H
@@ -0,0 +1,176 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: FS.cpp (Source)
+  ............................................................................
+  Directory-backed file system (see FS.h).
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "FS.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "LittleFS.h"
+
+fs::LittleFSFS LittleFS;
+
+namespace fs {
+
+// Host handle behind a File
+class FileImpl {
+   public:
+    FileImpl(const std::string &host_path, const std::string &path) : host_path_(host_path), path_(path) {
+        size_t slash = path_.find_last_of('/');
+        name_ = (slash == std::string::npos) ? path_ : path_.substr(slash + 1);
+    }
+    ~FileImpl() {
+        if (file_ != nullptr) {
+            fclose(file_);
+        }
+        if (dir_ != nullptr) {
+            closedir(dir_);
+        }
+    }
+    std::string host_path_, path_, name_;
+    FILE *file_ = nullptr;
+    DIR *dir_ = nullptr;
+    size_t size_ = 0;
+    bool writable_ = false;
+};
+
+size_t File::read(uint8_t *buf, size_t size) {
+    if (!impl_ || (impl_->file_ == nullptr)) {
+        return 0;
+    }
+    return fread(buf, 1, size, impl_->file_);
+}
+
+int File::read(void) {
+    uint8_t value = 0;
+    return (read(&value, 1) == 1) ? value : -1;
+}
+
+size_t File::write(const uint8_t *buf, size_t size) {
+    if (!impl_ || (impl_->file_ == nullptr) || !impl_->writable_) {
+        return 0;
+    }
+    size_t written = fwrite(buf, 1, size, impl_->file_);
+    impl_->size_ += written;
+    return written;
+}
+
+int File::available(void) {
+    if (!impl_ || (impl_->file_ == nullptr)) {
+        return 0;
+    }
+    return (int)(impl_->size_ - position());
+}
+
+bool File::seek(uint32_t pos) {
+    return impl_ && (impl_->file_ != nullptr) && (fseek(impl_->file_, pos, SEEK_SET) == 0);
+}
+
+size_t File::position(void) const {
+    return (impl_ && (impl_->file_ != nullptr)) ? ftell(impl_->file_) : 0;
+}
+
+size_t File::size(void) const {
+    return impl_ ? impl_->size_ : 0;
+}
+
+const char *File::name(void) const {
+    return impl_ ? impl_->name_.c_str() : "";
+}
+
+const char *File::path(void) const {
+    return impl_ ? impl_->path_.c_str() : "";
+}
+
+bool File::isDirectory(void) const {
+    return impl_ && (impl_->dir_ != nullptr);
+}
+
+File File::openNextFile(void) {
+    if (!isDirectory()) {
+        return File();
+    }
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(impl_->dir_)) != nullptr) {
+        if ((strcmp(entry->d_name, ".") != 0) && (strcmp(entry->d_name, "..") != 0)) {
+            break;
+        }
+    }
+    if (entry == nullptr) {
+        return File();
+    }
+    std::string path = impl_->path_ + ((impl_->path_ == "/") ? "" : "/") + entry->d_name;
+    return LittleFS.open(path.c_str());
+}
+
+File FS::open(const char *path, const char *mode) {
+    if (!mounted_ || (path == nullptr) || (path[0] != '/')) {
+        return File();
+    }
+    std::shared_ptr<FileImpl> impl(new FileImpl(root_ + path, path));
+    if (strcmp(mode, "w") == 0) {
+        impl->file_ = fopen(impl->host_path_.c_str(), "wb");
+        impl->writable_ = true;
+        return (impl->file_ != nullptr) ? File(impl) : File();
+    }
+    if (strcmp(mode, "r") != 0) {
+        return File();
+    }
+    struct stat info;
+    if (stat(impl->host_path_.c_str(), &info) != 0) {
+        return File();
+    }
+    if (S_ISDIR(info.st_mode)) {
+        impl->dir_ = opendir(impl->host_path_.c_str());
+    } else {
+        impl->file_ = fopen(impl->host_path_.c_str(), "rb");
+        impl->size_ = info.st_size;
+    }
+    if ((impl->dir_ == nullptr) && (impl->file_ == nullptr)) {
+        return File();
+    }
+    return File(impl);
+}
+
+bool FS::exists(const char *path) {
+    struct stat info;
+    return mounted_ && (path != nullptr) && (stat((root_ + path).c_str(), &info) == 0);
+}
+
+bool FS::mkdir(const char *path) {
+    struct stat info;
+    if (!mounted_ || (path == nullptr) || (path[0] != '/')) {
+        return false;
+    }
+    return (::mkdir((root_ + path).c_str(), 0755) == 0) || ((stat((root_ + path).c_str(), &info) == 0) && S_ISDIR(info.st_mode));
+}
+
+bool FS::remove(const char *path) {
+    return mounted_ && (path != nullptr) && (path[0] == '/') && (::remove((root_ + path).c_str()) == 0);
+}
+
+bool LittleFSFS::begin(bool format_on_fail, const char *base_path, uint8_t max_open_files, const char *partition_label) {
+    if (root_.empty()) {
+        const char *root = getenv("TIMONEL_FS_ROOT");
+        root_ = (root != nullptr) ? root : "data";
+    }
+    while ((root_.size() > 1) && (root_[root_.size() - 1] == '/')) {
+        root_.erase(root_.size() - 1);
+    }
+    struct stat info;
+    mounted_ = (stat(root_.c_str(), &info) == 0) && S_ISDIR(info.st_mode);
+    return mounted_;
+}
+
+}  // namespace fs
@@ -0,0 +1,75 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: FS.h (Header)
+  ............................................................................
+  Arduino ESP32 "fs::FS" / "fs::File" replacement backed by a plain
+  host directory.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_SIM_FS_H
+#define TIMONEL_SIM_FS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+// Arduino ESP32 "fs::FS" / "fs::File" replacement backed by a plain host
+// directory: paths are taken relative to the mount root, so a PlatformIO
+// "data/" folder can be read exactly like the LittleFS image built from it.
+// Files are opened for reading ("r") or rewritten from scratch ("w").
+
+namespace fs {
+
+class FileImpl;
+
+// Open file or directory handle, copies share the same host handle
+class File {
+   public:
+    File() {}
+    explicit File(std::shared_ptr<FileImpl> impl) : impl_(impl) {}
+    size_t read(uint8_t *buf, size_t size);
+    int read(void);
+    size_t write(const uint8_t *buf, size_t size);
+    size_t write(uint8_t value) { return write(&value, 1); }
+    int available(void);
+    bool seek(uint32_t pos);
+    size_t position(void) const;
+    size_t size(void) const;
+    const char *name(void) const;  // Base name, like Arduino ESP32 2.x
+    const char *path(void) const;  // Path from the mount root
+    bool isDirectory(void) const;
+    File openNextFile(void);
+    void close(void) { impl_.reset(); }
+    operator bool() const { return impl_ != nullptr; }
+
+   private:
+    std::shared_ptr<FileImpl> impl_;
+};
+
+// File system mounted on a host directory
+class FS {
+   public:
+    File open(const char *path, const char *mode = "r");
+    bool exists(const char *path);
+    bool mkdir(const char *path);
+    bool remove(const char *path);
+    // Simulator hook: host directory seen as "/" (default: $TIMONEL_FS_ROOT or "data")
+    void SetRoot(const char *root) { root_ = root; }
+    const char *GetRoot(void) const { return root_.c_str(); }
+
+   protected:
+    std::string root_;
+    bool mounted_ = false;
+};
+
+}  // namespace fs
+
+using fs::File;
+
+#endif  // TIMONEL_SIM_FS_H
@@ -0,0 +1,30 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: LittleFS.h (Header)
+  ............................................................................
+  Arduino ESP32 LittleFS replacement: begin() "mounts" a host directory.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_SIM_LITTLEFS_H
+#define TIMONEL_SIM_LITTLEFS_H
+
+#include "FS.h"
+
+namespace fs {
+
+class LittleFSFS : public FS {
+   public:
+    bool begin(bool format_on_fail = false, const char *base_path = "/littlefs", uint8_t max_open_files = 10,
+               const char *partition_label = "spiffs");
+    void end(void) { mounted_ = false; }
+};
+
+}  // namespace fs
+
+extern fs::LittleFSFS LittleFS;
+
+#endif  // TIMONEL_SIM_LITTLEFS_H
@@ -0,0 +1,67 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: NbMicro.cpp (Stand-in library)
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "NbMicro.h"
+
+// Class constructor
+NbMicro::NbMicro(uint8_t twi_address, uint8_t sda, uint8_t scl) : addr_(twi_address), sda_(sda), scl_(scl) {
+    Wire.begin(sda_, scl_);
+}
+
+// Class destructor
+NbMicro::~NbMicro() {
+}
+
+// Get the TWI address of this device
+uint8_t NbMicro::GetTwiAddress(void) {
+    return addr_;
+}
+
+// Set the TWI address of this device
+uint8_t NbMicro::SetTwiAddress(uint8_t twi_address) {
+    if ((twi_address < LOW_TWI_ADDR) || (twi_address > HIG_TWI_ADDR)) {
+        return ERR_03;
+    }
+    addr_ = twi_address;
+    return 0;
+}
+
+// Send a single-byte command and check its reply
+uint8_t NbMicro::TwiCmdXmit(uint8_t twi_cmd, uint8_t twi_reply, uint8_t twi_reply_arr[], uint8_t reply_size) {
+    const uint8_t cmd_size = 1;
+    uint8_t twi_cmd_arr[cmd_size] = {twi_cmd};
+    return TwiCmdXmit(twi_cmd_arr, cmd_size, twi_reply, twi_reply_arr, reply_size);
+}
+
+// Send a multi-byte command and check its reply
+uint8_t NbMicro::TwiCmdXmit(uint8_t twi_cmd_arr[], uint8_t cmd_size, uint8_t twi_reply, uint8_t twi_reply_arr[], uint8_t reply_size) {
+    Wire.beginTransmission(addr_);
+    Wire.write(twi_cmd_arr, cmd_size);
+    if (Wire.endTransmission() != 0) {
+        return ERR_01;
+    }
+    if (reply_size == 0) {
+        if (Wire.requestFrom(addr_, (uint8_t)1) != 1) {
+            return ERR_01;
+        }
+        return (Wire.read() == twi_reply) ? 0 : ERR_02;
+    }
+    if (Wire.requestFrom(addr_, reply_size) != reply_size) {
+        return ERR_01;
+    }
+    for (uint8_t i = 0; i < reply_size; i++) {
+        twi_reply_arr[i] = Wire.read();
+    }
+    return (twi_reply_arr[0] == twi_reply) ? 0 : ERR_02;
+}
+
+// Initialize the device firmware
+uint8_t NbMicro::InitMicro(void) {
+    return TwiCmdXmit(INITSOFT, AKINITS);
+}
@@ -0,0 +1,42 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: NbMicro.h (Header)
+  ............................................................................
+  NbMicro stand-in: generic NB TWI device, sends commands and checks
+  replies through Wire.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef NBMICRO_H
+#define NBMICRO_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "libconfig.h"
+#include "nb-twi-cmd.h"
+
+// Error codes
+#define ERR_01 1  // TWI transmission error
+#define ERR_02 2  // Command reply mismatch
+#define ERR_03 3  // Invalid TWI address
+#define ERR_04 4  // Checksum error
+
+class NbMicro {
+   public:
+    NbMicro(uint8_t twi_address = 0, uint8_t sda = 0, uint8_t scl = 0);
+    ~NbMicro();
+    uint8_t GetTwiAddress(void);
+    uint8_t SetTwiAddress(uint8_t twi_address);
+    uint8_t TwiCmdXmit(uint8_t twi_cmd, uint8_t twi_reply, uint8_t twi_reply_arr[] = nullptr, uint8_t reply_size = 0);
+    uint8_t TwiCmdXmit(uint8_t twi_cmd_arr[], uint8_t cmd_size, uint8_t twi_reply, uint8_t twi_reply_arr[] = nullptr, uint8_t reply_size = 0);
+    uint8_t InitMicro(void);
+
+   protected:
+    uint8_t addr_ = 0, sda_ = 0, scl_ = 0;
+};
+
+#endif  // NBMICRO_H
@@ -0,0 +1,194 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: Preferences.cpp (Stand-in library)
+  ............................................................................
+  File-backed NVS namespaces (see Preferences.h). A namespace file holds
+  its entries one after the other: key length, key, value length (16-bit
+  LE), value.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "Preferences.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+char Preferences::root_[PATH_MAX] = "";
+uint32_t Preferences::calls_ = 0;
+
+// Class Preferences: Host directory of the namespace files
+void Preferences::SetRoot(const char *root) {
+    snprintf(root_, sizeof(root_), "%s", root);
+}
+
+// Class Preferences: Open a namespace, loading what was committed to it
+bool Preferences::begin(const char *name, bool read_only, const char *partition_label) {
+    (void)partition_label;
+    calls_++;
+    if ((name == nullptr) || (name[0] == '\0') || (strlen(name) > SIM_NVS_KEY_SIZE)) {
+        return false;
+    }
+    if (root_[0] == '\0') {
+        const char *root = getenv("TIMONEL_NVS_ROOT");
+        SetRoot((root != nullptr) ? root : ".pio/nvs");
+    }
+    // Like "mkdir -p"
+    char dir[PATH_MAX];
+    snprintf(dir, sizeof(dir), "%s", root_);
+    for (char *slash = strchr(dir + 1, '/'); slash != nullptr; slash = strchr(slash + 1, '/')) {
+        *slash = '\0';
+        mkdir(dir, 0755);
+        *slash = '/';
+    }
+    mkdir(root_, 0755);
+    snprintf(path_, sizeof(path_), "%s/%s.nvs", root_, name);
+    read_only_ = read_only;
+    Clear();
+    FILE *file = fopen(path_, "rb");
+    if (file != nullptr) {
+        int key_size = 0;
+        uint8_t ix = 0;
+        while ((ix < SIM_NVS_ENTRIES) && ((key_size = fgetc(file)) != EOF)) {
+            Entry &entry = entries_[ix];
+            uint8_t size_le[2];
+            if ((key_size == 0) || (key_size > SIM_NVS_KEY_SIZE) || (fread(entry.key, 1, key_size, file) != (size_t)key_size) ||
+                (fread(size_le, 1, 2, file) != 2)) {
+                entry.key[0] = '\0';
+                break;
+            }
+            entry.key[key_size] = '\0';
+            entry.size = size_le[0] | (size_le[1] << 8);
+            if ((entry.size > SIM_NVS_VALUE_SIZE) || (fread(entry.value, 1, entry.size, file) != entry.size)) {
+                entry.key[0] = '\0';
+                break;
+            }
+            ix++;
+        }
+        fclose(file);
+    }
+    started_ = true;
+    return true;
+}
+
+// Class Preferences: Close the namespace
+void Preferences::end(void) {
+    started_ = false;
+    Clear();
+}
+
+// Class Preferences: Remove every key of the namespace
+bool Preferences::clear(void) {
+    calls_++;
+    if (!started_ || read_only_) {
+        return false;
+    }
+    Clear();
+    return Commit();
+}
+
+// Class Preferences: Remove a key
+bool Preferences::remove(const char *key) {
+    calls_++;
+    Entry *entry = Find(key);
+    if (!started_ || read_only_ || (entry == nullptr)) {
+        return false;
+    }
+    entry->key[0] = '\0';
+    return Commit();
+}
+
+// Class Preferences: True if the key holds a value
+bool Preferences::isKey(const char *key) {
+    calls_++;
+    return started_ && (Find(key) != nullptr);
+}
+
+// Class Preferences: Store a byte blob, returns its length (0 on failure)
+size_t Preferences::putBytes(const char *key, const void *value, size_t len) {
+    calls_++;
+    if (!started_ || read_only_ || (key == nullptr) || (key[0] == '\0') || (strlen(key) > SIM_NVS_KEY_SIZE) ||
+        (len > SIM_NVS_VALUE_SIZE)) {
+        return 0;
+    }
+    Entry *entry = Find(key);
+    for (uint8_t ix = 0; (ix < SIM_NVS_ENTRIES) && (entry == nullptr); ix++) {
+        if (entries_[ix].key[0] == '\0') {
+            entry = &entries_[ix];
+            snprintf(entry->key, sizeof(entry->key), "%s", key);
+        }
+    }
+    if (entry == nullptr) {
+        return 0; /* Namespace full */
+    }
+    memcpy(entry->value, value, len);
+    entry->size = (uint16_t)len;
+    return Commit() ? len : 0;
+}
+
+// Class Preferences: Length of a stored blob, 0 if the key doesn't exist
+size_t Preferences::getBytesLength(const char *key) {
+    calls_++;
+    Entry *entry = Find(key);
+    return (started_ && (entry != nullptr)) ? entry->size : 0;
+}
+
+// Class Preferences: Copy a stored blob, returns its length (0 if missing or larger than the buffer)
+size_t Preferences::getBytes(const char *key, void *buf, size_t max_len) {
+    calls_++;
+    Entry *entry = Find(key);
+    if (!started_ || (entry == nullptr) || (entry->size == 0) || (entry->size > max_len)) {
+        return 0;
+    }
+    memcpy(buf, entry->value, entry->size);
+    return entry->size;
+}
+
+// Class Preferences: Entry holding a key, nullptr if there is none
+Preferences::Entry *Preferences::Find(const char *key) {
+    for (uint8_t ix = 0; (key != nullptr) && (key[0] != '\0') && (ix < SIM_NVS_ENTRIES); ix++) {
+        if (strncmp(entries_[ix].key, key, sizeof(entries_[ix].key)) == 0) {
+            return &entries_[ix];
+        }
+    }
+    return nullptr;
+}
+
+// Class Preferences: Drop every entry from memory
+void Preferences::Clear(void) {
+    for (uint8_t ix = 0; ix < SIM_NVS_ENTRIES; ix++) {
+        entries_[ix].key[0] = '\0';
+        entries_[ix].size = 0;
+    }
+}
+
+// Class Preferences: Rewrite the namespace file, then swap it in, so a crash leaves the old or the new one
+bool Preferences::Commit(void) {
+    char temp_path[sizeof(path_) + 4];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path_);
+    FILE *file = fopen(temp_path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = true;
+    for (uint8_t ix = 0; ix < SIM_NVS_ENTRIES; ix++) {
+        const Entry &entry = entries_[ix];
+        if (entry.key[0] == '\0') {
+            continue;
+        }
+        uint8_t header[SIM_NVS_KEY_SIZE + 3];
+        size_t key_size = strlen(entry.key);
+        header[0] = (uint8_t)key_size;
+        memcpy(&header[1], entry.key, key_size);
+        header[key_size + 1] = (uint8_t)(entry.size & 0xFF);
+        header[key_size + 2] = (uint8_t)(entry.size >> 8);
+        ok &= (fwrite(header, 1, key_size + 3, file) == (key_size + 3));
+        ok &= (fwrite(entry.value, 1, entry.size, file) == entry.size);
+    }
+    ok &= (fclose(file) == 0);
+    return ok && (rename(temp_path, path_) == 0);
+}
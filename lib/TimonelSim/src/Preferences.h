@@ -0,0 +1,66 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: Preferences.h (Header)
+  ............................................................................
+  Arduino ESP32 "Preferences" (NVS) replacement backed by one host file
+  per namespace.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_SIM_PREFERENCES_H
+#define TIMONEL_SIM_PREFERENCES_H
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Arduino ESP32 "Preferences" (NVS key-value storage) replacement backed
+// by one host file per namespace, in $TIMONEL_NVS_ROOT or ".pio/nvs". Like
+// NVS, every put or remove is committed before it returns, so what was
+// stored survives a restart of the program (a power cycle of the master).
+// Only the byte blob calls are there. The entries live in a fixed table
+// inside the object. This says nothing about the memory the ESP32 NVS
+// library uses: nvs_open and the blob calls allocate there, so the heap
+// figures of bench-soak leave NVS out and count its calls instead
+// (GetCalls).
+
+#define SIM_NVS_KEY_SIZE 15     // NVS key length limit
+#define SIM_NVS_ENTRIES 32      // Keys per namespace
+#define SIM_NVS_VALUE_SIZE 256  // Largest blob stored (bytes)
+
+class Preferences {
+   public:
+    bool begin(const char *name, bool read_only = false, const char *partition_label = nullptr);
+    void end(void);
+    bool clear(void);
+    bool remove(const char *key);
+    bool isKey(const char *key);
+    size_t putBytes(const char *key, const void *value, size_t len);
+    size_t getBytesLength(const char *key);
+    size_t getBytes(const char *key, void *buf, size_t max_len);
+    // Simulator hook: host directory of the namespace files (default: $TIMONEL_NVS_ROOT or ".pio/nvs")
+    static void SetRoot(const char *root);
+    // Simulator hook: calls that reach NVS storage (begin, clear, remove, isKey, putBytes, getBytesLength, getBytes)
+    static uint32_t GetCalls(void) { return calls_; }
+
+   private:
+    struct Entry {
+        char key[SIM_NVS_KEY_SIZE + 1];  /* Empty: free */
+        uint16_t size;
+        uint8_t value[SIM_NVS_VALUE_SIZE];
+    };
+    static char root_[PATH_MAX];
+    static uint32_t calls_;
+    char path_[PATH_MAX + SIM_NVS_KEY_SIZE + 6] = ""; /* root_, "/", namespace, ".nvs" */
+    bool started_ = false;
+    bool read_only_ = false;
+    Entry entries_[SIM_NVS_ENTRIES] = {};
+    Entry *Find(const char *key);
+    void Clear(void);
+    bool Commit(void);
+};
+
+#endif  // TIMONEL_SIM_PREFERENCES_H
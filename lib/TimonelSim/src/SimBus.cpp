@@ -0,0 +1,167 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: SimBus.cpp (Stand-in library)
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "SimBus.h"
+
+#include "SimClock.h"
+
+// Class SimBus: Return one of the simulated buses (one per ESP32 I2C controller)
+SimBus *SimBus::Get(const uint8_t bus_num) {
+    static SimBus buses[SIM_MAX_BUSES];
+    return &buses[bus_num % SIM_MAX_BUSES];
+}
+
+// Class SimBus: Connect a slave to the bus
+void SimBus::Attach(SimSlave *slave) {
+    for (uint8_t i = 0; i < SIM_MAX_SLAVES; i++) {
+        if (slaves_[i] == nullptr) {
+            slaves_[i] = slave;
+            return;
+        }
+    }
+}
+
+// Class SimBus: Disconnect a slave from the bus
+void SimBus::Detach(SimSlave *slave) {
+    for (uint8_t i = 0; i < SIM_MAX_SLAVES; i++) {
+        if (slaves_[i] == slave) {
+            slaves_[i] = nullptr;
+        }
+    }
+}
+
+// Class SimBus: Set the SCL frequency
+void SimBus::SetClock(const uint32_t frequency) {
+    if (frequency != 0) {
+        frequency_ = frequency;
+    }
+}
+
+// Class SimBus: Master-to-slave transfer
+uint8_t SimBus::Write(const uint8_t twi_address, const uint8_t *data, const size_t size) {
+    if (twi_address == SIM_GENERAL_CALL) {
+        return GeneralCall(data, size);
+    }
+    stats_.transactions++;
+    SimSlave *slave = Select(twi_address);
+    int32_t damaged = (slave != nullptr) ? Damage(size + 1) : -1;
+    if ((slave == nullptr) || (damaged == 0)) {
+        Clock(0);
+        stats_.nacks++;
+        return 2;
+    }
+    Clock(size);
+    if (damaged > 0) {
+        stats_.nacks++;
+        return 3; /* Data NACK, the slave lost a bit */
+    }
+    slave->Receive(twi_address, data, size);
+    stats_.writes++;
+    stats_.bytes_tx += size;
+    return 0;
+}
+
+// Class SimBus: Master-to-every-listener transfer, ACKed if anyone takes the general call
+uint8_t SimBus::GeneralCall(const uint8_t *data, const size_t size) {
+    SimSlave *listeners[SIM_MAX_SLAVES];
+    uint8_t count = 0;
+    uint64_t busy_until = SimClock::Now();
+    stats_.transactions++;
+    for (uint8_t i = 0; i < SIM_MAX_SLAVES; i++) {
+        if ((slaves_[i] != nullptr) && slaves_[i]->Acknowledges(SIM_GENERAL_CALL)) {
+            listeners[count++] = slaves_[i];
+            busy_until = (slaves_[i]->BusyUntil() > busy_until) ? slaves_[i]->BusyUntil() : busy_until;
+        }
+    }
+    if (count == 0) {
+        Clock(0);
+        stats_.nacks++;
+        return 2;
+    }
+    stats_.stretch_us += busy_until - SimClock::Now();
+    SimClock::AdvanceTo(busy_until);
+    Clock(size);
+    if (Damage(size + 1) >= 0) {
+        stats_.nacks++;
+        return 3;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        listeners[i]->Receive(SIM_GENERAL_CALL, data, size);
+    }
+    stats_.writes++;
+    stats_.bytes_tx += size;
+    return 0;
+}
+
+// Class SimBus: Slave-to-master transfer (there are no general call reads)
+size_t SimBus::Read(const uint8_t twi_address, uint8_t *data, const size_t size) {
+    stats_.transactions++;
+    SimSlave *slave = (twi_address != SIM_GENERAL_CALL) ? Select(twi_address) : nullptr;
+    int32_t damaged = (slave != nullptr) ? Damage(size + 1) : -1;
+    if ((slave == nullptr) || (damaged == 0)) {
+        Clock(0);
+        stats_.nacks++;
+        return 0;
+    }
+    Clock(size);
+    size_t supplied = slave->Transmit(twi_address, data, size);
+    for (size_t i = supplied; i < size; i++) {
+        data[i] = 0xFF; /* Released SDA reads as ones */
+    }
+    if (damaged > 0) {
+        data[damaged - 1] ^= (uint8_t)(1 << (noise_ & 7)); /* The master samples a wrong bit */
+    }
+    stats_.reads++;
+    stats_.bytes_rx += size;
+    return size;
+}
+
+// Class SimBus: Find the slave answering an address, waiting out clock stretching
+SimSlave *SimBus::Select(const uint8_t twi_address) {
+    for (uint8_t i = 0; i < SIM_MAX_SLAVES; i++) {
+        if ((slaves_[i] != nullptr) && slaves_[i]->Acknowledges(twi_address)) {
+            uint64_t busy_until = slaves_[i]->BusyUntil();
+            if (busy_until > SimClock::Now()) {
+                stats_.stretch_us += busy_until - SimClock::Now();
+                SimClock::AdvanceTo(busy_until);
+            }
+            return slaves_[i];
+        }
+    }
+    return nullptr;
+}
+
+// Class SimBus: Charge the bus time of a transfer to the virtual clock
+void SimBus::Clock(const size_t size) {
+    // Start + address byte + data bytes (8 bits + ACK each) + stop
+    uint64_t bits = 1 + ((size + 1) * 9) + 1;
+    uint64_t us = ((bits * 1000000ULL) + frequency_ - 1) / frequency_;
+    stats_.bus_us += us;
+    SimClock::Advance(us);
+}
+
+// Class SimBus: First damaged byte of a transfer of "size" bytes (address byte = 0), -1 if none.
+// Past the reliable clock, each byte is hit with a probability growing with the excess rate.
+int32_t SimBus::Damage(const size_t size) {
+    if ((reliable_clock_ == 0) || (frequency_ <= reliable_clock_)) {
+        return -1;
+    }
+    uint64_t odds = ((uint64_t)(frequency_ - reliable_clock_) << 32) / ((uint64_t)reliable_clock_ * SIM_FAULT_SCALE);
+    uint32_t threshold = (odds > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)odds;
+    for (size_t i = 0; i < size; i++) {
+        noise_ ^= noise_ << 13; /* xorshift32 */
+        noise_ ^= noise_ >> 17;
+        noise_ ^= noise_ << 5;
+        if (noise_ < threshold) {
+            stats_.faults++;
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,90 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: SimBus.h (Header)
+  ............................................................................
+  Simulated I2C bus, timed from the SCL frequency on the virtual clock.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_SIM_BUS_H
+#define TIMONEL_SIM_BUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Simulated I2C bus. Every transfer is timed from the SCL frequency (nine
+// clocks per byte plus start, address and stop) and charged to the virtual
+// clock. A slave that is busy (e.g. a Tiny85 doing SPM page erase/write)
+// stretches the clock until it is ready again. A write to the general
+// call address reaches every slave that takes it, and is stretched until
+// the slowest of them is ready. The bus also keeps the transaction
+// counters used by the native benchmarks.
+// SetReliableClock() models the wiring of a fixture: above that SCL rate
+// each byte may be damaged, more often the faster the clock. A slave that
+// misses a bit of a write falls out of step and NAKs it (the command is
+// not taken), a damaged read reaches the master with a bit flipped. The
+// damage is pseudo-random but repeatable from run to run.
+
+#define SIM_MAX_BUSES 2
+#define SIM_MAX_SLAVES 16
+#define SIM_DEFAULT_CLOCK 100000
+#define SIM_GENERAL_CALL 0x00
+#define SIM_FAULT_SCALE 64  // A byte is damaged with (clock - reliable) / reliable / this probability
+
+// Simulated I2C slave device
+class SimSlave {
+   public:
+    virtual ~SimSlave() {}
+    // True if the slave ACKs this address right now
+    virtual bool Acknowledges(const uint8_t twi_address) = 0;
+    // Virtual time until which the slave holds SCL low
+    virtual uint64_t BusyUntil(void) = 0;
+    // Master-to-slave data (one complete write transaction)
+    virtual void Receive(const uint8_t twi_address, const uint8_t *data, const size_t size) = 0;
+    // Slave-to-master data (one complete read transaction), returns bytes supplied
+    virtual size_t Transmit(const uint8_t twi_address, uint8_t *data, const size_t size) = 0;
+};
+
+// Simulated I2C bus
+class SimBus {
+   public:
+    struct Stats {
+        uint32_t transactions = 0; /* Addressed transfers (probes included) */
+        uint32_t writes = 0;       /* Master-to-slave transfers */
+        uint32_t reads = 0;        /* Slave-to-master transfers */
+        uint32_t nacks = 0;        /* Transfers not acknowledged */
+        uint32_t bytes_tx = 0;     /* Payload bytes master-to-slave */
+        uint32_t bytes_rx = 0;     /* Payload bytes slave-to-master */
+        uint64_t bus_us = 0;       /* Time SCL was toggling */
+        uint64_t stretch_us = 0;   /* Time spent waiting on busy slaves */
+        uint32_t faults = 0;       /* Transfers damaged by a clock above the reliable rate */
+    };
+    static SimBus *Get(const uint8_t bus_num = 0);
+    void Attach(SimSlave *slave);
+    void Detach(SimSlave *slave);
+    void SetClock(const uint32_t frequency);
+    uint32_t GetClock(void) const { return frequency_; }
+    void SetReliableClock(const uint32_t frequency) { reliable_clock_ = frequency; } /* 0 = reliable at any rate */
+    // Returns 0 on success, 2 on address NACK (same codes as TwoWire::endTransmission)
+    uint8_t Write(const uint8_t twi_address, const uint8_t *data, const size_t size);
+    // Returns the amount of bytes read, 0 on address NACK
+    size_t Read(const uint8_t twi_address, uint8_t *data, const size_t size);
+    const Stats &GetStats(void) const { return stats_; }
+    void ResetStats(void) { stats_ = Stats(); }
+
+   private:
+    SimSlave *slaves_[SIM_MAX_SLAVES] = {nullptr};
+    uint32_t frequency_ = SIM_DEFAULT_CLOCK;
+    uint32_t reliable_clock_ = 0;
+    uint32_t noise_ = 0x2545F491;
+    Stats stats_;
+    SimSlave *Select(const uint8_t twi_address);
+    uint8_t GeneralCall(const uint8_t *data, const size_t size);
+    void Clock(const size_t size);
+    int32_t Damage(const size_t size);
+};
+
+#endif  // TIMONEL_SIM_BUS_H
@@ -0,0 +1,37 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: SimClock.h (Header)
+  ............................................................................
+  Virtual microsecond clock, one timeline per thread.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_SIM_CLOCK_H
+#define TIMONEL_SIM_CLOCK_H
+
+#include <stdint.h>
+
+// Virtual microsecond clock shared by the Arduino core stand-in, the
+// simulated I2C bus and the Tiny85 emulator. Each thread owns its own
+// timeline, so independent workers (e.g. one per bus) can be simulated
+// in parallel and the makespan taken as the latest timeline.
+
+class SimClock {
+   public:
+    static uint64_t Now(void) { return now_us_; }
+    static void Advance(uint64_t us) { now_us_ += us; }
+    static void AdvanceTo(uint64_t us) {
+        if (us > now_us_) {
+            now_us_ = us;
+        }
+    }
+    static void Set(uint64_t us) { now_us_ = us; }
+
+   private:
+    static thread_local uint64_t now_us_;
+};
+
+#endif  // TIMONEL_SIM_CLOCK_H
@@ -0,0 +1,370 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: TimonelSlave.cpp (Stand-in library)
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "TimonelSlave.h"
+
+#include <string.h>
+
+#include "SimClock.h"
+
+// Class constructor: blank application area, bootloader image, blank EEPROM
+TimonelSlave::TimonelSlave(const uint8_t boot_addr, const uint8_t app_addr, const uint16_t bootloader_start)
+    : boot_addr_(boot_addr), app_addr_(app_addr), bootloader_start_(bootloader_start) {
+    memset(flash_, 0xFF, sizeof(flash_));
+    memset(eeprom_, 0xFF, sizeof(eeprom_));
+    memset(page_buffer_, 0xFF, sizeof(page_buffer_));
+    uint32_t lfsr = 0xACE1u;
+    for (uint16_t addr = bootloader_start_; addr < MCU_TOTAL_MEM; addr++) {
+        lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+        flash_[addr] = (uint8_t)lfsr;
+    }
+}
+
+// Class TimonelSlave: Current running mode
+TimonelSlave::Mode TimonelSlave::GetMode(void) {
+    Update();
+    return mode_;
+}
+
+// Class TimonelSlave: Power-on reset, comes back in bootloader mode
+void TimonelSlave::PowerCycle(void) {
+    Restart(BOOTLOADER, timing_.reset_us);
+    restart_pending_ = false;
+    off_at_ = 0;
+    mode_ = OFF;
+}
+
+// Class TimonelSlave: Remove the device from the bus until the next power cycle
+void TimonelSlave::Unplug(void) {
+    restart_pending_ = false;
+    off_at_ = 0;
+    mode_ = OFF;
+    next_mode_ = OFF;
+}
+
+// Class TimonelSlave: ACK only the address of the firmware currently running (and the general call if enabled)
+bool TimonelSlave::Acknowledges(const uint8_t twi_address) {
+    Update();
+    return ((mode_ == BOOTLOADER) && ((twi_address == boot_addr_) || (general_call_ && (twi_address == SIM_GENERAL_CALL)))) ||
+           ((mode_ == APPLICATION) && (twi_address == app_addr_));
+}
+
+// Class TimonelSlave: SCL is held low while the CPU is halted by SPM or EEPROM writes
+uint64_t TimonelSlave::BusyUntil(void) {
+    return busy_until_;
+}
+
+// Class TimonelSlave: Decode one command
+void TimonelSlave::Receive(const uint8_t twi_address, const uint8_t *data, const size_t size) {
+    (void)twi_address;
+    reply_size_ = 0;
+    if (size == 0) {
+        return; /* Address probe */
+    }
+    if ((ignore_in_ != 0) && (--ignore_in_ == 0)) {
+        return;
+    }
+    counters_.commands++;
+    busy_until_ = SimClock::Now() + timing_.command_us;
+    if (mode_ == BOOTLOADER) {
+        BootloaderCommand(data, size);
+    } else {
+        ApplicationCommand(data, size);
+    }
+    if (twi_address == SIM_GENERAL_CALL) {
+        // Nobody reads a general call reply: a pending restart goes ahead at once
+        reply_size_ = 0;
+        if (restart_pending_) {
+            restart_pending_ = false;
+            mode_ = OFF;
+        }
+    }
+}
+
+// Class TimonelSlave: Send the reply prepared for the last command
+size_t TimonelSlave::Transmit(const uint8_t twi_address, uint8_t *data, const size_t size) {
+    (void)twi_address;
+    size_t supplied = (size < reply_size_) ? size : reply_size_;
+    memcpy(data, reply_, supplied);
+    if (restart_pending_) {
+        restart_pending_ = false; /* The reply is out, now the device goes away */
+        if (linger_us_ != 0) {
+            off_at_ = SimClock::Now() + linger_us_;
+            mode_change_at_ += linger_us_;
+        } else {
+            mode_ = OFF;
+        }
+    }
+    return supplied;
+}
+
+// Class TimonelSlave: Apply a pending mode change once its time has come
+void TimonelSlave::Update(void) {
+    if ((off_at_ != 0) && (SimClock::Now() >= off_at_)) {
+        off_at_ = 0;
+        mode_ = OFF;
+    }
+    if (!restart_pending_ && (next_mode_ != mode_) && (SimClock::Now() >= mode_change_at_)) {
+        mode_ = next_mode_;
+        page_addr_ = 0;
+        page_ix_ = 0;
+    }
+}
+
+// Class TimonelSlave: Drop off the bus once the reply is read, come back in another mode later
+void TimonelSlave::Restart(const Mode next_mode, const uint64_t after_us, const uint32_t linger_us) {
+    counters_.resets++;
+    restart_pending_ = true;
+    linger_us_ = linger_us;
+    next_mode_ = next_mode;
+    mode_change_at_ = ((busy_until_ > SimClock::Now()) ? busy_until_ : SimClock::Now()) + after_us;
+}
+
+// Class TimonelSlave: An application is installed when the trampoline is set
+bool TimonelSlave::HasApplication(void) const {
+    return (flash_[bootloader_start_ - 2] != 0xFF) || (flash_[bootloader_start_ - 1] != 0xFF);
+}
+
+// Class TimonelSlave: Timonel bootloader command set
+void TimonelSlave::BootloaderCommand(const uint8_t *data, const size_t size) {
+    switch (data[0]) {
+        case GETTMNLV: {
+            Reply(AKTMNLV);
+            reply_[reply_size_++] = T_SIGNATURE;
+            reply_[reply_size_++] = 1; /* Version major */
+            reply_[reply_size_++] = 5; /* Version minor */
+            reply_[reply_size_++] = features_code_;
+            reply_[reply_size_++] = ext_features_code_;
+            reply_[reply_size_++] = (uint8_t)(bootloader_start_ >> 8);
+            reply_[reply_size_++] = (uint8_t)(bootloader_start_ & 0xFF);
+            reply_[reply_size_++] = flash_[bootloader_start_ - 2]; /* Trampoline */
+            reply_[reply_size_++] = flash_[bootloader_start_ - 1];
+            reply_[reply_size_++] = 0xE1; /* Low fuse */
+            reply_[reply_size_++] = 0x8C; /* OSCCAL */
+            break;
+        }
+        case INITSOFT: {
+            Reply(AKINITS);
+            break;
+        }
+        case STPGADDR: {
+            if ((size < 4) || ((uint8_t)(data[1] + data[2]) != data[3])) {
+                Reply(UNKNOWNC);
+                break;
+            }
+            page_addr_ = ((data[1] << 8) | data[2]) & ~(SPM_PAGESIZE - 1);
+            page_ix_ = 0;
+            Reply(AKPGADDR);
+            reply_[reply_size_++] = data[3];
+            break;
+        }
+        case WRITPAGE: {
+            uint8_t checksum = 0;
+            for (size_t i = 1; i < size - 1; i++) {
+                checksum += data[i];
+            }
+            if ((size != (size_t)(tx_packet_ + 2)) || (checksum != data[size - 1]) || ((page_ix_ + tx_packet_) > SPM_PAGESIZE)) {
+                Reply(UNKNOWNC);
+                break;
+            }
+            memcpy(&page_buffer_[page_ix_], &data[1], tx_packet_);
+            page_ix_ += tx_packet_;
+            Reply(AKWTPAGE);
+            reply_[reply_size_++] = checksum;
+            if (page_ix_ >= SPM_PAGESIZE) {
+                CommitPage();
+            }
+            break;
+        }
+        case READFLSH: {
+            if ((size < 5) || ((uint8_t)(data[1] + data[2] + data[3]) != data[4]) || (data[3] > rx_packet_)) {
+                Reply(UNKNOWNC);
+                break;
+            }
+            uint16_t addr = (data[1] << 8) | data[2];
+            uint8_t checksum = 0;
+            Reply(ACKRDFSH);
+            for (uint8_t i = 0; i < data[3]; i++) {
+                uint8_t value = flash_[(addr + i) % MCU_TOTAL_MEM];
+                reply_[reply_size_++] = value;
+                checksum += value;
+            }
+            reply_[reply_size_++] = checksum;
+            break;
+        }
+        case READEEPR: {
+            uint16_t addr = ((data[1] << 8) | data[2]) % SIM_EEPROM_SIZE;
+            Reply(ACKRDEEP);
+            reply_[reply_size_++] = eeprom_[addr];
+            break;
+        }
+        case WRITEEPR: {
+            uint16_t addr = ((data[1] << 8) | data[2]) % SIM_EEPROM_SIZE;
+            eeprom_[addr] = data[3];
+            counters_.eeprom_writes++;
+            busy_until_ += timing_.eeprom_write_us;
+            Reply(ACKWTEEP);
+            break;
+        }
+        case READEEBK: {
+            if ((((ext_features_code_ >> E_EEPROM_BLOCKS) & true) == false) || (size < 5) ||
+                ((uint8_t)(data[1] + data[2] + data[3]) != data[4]) || (data[3] > rx_packet_)) {
+                Reply(UNKNOWNC);
+                break;
+            }
+            uint16_t addr = (data[1] << 8) | data[2];
+            uint8_t checksum = 0;
+            Reply(ACKRDEBK);
+            for (uint8_t i = 0; i < data[3]; i++) {
+                uint8_t value = eeprom_[(addr + i) % SIM_EEPROM_SIZE];
+                reply_[reply_size_++] = value;
+                checksum += value;
+            }
+            reply_[reply_size_++] = checksum;
+            break;
+        }
+        case WRITEEBK: {
+            if ((((ext_features_code_ >> E_EEPROM_BLOCKS) & true) == false) || (size < 5) || (size != (size_t)(data[3] + 5)) ||
+                (data[3] > tx_packet_)) {
+                Reply(UNKNOWNC);
+                break;
+            }
+            uint16_t addr = (data[1] << 8) | data[2];
+            uint8_t checksum = 0;
+            for (uint8_t i = 0; i < data[3]; i++) {
+                checksum += data[4 + i];
+            }
+            if (checksum != data[4 + data[3]]) {
+                Reply(UNKNOWNC);
+                break;
+            }
+            for (uint8_t i = 0; i < data[3]; i++) {
+                eeprom_[(addr + i) % SIM_EEPROM_SIZE] = data[4 + i];
+            }
+            counters_.eeprom_writes += data[3];
+            busy_until_ += (uint64_t)timing_.eeprom_write_us * data[3];
+            Reply(ACKWTEBK);
+            reply_[reply_size_++] = checksum;
+            break;
+        }
+        case READDEVS: {
+            const uint8_t dev_settings[] = {0xE1, 0xDD, 0xFE, 0xFF, 0x1E, 0x93, 0x0B, 0x8C, 0x6F};
+            Reply(AKRDEVS);
+            memcpy(&reply_[reply_size_], dev_settings, sizeof(dev_settings));
+            reply_size_ += sizeof(dev_settings);
+            break;
+        }
+        case DELFLASH: {
+            Reply(AKDLFLSH);
+            uint16_t pages = bootloader_start_ / SPM_PAGESIZE;
+            memset(flash_, 0xFF, bootloader_start_);
+            counters_.page_erases += pages;
+            busy_until_ += (uint64_t)pages * timing_.page_erase_us;
+            Restart(BOOTLOADER, timing_.reset_us); /* Watchdog reset when done */
+            break;
+        }
+        case EXITTMNL: {
+            Reply(AKEXITTM);
+            if (HasApplication()) {
+                Restart(APPLICATION, timing_.app_start_us);
+            } else {
+                Restart(BOOTLOADER, timing_.reset_us);
+            }
+            break;
+        }
+        case RESETMCU: {
+            Reply(ACKRESET);
+            Restart(BOOTLOADER, timing_.reset_us);
+            break;
+        }
+        default: {
+            Reply(UNKNOWNC);
+            break;
+        }
+    }
+}
+
+// Class TimonelSlave: avr-blink-twis application command set
+void TimonelSlave::ApplicationCommand(const uint8_t *data, const size_t size) {
+    (void)size;
+    switch (data[0]) {
+        case SETIO1_1: {
+            Reply(ACKIO1_1);
+            break;
+        }
+        case SETIO1_0: {
+            Reply(ACKIO1_0);
+            break;
+        }
+        case RESETMCU: {
+            Reply(ACKRESET);
+            Restart(BOOTLOADER, timing_.reset_us, timing_.wdt_linger_us); /* The application waits for the watchdog */
+            break;
+        }
+        default: {
+            Reply(UNKNOWNC);
+            break;
+        }
+    }
+}
+
+// Class TimonelSlave: Flash a full page buffer, relocating the reset vector on page 0
+void TimonelSlave::CommitPage(void) {
+    if ((page_addr_ == 0) && ((features_code_ >> F_APP_USE_TPL_PG) & true)) {
+        // The application reset vector (rjmp) goes to the trampoline, the
+        // device reset vector is pointed at the bootloader instead. Done
+        // for any page 0, a blank one too: its 0xFFFF gets a trampoline.
+        uint16_t app_target = (((page_buffer_[1] << 8) | page_buffer_[0]) + 1) & 0xFFF;
+        uint16_t tpl_jump = (app_target - (bootloader_start_ >> 1)) & 0xFFF;
+        uint16_t boot_jump = ((bootloader_start_ >> 1) - 1) & 0xFFF;
+        uint8_t tpl_page[SPM_PAGESIZE];
+        memcpy(tpl_page, &flash_[bootloader_start_ - SPM_PAGESIZE], SPM_PAGESIZE);
+        tpl_page[SPM_PAGESIZE - 2] = (uint8_t)(tpl_jump & 0xFF);
+        tpl_page[SPM_PAGESIZE - 1] = (uint8_t)(0xC0 | (tpl_jump >> 8));
+        ProgramPage(bootloader_start_ - SPM_PAGESIZE, tpl_page, true);
+        page_buffer_[0] = (uint8_t)(boot_jump & 0xFF);
+        page_buffer_[1] = (uint8_t)(0xC0 | (boot_jump >> 8));
+    }
+    if (page_addr_ < bootloader_start_) {
+        ProgramPage(page_addr_, page_buffer_, (ext_features_code_ >> E_FORCE_ERASE_PG) & true);
+    }
+    memset(page_buffer_, 0xFF, sizeof(page_buffer_));
+    page_ix_ = 0;
+    page_addr_ += SPM_PAGESIZE;
+}
+
+// Class TimonelSlave: SPM page write, optionally erasing first, the CPU halts meanwhile.
+// Without an erase, SPM can only clear bits: the new data is ANDed with the old one.
+void TimonelSlave::ProgramPage(const uint16_t page_addr, const uint8_t *page_data, const bool erase) {
+    if (erase) {
+        memset(&flash_[page_addr], 0xFF, SPM_PAGESIZE);
+        counters_.page_erases++;
+        busy_until_ += timing_.page_erase_us;
+    }
+    for (uint8_t i = 0; i < SPM_PAGESIZE; i++) {
+        flash_[page_addr + i] &= page_data[i];
+    }
+    if (page_addr == weak_page_) {
+        // A worn cell: the first byte that should be programmed stays erased
+        for (uint8_t i = 0; i < SPM_PAGESIZE; i++) {
+            if (page_data[i] != 0xFF) {
+                flash_[page_addr + i] = 0xFF;
+                break;
+            }
+        }
+    }
+    counters_.page_writes++;
+    busy_until_ += timing_.page_write_us;
+}
+
+// Class TimonelSlave: Start a reply with its acknowledge code
+void TimonelSlave::Reply(const uint8_t reply_code) {
+    reply_[0] = reply_code;
+    reply_size_ = 1;
+}
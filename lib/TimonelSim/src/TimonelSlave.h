@@ -0,0 +1,131 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: TimonelSlave.h (Header)
+  ............................................................................
+  Tiny85 running the Timonel bootloader, emulated at the NB TWI command
+  level.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_SIM_SLAVE_H
+#define TIMONEL_SIM_SLAVE_H
+
+#include "SimBus.h"
+#include "libconfig.h"
+#include "nb-twi-cmd.h"
+
+// Tiny85 running the Timonel bootloader (and the avr-blink-twis demo app
+// once it is flashed), emulated at the NB TWI command level. It keeps a
+// full flash and EEPROM image, relocates the reset vector into the
+// trampoline page like Timonel does, and models the time the device is
+// busy (SPM page erase/write, EEPROM writes) or gone (resets, deletion).
+// Like the real bootloader, application pages are only erased before
+// being written when the slave is built with FORCE_ERASE_PG.
+// SetGeneralCall() models a bootloader build whose USI address match also
+// takes the general call (address 0) in bootloader mode: such commands are
+// decoded like addressed ones, but nobody reads their reply.
+// SetPackets() models a bootloader built with other packet sizes than the
+// master: WRITPAGE takes packets of exactly its master-to-slave size,
+// WRITEEBK up to it, and READFLSH and READEEBK send up to its
+// slave-to-master size. Both must divide the flash page.
+
+#define SIM_EEPROM_SIZE 512
+#define SIM_BOOT_ADDR 11
+#define SIM_APP_ADDR 44
+#define SIM_TIMONEL_START 0x1A40
+#define SIM_MAX_REPLY 66  // A whole page packet, its reply code and checksum
+
+class TimonelSlave : public SimSlave {
+   public:
+    enum Mode : uint8_t {
+        OFF,         /* Resetting, erasing or unplugged: no ACK */
+        BOOTLOADER,  /* Timonel answering at the bootloader address */
+        APPLICATION  /* User application answering at the application address */
+    };
+    struct Timing {
+        uint32_t command_us = 50;       /* Command decode and reply preparation */
+        uint32_t page_erase_us = 4500;  /* SPM page erase */
+        uint32_t page_write_us = 4500;  /* SPM page write */
+        uint32_t eeprom_write_us = 3400;
+        uint32_t reset_us = 68000;      /* Reset to bootloader ready (SUT 14CK + 64 ms) */
+        uint32_t app_start_us = 2000;   /* Bootloader exit to application ready */
+        uint32_t wdt_linger_us = 0;     /* Application RESETMCU: still answering until the watchdog fires */
+    };
+    struct Counters {
+        uint32_t commands = 0;
+        uint32_t page_erases = 0;
+        uint32_t page_writes = 0;
+        uint32_t eeprom_writes = 0;
+        uint32_t resets = 0;
+    };
+    TimonelSlave(const uint8_t boot_addr = SIM_BOOT_ADDR, const uint8_t app_addr = SIM_APP_ADDR,
+                 const uint16_t bootloader_start = SIM_TIMONEL_START);
+    Timing &GetTiming(void) { return timing_; }
+    const Counters &GetCounters(void) const { return counters_; }
+    void ResetCounters(void) { counters_ = Counters(); }
+    Mode GetMode(void);
+    uint8_t GetBootAddress(void) const { return boot_addr_; }
+    uint8_t GetAppAddress(void) const { return app_addr_; }
+    uint16_t GetBootloaderStart(void) const { return bootloader_start_; }
+    void SetFeatures(const uint8_t features_code, const uint8_t ext_features_code) {
+        features_code_ = features_code;
+        ext_features_code_ = ext_features_code;
+    }
+    const uint8_t *GetFlash(void) const { return flash_; }
+    uint8_t *GetFlash(void) { return flash_; } /* A board swapped or left half written */
+    uint8_t *GetEeprom(void) { return eeprom_; }
+    void SetPackets(const uint8_t tx_size, const uint8_t rx_size) {
+        tx_packet_ = (tx_size <= SPM_PAGESIZE) ? tx_size : SPM_PAGESIZE;
+        rx_packet_ = (rx_size <= SIM_MAX_REPLY - 2) ? rx_size : SIM_MAX_REPLY - 2;
+    }
+    void SetGeneralCall(const bool enabled) { general_call_ = enabled; }
+    void IgnoreCommand(const uint32_t nth) { ignore_in_ = nth; } /* The nth command from now is lost on the wire */
+    void WeakPage(const uint16_t page_addr) { weak_page_ = page_addr; } /* Writes to this page don't fully program */
+    void PowerCycle(void);
+    void Unplug(void);
+    // SimSlave
+    bool Acknowledges(const uint8_t twi_address);
+    uint64_t BusyUntil(void);
+    void Receive(const uint8_t twi_address, const uint8_t *data, const size_t size);
+    size_t Transmit(const uint8_t twi_address, uint8_t *data, const size_t size);
+
+   private:
+    uint8_t boot_addr_, app_addr_;
+    uint16_t bootloader_start_;
+    uint8_t features_code_ = FEATURES_CODE;
+    uint8_t ext_features_code_ = EXT_FEATURES;
+    uint8_t tx_packet_ = MST_PACKET_SIZE; /* Master-to-slave data bytes the bootloader takes */
+    uint8_t rx_packet_ = SLV_PACKET_SIZE; /* Slave-to-master data bytes it sends at most */
+    uint8_t flash_[MCU_TOTAL_MEM];
+    uint8_t eeprom_[SIM_EEPROM_SIZE];
+    uint8_t page_buffer_[SPM_PAGESIZE];
+    uint8_t page_ix_ = 0;
+    uint16_t page_addr_ = 0;
+    Mode mode_ = BOOTLOADER;
+    Mode next_mode_ = BOOTLOADER;
+    uint64_t mode_change_at_ = 0;
+    bool restart_pending_ = false;
+    uint32_t linger_us_ = 0;  /* The pending restart keeps the device answering this long */
+    uint64_t off_at_ = 0;     /* Lingering: goes off the bus then, 0 = not lingering */
+    bool general_call_ = false;
+    uint32_t ignore_in_ = 0;
+    uint16_t weak_page_ = 0xFFFF;
+    uint64_t busy_until_ = 0;
+    uint8_t reply_[SIM_MAX_REPLY];
+    uint8_t reply_size_ = 0;
+    Timing timing_;
+    Counters counters_;
+    void Update(void);
+    void Restart(const Mode next_mode, const uint64_t after_us, const uint32_t linger_us = 0);
+    bool HasApplication(void) const;
+    void BootloaderCommand(const uint8_t *data, const size_t size);
+    void ApplicationCommand(const uint8_t *data, const size_t size);
+    void CommitPage(void);
+    void ProgramPage(const uint16_t page_addr, const uint8_t *page_data, const bool erase);
+    void Reply(const uint8_t reply_code);
+};
+
+#endif  // TIMONEL_SIM_SLAVE_H
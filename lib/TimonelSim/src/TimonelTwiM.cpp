@@ -0,0 +1,221 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: TimonelTwiM.cpp (Stand-in library)
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "TimonelTwiM.h"
+
+// Class constructor
+Timonel::Timonel(const uint8_t twi_address, const uint8_t sda, const uint8_t scl) : NbMicro(twi_address, sda, scl) {
+    if ((addr_ >= LOW_TWI_ADDR) && (addr_ < APP_TWI_ADDR)) {
+        BootloaderInit();
+    }
+}
+
+// Class destructor
+Timonel::~Timonel() {
+}
+
+// Query the bootloader status and return it
+Timonel::Status Timonel::GetStatus(void) {
+    QueryStatus();
+    return status_;
+}
+
+// Upload a user application to the device flash memory
+uint8_t Timonel::UploadApplication(uint8_t payload[], uint16_t payload_size, const uint16_t start_address) {
+    uint8_t packet = 0;                            /* Bytes in the current data packet */
+    uint8_t packets_per_page = 0;                  /* Packets sent into the current page */
+    uint8_t twi_errors = 0;                        /* Upload error counter */
+    uint8_t data_packet[MST_PACKET_SIZE] = {0xFF}; /* Data packet to be sent to Timonel */
+    uint16_t app_limit = status_.bootloader_start;
+    if ((status_.features_code >> F_APP_USE_TPL_PG) & true) {
+        app_limit -= SPM_PAGESIZE; /* The trampoline page is reserved */
+    }
+    if ((uint32_t)start_address + payload_size > app_limit) {
+        return ERR_APP_OVF;
+    }
+    if ((status_.features_code >> F_CMD_SETPGADDR) & true) {
+        twi_errors += SetPageAddress(start_address);
+        delay(DLY_SET_ADDR);
+    }
+    // Pad the last page with 0xFF
+    uint16_t padded_size = ((payload_size + SPM_PAGESIZE - 1) / SPM_PAGESIZE) * SPM_PAGESIZE;
+    for (uint16_t i = 0; i < padded_size; i++) {
+        data_packet[packet++] = (i < payload_size) ? payload[i] : 0xFF;
+        if (packet == MST_PACKET_SIZE) {
+            twi_errors += WritePageBuff(data_packet);
+            packet = 0;
+            delay(DLY_PKT_SEND);
+            if (++packets_per_page == (SPM_PAGESIZE / MST_PACKET_SIZE)) {
+                packets_per_page = 0;
+                delay(DLY_FLASH_PG);
+            }
+        }
+        if (twi_errors > 0) {
+            return twi_errors;
+        }
+    }
+    return twi_errors;
+}
+
+// Exit the bootloader and run the user application
+uint8_t Timonel::RunApplication(void) {
+    return TwiCmdXmit(EXITTMNL, AKEXITTM);
+}
+
+// Delete the user application from the device flash memory
+uint8_t Timonel::DeleteApplication(void) {
+    uint8_t twi_errors = TwiCmdXmit(DELFLASH, AKDLFLSH);
+    if (twi_errors != 0) {
+        return twi_errors;
+    }
+    delay(DLY_DEL_APP);
+    return 0;
+}
+
+#if ((defined FEATURES_CODE) && ((FEATURES_CODE >> F_CMD_READFLASH) & true))
+// Print the device flash memory contents on the console
+uint8_t Timonel::DumpMemory(const uint16_t flash_size, const uint8_t rx_packet_size, const uint8_t values_per_line) {
+    const uint8_t cmd_size = 5;
+    uint8_t twi_cmd_arr[cmd_size] = {READFLSH, 0, 0, 0, 0};
+    uint8_t twi_reply_arr[rx_packet_size + 2];
+    uint8_t checksum_errors = 0;
+    uint8_t line_values = 0;
+    Serial.printf_P("\n\r[Timonel] Dumping flash memory ...\n\n\r");
+    Serial.printf_P("Addr 0x%04X: ", 0);
+    for (uint16_t addr = 0; addr < flash_size; addr += rx_packet_size) {
+        twi_cmd_arr[1] = ((addr & 0xFF00) >> 8);
+        twi_cmd_arr[2] = (addr & 0xFF);
+        twi_cmd_arr[3] = rx_packet_size;
+        twi_cmd_arr[4] = (uint8_t)(twi_cmd_arr[1] + twi_cmd_arr[2] + twi_cmd_arr[3]);
+        uint8_t twi_errors = TwiCmdXmit(twi_cmd_arr, cmd_size, ACKRDFSH, twi_reply_arr, rx_packet_size + 2);
+        if (twi_errors != 0) {
+            Serial.printf_P("\n\r[Timonel] Error %d reading flash at 0x%04X\n\r", twi_errors, addr);
+            return twi_errors;
+        }
+        uint8_t checksum = 0;
+        for (uint8_t i = 1; i <= rx_packet_size; i++) {
+            checksum += twi_reply_arr[i];
+            Serial.printf_P("%02X ", twi_reply_arr[i]);
+            if ((++line_values == values_per_line) && ((addr + i) < flash_size)) {
+                Serial.printf_P("\n\rAddr 0x%04X: ", addr + i);
+                line_values = 0;
+            }
+        }
+        if (checksum != twi_reply_arr[rx_packet_size + 1]) {
+            checksum_errors++;
+        }
+    }
+    Serial.printf_P("\n\n\r[Timonel] Flash dump done, checksum errors: %d\n\n\r", checksum_errors);
+    return checksum_errors;
+}
+#endif  // F_CMD_READFLASH
+
+#if ((defined EXT_FEATURES) && ((EXT_FEATURES >> E_EEPROM_ACCESS) & true))
+// Write one byte to the device EEPROM
+void Timonel::WriteEeprom(const uint16_t eeprom_addr, uint8_t data_byte) {
+    const uint8_t cmd_size = 4;
+    uint8_t twi_cmd_arr[cmd_size] = {WRITEEPR, (uint8_t)((eeprom_addr & 0xFF00) >> 8), (uint8_t)(eeprom_addr & 0xFF), data_byte};
+    TwiCmdXmit(twi_cmd_arr, cmd_size, ACKWTEEP);
+    delay(DLY_EEPROM);
+}
+
+// Read one byte from the device EEPROM
+uint8_t Timonel::ReadEeprom(const uint16_t eeprom_addr) {
+    const uint8_t cmd_size = 3;
+    const uint8_t reply_size = 2;
+    uint8_t twi_cmd_arr[cmd_size] = {READEEPR, (uint8_t)((eeprom_addr & 0xFF00) >> 8), (uint8_t)(eeprom_addr & 0xFF)};
+    uint8_t twi_reply_arr[reply_size] = {0};
+    TwiCmdXmit(twi_cmd_arr, cmd_size, ACKRDEEP, twi_reply_arr, reply_size);
+    return twi_reply_arr[1];
+}
+#endif  // E_EEPROM_ACCESS
+
+#if ((defined EXT_FEATURES) && ((EXT_FEATURES >> E_CMD_READDEVS) & true))
+// Read the device fuses, lock bits, signature and oscillator calibration
+Timonel::DevSettings Timonel::GetDevSettings(void) {
+    const uint8_t reply_size = 10;
+    uint8_t twi_reply_arr[reply_size] = {0};
+    DevSettings dev_settings;
+    if (TwiCmdXmit(READDEVS, AKRDEVS, twi_reply_arr, reply_size) == 0) {
+        dev_settings.low_fuse_bits = twi_reply_arr[1];
+        dev_settings.high_fuse_bits = twi_reply_arr[2];
+        dev_settings.extended_fuse_bits = twi_reply_arr[3];
+        dev_settings.lock_bits = twi_reply_arr[4];
+        dev_settings.signature_byte_0 = twi_reply_arr[5];
+        dev_settings.signature_byte_1 = twi_reply_arr[6];
+        dev_settings.signature_byte_2 = twi_reply_arr[7];
+        dev_settings.calibration_0 = twi_reply_arr[8];
+        dev_settings.calibration_1 = twi_reply_arr[9];
+    }
+    return dev_settings;
+}
+#endif  // E_CMD_READDEVS
+
+// Initialize the bootloader: query its status, soft-init it if required
+uint8_t Timonel::BootloaderInit(void) {
+    uint8_t twi_errors = QueryStatus();
+    if ((twi_errors == 0) && ((status_.features_code >> F_TWO_STEP_INIT) & true)) {
+        twi_errors += InitMicro();
+    }
+    return twi_errors;
+}
+
+// Ask the bootloader for its version and status
+uint8_t Timonel::QueryStatus(void) {
+    const uint8_t reply_size = 12;
+    uint8_t twi_reply_arr[reply_size] = {0};
+    uint8_t twi_errors = TwiCmdXmit(GETTMNLV, AKTMNLV, twi_reply_arr, reply_size);
+    if ((twi_errors == 0) && (twi_reply_arr[1] == T_SIGNATURE)) {
+        status_.signature = twi_reply_arr[1];
+        status_.version_major = twi_reply_arr[2];
+        status_.version_minor = twi_reply_arr[3];
+        status_.features_code = twi_reply_arr[4];
+        status_.ext_features_code = twi_reply_arr[5];
+        status_.bootloader_start = (twi_reply_arr[6] << 8) | twi_reply_arr[7];
+        status_.application_start = (twi_reply_arr[8] << 8) | twi_reply_arr[9];
+        status_.low_fuse_setting = twi_reply_arr[10];
+        status_.oscillator_cal = twi_reply_arr[11];
+    } else {
+        status_ = Status();
+    }
+    return twi_errors;
+}
+
+// Set the flash page address where the next data packets will be written
+uint8_t Timonel::SetPageAddress(const uint16_t page_addr) {
+    const uint8_t cmd_size = 4;
+    const uint8_t reply_size = 2;
+    uint8_t twi_cmd_arr[cmd_size] = {STPGADDR, (uint8_t)((page_addr & 0xFF00) >> 8), (uint8_t)(page_addr & 0xFF), 0};
+    uint8_t twi_reply_arr[reply_size] = {0};
+    twi_cmd_arr[3] = (uint8_t)(twi_cmd_arr[1] + twi_cmd_arr[2]);
+    uint8_t twi_errors = TwiCmdXmit(twi_cmd_arr, cmd_size, AKPGADDR, twi_reply_arr, reply_size);
+    if ((twi_errors == 0) && (twi_reply_arr[1] != twi_cmd_arr[3])) {
+        twi_errors = ERR_04;
+    }
+    return twi_errors;
+}
+
+// Send a data packet to be written into the device page buffer
+uint8_t Timonel::WritePageBuff(uint8_t data_packet[]) {
+    const uint8_t cmd_size = MST_PACKET_SIZE + 2;
+    const uint8_t reply_size = 2;
+    uint8_t twi_cmd_arr[cmd_size] = {WRITPAGE};
+    uint8_t twi_reply_arr[reply_size] = {0};
+    uint8_t checksum = 0;
+    for (uint8_t i = 0; i < MST_PACKET_SIZE; i++) {
+        twi_cmd_arr[i + 1] = data_packet[i];
+        checksum += data_packet[i];
+    }
+    twi_cmd_arr[cmd_size - 1] = checksum;
+    uint8_t twi_errors = TwiCmdXmit(twi_cmd_arr, cmd_size, AKWTPAGE, twi_reply_arr, reply_size);
+    if ((twi_errors == 0) && (twi_reply_arr[1] != checksum)) {
+        twi_errors = ERR_04;
+    }
+    return twi_errors;
+}
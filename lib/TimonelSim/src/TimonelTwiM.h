@@ -0,0 +1,69 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: TimonelTwiM.h (Header)
+  ............................................................................
+  Timonel stand-in: drives a Timonel bootloader with the same command
+  sequences, packet sizes and delays as the TimonelTwiM master library.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONELTWIM_H
+#define TIMONELTWIM_H
+
+#include "NbMicro.h"
+
+#define ERR_APP_OVF 5  // The application overflows the bootloader
+
+class Timonel : public NbMicro {
+   public:
+    Timonel(const uint8_t twi_address = 0, const uint8_t sda = 0, const uint8_t scl = 0);
+    ~Timonel();
+    struct Status {
+        uint8_t signature = 0;
+        uint8_t version_major = 0;
+        uint8_t version_minor = 0;
+        uint8_t features_code = 0;
+        uint8_t ext_features_code = 0;
+        uint16_t bootloader_start = 0xFFFF;
+        uint16_t application_start = 0xFFFF;
+        uint8_t low_fuse_setting = 0;
+        uint8_t oscillator_cal = 0;
+    };
+    struct DevSettings {
+        uint8_t low_fuse_bits = 0;
+        uint8_t high_fuse_bits = 0;
+        uint8_t extended_fuse_bits = 0;
+        uint8_t lock_bits = 0;
+        uint8_t signature_byte_0 = 0;
+        uint8_t signature_byte_1 = 0;
+        uint8_t signature_byte_2 = 0;
+        uint8_t calibration_0 = 0;
+        uint8_t calibration_1 = 0;
+    };
+    Status GetStatus(void);
+    uint8_t UploadApplication(uint8_t payload[], uint16_t payload_size, const uint16_t start_address = 0x0000);
+    uint8_t RunApplication(void);
+    uint8_t DeleteApplication(void);
+#if ((defined FEATURES_CODE) && ((FEATURES_CODE >> F_CMD_READFLASH) & true))
+    uint8_t DumpMemory(const uint16_t flash_size = MCU_TOTAL_MEM, const uint8_t rx_packet_size = SLV_PACKET_SIZE, const uint8_t values_per_line = 32);
+#endif  // F_CMD_READFLASH
+#if ((defined EXT_FEATURES) && ((EXT_FEATURES >> E_EEPROM_ACCESS) & true))
+    void WriteEeprom(const uint16_t eeprom_addr, uint8_t data_byte);
+    uint8_t ReadEeprom(const uint16_t eeprom_addr);
+#endif  // E_EEPROM_ACCESS
+#if ((defined EXT_FEATURES) && ((EXT_FEATURES >> E_CMD_READDEVS) & true))
+    DevSettings GetDevSettings(void);
+#endif  // E_CMD_READDEVS
+
+   private:
+    Status status_;
+    uint8_t BootloaderInit(void);
+    uint8_t QueryStatus(void);
+    uint8_t SetPageAddress(const uint16_t page_addr = 0x0000);
+    uint8_t WritePageBuff(uint8_t data_packet[]);
+};
+
+#endif  // TIMONELTWIM_H
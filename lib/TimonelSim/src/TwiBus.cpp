@@ -0,0 +1,51 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: TwiBus.cpp (Stand-in library)
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "TwiBus.h"
+
+// Class constructor
+TwiBus::TwiBus(uint8_t sda, uint8_t scl) : sda_(sda), scl_(scl) {
+    Wire.begin(sda_, scl_);
+}
+
+// Class destructor
+TwiBus::~TwiBus() {
+}
+
+// Return the first address that answers, and whether it belongs to an application
+uint8_t TwiBus::ScanBus(bool *p_app_mode, uint8_t start_twi_addr) {
+    for (uint8_t twi_addr = start_twi_addr; twi_addr <= HIG_TWI_ADDR; twi_addr++) {
+        Wire.beginTransmission(twi_addr);
+        if (Wire.endTransmission() == 0) {
+            if (p_app_mode != nullptr) {
+                *p_app_mode = (twi_addr >= APP_TWI_ADDR);
+            }
+            return twi_addr;
+        }
+    }
+    return 0;
+}
+
+// Fill an array with every device found on the bus, return how many were found
+uint8_t TwiBus::ScanBus(DeviceInfo dev_info_arr[], uint8_t arr_size, uint8_t start_twi_addr) {
+    uint8_t found = 0;
+    for (uint8_t twi_addr = start_twi_addr; (twi_addr <= HIG_TWI_ADDR) && (found < arr_size); twi_addr++) {
+        Wire.beginTransmission(twi_addr);
+        if (Wire.endTransmission() == 0) {
+            dev_info_arr[found].addr = twi_addr;
+            if (twi_addr < APP_TWI_ADDR) {
+                strncpy(dev_info_arr[found].firmware, "Timonel", sizeof(dev_info_arr[found].firmware) - 1);
+            } else {
+                strncpy(dev_info_arr[found].firmware, "Unknown", sizeof(dev_info_arr[found].firmware) - 1);
+            }
+            found++;
+        }
+    }
+    return found;
+}
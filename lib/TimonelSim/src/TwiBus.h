@@ -0,0 +1,38 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: TwiBus.h (Header)
+  ............................................................................
+  TwiBus stand-in: scans the (simulated) bus looking for NB devices.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TWIBUS_H
+#define TWIBUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "libconfig.h"
+#include "nb-twi-cmd.h"
+
+class TwiBus {
+   public:
+    struct DeviceInfo {
+        uint8_t addr = 0;
+        char firmware[10] = {0};
+        uint8_t version_major = 0;
+        uint8_t version_minor = 0;
+    };
+    TwiBus(uint8_t sda = 0, uint8_t scl = 0);
+    ~TwiBus();
+    uint8_t ScanBus(bool *p_app_mode = nullptr, uint8_t start_twi_addr = LOW_TWI_ADDR);
+    uint8_t ScanBus(DeviceInfo dev_info_arr[], uint8_t arr_size, uint8_t start_twi_addr = LOW_TWI_ADDR);
+
+   private:
+    uint8_t sda_ = 0, scl_ = 0;
+};
+
+#endif  // TWIBUS_H
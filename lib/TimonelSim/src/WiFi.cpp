@@ -0,0 +1,144 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: WiFi.cpp (Source)
+  ............................................................................
+  Loopback sockets behind WiFiServer and WiFiClient (see WiFi.h).
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "WiFi.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiClass WiFi;
+
+// Function WiFiClient::connected: true while the peer hasn't closed or there is data left to read
+uint8_t WiFiClient::connected(void) {
+    if (fd_ < 0) {
+        return 0;
+    }
+    uint8_t probe;
+    ssize_t got = recv(fd_, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (got > 0) {
+        return 1;
+    }
+    return (got < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK));
+}
+
+// Function WiFiClient::available: bytes received and not read yet
+int WiFiClient::available(void) {
+    int count = 0;
+    if ((fd_ < 0) || (ioctl(fd_, FIONREAD, &count) < 0)) {
+        return 0;
+    }
+    return count;
+}
+
+int WiFiClient::read(void) {
+    uint8_t data;
+    return (read(&data, 1) == 1) ? data : -1;
+}
+
+// Function WiFiClient::read: up to "size" bytes already received, -1 if none
+int WiFiClient::read(uint8_t *buf, size_t size) {
+    if (fd_ < 0) {
+        return -1;
+    }
+    ssize_t got = recv(fd_, buf, size, MSG_DONTWAIT);
+    return (got > 0) ? (int)got : -1;
+}
+
+int WiFiClient::peek(void) {
+    uint8_t data;
+    if ((fd_ < 0) || (recv(fd_, &data, 1, MSG_PEEK | MSG_DONTWAIT) != 1)) {
+        return -1;
+    }
+    return data;
+}
+
+// Function WiFiClient::write: short replies, sent whole unless the connection is gone
+size_t WiFiClient::write(const uint8_t *data, size_t size) {
+    size_t sent = 0;
+    while ((fd_ >= 0) && (sent < size)) {
+        ssize_t done = send(fd_, data + sent, size - sent, MSG_NOSIGNAL);
+        if (done > 0) {
+            sent += done;
+        } else if ((done < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+            usleep(100);
+        } else {
+            break;
+        }
+    }
+    return sent;
+}
+
+void WiFiClient::stop(void) {
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+void WiFiClient::setNoDelay(bool nodelay) {
+    int flag = nodelay ? 1 : 0;
+    if (fd_ >= 0) {
+        setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+    }
+}
+
+// Function WiFiServer::begin: listen on 127.0.0.1
+void WiFiServer::begin(uint16_t port) {
+    if (port != 0) {
+        port_ = port;
+    }
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+        return;
+    }
+    int reuse = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    int window = SIM_TCP_WINDOW; /* Inherited by the accepted sockets */
+    setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &window, sizeof(window));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port_);
+    socklen_t addr_size = sizeof(addr);
+    if ((bind(fd_, (sockaddr *)&addr, sizeof(addr)) < 0) || (listen(fd_, max_clients_) < 0) ||
+        (getsockname(fd_, (sockaddr *)&addr, &addr_size) < 0)) {
+        end();
+        return;
+    }
+    port_ = ntohs(addr.sin_port);
+    fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+}
+
+void WiFiServer::end(void) {
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+// Function WiFiServer::accept: never waits
+WiFiClient WiFiServer::accept(void) {
+    if (fd_ < 0) {
+        return WiFiClient();
+    }
+    int client_fd = ::accept(fd_, nullptr, nullptr);
+    if (client_fd < 0) {
+        return WiFiClient();
+    }
+    WiFiClient client(client_fd);
+    client.setNoDelay(nodelay_);
+    return client;
+}
@@ -0,0 +1,91 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: WiFi.h (Header)
+  ............................................................................
+  Arduino ESP32 WiFi replacement on host loopback sockets.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_SIM_WIFI_H
+#define TIMONEL_SIM_WIFI_H
+
+#include "Arduino.h"
+
+// Arduino ESP32 WiFi replacement on host sockets: the station is always
+// "connected" as 127.0.0.1 and WiFiServer listens on the loopback
+// interface. Sockets are non-blocking like lwIP's with the ESP32 core:
+// accept() and available() never wait, and a client that is not read
+// keeps its data in the kernel buffers, so TCP flow control pushes back
+// on the sender as on the target, where lwIP grants each connection a
+// SIM_TCP_WINDOW receive window. Unlike the ESP32 core, copies of a
+// WiFiClient don't close the socket when the last one goes away: stop()
+// does.
+
+#define SIM_TCP_WINDOW 5744  // ESP32 lwIP TCP_WND (4 * MSS), the receive buffer of accepted sockets
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_CONNECTED = 3,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1
+} wifi_mode_t;
+
+// Station interface: always up on the loopback address
+class WiFiClass {
+   public:
+    bool mode(wifi_mode_t mode) { return true; }
+    wl_status_t begin(const char *ssid, const char *password = nullptr) { return WL_CONNECTED; }
+    wl_status_t status(void) { return WL_CONNECTED; }
+    String localIP(void) { return String("127.0.0.1"); }  // The ESP32 core returns an IPAddress
+};
+
+extern WiFiClass WiFi;
+
+// TCP connection, a socket descriptor shared by its copies
+class WiFiClient : public Stream {
+   public:
+    WiFiClient() {}
+    explicit WiFiClient(int fd) : fd_(fd) {}
+    uint8_t connected(void);
+    int available(void);
+    int read(void);
+    int read(uint8_t *buf, size_t size);
+    int peek(void);
+    size_t write(uint8_t data) { return write(&data, 1); }
+    size_t write(const uint8_t *data, size_t size);
+    void stop(void);
+    void setNoDelay(bool nodelay);
+    operator bool() { return fd_ >= 0; }
+    int fd(void) const { return fd_; }
+
+   private:
+    int fd_ = -1;
+};
+
+// Listening socket on 127.0.0.1
+class WiFiServer {
+   public:
+    explicit WiFiServer(uint16_t port = 80, uint8_t max_clients = 4) : port_(port), max_clients_(max_clients) {}
+    void begin(uint16_t port = 0);
+    void end(void);
+    WiFiClient accept(void);  // A new connection, or a client that is false
+    WiFiClient available(void) { return accept(); }
+    void setNoDelay(bool nodelay) { nodelay_ = nodelay; }
+    operator bool() { return fd_ >= 0; }
+    uint16_t port(void) const { return port_; }  // Simulator hook: the port bound (begin(0) picks a free one)
+
+   private:
+    uint16_t port_;
+    uint8_t max_clients_;  /* Listen backlog */
+    bool nodelay_ = false;
+    int fd_ = -1;
+};
+
+#endif  // TIMONEL_SIM_WIFI_H
@@ -0,0 +1,100 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: Wire.cpp (Stand-in library)
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "Wire.h"
+
+#include "esp32-hal-i2c.h"
+
+TwoWire Wire(0);
+TwoWire Wire1(1);
+
+// Class TwoWire: Constructor
+TwoWire::TwoWire(const uint8_t bus_num) : num_(bus_num), bus_(SimBus::Get(bus_num)) {
+}
+
+// Class TwoWire: Start the controller, pins are irrelevant on the host
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    (void)sda;
+    (void)scl;
+    i2cSetClock(num_, frequency);
+    return true;
+}
+
+// Class TwoWire: Stop the controller
+bool TwoWire::end(void) {
+    return true;
+}
+
+// Class TwoWire: Set the SCL frequency
+bool TwoWire::setClock(uint32_t frequency) {
+    return i2cSetClock(num_, frequency) == ESP_OK;
+}
+
+// Class TwoWire: Get the SCL frequency
+uint32_t TwoWire::getClock(void) {
+    uint32_t frequency = 0;
+    i2cGetClock(num_, &frequency);
+    return frequency;
+}
+
+// Class TwoWire: Start buffering a master-to-slave transfer
+void TwoWire::beginTransmission(uint16_t address) {
+    tx_address_ = address;
+    tx_length_ = 0;
+}
+
+// Class TwoWire: Buffer one byte
+size_t TwoWire::write(uint8_t data) {
+    if (tx_length_ >= I2C_BUFFER_LENGTH) {
+        return 0;
+    }
+    tx_buffer_[tx_length_++] = data;
+    return 1;
+}
+
+// Class TwoWire: Buffer several bytes
+size_t TwoWire::write(const uint8_t *data, size_t size) {
+    size_t written = 0;
+    while ((written < size) && write(data[written])) {
+        written++;
+    }
+    return written;
+}
+
+// Class TwoWire: Send the buffered transfer
+uint8_t TwoWire::endTransmission(bool send_stop) {
+    (void)send_stop;
+    esp_err_t err = i2cWrite(num_, tx_address_, tx_buffer_, tx_length_, timeout_ms_);
+    tx_length_ = 0;
+    return (err == ESP_OK) ? 0 : 2;
+}
+
+// Class TwoWire: Read from a slave into the receive buffer
+uint8_t TwoWire::requestFrom(uint16_t address, uint8_t size, bool send_stop) {
+    (void)send_stop;
+    if (size > I2C_BUFFER_LENGTH) {
+        size = I2C_BUFFER_LENGTH;
+    }
+    i2cRead(num_, address, rx_buffer_, size, timeout_ms_, &rx_length_);
+    rx_index_ = 0;
+    return rx_length_;
+}
+
+// Class TwoWire: Bytes left in the receive buffer
+int TwoWire::available(void) {
+    return rx_length_ - rx_index_;
+}
+
+// Class TwoWire: Read one received byte, -1 if none
+int TwoWire::read(void) {
+    if (rx_index_ >= rx_length_) {
+        return -1;
+    }
+    return rx_buffer_[rx_index_++];
+}
@@ -0,0 +1,59 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: Wire.h (Header)
+  ............................................................................
+  TwoWire stand-in with the ESP32 Arduino signatures, on the simulated
+  buses.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_SIM_WIRE_H
+#define TIMONEL_SIM_WIRE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SimBus.h"
+
+// TwoWire stand-in with the ESP32 Arduino signatures. "Wire" and "Wire1"
+// map to the two simulated buses, like the two ESP32 I2C controllers.
+// Transfers go through the I2C HAL calls like on the ESP32 (see
+// esp32-hal-i2c.h).
+
+#define I2C_BUFFER_LENGTH 128
+
+class TwoWire {
+   public:
+    TwoWire(const uint8_t bus_num);
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool end(void);
+    bool setClock(uint32_t frequency);
+    uint32_t getClock(void);
+    void beginTransmission(uint16_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t size);
+    uint8_t endTransmission(bool send_stop = true);
+    uint8_t requestFrom(uint16_t address, uint8_t size, bool send_stop = true);
+    int available(void);
+    int read(void);
+    SimBus *GetSimBus(void) { return bus_; }
+
+   private:
+    uint8_t num_;
+    SimBus *bus_;
+    uint32_t timeout_ms_ = 50;
+    uint16_t tx_address_ = 0;
+    uint8_t tx_buffer_[I2C_BUFFER_LENGTH];
+    size_t tx_length_ = 0;
+    uint8_t rx_buffer_[I2C_BUFFER_LENGTH];
+    size_t rx_length_ = 0;
+    size_t rx_index_ = 0;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif  // TIMONEL_SIM_WIRE_H
@@ -0,0 +1,45 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: esp32-hal-i2c.cpp (Stand-in library)
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "esp32-hal-i2c.h"
+
+#include "SimBus.h"
+
+// Function i2cSetClock: SCL frequency of a controller
+esp_err_t i2cSetClock(uint8_t i2c_num, uint32_t frequency) {
+    SimBus::Get(i2c_num)->SetClock(frequency);
+    return ESP_OK;
+}
+
+// Function i2cGetClock
+esp_err_t i2cGetClock(uint8_t i2c_num, uint32_t *frequency) {
+    *frequency = SimBus::Get(i2c_num)->GetClock();
+    return ESP_OK;
+}
+
+// Function i2cWrite: master-to-slave transfer, ESP_FAIL on an address or data NACK
+esp_err_t i2cWrite(uint8_t i2c_num, uint16_t address, const uint8_t *buff, size_t size, uint32_t timeOutMillis) {
+    (void)timeOutMillis;
+    return (SimBus::Get(i2c_num)->Write(address, buff, size) == 0) ? ESP_OK : ESP_FAIL;
+}
+
+// Function i2cRead: slave-to-master transfer, ESP_FAIL on an address NACK
+esp_err_t i2cRead(uint8_t i2c_num, uint16_t address, uint8_t *buff, size_t size, uint32_t timeOutMillis, size_t *readCount) {
+    (void)timeOutMillis;
+    *readCount = SimBus::Get(i2c_num)->Read(address, buff, size);
+    return (*readCount != 0) ? ESP_OK : ESP_FAIL;
+}
+
+// Function i2cWriteReadNonStop: a write, then a read after a repeated start
+esp_err_t i2cWriteReadNonStop(uint8_t i2c_num, uint16_t address, const uint8_t *wbuff, size_t wsize, uint8_t *rbuff, size_t rsize,
+                              uint32_t timeOutMillis, size_t *readCount) {
+    *readCount = 0;
+    esp_err_t err = i2cWrite(i2c_num, address, wbuff, wsize, timeOutMillis);
+    return (err == ESP_OK) ? i2cRead(i2c_num, address, rbuff, rsize, timeOutMillis, readCount) : err;
+}
@@ -0,0 +1,45 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: esp32-hal-i2c.h (Header)
+  ............................................................................
+  The ESP32 Arduino I2C HAL calls TwoWire is built on, on the simulated
+  buses.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_SIM_ESP32_HAL_I2C_H
+#define TIMONEL_SIM_ESP32_HAL_I2C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The ESP32 Arduino I2C HAL calls TwoWire is built on (core 2.x), on the
+// simulated buses. Like on the ESP32 they are C functions in their own
+// object file, so a build can wrap them at link time (-Wl,--wrap=...) to
+// see every transfer (see include/i2c-trace.h).
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1           // Address or data NACK
+#define ESP_ERR_TIMEOUT 0x107 // Not raised by the simulated buses
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t i2cSetClock(uint8_t i2c_num, uint32_t frequency);
+esp_err_t i2cGetClock(uint8_t i2c_num, uint32_t *frequency);
+esp_err_t i2cWrite(uint8_t i2c_num, uint16_t address, const uint8_t *buff, size_t size, uint32_t timeOutMillis);
+esp_err_t i2cRead(uint8_t i2c_num, uint16_t address, uint8_t *buff, size_t size, uint32_t timeOutMillis, size_t *readCount);
+esp_err_t i2cWriteReadNonStop(uint8_t i2c_num, uint16_t address, const uint8_t *wbuff, size_t wsize, uint8_t *rbuff, size_t rsize,
+                              uint32_t timeOutMillis, size_t *readCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TIMONEL_SIM_ESP32_HAL_I2C_H
@@ -0,0 +1,72 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: libconfig.h (Header)
+  ............................................................................
+  Build configuration of the master libraries: target memory layout, packet
+  sizes, the Timonel features the master is compiled for and the delays
+  between bootloader operations.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_SIM_LIBCONFIG_H
+#define TIMONEL_SIM_LIBCONFIG_H
+
+// Target device (ATtiny85)
+#ifndef MCU_TOTAL_MEM
+#define MCU_TOTAL_MEM 8192  // Flash memory size
+#endif
+#ifndef SPM_PAGESIZE
+#define SPM_PAGESIZE 64  // Flash page size
+#endif
+
+// Data packet sizes
+#ifndef MST_PACKET_SIZE
+#define MST_PACKET_SIZE 32  // Master-to-slave Xmit data block size: always even values, min = 2, max = 32
+#endif
+#ifndef SLV_PACKET_SIZE
+#define SLV_PACKET_SIZE 32  // Slave-to-master Xmit data block size: always even values, min = 2, max = 32
+#endif
+
+// TWI addresses: bootloader 8-35, applications 36-63
+#define LOW_TWI_ADDR 8
+#define HIG_TWI_ADDR 63
+#define APP_TWI_ADDR 36
+
+// Timonel signature and features
+#define T_SIGNATURE 84  // 'T'
+
+#define F_ENABLE_LED_UI 0
+#define F_AUTO_PAGE_ADDR 1
+#define F_APP_USE_TPL_PG 2
+#define F_CMD_SETPGADDR 3
+#define F_TWO_STEP_INIT 4
+#define F_USE_WDT_RESET 5
+#define F_APP_AUTORUN 6
+#define F_CMD_READFLASH 7
+
+#define E_AUTO_CLK_TWEAK 0
+#define E_FORCE_ERASE_PG 1
+#define E_CLEAR_BIT_7_R31 2
+#define E_CHECK_PAGE_IX 3
+#define E_CMD_READDEVS 4
+#define E_EEPROM_ACCESS 5
+#define E_EEPROM_BLOCKS 6
+
+#ifndef FEATURES_CODE
+#define FEATURES_CODE 0xAE  // AUTO_PAGE_ADDR, APP_USE_TPL_PG, CMD_SETPGADDR, USE_WDT_RESET, CMD_READFLASH
+#endif
+#ifndef EXT_FEATURES
+#define EXT_FEATURES 0x71  // AUTO_CLK_TWEAK, CMD_READDEVS, EEPROM_ACCESS, EEPROM_BLOCKS
+#endif
+
+// Delays (ms)
+#define DLY_SET_ADDR 10  // Delay after setting a new page address
+#define DLY_FLASH_PG 10  // Delay after filling a flash page, lets the device write it
+#define DLY_PKT_SEND 2   // Delay after sending a data packet
+#define DLY_DEL_APP 500  // Delay after a flash deletion request
+#define DLY_EEPROM 4     // Delay after an EEPROM write
+
+#endif  // TIMONEL_SIM_LIBCONFIG_H
@@ -0,0 +1,54 @@
+/*
+  TimonelSim: host-native stand-ins for the Timonel TWI master libraries
+  ............................................................................
+  File: nb-twi-cmd.h (Header)
+  ............................................................................
+  NB TWI (I2C) command set shared by the Timonel bootloader, the NB
+  applications and the I2C master libraries.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef NB_TWI_CMD_H
+#define NB_TWI_CMD_H
+
+// Reset / initialization
+#define RESETMCU 0x80  // Command: Reset microcontroller
+#define ACKRESET 0x7F  // Reply: Reset acknowledged
+#define INITSOFT 0x81  // Command: Initialize firmware (soft init)
+#define AKINITS 0x7E   // Reply: Soft init acknowledged
+
+// Timonel bootloader commands
+#define GETTMNLV 0x82  // Command: Get Timonel version and status
+#define AKTMNLV 0x7D   // Reply: Version and status follow
+#define DELFLASH 0x83  // Command: Delete the user application
+#define AKDLFLSH 0x7C  // Reply: Deletion started
+#define STPGADDR 0x84  // Command: Set flash page address
+#define AKPGADDR 0x7B  // Reply: Page address set
+#define WRITPAGE 0x85  // Command: Write data packet into the page buffer
+#define AKWTPAGE 0x7A  // Reply: Data packet accepted
+#define EXITTMNL 0x86  // Command: Exit bootloader, run the user application
+#define AKEXITTM 0x79  // Reply: Exiting bootloader
+#define READFLSH 0x87  // Command: Read flash memory
+#define ACKRDFSH 0x78  // Reply: Flash data follows
+#define READDEVS 0x88  // Command: Read fuses, lock bits, signature and calibration
+#define AKRDEVS 0x77   // Reply: Device settings follow
+#define READEEPR 0x89  // Command: Read one EEPROM byte
+#define ACKRDEEP 0x76  // Reply: EEPROM data follows
+#define WRITEEPR 0x8A  // Command: Write one EEPROM byte
+#define ACKWTEEP 0x75  // Reply: EEPROM byte written
+#define READEEBK 0x8B  // Command: Read an EEPROM block (EEPROM_BLOCKS builds)
+#define ACKRDEBK 0x74  // Reply: EEPROM block follows
+#define WRITEEBK 0x8C  // Command: Write an EEPROM block (EEPROM_BLOCKS builds)
+#define ACKWTEBK 0x73  // Reply: EEPROM block written
+
+// NB application commands
+#define SETIO1_1 0x92  // Command: Start blinking PB1
+#define ACKIO1_1 0x6D  // Reply: Blinking started
+#define SETIO1_0 0x93  // Command: Stop blinking PB1
+#define ACKIO1_0 0x6C  // Reply: Blinking stopped
+
+#define UNKNOWNC 0xFF  // Reply: Unknown command
+
+#endif  // NB_TWI_CMD_H
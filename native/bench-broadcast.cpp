@@ -0,0 +1,159 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-broadcast.cpp (Native benchmark)
+  ............................................................................
+  Broadcast upload against one upload per device on a shared bus.
+  Usage: bench-broadcast [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "bench.h"
+#include "broadcast-upload.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+#define BENCH_DEVICES 8      // Most devices in a round
+#define BENCH_BOOT_ADDR 11   // First device's bootloader address, the next ones follow
+#define BENCH_APP_OFFSET 33  // Application address = bootloader address + this (>= APP_TWI_ADDR)
+#define BENCH_LOST_PACKET 20 // Packet the faulty device loses
+
+uint8_t app_image[MCU_TOTAL_MEM];
+uint16_t app_size = 0;
+
+// Function Attach: "count" fresh devices taking the general call, with page erase before writes if asked
+void Attach(const BenchOptions &options, TimonelSlave **devices, const uint8_t count, const bool force_erase) {
+    for (uint8_t ix = 0; ix < count; ix++) {
+        devices[ix] = new TimonelSlave(BENCH_BOOT_ADDR + ix, BENCH_BOOT_ADDR + ix + BENCH_APP_OFFSET);
+        devices[ix]->GetTiming().page_erase_us = options.page_erase_us;
+        devices[ix]->GetTiming().page_write_us = options.page_write_us;
+        devices[ix]->SetGeneralCall(true);
+        if (force_erase) {
+            devices[ix]->SetFeatures(FEATURES_CODE, EXT_FEATURES | (1 << E_FORCE_ERASE_PG));
+        }
+        SimBus::Get(0)->Attach(devices[ix]);
+    }
+}
+
+// Function Detach: remove the devices, true if every one holds the image
+bool Detach(TimonelSlave **devices, const uint8_t count) {
+    bool flash_ok = true;
+    for (uint8_t ix = 0; ix < count; ix++) {
+        // The reset vector is relocated by Timonel, the rest must match
+        if (memcmp(&devices[ix]->GetFlash()[2], &app_image[2], app_size - 2) != 0) {
+            printf("%24s TWI %d: flash differs\n", "", BENCH_BOOT_ADDR + ix);
+            flash_ok = false;
+        }
+        SimBus::Get(0)->Detach(devices[ix]);
+        delete devices[ix];
+    }
+    return flash_ok;
+}
+
+// Function Sequential: erase and upload each device in turn, returns the time (us)
+uint64_t Sequential(const BenchOptions &options, const uint8_t count, bool *ok) {
+    TimonelSlave *devices[BENCH_DEVICES];
+    Attach(options, devices, count, false);
+    uint64_t start = SimClock::Now();
+    for (uint8_t ix = 0; ix < count; ix++) {
+        Timonel timonel(BENCH_BOOT_ADDR + ix);
+        uint8_t errors = timonel.DeleteApplication();
+        while ((errors == 0) && !ProbeAddress(BENCH_BOOT_ADDR + ix)) {
+            delay(BROADCAST_POLL_MS); /* Back after the erase reset */
+        }
+        Timonel erased(BENCH_BOOT_ADDR + ix);
+        errors = (errors == 0) ? erased.UploadApplication(app_image, app_size) : errors;
+        *ok &= (errors == 0);
+    }
+    uint64_t elapsed = SimClock::Now() - start;
+    *ok &= Detach(devices, count);
+    return elapsed;
+}
+
+// Function Broadcast: one broadcast upload to every device, returns the time (us).
+// Fault 1: the last device ignores the general call and holds an older image. Fault 2: it loses a packet.
+uint64_t Broadcast(const BenchOptions &options, const uint8_t count, const uint8_t fault, bool *ok, BroadcastReport *report) {
+    TimonelSlave *devices[BENCH_DEVICES];
+    uint8_t addresses[BROADCAST_DEVICES];
+    Attach(options, devices, count, fault == 2);
+    TimonelSlave *faulty = devices[count - 1];
+    if (fault == 1) {
+        uint8_t old_image[MCU_TOTAL_MEM];
+        for (uint16_t i = 0; i < app_size; i++) {
+            old_image[i] = app_image[i] ^ ((i < 2) ? 0x00 : 0x5A); /* Same reset vector, other code */
+        }
+        Timonel timonel(BENCH_BOOT_ADDR + count - 1);
+        timonel.UploadApplication(old_image, app_size);
+        faulty->SetGeneralCall(false);
+    } else if (fault == 2) {
+        faulty->IgnoreCommand(3 + BENCH_LOST_PACKET); /* After GETTMNLV twice and DELFLASH */
+    }
+    *ok &= (FindBootloaders(addresses, BROADCAST_DEVICES) == count);
+    RawPayload payload(app_image, app_size);
+    uint64_t start = SimClock::Now();
+    *ok &= (BroadcastUpload(&payload, addresses, count, report) == 0);
+    uint64_t elapsed = SimClock::Now() - start;
+    for (uint8_t ix = 0; ix < count; ix++) {
+        const BroadcastDevice &device = report->device[ix];
+        bool is_faulty = (fault != 0) && (ix == count - 1);
+        // Healthy devices must need no repair, the faulty one only its own
+        if (!device.verified || (!is_faulty && (device.pages_resent != 0)) || (is_faulty && (device.pages_resent == 0))) {
+            printf("%24s TWI %d: verified %d, %d pages resent, erased again %d\n", "", device.address, device.verified,
+                   device.pages_resent, device.erased_again);
+            *ok = false;
+        }
+    }
+    *ok &= Detach(devices, count);
+    return elapsed;
+}
+
+// The same payload on 2, 4 and 8 simulated Tiny85s sharing the bus: one
+// upload per device (erase, wait, 'w'), against the broadcast upload that
+// sends the erase and every packet once to the general call and then
+// reads each device back. Two rounds with 4 devices add faults: one that
+// doesn't take the general call (holding an older application), and one
+// that loses a packet halfway, which must only get its pages from there
+// on again. Every device's flash is checked afterwards.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    SimBus::Get(0)->SetClock(options.twi_clock);
+    USE_SERIAL.SetEcho(options.verbose);
+    app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    BenchBanner(options);
+    printf("Payload: %d bytes, %d pages per device\n", app_size, (app_size + SPM_PAGESIZE - 1) / SPM_PAGESIZE);
+    printf("\n%-8s %14s %14s %12s %12s %8s %s\n", "devices", "sequential ms", "broadcast ms", "(send ms", "verify ms)",
+           "speedup", "");
+    bool all_ok = true;
+    const uint8_t rounds[] = {2, 4, 8};
+    for (uint8_t count : rounds) {
+        bool ok = true;
+        BroadcastReport report;
+        uint64_t sequential_us = Sequential(options, count, &ok);
+        uint64_t broadcast_us = Broadcast(options, count, 0, &ok, &report);
+        printf("%-8d %14.1f %14.1f %12lu %12lu %7.2fx %s\n", count, sequential_us / 1000.0, broadcast_us / 1000.0,
+               (unsigned long)report.broadcast_ms, (unsigned long)report.verify_ms, (double)sequential_us / broadcast_us,
+               ok ? "verified" : "FAILED");
+        all_ok &= ok;
+    }
+    const char *faults[] = {"", "4 devices, one without general call", "4 devices, one loses a packet"};
+    for (uint8_t fault = 1; fault <= 2; fault++) {
+        bool ok = true;
+        BroadcastReport report;
+        uint64_t broadcast_us = Broadcast(options, 4, fault, &ok, &report);
+        const BroadcastDevice &device = report.device[3];
+        printf("\n%s: %.1f ms, TWI %d got %d of %d pages again%s: %s\n", faults[fault], broadcast_us / 1000.0, device.address,
+               device.pages_resent, report.pages, device.erased_again ? " after an erase" : "", ok ? "verified" : "FAILED");
+        all_ok &= ok;
+    }
+    printf("\n%s\n", all_ok ? "Every device flashed and verified" : "FAILED");
+    return all_ok ? 0 : 1;
+}
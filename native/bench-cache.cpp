@@ -0,0 +1,127 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-cache.cpp (Native benchmark)
+  ............................................................................
+  I2C traffic per console command with and without the device cache.
+  Usage: bench-cache [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "bench.h"
+#include "device-cache.h"
+#include "packet-size.h"
+#include "twi-clock.h"
+
+extern DeviceCache device_cache;
+
+struct Command {
+    char key;
+    const char *name;
+};
+
+// Function RunSession: type every key, return the bus transactions of each command and the saved counters
+void RunSession(const BenchOptions &options, const Command *commands, const uint8_t count, const bool cached,
+                uint32_t *transactions, int16_t *saved) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    ForgetDevice();
+    ForgetClocks();
+    ForgetPackets();
+    device_cache.SetEnabled(cached);
+    setup();
+    for (uint8_t i = 0; i < count; i++) {
+        const char keys[] = {commands[i].key, '\0'};
+        BenchSample sample;
+        uint32_t saved_start = device_cache.GetSavedTotal() - device_cache.GetPollProbes();
+        USE_SERIAL.Inject(keys);
+        loop(); /* The key is read at the end of a loop pass ... */
+        BenchStart(&sample, commands[i].name, 0, &tiny85);
+        loop(); /* ... and served on the next one */
+        while (CommandPending()) {
+            loop(); /* 'e' goes on until the device is back */
+        }
+        BenchStop(&sample, &tiny85);
+        transactions[i] = sample.bus.transactions - sample.bus.nacks; /* Reconnect polls vary with timing */
+        saved[i] = device_cache.GetSavedTotal() - device_cache.GetPollProbes() - saved_start;
+    }
+    SimBus::Get(0)->Detach(&tiny85);
+}
+
+// Function IdleFor: run the idle loop for "ms" of virtual time or until the cache sees another device
+void IdleFor(const uint32_t ms, const uint32_t swaps) {
+    uint64_t start_us = SimClock::Now();
+    while ((device_cache.GetSwaps() == swaps) && ((SimClock::Now() - start_us) < (ms * 1000ULL))) {
+        loop();
+    }
+}
+
+// Function SwapCheck: a status cached, then the idle loop with the same device, which must keep the cache,
+// and with another bootloader build answering at the same address, which must drop it. True if both did.
+bool SwapCheck(const BenchOptions &options, uint32_t *detect_ms) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    ForgetDevice();
+    device_cache.SetEnabled(true);
+    setup();
+    USE_SERIAL.Inject("v");
+    loop();
+    loop();
+    const uint32_t swaps = device_cache.GetSwaps();
+    const uint32_t generation = device_cache.GetGeneration();
+    IdleFor(CACHE_ALIVE_MS * 3, swaps);
+    bool kept = (device_cache.GetSwaps() == swaps) && (device_cache.GetGeneration() == generation);
+    tiny85.SetFeatures(FEATURES_CODE, EXT_FEATURES ^ (1 << E_CLEAR_BIT_7_R31)); /* Another board, another build */
+    uint64_t swap_us = SimClock::Now();
+    IdleFor(CACHE_ALIVE_MS * 2, swaps);
+    *detect_ms = (SimClock::Now() - swap_us) / 1000;
+    bool dropped = (device_cache.GetSwaps() == swaps + 1) && (device_cache.GetGeneration() != generation);
+    SimBus::Get(0)->Detach(&tiny85);
+    return kept && dropped;
+}
+
+// I2C traffic per console command with and without the device cache. The
+// same key sequence (version, menu refreshes, write, diff write, erase,
+// run, blink, reset) is typed into the demo twice on the simulated Tiny85;
+// the difference in acknowledged bus transactions (NACKed polls while a
+// device resets depend on timing) must match what the cache reports as
+// saved, less the background liveness probes it made meanwhile. Then a
+// board with another bootloader build is put at the device's address
+// while the status is cached: the liveness probe must notice within
+// CACHE_ALIVE_MS and drop the cache, and must not with the same board.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    const Command commands[] = {
+        {'v', "'v' version"}, {'.', "menu"},         {'.', "menu"},           {'w', "'w' write"},
+        {'.', "menu"},        {'d', "'d' diff"},      {'e', "'e' erase"},      {'w', "'w' write"},
+        {'r', "'r' run app"}, {'a', "app 'a' blink"}, {'s', "app 's' stop"},   {'z', "app 'z' reset"},
+        {'.', "menu"},        {'.', "menu"},
+    };
+    const uint8_t count = sizeof(commands) / sizeof(commands[0]);
+    uint32_t plain_tx[count], cached_tx[count];
+    int16_t plain_saved[count], cached_saved[count];
+    RunSession(options, commands, count, false, plain_tx, plain_saved);
+    RunSession(options, commands, count, true, cached_tx, cached_saved);
+
+    BenchBanner(options);
+    printf("\n%-24s %10s %10s %10s %10s\n", "command", "acked tx", "cached tx", "saved", "reported");
+    long plain_total = 0, cached_total = 0, reported_total = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        printf("%-24s %10lu %10lu %10ld %10d\n", commands[i].name, (unsigned long)plain_tx[i], (unsigned long)cached_tx[i],
+               (long)plain_tx[i] - (long)cached_tx[i], cached_saved[i]);
+        plain_total += plain_tx[i];
+        cached_total += cached_tx[i];
+        reported_total += cached_saved[i];
+    }
+    bool counters_ok = (reported_total == plain_total - cached_total);
+    printf("%-24s %10ld %10ld %10ld %10ld\n", "total", plain_total, cached_total, plain_total - cached_total,
+           reported_total);
+    printf("%-24s %10.1f%%\n", "bus traffic saved", 100.0 * (plain_total - cached_total) / plain_total);
+    uint32_t detect_ms = 0;
+    bool swap_ok = SwapCheck(options, &detect_ms);
+    printf("%-24s %s after %lu ms idle\n", "another board", swap_ok ? "cache dropped" : "NOT NOTICED", (unsigned long)detect_ms);
+    printf("\n%s\n", counters_ok ? "Saved counter matches the measured traffic" : "SAVED COUNTER MISMATCH");
+    return (counters_ok && swap_ok) ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-clock.cpp (Native benchmark)
+  ............................................................................
+  Adaptive I2C clock on simulated fixtures of different cable lengths.
+  Usage: bench-clock [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "bench.h"
+#include "twi-clock.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+uint8_t app_image[MCU_TOTAL_MEM];
+uint16_t app_size = 0;
+
+// Simulated fixture wiring
+struct Fixture {
+    const char *name;
+    uint32_t reliable_hz;  /* Fastest rate the wiring carries while negotiating */
+    uint32_t upload_hz;    /* ... and while uploading, lower if the fixture degrades */
+    uint32_t expect_hz;    /* Rate the negotiation must find */
+};
+
+// Function FlashMatches: the device holds the image (its reset vector is relocated by Timonel)
+bool FlashMatches(TimonelSlave *tiny85) {
+    return memcmp(&tiny85->GetFlash()[2], &app_image[2], app_size - 2) == 0;
+}
+
+// Function RunFixed: verified upload at the base rate on a blank device, returns the time (us)
+uint64_t RunFixed(const BenchOptions &options, const Fixture &fixture, bool *ok) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    SimBus::Get(0)->SetReliableClock(fixture.upload_hz);
+    SetBaseClock();
+    Timonel timonel(SIM_BOOT_ADDR);
+    Timonel::Status sts = timonel.GetStatus();
+    RawPayload payload(app_image, app_size);
+    VerifyReport verify;
+    BenchSample sample;
+    BenchStart(&sample, "fixed 100 kHz", app_size, &tiny85);
+    uint8_t errors = UploadVerified(&timonel, &payload, sts, &verify);
+    BenchStop(&sample, &tiny85);
+    BenchPrint(sample);
+    *ok &= (errors == 0) && FlashMatches(&tiny85);
+    SimBus::Get(0)->Detach(&tiny85);
+    return sample.sim_us;
+}
+
+// Function RunAdaptive: negotiation and adaptive verified upload on a blank device, returns the time (us)
+uint64_t RunAdaptive(const BenchOptions &options, const Fixture &fixture, bool *ok) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    SimBus::Get(0)->SetReliableClock(fixture.reliable_hz);
+    SetBaseClock();
+    Timonel timonel(SIM_BOOT_ADDR);
+    Timonel::Status sts = timonel.GetStatus();
+    RawPayload payload(app_image, app_size);
+    VerifyReport verify;
+    ClockReport report;
+    uint8_t fallbacks = 0;
+    BenchSample sample;
+    ForgetClocks();
+    BenchStart(&sample, "negotiated", app_size, &tiny85);
+    uint32_t chosen_hz = NegotiateClock(&timonel, &report);
+    SimBus::Get(0)->SetReliableClock(fixture.upload_hz);
+    uint8_t errors = UploadAdaptive(&timonel, &payload, sts, &verify, &fallbacks);
+    BenchStop(&sample, &tiny85);
+    BenchPrint(sample);
+    // A degrading fixture steps down during the upload (too many errors) or after it failed
+    bool stepped_down = (fallbacks != 0) || (SimBus::Get(0)->GetClock() < chosen_hz);
+    bool fixture_ok = (errors == 0) && FlashMatches(&tiny85) && (chosen_hz == fixture.expect_hz) &&
+                      (stepped_down == (fixture.upload_hz != fixture.reliable_hz));
+    printf("%24s probed %d rate(s) in %.1f ms, chose %lu kHz, uploaded at %lu kHz after %d fallback(s), %lu damaged transfer(s)%s\n", "",
+           report.probes, report.probe_us / 1000.0, (unsigned long)(chosen_hz / 1000),
+           (unsigned long)(SimBus::Get(0)->GetClock() / 1000), fallbacks, (unsigned long)sample.bus.faults,
+           fixture_ok ? "" : " UNEXPECTED");
+    *ok &= fixture_ok;
+    SimBus::Get(0)->Detach(&tiny85);
+    return sample.sim_us;
+}
+
+// Adaptive I2C clock on simulated fixtures whose wiring is reliable up to
+// different SCL rates (see SimBus::SetReliableClock): a verified upload at
+// the fixed 100 kHz rate against clock negotiation plus a verified upload
+// at the rate found. Short, medium and long cables must settle on 1 MHz,
+// 400 kHz and 100 kHz. The last fixture degrades after the negotiation:
+// its upload must step the rate down, while it runs or once it failed,
+// and still flash the device. Every device's
+// flash is checked afterwards.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    options.twi_clock = CLOCK_BASE;
+    app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    BenchBanner(options);
+    const Fixture fixtures[] = {
+        {"short cable (reliable to 1.2 MHz)", 1200000, 1200000, 1000000},
+        {"medium cable (reliable to 450 kHz)", 450000, 450000, 400000},
+        {"long cable (reliable to 150 kHz)", 150000, 150000, 100000},
+        {"degrading (450 kHz, then 300 kHz)", 450000, 300000, 400000},
+    };
+    bool all_ok = true;
+    for (const Fixture &fixture : fixtures) {
+        bool ok = true;
+        printf("\n%s", fixture.name);
+        BenchHeader();
+        uint64_t fixed_us = RunFixed(options, fixture, &ok);
+        uint64_t adaptive_us = RunAdaptive(options, fixture, &ok);
+        printf("%24s %.2fx the fixed rate: %s\n", "", (double)fixed_us / adaptive_us, ok ? "verified" : "FAILED");
+        all_ok &= ok;
+    }
+    SimBus::Get(0)->SetReliableClock(0);
+    printf("\n%s\n", all_ok ? "Every fixture flashed and verified" : "CLOCK MISMATCH");
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-diff.cpp (Native benchmark)
+  ............................................................................
+  Differential upload against full re-flashing on the simulated Tiny85.
+  Usage: bench-diff [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "bench.h"
+#include "flash-sync.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+struct Scenario {
+    const char *name;
+    bool programmed;  /* The device already holds the original payload */
+    int16_t changed;  /* Payload byte changed in the new image, -1 = none */
+    bool force_erase; /* Slave built with FORCE_ERASE_PG */
+};
+
+// Function RunScenario: returns false when the flash doesn't end up holding the new image
+bool RunScenario(const BenchOptions &options, const Scenario &scenario, const bool differential) {
+    TimonelSlave tiny85;
+    if (scenario.force_erase) {
+        tiny85.SetFeatures(FEATURES_CODE, EXT_FEATURES | (1 << E_FORCE_ERASE_PG));
+    }
+    BenchSetup(options, &tiny85);
+    Timonel timonel(SIM_BOOT_ADDR);
+    uint8_t new_image[MCU_TOTAL_MEM];
+    uint16_t image_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, new_image);
+    if (scenario.programmed) {
+        timonel.UploadApplication(new_image, image_size);
+    }
+    if (scenario.changed >= 0) {
+        new_image[scenario.changed] ^= 0x5A;
+    }
+    char name[40];
+    snprintf(name, sizeof(name), "%s %s", differential ? "diff" : "full", scenario.name);
+    BenchSample sample;
+    DiffReport diff;
+    BenchStart(&sample, name, image_size, &tiny85);
+    bool erase_first = !differential && scenario.programmed && !scenario.force_erase;
+    if (differential) {
+        RawPayload source(new_image, image_size);
+        UploadDifferential(&timonel, &source, &diff);
+        erase_first = diff.needs_erase;
+    }
+    if (erase_first) {
+        bool app_mode = false;
+        timonel.DeleteApplication();
+        DiscoverDevice(&app_mode, SDA, SCL);
+        timonel.GetStatus();
+    }
+    if (!differential || diff.needs_erase) {
+        timonel.UploadApplication(new_image, image_size);
+    }
+    BenchStop(&sample, &tiny85);
+    BenchPrint(sample);
+    bool flash_ok = (timonel.GetStatus().application_start == TrampolineFor(new_image, tiny85.GetBootloaderStart()));
+    for (uint16_t i = 2; i < image_size; i++) {
+        flash_ok &= (tiny85.GetFlash()[i] == new_image[i]);
+    }
+    if (differential) {
+        printf("%24s pages rewritten: %d of %d%s%s\n", "", diff.pages_written, diff.pages,
+               diff.needs_erase ? " (needed erase + full upload)" : "", flash_ok ? "" : " FLASH MISMATCH");
+    } else if (!flash_ok) {
+        printf("%24s FLASH MISMATCH\n", "");
+    }
+    SimBus::Get(0)->Detach(&tiny85);
+    return flash_ok;
+}
+
+// Differential upload against full re-flashing on the simulated Tiny85:
+// blank device, identical image and a one-byte change, with and without
+// FORCE_ERASE_PG on the slave. The full baseline is what the console does
+// today: 'e' + 'w' on a programmed device ('w' alone when pages are erased
+// before being written). Every run is checked against the emulated flash.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    const Scenario scenarios[] = {
+        {"blank", false, -1, false},
+        {"same", true, -1, false},
+        {"1 byte", true, 300, false},
+        {"1 byte fe", true, 300, true},
+    };
+    bool all_ok = true;
+    BenchBanner(options);
+    BenchHeader();
+    for (uint8_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        all_ok &= RunScenario(options, scenarios[i], false);
+        all_ok &= RunScenario(options, scenarios[i], true);
+    }
+    printf("\n%s\n", all_ok ? "All flash images verified" : "FLASH MISMATCH");
+    return all_ok ? 0 : 1;
+}
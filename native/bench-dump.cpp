@@ -0,0 +1,148 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-dump.cpp (Native benchmark)
+  ............................................................................
+  Full flash dump through the modelled console: text hexdump against
+  binary frames.
+  Usage: bench-dump [--capture=file] [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+         (--capture keeps the overlapped console output for flash-dump.py --input)
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include <string>
+
+#include "bench.h"
+#include "flash-dump.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+// Function DecodeDump: rebuild the flash image from a console capture, false if a frame or the image CRC is bad
+bool DecodeDump(const std::string &capture, uint8_t *flash, uint16_t *size) {
+    const uint8_t *stream = (const uint8_t *)capture.data();
+    uint16_t start = 0;
+    bool header = false, end = false, frames_ok = true;
+    size_t i = 0;
+    while (!end && (i + 6 <= capture.size())) {
+        if ((stream[i] != DUMP_SYNC_0) || (stream[i + 1] != DUMP_SYNC_1) || (i + 6 + stream[i + 3] > capture.size())) {
+            i++;
+            continue;
+        }
+        const uint8_t type = stream[i + 2], length = stream[i + 3];
+        const uint8_t *payload = &stream[i + 4];
+        uint16_t crc = Crc16(0xFFFF, &stream[i + 2], length + 2);
+        if (crc != (payload[length] | (payload[length + 1] << 8))) {
+            frames_ok &= !header; /* Console text before the dump may look like a sync */
+            i++;
+            continue;
+        }
+        if (type == DUMP_HEADER) {
+            header = (payload[0] == DUMP_VERSION);
+            start = payload[1] | (payload[2] << 8);
+            *size = payload[3] | (payload[4] << 8);
+        } else if ((type == DUMP_DATA) && header) {
+            uint16_t addr = payload[0] | (payload[1] << 8);
+            memcpy(&flash[addr - start], &payload[2], length - 2);
+        } else if ((type == DUMP_END) && header) {
+            end = (payload[2] == 0) && (Crc16(0xFFFF, flash, *size) == (payload[3] | (payload[4] << 8)));
+        }
+        i += length + 6;
+    }
+    return header && end && frames_ok;
+}
+
+// Function RunDump: one full flash dump, false if the decoded image differs from the device
+bool RunDump(const BenchOptions &options, const char *name, const uint8_t mode, const char *capture_path) {
+    enum { TEXT, SEQUENTIAL, OVERLAPPED };
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    uint8_t app_image[MCU_TOTAL_MEM];
+    uint16_t app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    Timonel timonel(SIM_BOOT_ADDR);
+    timonel.UploadApplication(app_image, app_size);
+    USE_SERIAL.flush();
+    USE_SERIAL.setTxBufferSize((mode == OVERLAPPED) ? DUMP_TX_BUFFER : 0);
+    USE_SERIAL.begin(SERIAL_BPS);
+    std::string capture;
+    USE_SERIAL.SetCapture(&capture);
+    DumpReport report;
+    BenchSample sample;
+    BenchStart(&sample, name, MCU_TOTAL_MEM, &tiny85);
+    uint8_t twi_errors = 0;
+    if (mode == TEXT) {
+        twi_errors = timonel.DumpMemory(MCU_TOTAL_MEM, SLV_PACKET_SIZE, 32);
+        USE_SERIAL.flush();
+    } else {
+        twi_errors = StreamFlash(&timonel, &USE_SERIAL, 0x0000, MCU_TOTAL_MEM, &report, (mode == OVERLAPPED));
+    }
+    BenchStop(&sample, &tiny85);
+    USE_SERIAL.SetCapture(nullptr);
+    USE_SERIAL.setTxBufferSize(0);
+    SimBus::Get(0)->Detach(&tiny85);
+    BenchPrint(sample);
+    bool dump_ok = (twi_errors == 0);
+    if (mode == TEXT) {
+        printf("%24s %lu console bytes, %.0f bytes/s of flash\n", "", (unsigned long)capture.size(),
+               MCU_TOTAL_MEM * 1000000.0 / sample.sim_us);
+        return dump_ok;
+    }
+    static uint8_t flash[MCU_TOTAL_MEM];
+    uint16_t size = 0;
+    memset(flash, 0, sizeof(flash));
+    dump_ok &= DecodeDump(capture, flash, &size) && (size == MCU_TOTAL_MEM) && (memcmp(flash, tiny85.GetFlash(), size) == 0);
+    printf("%24s %lu console bytes, I2C %.1f ms, blocked on serial %.1f ms, %.0f bytes/s of flash%s\n", "",
+           (unsigned long)report.bytes_sent, report.i2c_us / 1000.0, report.serial_wait_us / 1000.0,
+           MCU_TOTAL_MEM * 1000000.0 / report.total_us, dump_ok ? "" : " DECODE MISMATCH");
+    if (mode != OVERLAPPED) {
+        return dump_ok;
+    }
+    if (capture_path != nullptr) {
+        FILE *file = fopen(capture_path, "wb");
+        if (file != nullptr) {
+            fwrite(capture.data(), 1, capture.size(), file);
+            fclose(file);
+        }
+    }
+    // Flip a flash byte inside the 10th data frame: the decoder has to notice
+    std::string corrupted = capture;
+    size_t frame = 0;
+    for (uint8_t n = 0; n <= 10; n++) {
+        frame = corrupted.find("\xa5T", frame + 1);
+    }
+    corrupted[frame + 10] ^= 0x01;
+    bool caught = !DecodeDump(corrupted, flash, &size);
+    printf("%24s corrupted frame %s\n", "", caught ? "caught" : "NOT CAUGHT");
+    return dump_ok && caught;
+}
+
+// Full flash dump of the simulated Tiny85 through the modelled 115200 bps
+// console: the text hexdump (DumpMemory), the binary frames sent one at a
+// time (I2C read, then wait for the UART) and the binary frames with the
+// next I2C read overlapped with the UART draining the previous frame. The
+// console output is captured and decoded like flash-dump.py does, then
+// checked against the device flash; a corrupted frame must be caught.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    static char capture_path[256] = "";
+    for (int i = 1; i < argc; i++) {
+        sscanf(argv[i], "--capture=%255s", capture_path);
+    }
+    bool all_ok = true;
+    BenchBanner(options);
+    printf("Console: %d bps, TX FIFO 128 bytes, TX buffer %d bytes when overlapping\n", SERIAL_BPS, DUMP_TX_BUFFER);
+    BenchHeader();
+    all_ok &= RunDump(options, "'m' text DumpMemory", 0, nullptr);
+    all_ok &= RunDump(options, "binary, sequential", 1, nullptr);
+    all_ok &= RunDump(options, "binary, overlapped", 2, (capture_path[0] != '\0') ? capture_path : nullptr);
+    printf("\n%s\n", all_ok ? "All flash dumps decoded and verified" : "DUMP MISMATCH");
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,313 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-eeprom.cpp (Native benchmark)
+  ............................................................................
+  EEPROM transfers on the simulated Tiny85: byte commands, block
+  commands and the write-back mirror.
+  Usage: bench-eeprom [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "bench.h"
+#include "eeprom-image.h"
+#include "eeprom-mirror.h"
+
+#define EEPROM_SIZE (EEPROM_TOP + 1)
+#define TUNING_OPS 400       // Reads and writes of a tuning session
+#define TUNING_BASE 0x40     // Parameter table: 32 two-byte parameters
+#define TUNING_PARAMS 32
+#define TUNING_DUMPS 4       // Whole EEPROM dumps ('o') in the session
+
+// Function CalibrationImage: table-like EEPROM contents, "changes" bytes differ from the seed-0 image
+void CalibrationImage(uint8_t *image, const uint16_t changes) {
+    for (uint16_t i = 0; i < EEPROM_SIZE; i++) {
+        image[i] = (uint8_t)((i * 7) ^ (i >> 3));
+    }
+    for (uint16_t i = 0; i < changes; i++) {
+        image[(i * 97 + 13) % EEPROM_SIZE] ^= 0x5A;
+    }
+}
+
+// Function EepromMatches: device EEPROM against the image
+bool EepromMatches(TimonelSlave *tiny85, const uint8_t *image) {
+    return memcmp(tiny85->GetEeprom(), image, EEPROM_SIZE) == 0;
+}
+
+// Function Print: bench line plus the EEPROM write count
+void Print(const BenchSample &sample, TimonelSlave *tiny85, const uint32_t eeprom_writes_start, const bool data_ok) {
+    BenchPrint(sample);
+    printf("%24s %lu EEPROM byte writes%s\n", "", (unsigned long)(tiny85->GetCounters().eeprom_writes - eeprom_writes_start),
+           data_ok ? "" : " EEPROM MISMATCH");
+}
+
+// Function RunReads: whole EEPROM dump, false on a mismatch
+bool RunReads(const BenchOptions &options, const uint8_t *image) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    memcpy(tiny85.GetEeprom(), image, EEPROM_SIZE);
+    Timonel timonel(SIM_BOOT_ADDR);
+    uint8_t data[EEPROM_SIZE];
+    bool all_ok = true;
+    BenchSample sample;
+    BenchStart(&sample, "'o' ReadEeprom loop", EEPROM_SIZE, &tiny85);
+    for (uint16_t ee_addr = 0; ee_addr < EEPROM_SIZE; ee_addr++) {
+        data[ee_addr] = timonel.ReadEeprom(ee_addr);
+    }
+    BenchStop(&sample, &tiny85);
+    all_ok &= (memcmp(data, image, EEPROM_SIZE) == 0);
+    Print(sample, &tiny85, tiny85.GetCounters().eeprom_writes, all_ok);
+    for (uint8_t blocks = 0; blocks <= 1; blocks++) {
+        tiny85.SetFeatures(FEATURES_CODE, blocks ? EXT_FEATURES : (EXT_FEATURES & ~(1 << E_EEPROM_BLOCKS)));
+        EepromTransfer eeprom(&timonel, timonel.GetStatus());
+        memset(data, 0, sizeof(data));
+        BenchStart(&sample, blocks ? "Read, block" : "Read, single byte", EEPROM_SIZE, &tiny85);
+        bool read_ok = (eeprom.Read(0, data, EEPROM_SIZE) == 0) && (memcmp(data, image, EEPROM_SIZE) == 0);
+        BenchStop(&sample, &tiny85);
+        Print(sample, &tiny85, tiny85.GetCounters().eeprom_writes, read_ok);
+        all_ok &= read_ok;
+    }
+    SimBus::Get(0)->Detach(&tiny85);
+    return all_ok;
+}
+
+// Function RunWrites: program "image" over "previous", false on a mismatch
+bool RunWrites(const BenchOptions &options, const char *name, const uint8_t *previous, const uint8_t *image,
+               const bool legacy, const bool blocks) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    tiny85.SetFeatures(FEATURES_CODE, blocks ? EXT_FEATURES : (EXT_FEATURES & ~(1 << E_EEPROM_BLOCKS)));
+    memcpy(tiny85.GetEeprom(), previous, EEPROM_SIZE);
+    Timonel timonel(SIM_BOOT_ADDR);
+    EepromTransfer eeprom(&timonel, timonel.GetStatus());
+    EepromReport report;
+    uint32_t eeprom_writes_start = tiny85.GetCounters().eeprom_writes;
+    uint8_t twi_errors = 0;
+    BenchSample sample;
+    BenchStart(&sample, name, EEPROM_SIZE, &tiny85);
+    if (legacy) {
+        for (uint16_t ee_addr = 0; ee_addr < EEPROM_SIZE; ee_addr++) {
+            timonel.WriteEeprom(ee_addr, image[ee_addr]);
+        }
+    } else {
+        twi_errors = eeprom.Program(0, image, EEPROM_SIZE, &report);
+    }
+    BenchStop(&sample, &tiny85);
+    bool data_ok = (twi_errors == 0) && EepromMatches(&tiny85, image);
+    Print(sample, &tiny85, eeprom_writes_start, data_ok);
+    SimBus::Get(0)->Detach(&tiny85);
+    return data_ok;
+}
+
+// Function RunImages: export the EEPROM to LittleFS, import a modified image and a broken one
+bool RunImages(const BenchOptions &options, const uint8_t *previous, const uint8_t *image) {
+    char root[] = "/tmp/timonel-fs-XXXXXX";
+    if (mkdtemp(root) == nullptr) {
+        perror("mkdtemp");
+        return false;
+    }
+    LittleFS.SetRoot(root);
+    LittleFS.begin();
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    memcpy(tiny85.GetEeprom(), previous, EEPROM_SIZE);
+    Timonel timonel(SIM_BOOT_ADDR);
+    EepromTransfer eeprom(&timonel, timonel.GetStatus());
+    EepromReport report;
+    BenchSample sample;
+    BenchStart(&sample, "'k' EepromExport", EEPROM_SIZE, &tiny85);
+    bool all_ok = (EepromExport(&eeprom, EEPROM_EXPORT_PATH, EEPROM_SIZE) == 0);
+    BenchStop(&sample, &tiny85);
+    std::string export_path = std::string(root) + EEPROM_EXPORT_PATH;
+    uint8_t file_data[EEPROM_SIZE + 1];
+    FILE *file = fopen(export_path.c_str(), "rb");
+    all_ok &= (file != nullptr) && (fread(file_data, 1, sizeof(file_data), file) == EEPROM_SIZE);
+    all_ok &= (memcmp(file_data, previous, EEPROM_SIZE) == 0);
+    if (file != nullptr) {
+        fclose(file);
+    }
+    Print(sample, &tiny85, tiny85.GetCounters().eeprom_writes, all_ok);
+
+    std::string unit_path = std::string(root) + EEPROM_DIR "/unit.bin";
+    file = fopen(unit_path.c_str(), "wb");
+    fwrite(image, 1, EEPROM_SIZE, file);
+    fclose(file);
+    uint32_t eeprom_writes_start = tiny85.GetCounters().eeprom_writes;
+    BenchStart(&sample, "'l' EepromImport", EEPROM_SIZE, &tiny85);
+    bool import_ok = (EepromImport(&eeprom, EEPROM_DIR "/unit.bin", EEPROM_SIZE, &report) == 0);
+    BenchStop(&sample, &tiny85);
+    import_ok &= EepromMatches(&tiny85, image) && (report.bytes_written == tiny85.GetCounters().eeprom_writes - eeprom_writes_start);
+    Print(sample, &tiny85, eeprom_writes_start, import_ok);
+    all_ok &= import_ok;
+
+    std::string big_path = std::string(root) + EEPROM_DIR "/too-big.bin";
+    file = fopen(big_path.c_str(), "wb");
+    fwrite(file_data, 1, EEPROM_SIZE, file);
+    fputc(0, file);
+    fclose(file);
+    bool rejected = (EepromImport(&eeprom, EEPROM_DIR "/too-big.bin", EEPROM_SIZE, &report) == ERR_EEPROM_IMAGE) &&
+                    EepromMatches(&tiny85, image);
+    printf("%-24s %s\n", EEPROM_DIR "/too-big.bin", rejected ? "rejected" : "NOT REJECTED");
+    all_ok &= rejected;
+
+    SimBus::Get(0)->Detach(&tiny85);
+    unlink(export_path.c_str());
+    unlink(unit_path.c_str());
+    unlink(big_path.c_str());
+    rmdir((std::string(root) + EEPROM_DIR).c_str());
+    rmdir(root);
+    return all_ok;
+}
+
+// One step of a tuning session
+struct TuningOp {
+    bool write;
+    uint16_t addr;
+    uint8_t size;
+    uint8_t data[2];
+};
+
+// Function TuningSession: reads of one parameter, writes that move it up and down (often back to where it was)
+void TuningSession(const uint8_t *start, TuningOp *ops, uint8_t *expected) {
+    memcpy(expected, start, EEPROM_SIZE);
+    uint32_t seed = 12345;
+    for (uint16_t i = 0; i < TUNING_OPS; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint8_t param = (seed >> 16) % TUNING_PARAMS;
+        param = ((seed >> 24) & 1) ? (param % 6) : param; /* Half the session on a few parameters */
+        TuningOp *op = &ops[i];
+        op->write = (((seed >> 8) % 10) < 4);
+        op->addr = TUNING_BASE + (param * 2);
+        op->size = (((seed >> 12) & 3) == 0) ? 1 : 2;
+        if (op->write) {
+            int8_t step = (int8_t)(((seed >> 20) % 3) - 1); /* -1, 0 (unchanged) or +1 */
+            for (uint8_t b = 0; b < op->size; b++) {
+                op->data[b] = (uint8_t)(expected[op->addr + b] + step);
+                expected[op->addr + b] = op->data[b];
+            }
+        }
+    }
+}
+
+// Function RunTuning: the session straight to the device and on the mirror, false on a mismatch
+bool RunTuning(const BenchOptions &options, const uint8_t *image) {
+    static TuningOp ops[TUNING_OPS];
+    uint8_t expected[EEPROM_SIZE], model[EEPROM_SIZE], data[EEPROM_SIZE];
+    TuningSession(image, ops, expected);
+    bool all_ok = true;
+    for (uint8_t mirrored = 0; mirrored <= 1; mirrored++) {
+        TimonelSlave tiny85;
+        BenchSetup(options, &tiny85);
+        memcpy(tiny85.GetEeprom(), image, EEPROM_SIZE);
+        Timonel timonel(SIM_BOOT_ADDR);
+        EepromTransfer eeprom(&timonel, timonel.GetStatus());
+        DeviceCache cache;
+        EepromMirror mirror(&cache, EEPROM_SIZE);
+        EepromReport report;
+        uint32_t eeprom_writes_start = tiny85.GetCounters().eeprom_writes;
+        memcpy(model, image, EEPROM_SIZE); /* What every read must return */
+        bool reads_ok = true;
+        uint8_t twi_errors = 0;
+        BenchSample sample;
+        BenchStart(&sample, mirrored ? "tuning, mirror" : "tuning, direct", TUNING_OPS, &tiny85);
+        for (uint16_t i = 0; i < TUNING_OPS; i++) {
+            const TuningOp &op = ops[i];
+            if ((i % (TUNING_OPS / TUNING_DUMPS)) == 0) {
+                twi_errors |= mirrored ? mirror.Read(&eeprom, 0, data, EEPROM_SIZE) : eeprom.Read(0, data, EEPROM_SIZE);
+                reads_ok &= (memcmp(data, model, EEPROM_SIZE) == 0);
+            }
+            if (op.write) {
+                twi_errors |= mirrored ? mirror.Write(&eeprom, op.addr, op.data, op.size) : eeprom.Program(op.addr, op.data, op.size, &report);
+                memcpy(&model[op.addr], op.data, op.size);
+            } else {
+                uint8_t value[2];
+                twi_errors |= mirrored ? mirror.Read(&eeprom, op.addr, value, op.size) : eeprom.Read(op.addr, value, op.size);
+                reads_ok &= (memcmp(value, &model[op.addr], op.size) == 0);
+            }
+        }
+        if (mirrored) {
+            twi_errors |= mirror.Flush(&eeprom, &report);
+        }
+        BenchStop(&sample, &tiny85);
+        bool data_ok = (twi_errors == 0) && reads_ok && EepromMatches(&tiny85, expected);
+        Print(sample, &tiny85, eeprom_writes_start, data_ok);
+        if (mirrored) {
+            const MirrorStats &stats = mirror.GetStats();
+            printf("%24s %lu loads, %lu bytes read locally, %lu of %lu bytes written absorbed, %lu flushed in %lu runs\n", "",
+                   (unsigned long)stats.loads, (unsigned long)stats.local_reads, (unsigned long)stats.absorbed,
+                   (unsigned long)stats.writes, (unsigned long)stats.flushed, (unsigned long)stats.runs);
+            data_ok &= (stats.loads == 1);
+        }
+        all_ok &= data_ok;
+        SimBus::Get(0)->Detach(&tiny85);
+    }
+    return all_ok;
+}
+
+// Function RunMirrorReset: bytes pending when the device resets are dropped, and the mirror loaded again
+bool RunMirrorReset(const BenchOptions &options, const uint8_t *image) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    memcpy(tiny85.GetEeprom(), image, EEPROM_SIZE);
+    Timonel timonel(SIM_BOOT_ADDR);
+    EepromTransfer eeprom(&timonel, timonel.GetStatus());
+    DeviceCache cache;
+    EepromMirror mirror(&cache, EEPROM_SIZE);
+    uint8_t value = image[TUNING_BASE] ^ 0xFF;
+    bool ok = (mirror.Write(&eeprom, TUNING_BASE, &value, 1) == 0) && (mirror.GetDirty() == 1);
+    value = image[TUNING_BASE + 1];
+    ok &= (mirror.Write(&eeprom, TUNING_BASE + 1, &value, 1) == 0) && (mirror.GetDirty() == 1); /* Unchanged: not dirty */
+    tiny85.PowerCycle();
+    delay(MODE_SWITCH_DLY);
+    cache.Invalidate(); /* As the console does on a reset */
+    tiny85.GetEeprom()[TUNING_BASE + 2] ^= 0x55; /* Changed by the application meanwhile */
+    uint8_t data[EEPROM_SIZE];
+    ok &= (mirror.Read(&eeprom, 0, data, EEPROM_SIZE) == 0) && (mirror.TakeDropped() == 1) && (mirror.GetDirty() == 0) &&
+          (mirror.GetStats().loads == 2) && (memcmp(data, tiny85.GetEeprom(), EEPROM_SIZE) == 0) && (data[TUNING_BASE] == image[TUNING_BASE]);
+    printf("%-24s %s\n", "mirror, device reset", ok ? "pending byte dropped, reloaded" : "MIRROR STALE");
+    SimBus::Get(0)->Detach(&tiny85);
+    return ok;
+}
+
+// EEPROM transfers on the simulated Tiny85: the one-byte-per-command loops
+// the console used ('o' reads, 'p' writes) against EepromTransfer with
+// block commands and with the single byte fallback (a bootloader without
+// EEPROM_BLOCKS). Programming a calibration image on a blank EEPROM and
+// re-programming it with a few bytes changed, then an export / import
+// round trip through LittleFS. Then a parameter tuning session (many
+// small reads and writes to a parameter table, values often rewritten or
+// set back) straight to the device as 'o' and 'p' used to do, against the
+// write-back mirror flushed once at the end, and a mirror whose device
+// resets with bytes pending (they must be dropped, the mirror reloaded).
+// Every EEPROM is checked byte by byte.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    uint8_t blank[EEPROM_SIZE], calibration[EEPROM_SIZE], recalibration[EEPROM_SIZE];
+    memset(blank, 0xFF, sizeof(blank));
+    CalibrationImage(calibration, 0);
+    CalibrationImage(recalibration, 24);
+    bool all_ok = true;
+    BenchBanner(options);
+    BenchHeader();
+    all_ok &= RunReads(options, calibration);
+    printf("\n");
+    all_ok &= RunWrites(options, "'p' WriteEeprom loop", blank, calibration, true, true);
+    all_ok &= RunWrites(options, "Program, single byte", blank, calibration, false, false);
+    all_ok &= RunWrites(options, "Program, block", blank, calibration, false, true);
+    all_ok &= RunWrites(options, "Program 24 changed, byte", calibration, recalibration, false, false);
+    all_ok &= RunWrites(options, "Program 24 changed, blk", calibration, recalibration, false, true);
+    printf("\n");
+    all_ok &= RunImages(options, calibration, recalibration);
+    printf("\n");
+    all_ok &= RunTuning(options, calibration);
+    all_ok &= RunMirrorReset(options, calibration);
+    printf("\n%s\n", all_ok ? "All EEPROM images verified" : "EEPROM MISMATCH");
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-erase.cpp (Native benchmark)
+  ............................................................................
+  Selective erase against DELFLASH on a rework cycle.
+  Usage: bench-erase [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include <string>
+
+#include "bench.h"
+#include "packet-size.h"
+#include "selective-erase.h"
+#include "twi-clock.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+uint8_t app_image[MCU_TOTAL_MEM];
+uint16_t app_size = 0;
+
+// Rework cycle times of a bootloader build (us)
+struct Cycle {
+    uint64_t erase_us = 0, upload_us = 0;
+    bool selective = false;  /* 'u' reported pages erased */
+    bool ok = false;
+};
+
+// Function AreaErased: nothing left below the bootloader, but for the jump to it that Timonel puts at address 0
+bool AreaErased(TimonelSlave *tiny85) {
+    const uint8_t *flash = tiny85->GetFlash();
+    uint16_t boot_jump = ((tiny85->GetBootloaderStart() >> 1) - 1) & 0xFFF;
+    bool reset_vector = ((flash[0] == 0xFF) && (flash[1] == 0xFF)) ||
+                        ((flash[0] == (uint8_t)(boot_jump & 0xFF)) && (flash[1] == (uint8_t)(0xC0 | (boot_jump >> 8))));
+    for (uint16_t addr = 2; addr < tiny85->GetBootloaderStart(); addr++) {
+        if (flash[addr] != 0xFF) {
+            return false;
+        }
+    }
+    return reset_vector;
+}
+
+// Function FlashMatches: the device holds the image (its reset vector is relocated by Timonel)
+bool FlashMatches(TimonelSlave *tiny85) {
+    return memcmp(&tiny85->GetFlash()[2], &app_image[2], app_size - 2) == 0;
+}
+
+// Function RunCommand: type a console command key and run the main loop until it is served
+void RunCommand(const char key, BenchSample *sample, const char *name, const uint32_t bytes, TimonelSlave *tiny85) {
+    const char keys[] = {key, '\0'};
+    USE_SERIAL.Inject(keys);
+    loop(); /* The key is read at the end of a loop pass ... */
+    BenchStart(sample, name, bytes, tiny85);
+    loop(); /* ... and served on the next one */
+    while (CommandPending()) {
+        loop(); /* DELFLASH goes on until the device is back */
+    }
+    BenchStop(sample, tiny85);
+}
+
+// Function RunCycle: flash the payload, then time an erase ("key") and 'w' from the console
+void RunCycle(const BenchOptions &options, const char *name, const char key, const bool force_erase, Cycle *cycle) {
+    TimonelSlave tiny85;
+    if (force_erase) {
+        tiny85.SetFeatures(FEATURES_CODE, EXT_FEATURES | (1 << E_FORCE_ERASE_PG));
+    }
+    BenchSetup(options, &tiny85);
+    ForgetDevice();
+    ForgetClocks();
+    ForgetPackets();
+    setup();
+    BenchSample sample;
+    RunCommand('w', &sample, "'w' first upload", app_size, &tiny85);
+    bool ok = FlashMatches(&tiny85);
+    printf("\n%s", name);
+    BenchHeader();
+    std::string output;
+    USE_SERIAL.SetCapture(&output);
+    RunCommand(key, &sample, (key == 'u') ? "'u' erase used pages" : "'e' erase flash", 0, &tiny85);
+    USE_SERIAL.SetCapture(nullptr);
+    BenchPrint(sample);
+    cycle->erase_us = sample.sim_us;
+    cycle->selective = (output.find("pages erased") != std::string::npos);
+    Timonel timonel(SIM_BOOT_ADDR);
+    ok &= AreaErased(&tiny85) && (timonel.GetStatus().application_start == 0xFFFF) && (output.find("successful") != std::string::npos);
+    RunCommand('w', &sample, "'w' upload again", app_size, &tiny85);
+    BenchPrint(sample);
+    cycle->upload_us = sample.sim_us;
+    ok &= FlashMatches(&tiny85);
+    size_t line = output.find("successful");
+    printf("%24s%s\n", "", (line != std::string::npos) ? output.substr(line, output.find('\n', line) - line).c_str() : " no result");
+    cycle->ok = ok && (cycle->selective == (force_erase && (key == 'u')));
+    SimBus::Get(0)->Detach(&tiny85);
+}
+
+// What a selective erase must decide
+enum Outcome {
+    ERASE_PAGES,   /* Erase the pages, faster than DELFLASH */
+    USE_DELFLASH,  /* DELFLASH is faster, nothing written */
+    EITHER         /* Close to the break-even, one or the other */
+};
+
+// An occupied pages case
+struct Extent {
+    const char *name;
+    bool manifest;     /* The payload manifest is passed */
+    bool read_flash;   /* The bootloader has READFLSH */
+    uint8_t gap;       /* Pages are written from this many pages past the image, 0 = none */
+    uint8_t extra;     /* How many */
+    bool other_image;  /* The device holds an image the manifest doesn't describe */
+    Outcome outcome;
+};
+
+// Function RunBlankPage0: a blank page 0 written alone must get an application start (the reset vector is relocated)
+bool RunBlankPage0(const BenchOptions &options) {
+    TimonelSlave tiny85;
+    tiny85.SetFeatures(FEATURES_CODE, EXT_FEATURES | (1 << E_FORCE_ERASE_PG));
+    BenchSetup(options, &tiny85);
+    ForgetPackets();
+    Timonel timonel(SIM_BOOT_ADDR);
+    uint8_t blank[SPM_PAGESIZE];
+    memset(blank, 0xFF, SPM_PAGESIZE);
+    BenchSample sample;
+    BenchStart(&sample, "blank page 0 alone", SPM_PAGESIZE, &tiny85);
+    uint8_t errors = UploadAt(&timonel, blank, SPM_PAGESIZE, 0);
+    BenchStop(&sample, &tiny85);
+    BenchPrint(sample);
+    uint16_t app_start = timonel.GetStatus().application_start;
+    bool ok = (errors == 0) && (app_start != 0xFFFF);
+    printf("%24s application start 0x%04X: %s\n", "", app_start, ok ? "relocated, the trampoline must go after page 0" : "NOT RELOCATED");
+    SimBus::Get(0)->Detach(&tiny85);
+    return ok;
+}
+
+// Function RunExtent: one way of finding the occupied pages, on a FORCE_ERASE_PG device holding the payload.
+// An erase done must beat "delflash_us".
+bool RunExtent(const BenchOptions &options, const Extent &extent, const uint64_t delflash_us) {
+    TimonelSlave tiny85;
+    uint8_t features = extent.read_flash ? FEATURES_CODE : (FEATURES_CODE & ~(1 << F_CMD_READFLASH));
+    tiny85.SetFeatures(features, EXT_FEATURES | (1 << E_FORCE_ERASE_PG));
+    BenchSetup(options, &tiny85);
+    ForgetPackets();
+    Timonel timonel(SIM_BOOT_ADDR);
+    static uint8_t image[MCU_TOTAL_MEM];
+    memcpy(image, app_image, app_size);
+    if (extent.other_image) {
+        image[0] ^= 0x01; /* Another reset vector, another application start */
+    }
+    RawPayload payload(image, app_size);
+    bool ok = (UploadPages(&timonel, &payload) == 0);
+    uint16_t image_end = ((app_size + SPM_PAGESIZE - 1) / SPM_PAGESIZE) * SPM_PAGESIZE;
+    uint16_t pages = (image_end / SPM_PAGESIZE) + 1; /* The trampoline page too */
+    uint16_t stray_addr = 0; /* A page past a blank one, left by the erase */
+    if (extent.gap != 0) {
+        static uint8_t extra[MCU_TOTAL_MEM];
+        memset(extra, 0x5A, extent.extra * SPM_PAGESIZE);
+        uint16_t extra_addr = image_end + (extent.gap - 1) * SPM_PAGESIZE;
+        ok &= (UploadAt(&timonel, extra, extent.extra * SPM_PAGESIZE, extra_addr) == 0);
+        if (extent.gap == 1) {
+            image_end += extent.extra * SPM_PAGESIZE;
+            pages += extent.extra;
+        } else {
+            stray_addr = extra_addr;
+        }
+    }
+    Timonel::Status sts = timonel.GetStatus();
+    const ImageManifest *manifest = extent.manifest ? SelectedManifest() : nullptr;
+    bool can = CanEraseSelective(sts, manifest);
+    bool expect_can = !(extent.other_image && !extent.read_flash);
+    BenchSample sample;
+    EraseReport report;
+    uint32_t page_writes = tiny85.GetCounters().page_writes;
+    BenchStart(&sample, extent.name, 0, &tiny85);
+    uint8_t errors = EraseOccupied(&timonel, sts, manifest, &report);
+    BenchStop(&sample, &tiny85);
+    BenchPrint(sample);
+    if (report.slower || (extent.outcome == USE_DELFLASH)) {
+        ok &= can && (errors == ERR_NO_SELECTIVE) && report.slower && (extent.outcome != ERASE_PAGES) &&
+              (tiny85.GetCounters().page_writes == page_writes) && FlashMatches(&tiny85);
+        printf("%24s %lu ms of page erases expected after %d read, DELFLASH %lu ms: DELFLASH, nothing written: %s\n", "",
+               (unsigned long)(report.estimate_us / 1000), report.pages_read, (unsigned long)(report.delflash_us / 1000),
+               ok ? "yes" : "NO");
+        SimBus::Get(0)->Detach(&tiny85);
+        return ok;
+    }
+    if (!expect_can) {
+        ok &= !can && (errors == ERR_NO_SELECTIVE) && (sample.bus.transactions == 0) && FlashMatches(&tiny85);
+        printf("%24s refused, nothing sent: %s\n", "", ok ? "yes" : "NO");
+        SimBus::Get(0)->Detach(&tiny85);
+        return ok;
+    }
+    bool stray_left = (stray_addr != 0) && (tiny85.GetFlash()[stray_addr] == 0x5A);
+    if (stray_left) {
+        memset(tiny85.GetFlash() + stray_addr, 0xFF, SPM_PAGESIZE); /* The rest must be erased */
+    }
+    ok &= can && (errors == 0) && AreaErased(&tiny85) && (stray_left == (stray_addr != 0)) && (report.extent_end == image_end) &&
+          (report.pages == pages) && (report.from_manifest == (extent.manifest && !extent.other_image)) &&
+          (report.partial == !extent.read_flash) && (timonel.GetStatus().application_start == 0xFFFF) &&
+          (sample.sim_us < delflash_us);
+    printf("%24s %d of %d pages erased, %d read, last page 0x%04X%s, area %s%s, %lu ms expected%s\n", "", report.pages,
+           report.full_pages, report.pages_read, report.extent_end - SPM_PAGESIZE, report.partial ? " (partial)" : "",
+           AreaErased(&tiny85) ? "erased" : "NOT ERASED", stray_left ? ", page past the blank one left" : "",
+           (unsigned long)(report.estimate_us / 1000), ok ? "" : " UNEXPECTED");
+    SimBus::Get(0)->Detach(&tiny85);
+    return ok;
+}
+
+// Selective erase against DELFLASH: the demo setup() runs with a
+// simulated Tiny85 that holds the payload, then it is erased and 'w'
+// writes it again, as a board going round a rework cycle. On a
+// FORCE_ERASE_PG bootloader 'e' erases the whole application area
+// (DELFLASH) and 'u' only the pages the payload occupies; without it 'u'
+// must fall back to DELFLASH. Each cycle is timed and checked: the area
+// below the bootloader must read blank after the erase (but for the
+// jump to the bootloader at address 0), with no application start, and
+// hold the payload again after 'w'. The simulated bootloader relocates
+// the reset vector of any page 0 written, a blank one too, which must
+// give it an application start: the erase has to clear the trampoline
+// page after page 0. Then the occupied pages are found each way on its
+// own, at the bench clock: from the payload manifest, with a page
+// written past the image (read up to the first blank page) and with a
+// blank page between the image and another page (that one is left),
+// from the manifest alone on a bootloader without READFLSH (reported
+// partial). An erase done must be faster than the 'e' DELFLASH. Too many
+// pages past the manifest, or no manifest at all (every page read), must
+// be found slower than DELFLASH with nothing written, and a device whose
+// image the manifest doesn't describe and can't be read must be refused
+// with nothing sent.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    BenchBanner(options);
+    printf("Payload: %d bytes, %d pages\n", app_size, (app_size + SPM_PAGESIZE - 1) / SPM_PAGESIZE);
+    Cycle full, selective, fallback;
+    RunCycle(options, "DELFLASH, FORCE_ERASE_PG", 'e', true, &full);
+    RunCycle(options, "Selective, FORCE_ERASE_PG", 'u', true, &selective);
+    RunCycle(options, "No FORCE_ERASE_PG: DELFLASH", 'u', false, &fallback);
+
+    printf("\nOccupied pages, FORCE_ERASE_PG");
+    BenchHeader();
+    bool all_ok = full.ok && selective.ok && fallback.ok && RunBlankPage0(options);
+    const Extent extents[] = {
+        {"manifest", true, true, 0, 0, false, ERASE_PAGES},
+        {"manifest, page past it", true, true, 1, 1, false, EITHER},
+        {"manifest, blank page gap", true, true, 2, 1, false, ERASE_PAGES},
+        {"manifest, no READFLSH", true, false, 0, 0, false, ERASE_PAGES},
+        {"manifest, 30 pages past", true, true, 1, 30, false, USE_DELFLASH},
+        {"readback, no manifest", false, true, 0, 0, false, USE_DELFLASH},
+        {"other image, no READFLSH", true, false, 0, 0, true, ERASE_PAGES},
+    };
+    for (uint8_t ix = 0; ix < (sizeof(extents) / sizeof(extents[0])); ix++) {
+        all_ok &= RunExtent(options, extents[ix], full.erase_us); /* The console 'e' DELFLASH */
+    }
+
+    printf("\n%-12s %10s %10s %10s\n", "cycle", "erase ms", "upload ms", "total ms");
+    printf("%-12s %10.1f %10.1f %10.1f\n", "DELFLASH", full.erase_us / 1000.0, full.upload_us / 1000.0,
+           (full.erase_us + full.upload_us) / 1000.0);
+    printf("%-12s %10.1f %10.1f %10.1f\n", "selective", selective.erase_us / 1000.0, selective.upload_us / 1000.0,
+           (selective.erase_us + selective.upload_us) / 1000.0);
+    double erase_gain = (selective.erase_us > 0) ? ((double)full.erase_us / selective.erase_us) : 0;
+    double cycle_gain = ((selective.erase_us + selective.upload_us) > 0)
+                            ? ((double)(full.erase_us + full.upload_us) / (selective.erase_us + selective.upload_us))
+                            : 0;
+    printf("%-12s %9.2fx %10s %9.2fx\n", "speedup", erase_gain, "", cycle_gain);
+    all_ok &= (erase_gain > 1.0);
+    printf("\n%s\n", all_ok ? "Every erase left the application area blank" : "ERASE MISMATCH");
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-hostlink.cpp (Native benchmark)
+  ............................................................................
+  Loopback test of the framed host protocol.
+  Usage: bench-hostlink [--turnaround-us=us] [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+         (--turnaround-us: host reaction time to a reply, default 1000, USB serial latency)
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include <vector>
+
+#include "bench.h"
+#include "eeprom-image.h"
+#include "flash-dump.h"
+#include "flash-sync.h"
+#include "host-link.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+// Host end of the console: queued requests, a window of them in flight, go-back-N on NAKs and timeouts
+class HostClient : public SerialPeer {
+   public:
+    struct Request {
+        uint8_t opcode = 0, id = 0;
+        bool pipelined = false;             /* Page writes may share the window */
+        std::vector<uint8_t> frame;         /* Encoded, with delimiters */
+        bool done = false;
+        uint8_t status = 0;
+        std::vector<uint8_t> reply;         /* Reply data after the status */
+        uint64_t sent_us = 0, replied_us = 0;
+    };
+    HostClient(const uint8_t window, const uint32_t turnaround_us) : window_(window), turnaround_us_(turnaround_us) {}
+    size_t Add(const uint8_t opcode, const std::vector<uint8_t> &args, const bool pipelined = false) {
+        Request request;
+        request.opcode = opcode;
+        request.id = next_id_++;
+        request.pipelined = pipelined;
+        uint8_t body[HOST_FRAME_MAX], encoded[HOST_ENCODED_MAX];
+        body[0] = HOST_VERSION;
+        body[1] = opcode;
+        body[2] = request.id;
+        memcpy(&body[3], args.data(), args.size());
+        uint16_t crc = Crc16(0xFFFF, body, args.size() + 3);
+        body[args.size() + 3] = (crc & 0xFF);
+        body[args.size() + 4] = (crc >> 8);
+        uint8_t size = CobsEncode(body, args.size() + 5, encoded);
+        request.frame.push_back(HOST_DELIMITER);
+        request.frame.insert(request.frame.end(), encoded, encoded + size);
+        request.frame.push_back(HOST_DELIMITER);
+        requests_.push_back(request);
+        return requests_.size() - 1;
+    }
+    void Start(void) { Pump(SimClock::Now()); }
+    bool Finished(void) const { return oldest_ == requests_.size(); }
+    const Request &Get(const size_t ix) const { return requests_[ix]; }
+    void CorruptOnce(const size_t ix) { corrupt_ix_ = ix; }
+    void DropReplyOnce(const size_t ix) { drop_ix_ = ix; }
+    uint32_t GetRetransmits(void) const { return retransmits_; }
+    uint32_t GetBytesSent(void) const { return bytes_sent_; }
+    // SerialPeer: master output, byte by byte as it leaves the line
+    void Received(const uint8_t data, const uint64_t at_us) {
+        if (data != HOST_DELIMITER) {
+            if (raw_.size() < HOST_ENCODED_MAX) {
+                raw_.push_back(data);
+            }
+            return;
+        }
+        uint8_t body[HOST_ENCODED_MAX];
+        uint8_t size = raw_.empty() ? 0 : CobsDecode(raw_.data(), raw_.size(), body);
+        raw_.clear();
+        if ((size < 6) || (body[0] != HOST_VERSION) || (Crc16(0xFFFF, body, size - 2) != (body[size - 2] | (body[size - 1] << 8)))) {
+            return; /* Console text or line noise, the timeout takes care of it */
+        }
+        if (oldest_ == requests_.size()) {
+            return;
+        }
+        Request &oldest = requests_[oldest_];
+        if (body[1] == (HOST_NAK | HOST_REPLY)) {
+            GoBack(at_us);
+            return;
+        }
+        if ((body[1] != (oldest.opcode | HOST_REPLY)) || (body[2] != oldest.id)) {
+            return; /* Stale reply to a request sent again */
+        }
+        if (oldest_ == drop_ix_) {
+            drop_ix_ = SIZE_MAX; /* Lost on the way to the host */
+            return;
+        }
+        oldest.done = true;
+        oldest.status = body[3];
+        oldest.reply.assign(&body[4], &body[size - 2]);
+        oldest.replied_us = at_us;
+        oldest_++;
+        if ((oldest.status != 0) && oldest.pipelined) {
+            oldest_ = next_ = requests_.size(); /* A failed page ends the script */
+        }
+        Pump(at_us + turnaround_us_);
+    }
+    // SerialPeer: reply timeout, everything in flight goes again
+    void Idle(const uint64_t now_us) {
+        const uint64_t timeout_us = requests_[oldest_].pipelined ? 500000 : 5000000;
+        if ((oldest_ < next_) && (now_us > (requests_[oldest_].sent_us + timeout_us))) {
+            GoBack(now_us);
+        }
+    }
+
+   private:
+    void GoBack(const uint64_t at_us) {
+        retransmits_ += next_ - oldest_;
+        next_ = oldest_;
+        Pump(at_us + turnaround_us_);
+    }
+    void Pump(const uint64_t at_us) {
+        while (next_ < requests_.size()) {
+            Request &request = requests_[next_];
+            uint32_t in_flight = next_ - oldest_;
+            if ((in_flight > 0) && !(request.pipelined && requests_[oldest_].pipelined && (in_flight < window_))) {
+                break;
+            }
+            std::vector<uint8_t> frame = request.frame;
+            if (next_ == corrupt_ix_) {
+                corrupt_ix_ = SIZE_MAX;
+                frame[frame.size() / 2] ^= 0x10;
+            }
+            Serial.Send(frame.data(), frame.size(), at_us);
+            bytes_sent_ += frame.size();
+            request.sent_us = (at_us > SimClock::Now()) ? at_us : SimClock::Now();
+            next_++;
+        }
+    }
+    std::vector<Request> requests_;
+    std::vector<uint8_t> raw_;
+    size_t oldest_ = 0, next_ = 0;
+    size_t corrupt_ix_ = SIZE_MAX, drop_ix_ = SIZE_MAX;
+    uint8_t window_, next_id_ = 1;
+    uint32_t turnaround_us_;
+    uint32_t retransmits_ = 0, bytes_sent_ = 0;
+};
+
+static std::vector<uint8_t> Args16(const uint16_t a, const uint16_t b) {
+    return std::vector<uint8_t>{(uint8_t)(a & 0xFF), (uint8_t)(a >> 8), (uint8_t)(b & 0xFF), (uint8_t)(b >> 8)};
+}
+
+enum Fault { NO_FAULT, CORRUPT_REQUEST, LOST_REPLY };
+
+// Function RunSession: full scripted session against a fresh device, false on any failed step or mismatch
+bool RunSession(const BenchOptions &options, const char *name, const uint8_t window, const uint32_t turnaround_us,
+                const Fault fault, uint64_t *upload_us) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    uint8_t app_image[MCU_TOTAL_MEM];
+    uint16_t app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    memset(&app_image[app_size], 0xFF, sizeof(app_image) - app_size);
+    uint16_t padded_size = ((app_size + SPM_PAGESIZE - 1) / SPM_PAGESIZE) * SPM_PAGESIZE;
+    Timonel *timonel = new Timonel(SIM_BOOT_ADDR);
+    bool app_mode = false;
+    DeviceCache cache;
+    HostTarget target = {&timonel, &app_mode, &cache, 0, 0};
+
+    HostClient host(window, turnaround_us);
+    host.Add(HOST_HELLO, {});
+    host.Add(HOST_ERASE, {});
+    size_t begin_ix = host.Add(HOST_BEGIN, Args16(0x0000, padded_size));
+    size_t first_page = begin_ix + 1;
+    for (uint16_t addr = 0; addr < padded_size; addr += SPM_PAGESIZE) {
+        std::vector<uint8_t> args = {(uint8_t)(addr & 0xFF), (uint8_t)(addr >> 8)};
+        args.insert(args.end(), &app_image[addr], &app_image[addr + SPM_PAGESIZE]);
+        host.Add(HOST_PAGE, args, true);
+    }
+    uint16_t image_crc = Crc16(0xFFFF, app_image, padded_size);
+    size_t finish_ix = host.Add(HOST_FINISH, {(uint8_t)(image_crc & 0xFF), (uint8_t)(image_crc >> 8)});
+    std::vector<uint8_t> verify = Args16(0x0000, padded_size);
+    verify.insert(verify.end(), {(uint8_t)(image_crc & 0xFF), (uint8_t)(image_crc >> 8), app_image[0], app_image[1]});
+    host.Add(HOST_VERIFY, verify);
+    size_t read_ix = host.Add(HOST_READ, {0x40, 0x00, HOST_DATA_MAX});
+    const std::vector<uint8_t> ee_data = {'h', 'o', 's', 't', '-', 'l', 'i', 'n', 'k'};
+    std::vector<uint8_t> ee_write = {0x20, 0x00};
+    ee_write.insert(ee_write.end(), ee_data.begin(), ee_data.end());
+    host.Add(HOST_EE_WRITE, ee_write);
+    size_t ee_read_ix = host.Add(HOST_EE_READ, {0x20, 0x00, (uint8_t)ee_data.size()});
+    size_t run_ix = host.Add(HOST_RUN, {});
+    host.Add(HOST_QUIT, {});
+    if (fault == CORRUPT_REQUEST) {
+        host.CorruptOnce(first_page + 5);
+    } else if (fault == LOST_REPLY) {
+        host.DropReplyOnce(first_page + 7);
+    }
+
+    Serial.SetPeer(&host);
+    HostLink link(&Serial, &target);
+    uint64_t start_us = SimClock::Now();
+    host.Start();
+    link.Serve();
+    uint64_t session_us = SimClock::Now() - start_us;
+    Serial.SetPeer(nullptr);
+
+    bool session_ok = host.Finished();
+    for (size_t ix = 0; session_ok && (ix < run_ix + 2); ix++) {
+        session_ok &= host.Get(ix).done && (host.Get(ix).status == 0);
+    }
+    *upload_us = host.Get(finish_ix).replied_us - host.Get(begin_ix).sent_us;
+    bool flash_ok = session_ok; /* The verify request checked the trampoline */
+    for (uint16_t i = 2; i < tiny85.GetBootloaderStart() - SPM_PAGESIZE; i++) {
+        flash_ok &= (tiny85.GetFlash()[i] == app_image[i]);
+    }
+    flash_ok &= (host.Get(read_ix).reply.size() == HOST_DATA_MAX + 2) &&
+                (memcmp(&host.Get(read_ix).reply[2], &app_image[0x40], HOST_DATA_MAX) == 0);
+    flash_ok &= (host.Get(ee_read_ix).reply.size() == ee_data.size() + 2) &&
+                (memcmp(&host.Get(ee_read_ix).reply[2], ee_data.data(), ee_data.size()) == 0) &&
+                (memcmp(&tiny85.GetEeprom()[0x20], ee_data.data(), ee_data.size()) == 0);
+    flash_ok &= app_mode && (tiny85.GetMode() == TimonelSlave::APPLICATION);
+    const HostStats &stats = link.GetStats();
+    printf("%-26s %8.1f %8.1f %8.0f %6lu %6lu %5lu %6lu %6lu %7lu %s\n", name, session_us / 1000.0, *upload_us / 1000.0,
+           padded_size * 1000000.0 / *upload_us, (unsigned long)stats.frames_rx, (unsigned long)stats.pages,
+           (unsigned long)stats.overlapped, (unsigned long)stats.bad_frames, (unsigned long)stats.repeats,
+           (unsigned long)host.GetRetransmits(), flash_ok ? "verified" : "SESSION FAILED");
+    if (!session_ok) {
+        for (size_t ix = 0; ix < run_ix + 2; ix++) {
+            if (!host.Get(ix).done || (host.Get(ix).status != 0)) {
+                printf("%26s request %lu '%c' %s, status 0x%02X\n", "", (unsigned long)ix, host.Get(ix).opcode,
+                       host.Get(ix).done ? "failed" : "not answered", host.Get(ix).status);
+                break;
+            }
+        }
+    }
+    delete timonel;
+    SimBus::Get(0)->Detach(&tiny85);
+    return flash_ok;
+}
+
+// Loopback test of the framed host protocol. A host client (the same
+// logic as timonel-host.py) sits at the far end of the modelled 115200 bps
+// console and drives a host link session on the master: hello, erase,
+// upload, finish, verify, flash and EEPROM reads, an EEPROM write and run.
+// The upload is timed with one page frame in flight (receive, then write)
+// and with the pipelined window, and repeated with a corrupted request
+// and a lost reply, which must be recovered by retransmission. The
+// device flash is checked against the image after every upload.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    unsigned long turnaround_us = 1000;
+    for (int i = 1; i < argc; i++) {
+        sscanf(argv[i], "--turnaround-us=%lu", &turnaround_us);
+    }
+    bool all_ok = true;
+    BenchBanner(options);
+    printf("Console: %d bps, host turnaround %lu us, frames: %d data bytes max, window %d\n\n", SERIAL_BPS, turnaround_us,
+           HOST_DATA_MAX, HOST_SLOTS);
+    printf("%-26s %8s %8s %8s %6s %6s %5s %6s %6s %7s\n", "session", "total ms", "upl ms", "upl B/s", "frames", "pages",
+           "ovlp", "nak", "repeat", "resent");
+    uint64_t sequential_us = 0, pipelined_us = 0, fault_us = 0;
+    all_ok &= RunSession(options, "receive, then write", 1, turnaround_us, NO_FAULT, &sequential_us);
+    all_ok &= RunSession(options, "pipelined", HOST_SLOTS, turnaround_us, NO_FAULT, &pipelined_us);
+    all_ok &= RunSession(options, "pipelined, corrupt frame", HOST_SLOTS, turnaround_us, CORRUPT_REQUEST, &fault_us);
+    all_ok &= RunSession(options, "pipelined, lost reply", HOST_SLOTS, turnaround_us, LOST_REPLY, &fault_us);
+    printf("\nPipelined upload: %.2fx the receive-then-write throughput\n", (double)sequential_us / pipelined_us);
+    printf("%s\n", all_ok ? "All host link sessions verified" : "HOST LINK FAILURE");
+    return all_ok ? 0 : 1;
+}
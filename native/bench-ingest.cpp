@@ -0,0 +1,208 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-ingest.cpp (Native benchmark)
+  ............................................................................
+  Payload library ingest: HEX and binary files turned into pages and
+  flashed.
+  Usage: bench-ingest [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include <malloc.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "bench.h"
+#include "flash-sync.h"
+#include "payload-store.h"
+
+#define INGEST_ROUNDS 200
+
+struct Segment {
+    uint16_t start, size;
+};
+
+// Function FillImage: pseudo-random code-like bytes in the segments, 0xFF elsewhere
+void FillImage(uint8_t *image, const Segment *segments, const uint8_t count) {
+    uint32_t seed = 0x85;
+    memset(image, 0xFF, MCU_TOTAL_MEM);
+    for (uint8_t s = 0; s < count; s++) {
+        for (uint16_t i = 0; i < segments[s].size; i++) {
+            seed = seed * 1103515245 + 12345;
+            image[segments[s].start + i] = (uint8_t)(seed >> 16);
+        }
+    }
+    image[0] = 0x0E; /* rjmp to the application, for the trampoline check */
+    image[1] = 0xC0;
+}
+
+// Function WriteHex: Intel HEX file of the segments, optionally swapping two records
+void WriteHex(const std::string &path, const uint8_t *image, const Segment *segments, const uint8_t count,
+              const uint8_t record_size, const bool swap_records) {
+    std::string records[512];
+    uint16_t record_count = 0;
+    for (uint8_t s = 0; s < count; s++) {
+        for (uint16_t offset = 0; offset < segments[s].size; offset += record_size) {
+            uint16_t addr = segments[s].start + offset;
+            uint8_t size = ((segments[s].size - offset) < record_size) ? (segments[s].size - offset) : record_size;
+            uint8_t checksum = size + (addr >> 8) + (addr & 0xFF);
+            char text[16];
+            snprintf(text, sizeof(text), ":%02X%04X00", size, addr);
+            records[record_count] = text;
+            for (uint8_t i = 0; i < size; i++) {
+                snprintf(text, sizeof(text), "%02X", image[addr + i]);
+                records[record_count] += text;
+                checksum += image[addr + i];
+            }
+            snprintf(text, sizeof(text), "%02X\r\n", (uint8_t)(-checksum));
+            records[record_count++] += text;
+        }
+    }
+    if (swap_records) {
+        records[2].swap(records[record_count - 2]);
+    }
+    FILE *file = fopen(path.c_str(), "w");
+    fputs(":020000040000FA\r\n", file);
+    for (uint16_t i = 0; i < record_count; i++) {
+        fputs(records[i].c_str(), file);
+    }
+    fputs(":00000001FF\r\n", file);
+    fclose(file);
+}
+
+// Function IngestPass: one pass over a payload file, returns the peak heap growth over "heap_start"
+size_t IngestPass(FilePayload *source, uint16_t *pages, const size_t heap_start) {
+    size_t heap_peak = 0;
+    uint16_t flash_addr = 0, size = 0;
+    uint8_t *data = nullptr;
+    *pages = 0;
+    source->Rewind();
+    while (source->NextBlock(&flash_addr, &data, &size)) {
+        size_t heap = mallinfo2().uordblks;
+        if ((heap > heap_start) && ((heap - heap_start) > heap_peak)) {
+            heap_peak = heap - heap_start;
+        }
+        (*pages)++;
+    }
+    return heap_peak;
+}
+
+// Function RunPayload: ingest figures and a verified upload, false on any mismatch
+bool RunPayload(const BenchOptions &options, const char *path, const uint8_t *image) {
+    // The open file heap (host stdio FILE and its buffer) counts, a second pass must not add any
+    size_t heap_start = mallinfo2().uordblks;
+    FilePayload source;
+    if (!source.Open(path)) {
+        printf("%-24s can't open\n", path);
+        return false;
+    }
+    uint16_t pages = 0;
+    size_t first_heap = IngestPass(&source, &pages, heap_start);
+    size_t steady_heap = IngestPass(&source, &pages, mallinfo2().uordblks);
+    clock_t start = clock();
+    for (uint16_t round = 0; round < INGEST_ROUNDS; round++) {
+        IngestPass(&source, &pages, 0);
+    }
+    double cpu_s = (double)(clock() - start) / CLOCKS_PER_SEC;
+    File file = LittleFS.open(path, "r");
+    size_t file_size = file.size();
+    file.close();
+
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    Timonel timonel(SIM_BOOT_ADDR);
+    BenchSample sample;
+    BenchStart(&sample, path, source.GetImageSize(), &tiny85);
+    uint8_t twi_errors = UploadPages(&timonel, &source);
+    BenchStop(&sample, &tiny85);
+    bool flash_ok = (twi_errors == 0) && (steady_heap == 0);
+    if (image[0] != 0xFF) {
+        sample.page_writes--; /* Not counting the trampoline page */
+        flash_ok &= (timonel.GetStatus().application_start == TrampolineFor(image, tiny85.GetBootloaderStart()));
+    }
+    for (uint16_t i = 2; i < tiny85.GetBootloaderStart() - SPM_PAGESIZE; i++) {
+        flash_ok &= (tiny85.GetFlash()[i] == image[i]);
+    }
+    flash_ok &= (sample.page_writes == pages);
+    SimBus::Get(0)->Detach(&tiny85);
+    BenchPrint(sample);
+    printf("%24s %s: %lu file bytes -> %d pages, ingest %.2f MB/s (%.0f pages/s, host), heap %lu bytes (open file), +%lu next pass,"
+           " working set %lu bytes vs %lu to load the file%s\n",
+           "", source.IsHex() ? "hex" : "bin", (unsigned long)file_size, pages,
+           file_size * INGEST_ROUNDS / cpu_s / 1000000.0, pages * INGEST_ROUNDS / cpu_s, (unsigned long)first_heap,
+           (unsigned long)steady_heap, (unsigned long)sizeof(FilePayload), (unsigned long)(file_size + MCU_TOTAL_MEM),
+           flash_ok ? "" : " FLASH MISMATCH");
+    return flash_ok;
+}
+
+// Function Rejected: a broken file must not upload
+bool Rejected(const char *path) {
+    TimonelSlave tiny85;
+    SimBus::Get(0)->Attach(&tiny85);
+    Timonel timonel(SIM_BOOT_ADDR);
+    FilePayload source;
+    bool rejected = source.Open(path) && (UploadPages(&timonel, &source) == ERR_BAD_PAYLOAD);
+    SimBus::Get(0)->Detach(&tiny85);
+    printf("%-24s %s\n", path, rejected ? "rejected" : "NOT REJECTED");
+    return rejected;
+}
+
+// Payload library ingest: writes a full Intel HEX image, a sparse one
+// (non-zero start, holes, a record across a page boundary) and a raw
+// binary into a scratch directory mounted as LittleFS, then measures how
+// fast FilePayload turns them into pages (host CPU) and the peak heap it
+// needs, against loading the whole file. Each image is then flashed on the
+// simulated Tiny85 and checked byte by byte; a corrupted and an unordered
+// HEX file must be rejected.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    char root[] = "/tmp/timonel-fs-XXXXXX";
+    if (mkdtemp(root) == nullptr) {
+        perror("mkdtemp");
+        return 1;
+    }
+    std::string dir = std::string(root) + PAYLOAD_DIR;
+    mkdir(dir.c_str(), 0755);
+
+    static uint8_t full[MCU_TOTAL_MEM], sparse[MCU_TOTAL_MEM];
+    const Segment full_segments[] = {{0x0000, 0x1A00 - SPM_PAGESIZE}};
+    const Segment sparse_segments[] = {{0x0230, 0x03D0}, {0x0A10, 0x0020}, {0x1400, 0x0400}};
+    FillImage(full, full_segments, 1);
+    FillImage(sparse, sparse_segments, 3);
+    sparse[0] = sparse[1] = 0xFF;
+    WriteHex(dir + "/full.hex", full, full_segments, 1, 16, false);
+    WriteHex(dir + "/sparse.hex", sparse, sparse_segments, 3, 32, false);
+    WriteHex(dir + "/unordered.hex", sparse, sparse_segments, 3, 32, true);
+    FILE *file = fopen((dir + "/full.bin").c_str(), "wb");
+    fwrite(full, 1, full_segments[0].size, file);
+    fclose(file);
+    file = fopen((dir + "/corrupted.hex").c_str(), "w");
+    fputs(":100000000EC028C027C026C025C024C023C022C0DE\r\n:00000001FF\r\n", file);
+    fclose(file);
+
+    LittleFS.SetRoot(root);
+    PayloadStoreBegin();
+    bool all_ok = true;
+    BenchBanner(options);
+    BenchHeader();
+    all_ok &= RunPayload(options, PAYLOAD_DIR "/full.hex", full);
+    all_ok &= RunPayload(options, PAYLOAD_DIR "/sparse.hex", sparse);
+    all_ok &= RunPayload(options, PAYLOAD_DIR "/full.bin", full);
+    printf("\n");
+    all_ok &= Rejected(PAYLOAD_DIR "/corrupted.hex");
+    all_ok &= Rejected(PAYLOAD_DIR "/unordered.hex");
+
+    const char *names[] = {"full.hex", "sparse.hex", "unordered.hex", "full.bin", "corrupted.hex"};
+    for (uint8_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        unlink((dir + "/" + names[i]).c_str());
+    }
+    rmdir(dir.c_str());
+    rmdir(root);
+    printf("\n%s\n", all_ok ? "All flash images verified" : "FLASH MISMATCH");
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-jobs.cpp (Native benchmark)
+  ............................................................................
+  Console response while long commands run on the simulated Tiny85.
+  Usage: bench-jobs [--queries=n] [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include <Preferences.h>
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "console-job.h"
+
+#define PROMPT_WAIT_MS 10000  // Time a number prompt is left waiting (virtual ms)
+
+// Keys pressed at set times, and when the console answered them
+class Typist : public SerialPeer {
+   public:
+    struct KeyPress {
+        uint64_t arrived_us = 0;  /* Last bit of the key on the ESP32 RX pin */
+        uint64_t answered_us = 0; /* First byte of the answer on the TX pin, 0 if none */
+    };
+    // Press "key" at "at_us", an answer starts with "answer"
+    void PressAt(const char key, const uint64_t at_us, const char *answer) {
+        USE_SERIAL.Send((const uint8_t *)&key, 1, at_us);
+        Typist::KeyPress press;
+        press.arrived_us = at_us + (10 * 1000000ULL) / SERIAL_BPS;
+        presses_.push_back(press);
+        answer_ = answer;
+    }
+    void Clear(void) {
+        presses_.clear();
+        next_ = 0;
+        seen_.clear();
+    }
+    const std::vector<Typist::KeyPress> &GetPresses(void) const { return presses_; }
+    // SerialPeer: master output, byte by byte as it leaves the line
+    void Received(const uint8_t data, const uint64_t at_us) {
+        if (next_ >= presses_.size()) {
+            return;
+        }
+        if (seen_.empty()) {
+            first_us_ = at_us;
+        }
+        seen_ += (char)data;
+        if (strncmp(seen_.c_str(), answer_, seen_.size()) != 0) {
+            seen_.clear(); /* Not the answer, e.g. progress */
+            if (data == answer_[0]) {
+                seen_ += (char)data;
+                first_us_ = at_us;
+            }
+            return;
+        }
+        if (seen_.size() == strlen(answer_)) {
+            presses_[next_++].answered_us = first_us_;
+            seen_.clear();
+        }
+    }
+
+   private:
+    std::vector<KeyPress> presses_;
+    size_t next_ = 0;
+    const char *answer_ = "";
+    std::string seen_;
+    uint64_t first_us_ = 0;
+};
+
+// Console latency of the keys pressed during a command
+struct Latency {
+    const char *name;
+    uint16_t pressed = 0, answered = 0;
+    double min_ms = 0, avg_ms = 0, max_ms = 0;
+    double blocked_ms = 0; /* Average wait until the command ended */
+};
+
+extern Prompt prompt;
+
+// Function TypeCommand: type console keys and run the main loop until they are served
+void TypeCommand(const char *keys) {
+    USE_SERIAL.Inject(keys);
+    loop(); /* A key is read at the end of a loop pass ... */
+    for (size_t ix = 0; ix < strlen(keys); ix++) {
+        loop(); /* ... and served on the next one */
+    }
+    while (CommandPending()) {
+        loop();
+    }
+}
+
+// Function Measure: latencies of the keys pressed during a command that ended at "end_us"
+Latency Measure(const char *name, const Typist &typist, const uint64_t end_us) {
+    Latency latency;
+    latency.name = name;
+    latency.min_ms = 1e9;
+    for (const Typist::KeyPress &press : typist.GetPresses()) {
+        latency.pressed++;
+        latency.blocked_ms += (end_us > press.arrived_us) ? (end_us - press.arrived_us) / 1000.0 : 0;
+        if (press.answered_us == 0) {
+            continue;
+        }
+        double ms = (press.answered_us - press.arrived_us) / 1000.0;
+        latency.answered++;
+        latency.avg_ms += ms;
+        latency.min_ms = (ms < latency.min_ms) ? ms : latency.min_ms;
+        latency.max_ms = (ms > latency.max_ms) ? ms : latency.max_ms;
+    }
+    latency.avg_ms = (latency.answered != 0) ? latency.avg_ms / latency.answered : 0;
+    latency.min_ms = (latency.answered != 0) ? latency.min_ms : 0;
+    latency.blocked_ms = (latency.pressed != 0) ? latency.blocked_ms / latency.pressed : 0;
+    return latency;
+}
+
+// Function Queried: type a command, press '?' "queries" times over "duration_us" past the first "skip_us"
+// and measure the answers
+Latency Queried(const char *name, const char *keys, const char *answer, Typist *typist, const uint16_t queries, const uint64_t duration_us,
+                const uint64_t skip_us = 0) {
+    typist->Clear();
+    uint64_t start_us = SimClock::Now() + skip_us;
+    for (uint16_t ix = 0; ix < queries; ix++) {
+        typist->PressAt(JOB_STATUS_KEY, start_us + ((ix + 1) * (duration_us - skip_us)) / (queries + 1), answer);
+    }
+    TypeCommand(keys);
+    return Measure(name, *typist, SimClock::Now());
+}
+
+// Console response while long commands run, on the simulated Tiny85. A
+// typist at the other end of the serial cable presses '?' at set times
+// during an 'e' flash deletion and a 'w' upload; the time from the key
+// reaching the ESP32 to the first byte of its answer leaving the UART is
+// the console latency. Next to it, the time the key would have waited
+// for the command to end (the engine before console jobs). The Tiny85
+// holds SCL low while it erases, so the DELFLASH reply is only read once
+// the erase should be over: no transaction waits on it. A 'd' that finds
+// a page it can't patch goes through the same erase job, then uploads;
+// its keys are pressed past its flash readback, which doesn't serve the
+// console. Then 'q' is
+// pressed halfway through an upload: it must stop with the confirmed
+// pages checkpointed, and the next 'w' must go on from them. Last, a
+// number prompt ('b') is left waiting for 10 s: engine passes, the
+// passes that found nothing to do (paused ENGINE_IDLE_MS) and the host
+// CPU time they took show the engine no longer spins on the UART.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    unsigned long queries = 20;
+    for (int i = 1; i < argc; i++) {
+        sscanf(argv[i], "--queries=%lu", &queries);
+    }
+    char nvs_root[] = "/tmp/timonel-nvs-XXXXXX";
+    if (mkdtemp(nvs_root) == nullptr) {
+        printf("Can't create the NVS directory\n");
+        return 1;
+    }
+    Preferences::SetRoot(nvs_root);
+    BenchBanner(options);
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    Typist typist;
+    std::string output;
+    USE_SERIAL.SetPeer(&typist);
+    USE_SERIAL.SetCapture(&output);
+    setup();
+
+    // First upload (and clock negotiation) and erase, to time them
+    uint64_t start_us = SimClock::Now();
+    TypeCommand("w");
+    start_us = SimClock::Now();
+    TypeCommand("e");
+    uint64_t erase_us = SimClock::Now() - start_us;
+    start_us = SimClock::Now();
+    TypeCommand("w");
+    uint64_t upload_us = SimClock::Now() - start_us;
+    TypeCommand("e");
+
+    // '?' during a deletion and an upload
+    Latency erase = Queried("'e' erase", "e", "\n\r  [ erase:", &typist, 5, erase_us);
+    Latency upload = Queried("'w' upload", "w", "\n\r  [ upload:", &typist, queries, upload_us);
+
+    // '?' during a 'd' that can't patch a page in place: erase job, then upload
+    start_us = SimClock::Now();
+    TypeCommand("d");
+    uint64_t diff_read_us = SimClock::Now() - start_us; /* Flash up to date: the readback alone */
+    tiny85.GetFlash()[SPM_PAGESIZE * 2] ^= 0x01;
+    output.clear();
+    start_us = SimClock::Now();
+    TypeCommand("d");
+    uint64_t diff_us = SimClock::Now() - start_us;
+    bool diff_erased = (output.find("erasing first") != std::string::npos) && (output.find("pages verified") != std::string::npos);
+    tiny85.GetFlash()[SPM_PAGESIZE * 2] ^= 0x01;
+    Latency diff = Queried("'d' erase+upl", "d", "\n\r  [ ", &typist, 5, diff_us, diff_read_us);
+
+    // 'q' halfway through an upload, then 'w' again
+    TypeCommand("e");
+    typist.Clear();
+    typist.PressAt(JOB_CANCEL_KEY, SimClock::Now() + upload_us / 2, "\n\r  [ upload: cancelling");
+    output.clear();
+    TypeCommand("w");
+    bool cancelled = (output.find("[ cancelled ]") != std::string::npos) && (output.find("pages confirmed, 'w' goes on") != std::string::npos);
+    uint16_t written = tiny85.GetCounters().page_writes;
+    output.clear();
+    TypeCommand("w");
+    size_t resumed_at = output.find("resumed after ");
+    int resumed = (resumed_at != std::string::npos) ? atoi(output.c_str() + resumed_at + strlen("resumed after ")) : 0;
+    bool finished = (output.find("pages verified") != std::string::npos);
+    uint16_t rewritten = tiny85.GetCounters().page_writes - written;
+
+    // A number prompt left waiting
+    typist.Clear();
+    TypeCommand("b");
+    uint32_t passes = 0, idle_passes = 0;
+    clock_t cpu_start = clock();
+    start_us = SimClock::Now();
+    while ((SimClock::Now() - start_us) < (PROMPT_WAIT_MS * 1000ULL)) {
+        uint64_t pass_start = SimClock::Now();
+        loop();
+        passes++;
+        idle_passes += ((SimClock::Now() - pass_start) >= (ENGINE_IDLE_MS * 1000ULL)) ? 1 : 0;
+    }
+    double prompt_cpu_ms = (double)(clock() - cpu_start) * 1000.0 / CLOCKS_PER_SEC;
+    TypeCommand("0\r");
+    bool prompt_done = (prompt == PROMPT_NONE) && (output.find("Flash memory page base address: 0") != std::string::npos);
+    USE_SERIAL.SetCapture(nullptr);
+    USE_SERIAL.SetPeer(nullptr);
+    SimBus::Get(0)->Detach(&tiny85);
+
+    printf("\n%-14s %8s %8s %10s %10s %10s %12s\n", "command", "pressed", "answered", "min ms", "avg ms", "max ms", "blocked ms");
+    bool ok = true;
+    for (const Latency &latency : {erase, upload, diff}) {
+        printf("%-14s %8d %8d %10.1f %10.1f %10.1f %12.1f\n", latency.name, latency.pressed, latency.answered, latency.min_ms,
+               latency.avg_ms, latency.max_ms, latency.blocked_ms);
+        ok &= (latency.answered == latency.pressed);
+    }
+    printf("\n%-28s %s, %d pages resumed, %d written again, %s\n", "'q' halfway, then 'w'", cancelled ? "cancelled" : "NOT CANCELLED",
+           resumed, rewritten, finished ? "verified" : "NOT VERIFIED");
+    printf("%-28s %lu passes, %lu paused %d ms, %.1f ms host CPU\n", "prompt waiting 10 s", (unsigned long)passes, (unsigned long)idle_passes,
+           ENGINE_IDLE_MS, prompt_cpu_ms);
+    printf("%-28s %s\n", "'d' on a changed page", diff_erased ? "erase job, then full upload" : "NOT ERASED AND UPLOADED");
+    ok &= diff_erased && cancelled && (resumed != 0) && finished && prompt_done && (idle_passes != 0);
+    printf("\n%s\n", ok ? "The console kept answering during every job" : "CONSOLE JOB MISMATCH");
+    return ok ? 0 : 1;
+}
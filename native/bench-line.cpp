@@ -0,0 +1,227 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-line.cpp (Native benchmark)
+  ............................................................................
+  Production line mode on a simulated fixture.
+  Usage: bench-line [--boards=n] [--swap-ms=ms] [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include <Preferences.h>
+#include <stdlib.h>
+
+#include <string>
+
+#include "bench.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+#define BENCH_WEAK_PAGE (SPM_PAGESIZE * 2)  // Page that doesn't program on a bad board
+#define BENCH_BOARD_MS 60000                // Longest a board may take on the line (virtual ms)
+
+extern LineLog line_log;
+
+uint8_t app_image[MCU_TOTAL_MEM];
+uint16_t app_size = 0;
+
+// Boards the operator puts in
+enum BoardKind : uint8_t {
+    BOARD_FRESH,       /* Bootloader only */
+    BOARD_REWORK_APP,  /* A good board back, running its application */
+    BOARD_REWORK_BOOT, /* A good board back, powered up in the bootloader */
+    BOARD_BAD          /* A flash page doesn't program */
+};
+
+// Function KindOf: the n-th board (from 0)
+BoardKind KindOf(const uint32_t n) {
+    switch (n % 10) {
+        case 3:
+            return BOARD_REWORK_APP;
+        case 6:
+            return BOARD_REWORK_BOOT;
+        case 8:
+            return BOARD_BAD;
+        default:
+            return BOARD_FRESH;
+    }
+}
+
+// The fixture: one board at a time on the bus, swapped by the operator after each log line
+class Fixture : public SimSlave {
+   public:
+    Fixture(const BenchOptions &options, const uint32_t boards, const uint32_t swap_ms)
+        : options_(options), boards_(boards), swap_us_((uint64_t)swap_ms * 1000) {}
+    ~Fixture() {
+        delete board_;
+        delete rework_;
+    }
+    // Put the next board in now
+    void Load(void) {
+        BoardKind kind = KindOf(loaded_);
+        bool rework = ((kind == BOARD_REWORK_APP) || (kind == BOARD_REWORK_BOOT)) && (rework_ != nullptr);
+        kind_ = rework ? kind : ((kind == BOARD_BAD) ? BOARD_BAD : BOARD_FRESH);
+        if (rework) {
+            board_ = rework_;
+            rework_ = nullptr;
+        } else {
+            board_ = new TimonelSlave();
+            board_->GetTiming().page_erase_us = options_.page_erase_us;
+            board_->GetTiming().page_write_us = options_.page_write_us;
+        }
+        if (kind_ == BOARD_BAD) {
+            board_->WeakPage(BENCH_WEAK_PAGE);
+        }
+        if (kind_ != BOARD_REWORK_APP) {
+            board_->PowerCycle(); /* Put in unpowered: comes up in the bootloader */
+        }
+        expected_[kind_]++;
+        loaded_++;
+    }
+    // Take the board out and check it against its log line
+    void Unload(void) {
+        bool passed = (line_log.GetPassed() > passed_seen_);
+        passed_seen_ = line_log.GetPassed();
+        bool holds = (memcmp(&board_->GetFlash()[2], &app_image[2], app_size - 2) == 0);
+        bool runs = (board_->GetMode() == TimonelSlave::APPLICATION);
+        bool expected = (kind_ == BOARD_BAD) ? !passed : (passed && holds && runs);
+        if (!expected) {
+            printf("%24s board %lu (kind %d): %s, flash %s, %s\n", "", (unsigned long)loaded_, kind_, passed ? "PASS" : "FAIL",
+                   holds ? "ok" : "differs", runs ? "running" : "not running");
+            mismatches_++;
+        }
+        if ((kind_ != BOARD_BAD) && passed && (rework_ == nullptr)) {
+            rework_ = board_; /* Kept aside, it comes back for rework */
+        } else {
+            delete board_;
+        }
+        board_ = nullptr;
+    }
+    // The operator: a board out after half the swap time from its log line, the next one in after the whole of it
+    void Operate(void) {
+        uint64_t now = SimClock::Now();
+        if ((board_ != nullptr) && (line_log.GetUnits() > units_seen_)) {
+            units_seen_ = line_log.GetUnits();
+            remove_at_ = now + (swap_us_ / 2);
+            insert_at_ = now + swap_us_;
+        }
+        if ((board_ != nullptr) && (remove_at_ != 0) && (now >= remove_at_)) {
+            Unload();
+            remove_at_ = 0;
+        }
+        if ((board_ == nullptr) && (loaded_ < boards_) && (now >= insert_at_)) {
+            Load();
+        }
+    }
+    uint32_t GetMismatches(void) const { return mismatches_; }
+    uint32_t GetExpected(const BoardKind kind) const { return expected_[kind]; }
+    // SimSlave
+    bool Acknowledges(const uint8_t twi_address) {
+        Operate();
+        return (board_ != nullptr) && board_->Acknowledges(twi_address);
+    }
+    uint64_t BusyUntil(void) { return (board_ != nullptr) ? board_->BusyUntil() : 0; }
+    void Receive(const uint8_t twi_address, const uint8_t *data, const size_t size) {
+        if (board_ != nullptr) {
+            board_->Receive(twi_address, data, size);
+        }
+    }
+    size_t Transmit(const uint8_t twi_address, uint8_t *data, const size_t size) {
+        return (board_ != nullptr) ? board_->Transmit(twi_address, data, size) : 0;
+    }
+
+   private:
+    BenchOptions options_;
+    uint32_t boards_;
+    uint64_t swap_us_;
+    TimonelSlave *board_ = nullptr;
+    TimonelSlave *rework_ = nullptr;
+    BoardKind kind_ = BOARD_FRESH;
+    uint32_t loaded_ = 0, units_seen_ = 0, passed_seen_ = 0, mismatches_ = 0;
+    uint32_t expected_[4] = {0};
+    uint64_t remove_at_ = 0, insert_at_ = 0;
+};
+
+// Production line mode on a simulated fixture: the master starts with
+// the line mode selected in NVS (as 'y' leaves it) and an operator swaps
+// boards back to back. Once a board's log line is out, it is taken out
+// after half the swap time and the next one put in (and powered up) after
+// the whole of it. Most boards are fresh; every tenth board from the
+// fourth on comes back for rework still running the application, from
+// the seventh on it comes back powered up in the bootloader (both hold
+// the payload: erased first), and from the ninth on it has a flash page
+// that doesn't program (it must FAIL at verify). Every board taken out is
+// checked: a good one holds the payload and runs it. Reported: the
+// pass/fail log, the stage times, units per hour, and that nothing but
+// log lines reached the console.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    unsigned long boards = 20, swap_ms = 2500;
+    for (int i = 1; i < argc; i++) {
+        sscanf(argv[i], "--boards=%lu", &boards);
+        sscanf(argv[i], "--swap-ms=%lu", &swap_ms);
+    }
+    char nvs_root[] = "/tmp/timonel-nvs-XXXXXX";
+    if (mkdtemp(nvs_root) == nullptr) {
+        printf("Can't create the NVS directory\n");
+        return 1;
+    }
+    Preferences::SetRoot(nvs_root);
+    app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    BenchBanner(options);
+    printf("Payload: %d bytes, %lu boards, %lu ms per swap\n", app_size, boards, swap_ms);
+    LineSelection selection;
+    selection.enabled = true; /* As 'y' leaves it */
+    SaveLineSelection(selection);
+    Fixture fixture(options, boards, swap_ms);
+    fixture.Load();
+    SimBus::Get(0)->Attach(&fixture);
+    SimBus::Get(0)->SetClock(options.twi_clock);
+    USE_SERIAL.SetEcho(options.verbose);
+    std::string output;
+    USE_SERIAL.SetCapture(&output);
+    clock_t cpu_start = clock();
+    uint64_t start_us = SimClock::Now();
+    setup();
+    bool stuck = false;
+    while ((line_log.GetUnits() < boards) && !stuck) {
+        loop();
+        stuck = ((SimClock::Now() - start_us) > ((uint64_t)boards * BENCH_BOARD_MS * 1000));
+    }
+    double cpu_ms = (double)(clock() - cpu_start) * 1000.0 / CLOCKS_PER_SEC;
+    uint64_t line_us = SimClock::Now() - start_us;
+    fixture.Unload(); /* The last one */
+    USE_SERIAL.SetCapture(nullptr);
+    SimBus::Get(0)->Detach(&fixture);
+
+    printf("\n%s", output.c_str());
+    printf("\n%-10s %10s\n", "stage", "avg ms");
+    for (uint8_t stage = 0; stage < LINE_STAGES; stage++) {
+        uint32_t avg_us = line_log.GetStageAvgUs((LineStage)stage);
+        printf("%-10s %10.1f\n", LineStageName((LineStage)stage), avg_us / 1000.0);
+    }
+    // Headless: the console gets the banner and log lines only, no screen clearing, logo or menu
+    bool headless = (output.find("\x1b[2J") == std::string::npos) && (output.find("Timonel bootloader (") == std::string::npos) &&
+                    (output.find("device active") == std::string::npos);
+    uint32_t bad = fixture.GetExpected(BOARD_BAD);
+    printf("\n%-28s %lu PASS, %lu FAIL (%lu bad boards put in)\n", "boards", (unsigned long)line_log.GetPassed(),
+           (unsigned long)line_log.GetFailed(), (unsigned long)bad);
+    printf("%-28s %lu fresh, %lu running their app, %lu in the bootloader\n", "boards put in", (unsigned long)fixture.GetExpected(BOARD_FRESH),
+           (unsigned long)fixture.GetExpected(BOARD_REWORK_APP), (unsigned long)fixture.GetExpected(BOARD_REWORK_BOOT));
+    printf("%-28s %lu on the line, %lu flashing only\n", "units/hour", (unsigned long)line_log.GetUnitsPerHour(),
+           (unsigned long)line_log.GetFlashPerHour());
+    printf("%-28s %.1f s virtual, %.0f ms host CPU\n", "line time", line_us / 1e6, cpu_ms);
+    printf("%-28s %s\n", "console", headless ? "log lines only" : "NOT HEADLESS");
+    bool ok = !stuck && headless && (fixture.GetMismatches() == 0) && (line_log.GetFailed() == bad) && (line_log.GetUnits() == boards);
+    printf("\n%s\n", ok ? "Every board came out as expected" : "LINE MISMATCH");
+    return ok ? 0 : 1;
+}
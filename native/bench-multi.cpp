@@ -0,0 +1,141 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-multi.cpp (Native benchmark)
+  ............................................................................
+  Flashing the same payload on 1 to 8 simulated Tiny85s.
+  Usage: bench-multi [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "bench.h"
+#include "core-tasks.h"
+#include "multi-flash.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+#define BENCH_DEVICES 8      // Most devices in a round
+#define BENCH_BOOT_ADDR 11   // First device's bootloader address, the next ones follow
+#define BENCH_APP_OFFSET 33  // Application address = bootloader address + this (>= APP_TWI_ADDR)
+
+uint8_t app_image[MCU_TOTAL_MEM];
+uint16_t app_size = 0;
+
+// Function Attach: "count" fresh devices, on bus 0 or alternating between both buses
+void Attach(const BenchOptions &options, TimonelSlave **devices, const uint8_t count, const bool both_buses) {
+    for (uint8_t ix = 0; ix < count; ix++) {
+        devices[ix] = new TimonelSlave(BENCH_BOOT_ADDR + ix, BENCH_BOOT_ADDR + ix + BENCH_APP_OFFSET);
+        devices[ix]->GetTiming().page_erase_us = options.page_erase_us;
+        devices[ix]->GetTiming().page_write_us = options.page_write_us;
+        SimBus::Get((both_buses && (ix & 1)) ? 1 : 0)->Attach(devices[ix]);
+    }
+}
+
+// Function Detach: remove the devices from both buses, true if every one not skipped holds the image
+bool Detach(TimonelSlave **devices, const uint8_t count, const int skip = -1) {
+    bool flash_ok = true;
+    for (uint8_t ix = 0; ix < count; ix++) {
+        // The reset vector is relocated by Timonel, the rest must match
+        if ((ix != skip) && (memcmp(&devices[ix]->GetFlash()[2], &app_image[2], app_size - 2) != 0)) {
+            printf("%24s TWI %d: flash differs\n", "", BENCH_BOOT_ADDR + ix);
+            flash_ok = false;
+        }
+        SimBus::Get(0)->Detach(devices[ix]);
+        SimBus::Get(1)->Detach(devices[ix]);
+        delete devices[ix];
+    }
+    return flash_ok;
+}
+
+// Function Sequential: erase and upload each device in turn through the NB library, returns the time (us)
+uint64_t Sequential(const BenchOptions &options, const uint8_t count, bool *ok) {
+    TimonelSlave *devices[BENCH_DEVICES];
+    Attach(options, devices, count, false);
+    uint64_t start = SimClock::Now();
+    for (uint8_t ix = 0; ix < count; ix++) {
+        Timonel timonel(BENCH_BOOT_ADDR + ix);
+        uint8_t errors = timonel.DeleteApplication();
+        Timonel::Status status = timonel.GetStatus();
+        while ((errors == 0) && (status.signature != T_SIGNATURE)) {
+            delay(MULTI_POLL_MS); /* Back after the erase reset */
+            status = timonel.GetStatus();
+        }
+        errors = (errors == 0) ? timonel.UploadApplication(app_image, app_size) : errors;
+        *ok &= (errors == 0);
+    }
+    uint64_t elapsed = SimClock::Now() - start;
+    *ok &= Detach(devices, count);
+    return elapsed;
+}
+
+// Function Parallel: flash every device with MultiFlash, returns the time (us)
+uint64_t Parallel(const BenchOptions &options, const uint8_t count, const bool both_buses, bool *ok, const int unplug = -1) {
+    static MultiFlash multi_flash(SDA, SCL, SDA_1, SCL_1);
+    TimonelSlave *devices[BENCH_DEVICES];
+    Attach(options, devices, count, both_buses);
+    *ok &= (multi_flash.Enumerate() == count);
+    if (unplug >= 0) {
+        devices[unplug]->Unplug();
+    }
+    multi_flash.Start(app_image, app_size, 0, false);
+    while (!multi_flash.IsDone()) {
+        TaskPause();
+    }
+    for (uint8_t ix = 0; ix < multi_flash.GetCount(); ix++) {
+        SlaveFlash &device = multi_flash.GetDevice(ix);
+        bool expect_fail = (device.address == BENCH_BOOT_ADDR + unplug);
+        if ((device.step.load() == STEP_FAILED) != expect_fail) {
+            printf("%24s bus %d, TWI %d: step %d, error %d\n", "", device.bus, device.address, device.step.load(), device.error);
+            *ok = false;
+        }
+        if ((device.step.load() == STEP_DONE) && (device.pages_done.load() != multi_flash.GetPages())) {
+            *ok = false;
+        }
+    }
+    SimClock::Advance((uint64_t)multi_flash.GetElapsedMs() * 1000); /* The workers ran on their own clocks */
+    *ok &= Detach(devices, count, unplug);
+    return (uint64_t)multi_flash.GetElapsedMs() * 1000;
+}
+
+// Flashing the same payload on 1, 2, 4 and 8 simulated Tiny85s: one after
+// the other with the library calls, as 'w' would on each of them, then
+// with MultiFlash interleaving all of them on one bus, and split across
+// both I2C controllers. Every device's flash is checked afterwards. A
+// last round unplugs one device after the scan: only that one may fail.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    SimBus::Get(0)->SetClock(options.twi_clock);
+    SimBus::Get(1)->SetClock(options.twi_clock);
+    USE_SERIAL.SetEcho(options.verbose);
+    app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    BenchBanner(options);
+    printf("Payload: %d bytes, %d pages per device\n", app_size, (app_size + SPM_PAGESIZE - 1) / SPM_PAGESIZE);
+    printf("\n%-8s %14s %14s %8s %14s %8s %s\n", "devices", "sequential ms", "1 bus ms", "speedup", "2 buses ms", "speedup", "");
+    bool all_ok = true;
+    const uint8_t rounds[] = {1, 2, 4, 8};
+    for (uint8_t count : rounds) {
+        bool ok = true;
+        uint64_t sequential_us = Sequential(options, count, &ok);
+        uint64_t one_bus_us = Parallel(options, count, false, &ok);
+        uint64_t two_buses_us = Parallel(options, count, true, &ok);
+        printf("%-8d %14.1f %14.1f %7.2fx %14.1f %7.2fx %s\n", count, sequential_us / 1000.0, one_bus_us / 1000.0,
+               (double)sequential_us / one_bus_us, two_buses_us / 1000.0, (double)sequential_us / two_buses_us,
+               ok ? "verified" : "FAILED");
+        all_ok &= ok;
+    }
+    bool ok = true;
+    Parallel(options, 4, true, &ok, 2);
+    printf("\nOne of 4 devices unplugged after the scan: %s\n", ok ? "only it failed, the rest verified" : "FAILED");
+    all_ok &= ok;
+    printf("\n%s\n", all_ok ? "Every device flashed and verified" : "FAILED");
+    return all_ok ? 0 : 1;
+}
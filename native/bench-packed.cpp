@@ -0,0 +1,121 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-packed.cpp (Native benchmark)
+  ............................................................................
+  TPZ packed payloads against plain arrays on the simulated Tiny85.
+  Usage: bench-packed [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "bench.h"
+#include "flash-sync.h"
+
+namespace image {
+#include "payload.h"
+}
+#include "payload-tables.h"
+
+#define UNPACK_ROUNDS 2000
+
+// Function UnpackPageNs: host nanoseconds to unpack one page, averaged over many passes
+double UnpackPageNs(const uint8_t packed[], const uint16_t packed_size) {
+    PackedPayload source(packed, packed_size);
+    uint16_t flash_addr = 0, size = 0;
+    uint8_t *data = nullptr;
+    uint32_t pages = 0;
+    volatile uint8_t sink = 0; /* Keeps the unpacked data alive */
+    clock_t start = clock();
+    for (uint16_t round = 0; round < UNPACK_ROUNDS; round++) {
+        source.Rewind();
+        while (source.NextBlock(&flash_addr, &data, &size)) {
+            sink = data[size - 1];
+            pages++;
+        }
+    }
+    double elapsed_ns = (double)(clock() - start) * 1000000000.0 / CLOCKS_PER_SEC;
+    (void)sink;
+    return (pages > 0) ? (elapsed_ns / pages) : 0;
+}
+
+// Function RunUpload: upload a payload plain or packed, returns false on a flash mismatch
+bool RunUpload(const BenchOptions &options, const char *name, const uint8_t packed[], const uint16_t packed_size,
+               uint8_t *plain, const uint16_t plain_size, const bool use_packed, BenchSample *sample) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    Timonel timonel(SIM_BOOT_ADDR);
+    BenchStart(sample, name, plain_size, &tiny85);
+    uint8_t twi_errors = 0;
+    if (use_packed) {
+        PackedPayload source(packed, packed_size);
+        twi_errors = UploadPages(&timonel, &source);
+    } else {
+        twi_errors = timonel.UploadApplication(plain, plain_size);
+    }
+    BenchStop(sample, &tiny85);
+    bool flash_ok = (twi_errors == 0) &&
+                    (timonel.GetStatus().application_start == TrampolineFor(plain, tiny85.GetBootloaderStart()));
+    for (uint16_t i = 2; i < plain_size; i++) {
+        flash_ok &= (tiny85.GetFlash()[i] == plain[i]);
+    }
+    SimBus::Get(0)->Detach(&tiny85);
+    return flash_ok;
+}
+
+// Function RunPayload: footprint, unpack cost and uploads of one payload
+bool RunPayload(const BenchOptions &options, const char *name, const uint8_t packed[], const uint16_t packed_size) {
+    uint8_t plain[MCU_TOTAL_MEM];
+    uint16_t plain_size = BenchImage(packed, packed_size, true, plain);
+    uint16_t pages = (plain_size + SPM_PAGESIZE - 1) / SPM_PAGESIZE;
+    char raw_name[40], packed_name[40];
+    snprintf(raw_name, sizeof(raw_name), "raw %s", name);
+    snprintf(packed_name, sizeof(packed_name), "packed %s", name);
+    BenchSample raw_sample, packed_sample;
+    bool raw_ok = RunUpload(options, raw_name, packed, packed_size, plain, plain_size, false, &raw_sample);
+    bool packed_ok = RunUpload(options, packed_name, packed, packed_size, plain, plain_size, true, &packed_sample);
+    double unpack_ns = UnpackPageNs(packed, packed_size);
+    double i2c_page_us = (double)packed_sample.sim_us / pages;
+    BenchPrint(raw_sample);
+    BenchPrint(packed_sample);
+    bool smaller = (packed_size < plain_size); /* payload-gen.py keeps the others raw */
+    printf("%24s %s, master flash %d -> %d bytes (%.0f%%), unpack %.0f ns/page (host) vs %.0f us/page upload%s%s\n", "",
+           (packed[3] & TPZ_STORED) ? "stored" : "packed", plain_size, packed_size, 100.0 * packed_size / plain_size,
+           unpack_ns, i2c_page_us, (raw_ok && packed_ok) ? "" : " FLASH MISMATCH", smaller ? "" : " LARGER THAN RAW");
+    return raw_ok && packed_ok && smaller;
+}
+
+// Function RunRaw: upload of a payload payload-gen.py kept raw, returns false on a flash mismatch
+bool RunRaw(const BenchOptions &options, const char *name, uint8_t plain[], const uint16_t plain_size) {
+    char raw_name[40];
+    snprintf(raw_name, sizeof(raw_name), "raw %s", name);
+    BenchSample raw_sample;
+    bool raw_ok = RunUpload(options, raw_name, nullptr, 0, plain, plain_size, false, &raw_sample);
+    BenchPrint(raw_sample);
+    printf("%24s kept raw by payload-gen.py (TPZ isn't smaller), master flash %d bytes%s\n", "", plain_size,
+           raw_ok ? "" : " FLASH MISMATCH");
+    return raw_ok;
+}
+
+// TPZ packed payloads against plain arrays on the simulated Tiny85: flash
+// footprint on the master, host CPU time to unpack a page and upload time
+// of both forms. The demo payload is dense AVR code: TPZ would make it 8
+// bytes larger, so payload-gen.py keeps it raw and only its raw upload is
+// timed. payload-tables.h adds the lookup tables and 0xFF holes that make
+// packing worthwhile. A packed payload must be smaller than its raw form,
+// and every upload is checked against the emulated flash.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    bool all_ok = true;
+    BenchBanner(options);
+    BenchHeader();
+#ifdef PAYLOAD_PACKED
+    all_ok &= RunPayload(options, "payload.h", image::payload, sizeof(image::payload));
+#else
+    all_ok &= RunRaw(options, "payload.h", image::payload, sizeof(image::payload));
+#endif  // PAYLOAD_PACKED
+    all_ok &= RunPayload(options, "payload-tables.h", payload_tables, sizeof(payload_tables));
+    printf("\n%s\n", all_ok ? "All flash images verified" : "FLASH MISMATCH");
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-packets.cpp (Native benchmark)
+  ............................................................................
+  Packet size sweep over bootloaders built with every packet size.
+  Usage: bench-packets [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "bench.h"
+#include "eeprom-image.h"
+#include "flash-sync.h"
+#include "packet-size.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+uint8_t app_image[MCU_TOTAL_MEM];
+uint16_t app_size = 0;
+
+// A bootloader build on the bench
+struct Build {
+    const char *name;
+    uint8_t rx_size;   /* SLV_PACKET_SIZE it was built with, MST_PACKET_SIZE is the master's */
+    bool force_erase;  /* FORCE_ERASE_PG */
+    bool sweep;        /* A row of the sweep table */
+};
+
+// Throughput of one build (bytes/s)
+struct Sweep {
+    double upload = 0, verified = 0, readback = 0, eeprom_write = 0, eeprom_read = 0;
+    double readback_payload = 0;     /* Share of the readback bus bytes that were flash data */
+    bool compiled_upload = false;    /* The compiled sizes work at all */
+    bool compiled_readback = false;
+};
+
+// Function FlashMatches: the device holds the image (its reset vector is relocated by Timonel)
+bool FlashMatches(TimonelSlave *tiny85) {
+    return memcmp(&tiny85->GetFlash()[2], &app_image[2], app_size - 2) == 0;
+}
+
+// Function Rate: bytes/s of a sample
+double Rate(const BenchSample &sample) {
+    return (sample.sim_us > 0) ? (sample.bytes * 1000000.0 / sample.sim_us) : 0;
+}
+
+// Function TryCompiled: whether an upload and a readback at the master's compiled sizes go through on a blank device
+void TryCompiled(const BenchOptions &options, const Build &build, Sweep *sweep) {
+    TimonelSlave tiny85;
+    tiny85.SetPackets(MST_PACKET_SIZE, build.rx_size);
+    BenchSetup(options, &tiny85);
+    ForgetPackets();
+    Timonel timonel(SIM_BOOT_ADDR);
+    RawPayload payload(app_image, app_size);
+    uint8_t readback[MCU_TOTAL_MEM];
+    sweep->compiled_upload = (UploadPages(&timonel, &payload) == 0) && FlashMatches(&tiny85);
+    sweep->compiled_readback = (ReadFlash(&timonel, 0, readback, app_size, 0) == 0);
+    SimBus::Get(0)->Detach(&tiny85);
+}
+
+// Function RunBuild: negotiate with a blank device of this build, then time and check every transfer kind
+bool RunBuild(const BenchOptions &options, const Build &build, Sweep *sweep) {
+    TryCompiled(options, build, sweep);
+    TimonelSlave tiny85;
+    tiny85.SetPackets(MST_PACKET_SIZE, build.rx_size);
+    if (build.force_erase) {
+        tiny85.SetFeatures(FEATURES_CODE, EXT_FEATURES | (1 << E_FORCE_ERASE_PG));
+    }
+    BenchSetup(options, &tiny85);
+    ForgetPackets();
+    Timonel timonel(SIM_BOOT_ADDR);
+    Timonel::Status sts = timonel.GetStatus();
+    RawPayload payload(app_image, app_size);
+    static uint8_t flash_before[MCU_TOTAL_MEM];
+    memcpy(flash_before, tiny85.GetFlash(), MCU_TOTAL_MEM);
+    BenchHeader();
+    BenchSample sample;
+    PacketReport report;
+    BenchStart(&sample, "negotiation", 0, &tiny85);
+    uint8_t errors = NegotiatePackets(&timonel, sts, &report);
+    BenchStop(&sample, &tiny85);
+    BenchPrint(sample);
+    bool untouched = (memcmp(flash_before, tiny85.GetFlash(), MCU_TOTAL_MEM) == 0);
+    bool reads_only = (sample.bus.bytes_tx == (uint32_t)report.probes * 5); /* READFLSH commands, nothing written */
+    bool ok = (errors == 0) && (report.rx_size == build.rx_size) && untouched && reads_only;
+
+    BenchStart(&sample, "upload", app_size, &tiny85);
+    errors = UploadPages(&timonel, &payload);
+    BenchStop(&sample, &tiny85);
+    BenchPrint(sample);
+    sweep->upload = Rate(sample);
+    ok &= (errors == 0) && FlashMatches(&tiny85);
+
+    VerifyReport verify;
+    BenchStart(&sample, "verified upload", app_size, &tiny85);
+    errors = UploadVerified(&timonel, &payload, sts, &verify);
+    BenchStop(&sample, &tiny85);
+    BenchPrint(sample);
+    sweep->verified = Rate(sample);
+    ok &= (errors == 0) && FlashMatches(&tiny85) && verify.readback && (verify.first_bad_page == 0xFFFF) &&
+          (verify.pages_verified == verify.pages);
+
+    static uint8_t readback[MCU_TOTAL_MEM];
+    BenchStart(&sample, "readback", app_size, &tiny85);
+    errors = ReadFlash(&timonel, 0, readback, app_size);
+    BenchStop(&sample, &tiny85);
+    BenchPrint(sample);
+    sweep->readback = Rate(sample);
+    uint32_t bus_bytes = sample.bus.bytes_tx + sample.bus.bytes_rx + sample.bus.transactions; /* Address bytes too */
+    sweep->readback_payload = (bus_bytes > 0) ? ((double)app_size / bus_bytes) : 0;
+    ok &= (errors == 0) && (memcmp(readback, tiny85.GetFlash(), app_size) == 0);
+
+    uint8_t pattern[EEPROM_IMAGE_MAX];
+    for (uint16_t ix = 0; ix < EEPROM_IMAGE_MAX; ix++) {
+        pattern[ix] = (uint8_t)((ix * 7) ^ 0x5A);
+    }
+    EepromTransfer eeprom(&timonel, sts);
+    BenchStart(&sample, "eeprom write", EEPROM_IMAGE_MAX, &tiny85);
+    errors = eeprom.Write(0, pattern, EEPROM_IMAGE_MAX);
+    BenchStop(&sample, &tiny85);
+    BenchPrint(sample);
+    sweep->eeprom_write = Rate(sample);
+    ok &= (errors == 0) && (memcmp(tiny85.GetEeprom(), pattern, EEPROM_IMAGE_MAX) == 0);
+
+    BenchStart(&sample, "eeprom read", EEPROM_IMAGE_MAX, &tiny85);
+    errors = eeprom.Read(0, readback, EEPROM_IMAGE_MAX);
+    BenchStop(&sample, &tiny85);
+    BenchPrint(sample);
+    sweep->eeprom_read = Rate(sample);
+    ok &= (errors == 0) && (memcmp(readback, pattern, EEPROM_IMAGE_MAX) == 0);
+
+    printf("%24s found %d in with %d probe packets in %.1f ms, %s, flash %s; compiled %d/%d: upload %s, readback %s%s\n", "",
+           report.rx_size, report.probes, report.probe_us / 1000.0, reads_only ? "reads only" : "WRITES SENT",
+           untouched ? "untouched" : "CHANGED", MST_PACKET_SIZE, SLV_PACKET_SIZE, sweep->compiled_upload ? "ok" : "refused",
+           sweep->compiled_readback ? "ok" : "refused", ok ? "" : " UNEXPECTED");
+    SimBus::Get(0)->Detach(&tiny85);
+    return ok;
+}
+
+// Packet size sweep: simulated Tiny85s whose bootloaders were built with
+// every slave-to-master packet size from 32 down to 2 bytes, and one that
+// erases pages before writing them. For each one the master's compiled
+// sizes are tried first, then the readback size is negotiated (it must be
+// the one the device was built with, only READFLSH commands may go out
+// and the flash must come out untouched) and a plain upload, a verified
+// upload, a flash readback and a whole EEPROM write and read are timed
+// and checked. The sweep table gives the throughput at each size and the
+// share of the readback bus bytes that were flash data (the rest is
+// addresses, commands, reply codes and checksums): larger packets must
+// never be slower.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    BenchBanner(options);
+    printf("Payload: %d bytes, EEPROM: %d bytes\n", app_size, EEPROM_IMAGE_MAX);
+    const Build builds[] = {
+        {"32-byte replies", 32, false, true},
+        {"16-byte replies", 16, false, true},
+        {"8-byte replies", 8, false, true},
+        {"4-byte replies", 4, false, true},
+        {"2-byte replies", 2, false, true},
+        {"16-byte replies, FORCE_ERASE_PG", 16, true, false},
+    };
+    const uint8_t build_count = sizeof(builds) / sizeof(builds[0]);
+    Sweep sweeps[build_count];
+    bool all_ok = true;
+    for (uint8_t ix = 0; ix < build_count; ix++) {
+        printf("\n%s", builds[ix].name);
+        all_ok &= RunBuild(options, builds[ix], &sweeps[ix]);
+    }
+    printf("\n%-8s %11s %11s %11s %11s %11s %9s %10s\n", "packet", "upload B/s", "verified", "readback", "ee write", "ee read",
+           "payload", "compiled");
+    bool monotonic = true;
+    const Sweep *larger = nullptr;
+    for (uint8_t ix = 0; ix < build_count; ix++) {
+        if (!builds[ix].sweep) {
+            continue;
+        }
+        const Sweep &sweep = sweeps[ix];
+        printf("%-8d %11.0f %11.0f %11.0f %11.0f %11.0f %8.0f%% %10s\n", builds[ix].rx_size, sweep.upload, sweep.verified, sweep.readback,
+               sweep.eeprom_write, sweep.eeprom_read, sweep.readback_payload * 100,
+               (sweep.compiled_upload && sweep.compiled_readback) ? "works" : (sweep.compiled_upload ? "write only" : "refused"));
+        if (larger != nullptr) {
+            monotonic &= (larger->upload >= sweep.upload) && (larger->verified >= sweep.verified) && (larger->readback >= sweep.readback) &&
+                         (larger->eeprom_write >= sweep.eeprom_write) && (larger->eeprom_read >= sweep.eeprom_read);
+        }
+        larger = &sweep;
+    }
+    printf("%-8s %10.2fx %10.2fx %10.2fx %10.2fx %10.2fx\n", "32 vs 16", sweeps[0].upload / sweeps[1].upload,
+           sweeps[0].verified / sweeps[1].verified, sweeps[0].readback / sweeps[1].readback, sweeps[0].eeprom_write / sweeps[1].eeprom_write,
+           sweeps[0].eeprom_read / sweeps[1].eeprom_read);
+    printf("%-8s %s\n", "", monotonic ? "larger packets never slower" : "A LARGER PACKET WAS SLOWER");
+    all_ok &= monotonic;
+    printf("\n%s\n", all_ok ? "Every build negotiated, transferred and verified" : "PACKET MISMATCH");
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-perf.cpp (Native benchmark)
+  ............................................................................
+  Performance counters: accuracy and cost.
+  Usage: bench-perf [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include <thread>
+
+#include "bench.h"
+#include "flash-sync.h"
+#include "perf-stats.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+#define BENCH_RECORDS 1000000  // Records timed per thread
+#define BENCH_THREADS 4        // Threads recording at once
+
+uint8_t app_image[MCU_TOTAL_MEM];
+uint16_t app_size = 0;
+
+// Counters of one operation at a point in time
+struct PerfSnapshot {
+    uint32_t calls, errors, bytes, histogram;
+};
+
+// Function Snapshot: current counters of "op", the histogram summed up
+PerfSnapshot Snapshot(const PerfOp op) {
+    const PerfCounter &counter = PerfGet(op);
+    PerfSnapshot snapshot = {counter.calls.load(), counter.errors.load(), counter.bytes.load(), 0};
+    for (uint8_t bucket = 0; bucket < PERF_BUCKETS; bucket++) {
+        snapshot.histogram += counter.histogram[bucket].load();
+    }
+    return snapshot;
+}
+
+// Function CheckUpload: a verified upload, its counters must match the device and the bus
+bool CheckUpload(const BenchOptions &options, uint32_t *records, uint64_t *upload_us) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    Timonel timonel(SIM_BOOT_ADDR);
+    Timonel::Status sts = timonel.GetStatus();
+    RawPayload payload(app_image, app_size);
+    PerfSnapshot upload = Snapshot(PERF_UPLOAD), xmit = Snapshot(PERF_XMIT), status = Snapshot(PERF_STATUS);
+    VerifyReport verify;
+    BenchSample sample;
+    BenchStart(&sample, "verified upload", app_size, &tiny85);
+    uint8_t errors = UploadVerified(&timonel, &payload, sts, &verify);
+    BenchStop(&sample, &tiny85);
+    SimBus::Get(0)->Detach(&tiny85);
+    BenchPrint(sample);
+    PerfSnapshot upload_now = Snapshot(PERF_UPLOAD), xmit_now = Snapshot(PERF_XMIT), status_now = Snapshot(PERF_STATUS);
+    uint32_t pages = (app_size + SPM_PAGESIZE - 1) / SPM_PAGESIZE;
+    uint32_t upload_calls = upload_now.calls - upload.calls;
+    uint32_t xmit_calls = xmit_now.calls - xmit.calls;
+    // Page 0 goes through UploadApplication, whose transactions the library makes: the rest are ours
+    uint32_t lib_transactions = ((SPM_PAGESIZE / MST_PACKET_SIZE) + 2) * 2; /* STPGADDR, packets, GETTMNLV */
+    bool ok = (errors == 0) && (upload_calls == pages) && ((upload_now.bytes - upload.bytes) == (pages * SPM_PAGESIZE)) &&
+              ((upload_now.histogram - upload.histogram) == upload_calls) && ((xmit_now.histogram - xmit.histogram) == xmit_calls) &&
+              (xmit_now.errors == xmit.errors) && ((status_now.calls - status.calls) == 1) &&
+              ((xmit_calls * 2) == (sample.bus.transactions - lib_transactions));
+    printf("%24s %lu page writes, %lu transactions, %lu status queries counted, bus %lu transactions%s\n", "",
+           (unsigned long)upload_calls, (unsigned long)xmit_calls, (unsigned long)(status_now.calls - status.calls),
+           (unsigned long)sample.bus.transactions, ok ? "" : " MISMATCH");
+    *records = upload_calls + xmit_calls + (status_now.calls - status.calls);
+    *upload_us = sample.sim_us;
+    return ok;
+}
+
+// Function RecordLoop: time BENCH_RECORDS records, returns host CPU ns per record
+double RecordLoop(void) {
+    struct timespec start, stop;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+    for (uint32_t i = 0; i < BENCH_RECORDS; i++) {
+        PerfRecord(PERF_XMIT, (i * 37) & 0xFFFFF, (i & 0xFF) == 0, 32, 0);
+    }
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &stop);
+    return ((stop.tv_sec - start.tv_sec) * 1e9 + (stop.tv_nsec - start.tv_nsec)) / BENCH_RECORDS;
+}
+
+// Performance counters: a verified upload on the simulated Tiny85 must
+// leave counters that agree with what happened on the bus (pages, bytes,
+// calls, histogram totals). Then their cost: host CPU time of a record,
+// alone and with 4 threads recording at once (no count may be lost), and
+// what that adds to the upload next to its bus time.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    BenchBanner(options);
+    BenchHeader();
+    bool all_ok = true;
+    uint32_t records = 0;
+    uint64_t upload_us = 0;
+    all_ok &= CheckUpload(options, &records, &upload_us);
+    // Cost of a record, alone and contended
+    double alone_ns = RecordLoop();
+    PerfSnapshot before = Snapshot(PERF_XMIT);
+    double contended_ns[BENCH_THREADS];
+    std::thread threads[BENCH_THREADS];
+    for (uint8_t t = 0; t < BENCH_THREADS; t++) {
+        threads[t] = std::thread([&contended_ns, t]() { contended_ns[t] = RecordLoop(); });
+    }
+    double worst_ns = 0;
+    for (uint8_t t = 0; t < BENCH_THREADS; t++) {
+        threads[t].join();
+        worst_ns = (contended_ns[t] > worst_ns) ? contended_ns[t] : worst_ns;
+    }
+    PerfSnapshot after = Snapshot(PERF_XMIT);
+    uint32_t expected = BENCH_THREADS * BENCH_RECORDS;
+    bool counts_ok = ((after.calls - before.calls) == expected) && ((after.histogram - before.histogram) == expected) &&
+                     ((after.errors - before.errors) == (BENCH_THREADS * ((BENCH_RECORDS + 255) / 256))) &&
+                     ((after.bytes - before.bytes) == (expected * 32));
+    all_ok &= counts_ok;
+    printf("\nRecord cost (host CPU): %.1f ns alone, %.1f ns with %d threads at once, %s\n", alone_ns, worst_ns, BENCH_THREADS,
+           counts_ok ? "no count lost" : "COUNTS LOST");
+    printf("Upload: %lu records, %.1f us of recording in %.1f ms (%.4f%%)\n", (unsigned long)records, records * worst_ns / 1000.0,
+           upload_us / 1000.0, (records * worst_ns / 1000.0) * 100.0 / upload_us);
+    printf("\n%s\n", all_ok ? "Counters match the bus" : "PERF MISMATCH");
+    return all_ok ? 0 : 1;
+}
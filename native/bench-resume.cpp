@@ -0,0 +1,153 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-resume.cpp (Native benchmark)
+  ............................................................................
+  Resumable uploads against erasing and starting over.
+  Usage: bench-resume [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include <Preferences.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "flash-sync.h"
+#include "upload-checkpoint.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+uint8_t app_image[MCU_TOTAL_MEM];
+uint16_t app_size = 0;
+
+enum Recovery {
+    RECOVER_RESTART,  /* Erase, then upload every page again */
+    RECOVER_RESUME,   /* Go on from the last confirmed page */
+    RECOVER_POWER,    /* The Tiny85 is power cycled first, then resume */
+    RECOVER_ERASED,   /* The Tiny85 is erased first, the checkpoint must be dropped */
+    RECOVER_SWAPPED,  /* A confirmed page but the last one differs (another board), the checkpoint must be dropped */
+    RECOVER_HALF      /* The first page not confirmed can't be written over: erase first, nothing is written */
+};
+
+// Function StoredConfirmed: pages confirmed in the checkpoint file, read with a handle of its own
+uint16_t StoredConfirmed(void) {
+    Preferences nvs;
+    UploadCheckpoint stored;
+    char key[16];
+    snprintf(key, sizeof(key), "addr%02d", SIM_BOOT_ADDR);
+    bool found = nvs.begin(CHECKPOINT_NAMESPACE, true) && (nvs.getBytes(key, &stored, sizeof(stored)) == sizeof(stored));
+    nvs.end();
+    return found ? stored.confirmed : 0;
+}
+
+// Function RunRecovery: fail an upload partway, recover it as asked and time the recovery. True if it
+// verified and resumed (or not) as expected.
+bool RunRecovery(const BenchOptions &options, const char *name, const Recovery recovery) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    Timonel timonel(SIM_BOOT_ADDR);
+    Timonel::Status sts = timonel.GetStatus();
+    ClearCheckpoint(SIM_BOOT_ADDR);
+    RawPayload payload(app_image, app_size);
+    VerifyReport verify;
+    // The last packet of the page three quarters in: the STPGADDR, then each page before takes its packets and its
+    // readback packets (a lost READFLSH is read again, a lost WRITPAGE fails the upload). Counted for the
+    // default readback: VERIFY_OVERLAP reads in more, smaller packets.
+    uint16_t pages = (app_size + SPM_PAGESIZE - 1) / SPM_PAGESIZE;
+    tiny85.IgnoreCommand(1 + (pages * 3 / 4) * ((SPM_PAGESIZE / MST_PACKET_SIZE) + (SPM_PAGESIZE / SLV_PACKET_SIZE)) +
+                         (SPM_PAGESIZE / MST_PACKET_SIZE));
+    uint8_t first_errors = UploadResumable(&timonel, &payload, sts, &verify);
+    uint16_t confirmed = StoredConfirmed();
+    if (recovery == RECOVER_POWER) {
+        tiny85.PowerCycle();
+        delay((tiny85.GetTiming().reset_us / 1000) + 1);
+        sts = timonel.GetStatus();
+    } else if (recovery == RECOVER_ERASED) {
+        timonel.DeleteApplication();
+        delay(((tiny85.GetTiming().reset_us + ((uint32_t)MCU_TOTAL_MEM / SPM_PAGESIZE) * options.page_erase_us) / 1000) + 1);
+        sts = timonel.GetStatus();
+    } else if (recovery == RECOVER_SWAPPED) {
+        // Set a bit the payload clears on page 1: the upload from the first page writes it right again
+        uint8_t *flash = tiny85.GetFlash();
+        for (uint8_t i = 0; i < SPM_PAGESIZE; i++) {
+            if (app_image[SPM_PAGESIZE + i] != 0xFF) {
+                flash[SPM_PAGESIZE + i] |= (uint8_t)~app_image[SPM_PAGESIZE + i];
+                break;
+            }
+        }
+    } else if (recovery == RECOVER_HALF) {
+        memset(tiny85.GetFlash() + (confirmed * SPM_PAGESIZE), 0x00, SPM_PAGESIZE / 2);
+    }
+    uint32_t page_writes = tiny85.GetCounters().page_writes;
+    BenchSample sample;
+    BenchStart(&sample, name, app_size, &tiny85);
+    uint8_t errors = 0;
+    if (recovery == RECOVER_RESTART) {
+        ClearCheckpoint(SIM_BOOT_ADDR); /* Not used by a plain upload */
+        errors = timonel.DeleteApplication();
+        while ((errors == 0) && !tiny85.Acknowledges(SIM_BOOT_ADDR)) {
+            delay(1);
+        }
+        if (errors == 0) {
+            sts = timonel.GetStatus();
+            errors = UploadVerified(&timonel, &payload, sts, &verify);
+        }
+    } else {
+        errors = UploadResumable(&timonel, &payload, sts, &verify);
+    }
+    BenchStop(&sample, &tiny85);
+    SimBus::Get(0)->Detach(&tiny85);
+    BenchPrint(sample);
+    bool resumes = (recovery == RECOVER_RESUME) || (recovery == RECOVER_POWER);
+    bool ok = (first_errors != 0) && (confirmed != 0) && (StoredConfirmed() == 0);
+    if (recovery == RECOVER_HALF) {
+        ok &= (errors == ERR_NEEDS_ERASE) && (tiny85.GetCounters().page_writes == page_writes);
+    } else {
+        ok &= (errors == 0) && (verify.first_bad_page == 0xFFFF) && ((verify.resumed == confirmed) == resumes) &&
+              (memcmp(tiny85.GetFlash() + SPM_PAGESIZE, app_image + SPM_PAGESIZE, app_size - SPM_PAGESIZE) == 0);
+    }
+    printf("%24s failed with %d after %d/%d pages confirmed, %d resumed, %d pages verified%s\n", "", first_errors, confirmed,
+           pages, verify.resumed, verify.pages_verified, ok ? "" : " UNEXPECTED");
+    return ok;
+}
+
+// Resumable uploads on the simulated Tiny85, with the NVS checkpoints in
+// a temporary directory. A verified upload loses a packet three quarters
+// of the way through; the recovery by erasing and uploading everything
+// again is timed against going on from the last confirmed page. The
+// checkpoint must also be found again after the Tiny85 is power cycled
+// (and by a new NVS handle, as after an ESP32 restart), and be dropped
+// when the device was erased meanwhile, or when any confirmed page (not
+// only the last one) differs, as on another board. A page left half
+// written that the payload can't be written over must be refused with
+// ERR_NEEDS_ERASE before anything is written.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    char nvs_root[] = "/tmp/timonel-nvs-XXXXXX";
+    if (mkdtemp(nvs_root) == nullptr) {
+        printf("Can't create the NVS directory\n");
+        return 1;
+    }
+    Preferences::SetRoot(nvs_root);
+    app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    BenchBanner(options);
+    BenchHeader();
+    bool all_ok = true;
+    all_ok &= RunRecovery(options, "erase + full upload", RECOVER_RESTART);
+    all_ok &= RunRecovery(options, "resume", RECOVER_RESUME);
+    all_ok &= RunRecovery(options, "power cycle + resume", RECOVER_POWER);
+    all_ok &= RunRecovery(options, "erased, no resume", RECOVER_ERASED);
+    all_ok &= RunRecovery(options, "swapped, no resume", RECOVER_SWAPPED);
+    all_ok &= RunRecovery(options, "half written, erase", RECOVER_HALF);
+    printf("\n%s\n", all_ok ? "Every upload recovered as expected" : "RESUME MISMATCH");
+    return all_ok ? 0 : 1;
+}
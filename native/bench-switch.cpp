@@ -0,0 +1,141 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-switch.cpp (Native benchmark)
+  ............................................................................
+  Bootloader <-> application round trips: legacy sequence against the
+  reconnect engine.
+  Usage: bench-switch [--cycles=n] [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "bench.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+#define LEGACY_SWITCH_DLY 250  // MODE_SWITCH_DLY before the reconnect engine
+#define LEGACY_HEADER_DLY 125  // ShowHeader delay before the reconnect engine
+
+// Switch latency figures
+struct SwitchStats {
+    uint32_t switches = 0, probes = 0, scans = 0;
+    uint64_t total_us = 0, max_us = 0;
+    void Add(const uint32_t latency_us, const uint16_t switch_probes, const bool scanned) {
+        switches++;
+        total_us += latency_us;
+        max_us = (latency_us > max_us) ? latency_us : max_us;
+        probes += switch_probes;
+        scans += scanned;
+    }
+};
+
+// Function LegacySwitch: send a mode switch command and wait for the device like the console used to
+uint8_t LegacySwitch(Timonel *timonel, const uint8_t cmd, const uint8_t ack, SwitchStats *stats) {
+    timonel->TwiCmdXmit(cmd, ack);
+    uint64_t start = SimClock::Now();
+    delay(LEGACY_SWITCH_DLY);
+    TwiBus twi_bus(SDA, SCL);
+    bool app_mode = false;
+    uint8_t twi_addr = 0;
+    uint16_t probes = 0;
+    while (twi_addr == 0) {
+        twi_addr = twi_bus.ScanBus(&app_mode);
+        probes += (twi_addr != 0) ? (twi_addr - LOW_TWI_ADDR + 1) : (HIG_TWI_ADDR - LOW_TWI_ADDR + 1);
+    }
+    delay(LEGACY_HEADER_DLY);
+    stats->Add(SimClock::Now() - start, probes, true);
+    return twi_addr;
+}
+
+// Function FastSwitch: send a mode switch command and wait for the device with the reconnect engine
+uint8_t FastSwitch(Timonel *timonel, const uint8_t cmd, const uint8_t ack, const DeviceMode expect, SwitchStats *stats) {
+    timonel->TwiCmdXmit(cmd, ack);
+    TwiBus twi_bus(SDA, SCL);
+    SwitchReport report;
+    uint8_t twi_addr = FindDevice(&twi_bus, expect, &report);
+    stats->Add(report.latency_us, report.probes, report.scanned);
+    return twi_addr;
+}
+
+// Function RunCycles: bootloader -> application -> bootloader round trips, false if a switch lands wrong
+bool RunCycles(const BenchOptions &options, const char *name, const uint16_t cycles, const bool legacy,
+               const bool with_app, const bool cold, const uint32_t wdt_linger_us = 0) {
+    TimonelSlave tiny85;
+    tiny85.GetTiming().wdt_linger_us = wdt_linger_us;
+    BenchSetup(options, &tiny85);
+    uint8_t app_image[MCU_TOTAL_MEM];
+    uint16_t app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    Timonel *timonel = new Timonel(SIM_BOOT_ADDR);
+    if (with_app) {
+        timonel->UploadApplication(app_image, app_size);
+    }
+    ForgetDevice();
+    TwiBus twi_bus(SDA, SCL);
+    SwitchReport report;
+    if (!cold) {
+        FindDevice(&twi_bus, MODE_ANY, &report); /* The console has seen the bootloader ... */
+    }
+    SwitchStats stats;
+    BenchSample sample;
+    bool landed_ok = true;
+    BenchStart(&sample, name, 0, &tiny85);
+    for (uint16_t cycle = 0; cycle < cycles; cycle++) {
+        uint8_t twi_addr = legacy ? LegacySwitch(timonel, EXITTMNL, AKEXITTM, &stats)
+                                  : FastSwitch(timonel, EXITTMNL, AKEXITTM, MODE_APPLICATION, &stats);
+        delete timonel;
+        timonel = new Timonel(twi_addr);
+        if (!with_app) {
+            landed_ok &= (twi_addr == SIM_BOOT_ADDR);
+            continue;
+        }
+        landed_ok &= (twi_addr == SIM_APP_ADDR);
+        twi_addr = legacy ? LegacySwitch(timonel, RESETMCU, ACKRESET, &stats)
+                          : FastSwitch(timonel, RESETMCU, ACKRESET, MODE_BOOTLOADER, &stats);
+        delete timonel;
+        timonel = new Timonel(twi_addr);
+        landed_ok &= (twi_addr == SIM_BOOT_ADDR);
+    }
+    BenchStop(&sample, &tiny85);
+    delete timonel;
+    SimBus::Get(0)->Detach(&tiny85);
+    BenchPrint(sample);
+    printf("%24s %lu switches: %.1f ms mean, %.1f ms max, %.1f probes/switch, %lu bus scans%s\n", "",
+           (unsigned long)stats.switches, stats.total_us / 1000.0 / stats.switches, stats.max_us / 1000.0,
+           (double)stats.probes / stats.switches, (unsigned long)stats.scans, landed_ok ? "" : " WRONG MODE");
+    return landed_ok;
+}
+
+// Bootloader <-> application round trips on the simulated Tiny85, the way
+// a test rig cycles them: EXITTMNL to run the application, then RESETMCU
+// back to Timonel. The legacy sequence (fixed MODE_SWITCH_DLY, full bus
+// sweeps, the 125 ms header delay) is compared with the reconnect engine,
+// plus 'r' without an application and a cold start with no known address.
+// A Tiny85 whose application keeps answering for 30 ms after RESETMCU,
+// until its watchdog fires, must still be found in the bootloader.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    unsigned long cycles = 100;
+    for (int i = 1; i < argc; i++) {
+        sscanf(argv[i], "--cycles=%lu", &cycles);
+    }
+    bool all_ok = true;
+    BenchBanner(options);
+    BenchHeader();
+    all_ok &= RunCycles(options, "legacy r/z cycles", cycles, true, true, false);
+    all_ok &= RunCycles(options, "reconnect r/z cycles", cycles, false, true, false);
+    all_ok &= RunCycles(options, "reconnect r/z cold", 1, false, true, true);
+    all_ok &= RunCycles(options, "reconnect r/z, slow WDT", cycles, false, true, false, 30000);
+    all_ok &= RunCycles(options, "legacy r, no app", cycles, true, false, false);
+    all_ok &= RunCycles(options, "reconnect r, no app", cycles, false, false, false);
+    printf("\n%s\n", all_ok ? "Every switch landed in the expected mode" : "WRONG MODE");
+    return all_ok ? 0 : 1;
+}
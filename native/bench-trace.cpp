@@ -0,0 +1,324 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-trace.cpp (Native benchmark)
+  ............................................................................
+  I2C trace export, parse and replay against the timing model.
+  Usage: bench-trace [--replay=file] [--save=file] [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include <esp32-hal-i2c.h>
+
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "flash-sync.h"
+#include "i2c-trace.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+#define BENCH_SLOWER_PCT 125  // Page write time of the regressed model (% of the recorded one)
+#define BENCH_TOLERANCE_US 50 // A replayed transfer this much longer than recorded is flagged
+#define BENCH_IDLE_TOP 5      // Longest idle stretches listed
+
+uint8_t app_image[MCU_TOTAL_MEM];
+uint16_t app_size = 0;
+
+// Export target: the JSON in a string
+class StringPrint : public Print {
+   public:
+    size_t write(uint8_t data) {
+        text_ += (char)data;
+        return 1;
+    }
+    const std::string &GetText(void) const { return text_; }
+
+   private:
+    std::string text_;
+};
+
+// A transfer or span read back from the JSON
+struct TraceLine {
+    char name[32] = "";
+    char cat[8] = "";
+    unsigned long ts = 0, dur = 0;
+    int tid = 0, addr = 0, len = 0, khz = 0, result = 0;
+    std::vector<uint8_t> data;
+    bool IsTransfer(void) const { return (strcmp(cat, "write") == 0) || (strcmp(cat, "read") == 0); }
+};
+
+// Replay outcome
+struct ReplayReport {
+    uint32_t transfers = 0;
+    uint32_t mismatched = 0;   /* Result or reply bytes differ */
+    uint32_t slower = 0;       /* Longer than recorded by more than BENCH_TOLERANCE_US */
+    uint32_t faster = 0;
+    uint32_t short_data = 0;   /* Writes longer than the bytes kept (TRACE_DATA): padded */
+    uint64_t recorded_us = 0;  /* Transfer time, recorded and replayed */
+    uint64_t replayed_us = 0;
+    uint32_t worst_us = 0;     /* Largest slowdown of a transfer */
+    const TraceLine *worst = nullptr;
+};
+
+// Function ParseTrace: the events of a Chrome trace JSON written by TraceExport, other lines are skipped
+std::vector<TraceLine> ParseTrace(const std::string &json) {
+    std::vector<TraceLine> lines;
+    size_t from = 0;
+    while (from < json.size()) {
+        size_t to = json.find('\n', from);
+        to = (to == std::string::npos) ? json.size() : to;
+        std::string text = json.substr(from, to - from);
+        from = to + 1;
+        TraceLine line;
+        if (sscanf(text.c_str(), "{\"name\":\"%31[^\"]\",\"cat\":\"%7[^\"]\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%lu,\"pid\":1,\"tid\":%d", line.name,
+                   line.cat, &line.ts, &line.dur, &line.tid) != 5) {
+            continue;
+        }
+        size_t args = text.find("\"args\":{\"addr\":");
+        if (line.IsTransfer() && (args != std::string::npos)) {
+            char hex[2 * I2C_BUFFER_LENGTH + 1] = "";
+            if (sscanf(text.c_str() + args, "\"args\":{\"addr\":%d,\"len\":%d,\"khz\":%d,\"result\":%d,\"data\":\"%256[0-9a-f]", &line.addr,
+                       &line.len, &line.khz, &line.result, hex) < 4) {
+                continue;
+            }
+            for (size_t ix = 0; (ix + 1) < strlen(hex); ix += 2) {
+                unsigned int value = 0;
+                sscanf(&hex[ix], "%2x", &value);
+                line.data.push_back((uint8_t)value);
+            }
+        }
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+// Function Replay: send the recorded transfers to a fresh Tiny85 with "timing", each at its recorded time
+ReplayReport Replay(const std::vector<TraceLine> &trace, const TimonelSlave::Timing &timing, const bool verbose) {
+    ReplayReport report;
+    TimonelSlave tiny85;
+    tiny85.GetTiming() = timing;
+    SimBus::Get(0)->Attach(&tiny85);
+    uint64_t origin_us = SimClock::Now();
+    for (const TraceLine &line : trace) {
+        if (!line.IsTransfer() || (line.tid != 1)) {
+            continue;
+        }
+        SimClock::AdvanceTo(origin_us + line.ts);
+        i2cSetClock(0, (uint32_t)line.khz * 1000);
+        uint8_t buffer[I2C_BUFFER_LENGTH] = {0};
+        size_t length = ((size_t)line.len < sizeof(buffer)) ? (size_t)line.len : sizeof(buffer);
+        uint64_t start_us = SimClock::Now();
+        esp_err_t err;
+        bool same = true;
+        if (strcmp(line.cat, "write") == 0) {
+            memcpy(buffer, line.data.data(), line.data.size());
+            report.short_data += (line.data.size() < length) ? 1 : 0;
+            err = i2cWrite(0, line.addr, buffer, length, 50);
+        } else {
+            size_t count = 0;
+            err = i2cRead(0, line.addr, buffer, length, 50, &count);
+            same = (err != ESP_OK) || (memcmp(buffer, line.data.data(), line.data.size()) == 0);
+        }
+        uint32_t duration_us = (uint32_t)(SimClock::Now() - start_us);
+        same &= (((err == ESP_OK) ? 0 : 1) == line.result);
+        report.transfers++;
+        report.mismatched += same ? 0 : 1;
+        report.recorded_us += line.dur;
+        report.replayed_us += duration_us;
+        if (duration_us > (line.dur + BENCH_TOLERANCE_US)) {
+            report.slower++;
+            if ((duration_us - line.dur) > report.worst_us) {
+                report.worst_us = duration_us - line.dur;
+                report.worst = &line;
+            }
+        } else if ((duration_us + BENCH_TOLERANCE_US) < line.dur) {
+            report.faster++;
+        }
+        if (verbose && (!same || (duration_us != line.dur))) {
+            printf("%24s %-8s @%lu us: %s, %lu us (recorded %lu us)\n", "", line.name, line.ts, same ? "same" : "DIFFERS",
+                   (unsigned long)duration_us, line.dur);
+        }
+    }
+    SimBus::Get(0)->Detach(&tiny85);
+    return report;
+}
+
+// Function PrintReplay: one line per replay
+void PrintReplay(const char *title, const ReplayReport &report) {
+    printf("%-28s %lu transfers, %lu differ, %lu slower, %lu faster | bus %.1f ms recorded, %.1f ms replayed", title,
+           (unsigned long)report.transfers, (unsigned long)report.mismatched, (unsigned long)report.slower,
+           (unsigned long)report.faster, report.recorded_us / 1000.0, report.replayed_us / 1000.0);
+    if (report.worst != nullptr) {
+        printf(" | worst +%lu us (%s @%lu us)", (unsigned long)report.worst_us, report.worst->name, report.worst->ts);
+    }
+    if (report.short_data != 0) {
+        printf(" | %lu writes padded (TRACE_DATA %d)", (unsigned long)report.short_data, TRACE_DATA);
+    }
+    printf("\n");
+}
+
+// Function PrintIdle: the longest idle stretches of the bus and the operation each one fell in
+void PrintIdle(const std::vector<TraceLine> &trace) {
+    std::vector<const TraceLine *> gaps;
+    uint64_t idle_us = 0, span_us = 0;
+    for (const TraceLine &line : trace) {
+        if (strcmp(line.cat, "idle") == 0) {
+            gaps.push_back(&line);
+            idle_us += line.dur;
+        }
+        span_us = ((line.ts + line.dur) > span_us) ? (line.ts + line.dur) : span_us;
+    }
+    printf("\n%-28s %lu stretches over %d us, %.1f of %.1f ms\n", "bus idle", (unsigned long)gaps.size(), TRACE_IDLE_US, idle_us / 1000.0,
+           span_us / 1000.0);
+    for (uint8_t top = 0; (top < BENCH_IDLE_TOP) && (top < gaps.size()); top++) {
+        size_t longest = top;
+        for (size_t ix = top + 1; ix < gaps.size(); ix++) {
+            longest = (gaps[ix]->dur > gaps[longest]->dur) ? ix : longest;
+        }
+        const TraceLine *gap = gaps[longest];
+        gaps[longest] = gaps[top];
+        gaps[top] = gap;
+        const TraceLine *within = nullptr; /* Innermost operation holding the gap */
+        for (const TraceLine &line : trace) {
+            if ((strcmp(line.cat, "op") == 0) && (line.ts <= gap->ts) && ((line.ts + line.dur) >= (gap->ts + gap->dur)) &&
+                ((within == nullptr) || (line.dur < within->dur))) {
+                within = &line;
+            }
+        }
+        const TraceLine *next = nullptr; /* Transfer that ended it */
+        for (const TraceLine &line : trace) {
+            if (line.IsTransfer() && (line.ts >= (gap->ts + gap->dur)) && (line.tid == gap->tid)) {
+                next = &line;
+                break;
+            }
+        }
+        printf("%28s %8.1f ms @%lu us, in %s, before %s\n", "", gap->dur / 1000.0, gap->ts, (within != nullptr) ? within->name : "-",
+               (next != nullptr) ? next->name : "-");
+    }
+}
+
+// Function Record: the session traced on the simulated Tiny85, as exported by 'j'
+std::string Record(const BenchOptions &options) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    TraceClear();
+    Timonel timonel(SIM_BOOT_ADDR);
+    Timonel::Status sts = timonel.GetStatus();
+    RawPayload payload(app_image, app_size);
+    VerifyReport verify;
+    BenchSample sample;
+    BenchStart(&sample, "verified upload, run", app_size, &tiny85);
+    uint8_t errors = UploadVerified(&timonel, &payload, sts, &verify);
+    errors += timonel.RunApplication();
+    delay(MODE_SWITCH_DLY);
+    BenchStop(&sample, &tiny85);
+    SimBus::Get(0)->Detach(&tiny85);
+    BenchPrint(sample);
+    uint32_t count = TraceCount(), lost = TraceLost();
+    StringPrint json;
+    TraceExport(&json);
+    printf("%24s %lu events (%lu lost), %lu bytes of JSON%s\n", "", (unsigned long)count, (unsigned long)lost,
+           (unsigned long)json.GetText().size(), (errors == 0) ? "" : ", UPLOAD FAILED");
+    return json.GetText();
+}
+
+// I2C trace and replay: a verified upload and application start on the
+// simulated Tiny85 are recorded, exported as Chrome trace JSON ('j') and
+// parsed back, every transfer must survive the round trip. Then the trace
+// is replayed on a fresh Tiny85: each transfer is sent at its recorded
+// time with its recorded SCL rate and bytes, and its result, reply and
+// duration compared with the recording. The same timing model must
+// replay it exactly; one whose page writes take 25% longer must be
+// flagged. The longest idle stretches of the bus are listed with the
+// operation they fell in.
+// --save writes the recorded trace to a file, --replay replays a trace
+// from a file (e.g. one dumped with 'j' on the ESP32, the marker lines
+// may be left in) against the timing model given, to catch regressions.
+// Built with -D I2C_TRACE and the HAL wrapped (see platformio.ini).
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    char replay_path[256] = "", save_path[256] = "";
+    for (int i = 1; i < argc; i++) {
+        sscanf(argv[i], "--replay=%255s", replay_path);
+        sscanf(argv[i], "--save=%255s", save_path);
+    }
+    TimonelSlave::Timing timing;
+    timing.page_erase_us = options.page_erase_us;
+    timing.page_write_us = options.page_write_us;
+    BenchBanner(options);
+    USE_SERIAL.SetEcho(options.verbose);
+    if (replay_path[0] != '\0') {
+        // A trace from a file against the timing model given
+        FILE *file = fopen(replay_path, "r");
+        if (file == nullptr) {
+            printf("Can't open %s\n", replay_path);
+            return 1;
+        }
+        std::string json;
+        char chunk[4096];
+        size_t got;
+        while ((got = fread(chunk, 1, sizeof(chunk), file)) != 0) {
+            json.append(chunk, got);
+        }
+        fclose(file);
+        std::vector<TraceLine> trace = ParseTrace(json);
+        ReplayReport report = Replay(trace, timing, options.verbose);
+        printf("\n");
+        PrintReplay(replay_path, report);
+        PrintIdle(trace);
+        bool ok = (report.transfers != 0) && (report.mismatched == 0) && (report.slower == 0);
+        printf("\n%s\n", ok ? "Replay matches the trace" : "REPLAY REGRESSION");
+        return ok ? 0 : 1;
+    }
+    app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    BenchHeader();
+    uint32_t events = TRACE_EVENTS;
+    std::string json = Record(options);
+    if (save_path[0] != '\0') {
+        FILE *file = fopen(save_path, "w");
+        bool saved = (file != nullptr) && (fwrite(json.data(), 1, json.size(), file) == json.size());
+        if (file != nullptr) {
+            fclose(file);
+        }
+        printf("%24s trace %s %s\n", "", saved ? "saved to" : "NOT SAVED to", save_path);
+    }
+    // Round trip: every event back from the JSON
+    std::vector<TraceLine> trace = ParseTrace(json);
+    unsigned long recorded = 0, parsed = 0;
+    sscanf(json.c_str(), "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"events\":%lu", &recorded);
+    for (const TraceLine &line : trace) {
+        parsed += (strcmp(line.cat, "idle") != 0) ? 1 : 0;
+    }
+    bool round_trip = (recorded != 0) && (recorded < events) && (parsed == recorded);
+    printf("\n%-28s %lu of %lu events parsed back\n", "round trip", parsed, recorded);
+    // Same model: exact; page writes slower: flagged
+    printf("\n");
+    ReplayReport same = Replay(trace, timing, options.verbose);
+    PrintReplay("replay, same model", same);
+    TimonelSlave::Timing slower = timing;
+    slower.page_write_us = (timing.page_write_us * BENCH_SLOWER_PCT) / 100;
+    ReplayReport regressed = Replay(trace, slower, options.verbose);
+    char title[40];
+    snprintf(title, sizeof(title), "replay, page write %d%%", BENCH_SLOWER_PCT);
+    PrintReplay(title, regressed);
+    PrintIdle(trace);
+    bool exact = (same.transfers != 0) && (same.mismatched == 0) && (same.slower == 0) && (same.faster == 0) &&
+                 (same.replayed_us == same.recorded_us) && (same.short_data == 0);
+    bool flagged = (regressed.slower != 0);
+    printf("\n%-28s %s\n", "same model", exact ? "replayed exactly" : "REPLAY DIFFERS");
+    printf("%-28s %s\n", "slower page writes", flagged ? "flagged" : "NOT FLAGGED");
+    bool ok = round_trip && exact && flagged;
+    printf("\n%s\n", ok ? "Trace round trip and replay check passed" : "TRACE MISMATCH");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-upload.cpp (Native benchmark)
+  ............................................................................
+  Flashing throughput against the simulated Tiny85.
+  Usage: bench-upload [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "bench.h"
+
+// Private copy of the payload the master was built with, to check the flash
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+extern uint16_t flash_page_addr;
+
+// Type a console command key and run the main loop until it is served
+void RunCommand(const char key, BenchSample *sample, const char *name, const uint32_t bytes, TimonelSlave *tiny85) {
+    const char keys[] = {key, '\0'};
+    USE_SERIAL.Inject(keys);
+    loop(); /* The key is read at the end of a loop pass ... */
+    BenchStart(sample, name, bytes, tiny85);
+    loop(); /* ... and served on the next one */
+    while (CommandPending()) {
+        loop(); /* 'e' goes on until the device is back */
+    }
+    BenchStop(sample, tiny85);
+}
+
+// Function CountMismatches: application bytes that differ from the image. Page 0 starts with the jump to
+// the bootloader, Timonel relocates the app reset vector.
+uint16_t CountMismatches(TimonelSlave *tiny85, const uint8_t *app_image, const uint16_t app_size) {
+    uint16_t mismatches = 0;
+    for (uint16_t i = 2; i < app_size; i++) {
+        if (tiny85->GetFlash()[flash_page_addr + i] != app_image[i]) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+// Function Erased: whether the application area is blank
+bool Erased(TimonelSlave *tiny85) {
+    return (tiny85->GetFlash()[flash_page_addr + 2] == 0xFF) && (tiny85->GetFlash()[tiny85->GetBootloaderStart() - 1] == 0xFF);
+}
+
+// Flashing throughput against the simulated Tiny85, in two parts:
+// - Library baseline: UploadApplication(payload, size, flash_page_addr),
+//   DumpMemory() and DeleteApplication() called straight on a Timonel
+//   instance at the fixed --clock rate (100 kHz by default). This is the
+//   number to compare across changes to the master's upload path.
+// - Console end to end: the demo setup() and then the 'w', 'm' and 'e'
+//   keys, as a user runs them. 'w' is the adaptive upload (I2C clock
+//   negotiation, readback verify, NVS checkpoints), 'm' the binary flash
+//   dump and 'e' the DELFLASH console job, so these rows move with every
+//   feature added to those commands.
+// Each one is timed on the virtual clock, reporting bytes/s, wall time
+// and I2C transactions. Both uploads are checked against the emulated
+// flash, and both erases must leave it blank, or the program exits with
+// an error.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    TimonelSlave tiny85;
+    BenchBanner(options);
+    BenchSetup(options, &tiny85);
+    setup();
+
+    uint8_t app_image[MCU_TOTAL_MEM];
+    uint16_t app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    BenchSample upload, dump, erase, console_upload, console_dump, console_erase;
+
+    SimBus::Get(0)->SetClock(options.twi_clock);
+    Timonel timonel(SIM_BOOT_ADDR);
+    timonel.GetStatus();
+    BenchStart(&upload, "UploadApplication", app_size, &tiny85);
+    uint8_t errors = timonel.UploadApplication(app_image, app_size, flash_page_addr);
+    BenchStop(&upload, &tiny85);
+    uint16_t mismatches = CountMismatches(&tiny85, app_image, app_size);
+#if ((defined FEATURES_CODE) && ((FEATURES_CODE >> F_CMD_READFLASH) & true))
+    BenchStart(&dump, "DumpMemory", MCU_TOTAL_MEM, &tiny85);
+    errors |= timonel.DumpMemory(MCU_TOTAL_MEM, SLV_PACKET_SIZE, 32);
+    BenchStop(&dump, &tiny85);
+#endif  // F_CMD_READFLASH
+    BenchStart(&erase, "DeleteApplication", tiny85.GetBootloaderStart(), &tiny85);
+    errors |= timonel.DeleteApplication();
+    BenchStop(&erase, &tiny85);
+    bool erased = Erased(&tiny85);
+
+    RunCommand('w', &console_upload, "'w' console upload", app_size, &tiny85);
+    uint16_t console_mismatches = CountMismatches(&tiny85, app_image, app_size);
+#if ((defined FEATURES_CODE) && ((FEATURES_CODE >> F_CMD_READFLASH) & true))
+    RunCommand('m', &console_dump, "'m' console dump", MCU_TOTAL_MEM, &tiny85);
+#endif  // F_CMD_READFLASH
+    RunCommand('e', &console_erase, "'e' console erase", tiny85.GetBootloaderStart(), &tiny85);
+    bool console_erased = Erased(&tiny85);
+
+    printf("\nLibrary calls at %lu Hz\n", (unsigned long)options.twi_clock);
+    BenchHeader();
+    BenchPrint(upload);
+#if ((defined FEATURES_CODE) && ((FEATURES_CODE >> F_CMD_READFLASH) & true))
+    BenchPrint(dump);
+#endif  // F_CMD_READFLASH
+    BenchPrint(erase);
+    printf("\nConsole commands, end to end\n");
+    BenchHeader();
+    BenchPrint(console_upload);
+#if ((defined FEATURES_CODE) && ((FEATURES_CODE >> F_CMD_READFLASH) & true))
+    BenchPrint(console_dump);
+#endif  // F_CMD_READFLASH
+    BenchPrint(console_erase);
+    printf("\nFlash mismatches after upload: %d library, %d console | application erased: %s library, %s console\n", mismatches,
+           console_mismatches, erased ? "yes" : "no", console_erased ? "yes" : "no");
+    bool ok = (errors == 0) && (mismatches == 0) && (console_mismatches == 0) && erased && console_erased;
+    return ok ? 0 : 1;
+}
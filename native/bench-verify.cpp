@@ -0,0 +1,160 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench-verify.cpp (Native benchmark)
+  ............................................................................
+  Cost of verified flashing on the simulated Tiny85.
+  Usage: bench-verify [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "bench.h"
+#include "flash-dump.h"
+#include "flash-sync.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif  // PAYLOAD_PACKED
+
+#define BENCH_WEAK_PAGE 0x0180  // Page the faulty device doesn't program fully
+
+#ifdef PAYLOAD_MANIFEST
+typedef PayloadLayout<image::payload_start, image::payload_image_size, image::payload_reset_vector,
+                      sizeof(image::payload_page_crc) / sizeof(image::payload_page_crc[0])>
+    ImageLayout;
+const ImageManifest manifest = ImageLayout::Make(image::payload_fingerprint, image::payload_page_crc);
+#endif  // PAYLOAD_MANIFEST
+
+uint8_t app_image[MCU_TOTAL_MEM];
+uint16_t app_size = 0;
+
+enum VerifyMode {
+    VERIFY_NONE,     /* UploadPages */
+    VERIFY_AFTER,    /* UploadPages, then read every page back */
+    VERIFY_PAGES,    /* UploadVerified */
+    VERIFY_MANIFEST  /* UploadVerified, page CRCs from the manifest */
+};
+
+// Function ReadBack: compare the CRC of every image page with the device flash, false on a mismatch
+bool ReadBack(Timonel *timonel) {
+    uint8_t page[SPM_PAGESIZE];
+    for (uint16_t page_addr = SPM_PAGESIZE; page_addr < app_size; page_addr += SPM_PAGESIZE) {
+        uint16_t page_bytes = ((app_size - page_addr) < SPM_PAGESIZE) ? (app_size - page_addr) : SPM_PAGESIZE;
+        if ((ReadFlash(timonel, page_addr, page, SPM_PAGESIZE) != 0) ||
+            (Crc16(0xFFFF, page, page_bytes) != Crc16(0xFFFF, &app_image[page_addr], page_bytes))) {
+            return false;
+        }
+    }
+    // Page 0 comes back relocated, so only its last bytes are compared here
+    return (ReadFlash(timonel, 0, page, SPM_PAGESIZE) == 0) && (memcmp(&page[2], &app_image[2], SPM_PAGESIZE - 2) == 0);
+}
+
+// Function RunUpload: flash the image on a blank device, true if the outcome is the expected one
+bool RunUpload(const BenchOptions &options, const char *name, const VerifyMode mode, const uint16_t weak_page,
+               const bool expect_ok, const ImageManifest *image_manifest = nullptr) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    Timonel timonel(SIM_BOOT_ADDR);
+    Timonel::Status sts = timonel.GetStatus();
+    tiny85.WeakPage(weak_page);
+    RawPayload payload(app_image, app_size);
+    payload.SetManifest(image_manifest);
+    VerifyReport verify;
+    BenchSample sample;
+    BenchStart(&sample, name, app_size, &tiny85);
+    uint8_t errors = 0;
+    bool matches = true;
+    if ((mode == VERIFY_PAGES) || (mode == VERIFY_MANIFEST)) {
+        errors = UploadVerified(&timonel, &payload, sts, &verify);
+    } else {
+        errors = UploadPages(&timonel, &payload);
+        if ((errors == 0) && (mode == VERIFY_AFTER)) {
+            matches = ReadBack(&timonel);
+        }
+    }
+    BenchStop(&sample, &tiny85);
+    SimBus::Get(0)->Detach(&tiny85);
+    BenchPrint(sample);
+    bool verified = (mode == VERIFY_PAGES) || (mode == VERIFY_MANIFEST);
+    bool ok = verified ? ((errors == 0) == expect_ok) : (((errors == 0) && matches) == expect_ok);
+    if (verified) {
+        char first_bad[16] = "none";
+        if (verify.first_bad_page != 0xFFFF) {
+            snprintf(first_bad, sizeof(first_bad), "0x%04X", verify.first_bad_page);
+        }
+        printf("%24s %d/%d pages verified, first bad page %s, readback %.1f ms (%.1f ms after the upload)%s\n", "",
+               verify.pages_verified, verify.pages, first_bad, verify.readback_us / 1000.0, verify.tail_us / 1000.0,
+               ok ? "" : " UNEXPECTED");
+        ok &= (verify.first_bad_page == weak_page);
+    }
+    return ok;
+}
+
+#ifdef PAYLOAD_MANIFEST
+// Function RunNoRoom: a manifest reaching the trampoline page must be refused without any bus traffic
+bool RunNoRoom(const BenchOptions &options) {
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    Timonel timonel(SIM_BOOT_ADDR);
+    Timonel::Status sts = timonel.GetStatus();
+    ImageManifest too_large = manifest;
+    too_large.image_size = sts.bootloader_start - SPM_PAGESIZE + 1;
+    RawPayload payload(app_image, app_size);
+    payload.SetManifest(&too_large);
+    VerifyReport verify;
+    BenchSample sample;
+    BenchStart(&sample, "no room, manifest", app_size, &tiny85);
+    uint8_t errors = UploadVerified(&timonel, &payload, sts, &verify);
+    BenchStop(&sample, &tiny85);
+    SimBus::Get(0)->Detach(&tiny85);
+    BenchPrint(sample);
+    // The build-time trampoline must be the one worked out from the flashed reset vector
+    bool ok = (errors == ERR_NO_ROOM) && (sample.bus.transactions == 0) &&
+              (ManifestAppStart(manifest, SIM_TIMONEL_START) == TrampolineFor(app_image, SIM_TIMONEL_START)) &&
+              (ManifestAppStart(manifest, SIM_TIMONEL_START - SPM_PAGESIZE) == TrampolineFor(app_image, SIM_TIMONEL_START - SPM_PAGESIZE));
+    printf("%24s refused with %d before any transaction, build-time trampoline 0x%04X%s\n", "", errors, manifest.application_start,
+           ok ? "" : " UNEXPECTED");
+    return ok;
+}
+#endif  // PAYLOAD_MANIFEST
+
+// Cost of verified flashing on the simulated Tiny85: an unverified upload
+// (UploadPages), the same upload followed by a full readback of its pages,
+// and UploadVerified, which reads each page back once it is written, or
+// during the next page's write delays when built with the experimental
+// VERIFY_OVERLAP (native-bench-verify-overlap). Then a device with a page that doesn't program fully
+// (every packet checksum is still fine) must be caught, at that page.
+// With the payload.h manifest, the verified upload takes the page CRCs
+// and trampoline from it, and a payload too large for the device must be
+// refused before anything goes on the bus.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    BenchBanner(options);
+#ifdef VERIFY_OVERLAP
+    printf("Verified uploads read each page during the next page's delays (VERIFY_OVERLAP, experimental)\n");
+#else
+    printf("Verified uploads read each page once its write delay is over\n");
+#endif  // VERIFY_OVERLAP
+    BenchHeader();
+    bool all_ok = true;
+    all_ok &= RunUpload(options, "upload, unverified", VERIFY_NONE, 0xFFFF, true);
+    all_ok &= RunUpload(options, "upload + readback", VERIFY_AFTER, 0xFFFF, true);
+    all_ok &= RunUpload(options, "upload, verified", VERIFY_PAGES, 0xFFFF, true);
+    all_ok &= RunUpload(options, "weak page + readback", VERIFY_AFTER, BENCH_WEAK_PAGE, false);
+    all_ok &= RunUpload(options, "weak page, verified", VERIFY_PAGES, BENCH_WEAK_PAGE, false);
+#ifdef PAYLOAD_MANIFEST
+    all_ok &= RunUpload(options, "upload, manifest", VERIFY_MANIFEST, 0xFFFF, true, &manifest);
+    all_ok &= RunUpload(options, "weak page, manifest", VERIFY_MANIFEST, BENCH_WEAK_PAGE, false, &manifest);
+    all_ok &= RunNoRoom(options);
+#endif  // PAYLOAD_MANIFEST
+    printf("\n%s\n", all_ok ? "Every upload verified as expected" : "VERIFY MISMATCH");
+    return all_ok ? 0 : 1;
+}
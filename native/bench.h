@@ -0,0 +1,124 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bench.h (Native benchmark helpers)
+  ............................................................................
+  Shared plumbing for the native benchmarks: simulated timing options,
+  per-operation samples (virtual time, host CPU time, bus counters) and
+  the result table.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifndef TIMONEL_MSS_BENCH_H
+#define TIMONEL_MSS_BENCH_H
+
+#include <SimBus.h>
+#include <SimClock.h>
+#include <TimonelSlave.h>
+#include <time.h>
+
+#include "payload-stream.h"
+#include "timonel-mss-esp32.h"
+
+// Timing model options, "--name=value" on the command line
+struct BenchOptions {
+    uint32_t twi_clock = SIM_DEFAULT_CLOCK; /* --clock: SCL frequency (Hz) */
+    uint32_t page_erase_us = 4500;          /* --erase-us: SPM page erase time */
+    uint32_t page_write_us = 4500;          /* --write-us: SPM page write time */
+    bool verbose = false;                   /* --verbose: show console output */
+};
+
+// One measured operation
+struct BenchSample {
+    const char *name = "";
+    uint32_t bytes = 0;
+    uint64_t start_us = 0, sim_us = 0;
+    double cpu_ms = 0;
+    clock_t cpu_start = 0;
+    SimBus::Stats bus_start, bus;
+    uint32_t page_writes = 0, page_writes_start = 0;
+};
+
+inline BenchOptions BenchParse(int argc, char *argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        unsigned long value = 0;
+        if (sscanf(argv[i], "--clock=%lu", &value) == 1) {
+            options.twi_clock = value;
+        } else if (sscanf(argv[i], "--erase-us=%lu", &value) == 1) {
+            options.page_erase_us = value;
+        } else if (sscanf(argv[i], "--write-us=%lu", &value) == 1) {
+            options.page_write_us = value;
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            options.verbose = true;
+        }
+    }
+    return options;
+}
+
+inline void BenchSetup(const BenchOptions &options, TimonelSlave *tiny85) {
+    tiny85->GetTiming().page_erase_us = options.page_erase_us;
+    tiny85->GetTiming().page_write_us = options.page_write_us;
+    SimBus::Get(0)->Attach(tiny85);
+    SimBus::Get(0)->SetClock(options.twi_clock);
+    USE_SERIAL.SetEcho(options.verbose);
+}
+
+// Plain image of a payload.h array, TPZ packed by payload-gen.py or not
+inline uint16_t BenchImage(const uint8_t payload[], const uint16_t payload_size, const bool packed, uint8_t *image) {
+    if (!packed) {
+        memcpy(image, payload, payload_size);
+        return payload_size;
+    }
+    PackedPayload source(payload, payload_size);
+    return source.Unpack(image, source.GetImageSize());
+}
+
+inline void BenchBanner(const BenchOptions &options) {
+    printf("Timing model: SCL %lu Hz | SPM erase %lu us + write %lu us | packets M>S %d, S>M %d | page %d\n",
+           (unsigned long)options.twi_clock, (unsigned long)options.page_erase_us, (unsigned long)options.page_write_us,
+           MST_PACKET_SIZE, SLV_PACKET_SIZE, SPM_PAGESIZE);
+}
+
+inline void BenchStart(BenchSample *sample, const char *name, const uint32_t bytes, TimonelSlave *tiny85) {
+    sample->name = name;
+    sample->bytes = bytes;
+    sample->start_us = SimClock::Now();
+    sample->bus_start = SimBus::Get(0)->GetStats();
+    sample->page_writes_start = tiny85->GetCounters().page_writes;
+    sample->cpu_start = clock();
+}
+
+inline void BenchStop(BenchSample *sample, TimonelSlave *tiny85) {
+    sample->cpu_ms = (double)(clock() - sample->cpu_start) * 1000.0 / CLOCKS_PER_SEC;
+    SimBus::Stats now = SimBus::Get(0)->GetStats();
+    sample->sim_us = SimClock::Now() - sample->start_us;
+    sample->bus.transactions = now.transactions - sample->bus_start.transactions;
+    sample->bus.writes = now.writes - sample->bus_start.writes;
+    sample->bus.reads = now.reads - sample->bus_start.reads;
+    sample->bus.nacks = now.nacks - sample->bus_start.nacks;
+    sample->bus.bytes_tx = now.bytes_tx - sample->bus_start.bytes_tx;
+    sample->bus.bytes_rx = now.bytes_rx - sample->bus_start.bytes_rx;
+    sample->bus.bus_us = now.bus_us - sample->bus_start.bus_us;
+    sample->bus.stretch_us = now.stretch_us - sample->bus_start.stretch_us;
+    sample->bus.faults = now.faults - sample->bus_start.faults;
+    sample->page_writes = tiny85->GetCounters().page_writes - sample->page_writes_start;
+}
+
+inline void BenchHeader(void) {
+    printf("\n%-24s %7s %10s %10s %7s %6s %6s %6s %9s %9s %6s %8s\n", "operation", "bytes", "wall ms", "bytes/s",
+           "i2c tx", "wr", "rd", "nack", "bus ms", "stretch", "pages", "cpu ms");
+}
+
+inline void BenchPrint(const BenchSample &sample) {
+    double wall_ms = sample.sim_us / 1000.0;
+    double rate = (sample.sim_us > 0) ? (sample.bytes * 1000000.0 / sample.sim_us) : 0;
+    printf("%-24s %7lu %10.1f %10.0f %7lu %6lu %6lu %6lu %9.1f %9.1f %6lu %8.2f\n", sample.name, (unsigned long)sample.bytes,
+           wall_ms, rate, (unsigned long)sample.bus.transactions, (unsigned long)sample.bus.writes,
+           (unsigned long)sample.bus.reads, (unsigned long)sample.bus.nacks, sample.bus.bus_us / 1000.0,
+           sample.bus.stretch_us / 1000.0, (unsigned long)sample.page_writes, sample.cpu_ms);
+}
+
+#endif  // TIMONEL_MSS_BENCH_H
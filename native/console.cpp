@@ -0,0 +1,36 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: console.cpp (Native entry point)
+  ............................................................................
+  Runs the interactive serial commander on the host, against a simulated
+  Tiny85 running Timonel.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include <TimonelSlave.h>
+
+#include "timonel-mss-esp32.h"
+
+// Runs the interactive serial commander on the host: the Arduino setup()
+// and loop() from src/ drive a simulated Tiny85 running Timonel. Keys are
+// read from stdin, a terminal is switched to raw mode so single keys act
+// like on the serial console. The Tiny85 takes the general call, for the
+// 'g' broadcast when built with BROADCAST_UPLOAD, and a second one sits
+// on the other I2C controller, for the multi-slave 'x' command.
+int main(void) {
+    TimonelSlave tiny85;
+    TimonelSlave tiny85_bus1(12, 45);
+    tiny85.SetGeneralCall(true);
+    SimBus::Get(0)->Attach(&tiny85);
+    SimBus::Get(1)->Attach(&tiny85_bus1);
+    setvbuf(stdout, nullptr, _IONBF, 0);
+    USE_SERIAL.SetStdin(true);
+    setup();
+    for (;;) {
+        loop();
+    }
+    return 0;
+}
@@ -0,0 +1,358 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: load-ingest.cpp (Native load test)
+  ............................................................................
+  TCP firmware ingest under load: many clients, one I2C engine.
+  Usage: load-ingest [--clients=n] [--jobs=n] [--clock=Hz] [--erase-us=us] [--write-us=us] [--verbose]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "flash-dump.h"
+#include "tcp-ingest.h"
+
+namespace image {
+#include "payload.h"
+}
+#ifdef PAYLOAD_PACKED
+const bool payload_packed = true;
+#else
+const bool payload_packed = false;
+#endif
+
+#define LOAD_TIMEOUT_MS 500  // Ingest idle timeout in the load test, keeps the stalled client short
+#define LOAD_STEP_US 200     // Idle step of the server and engine threads (real and virtual)
+#define LOAD_TAG_SIZE 4      // Client and job number appended to every image
+
+// What a client does with its images
+enum ClientKind { CLIENT_NORMAL, CLIENT_SLOW, CLIENT_STALLED, CLIENT_BAD_CRC, CLIENT_BAD_VECTOR, CLIENT_BAD_HEADER };
+
+struct ClientPlan {
+    ClientKind kind = CLIENT_NORMAL;
+    uint8_t jobs = 1;
+    // Outcome
+    uint8_t done_ok = 0, done_failed = 0, refused = 0, waits = 0;
+    char error[48] = "";
+    std::chrono::steady_clock::time_point finished;
+};
+
+static std::atomic<bool> start_clients{false};
+
+// Heap accounting: every operator new of the process, and the ones of each thread
+static std::atomic<int64_t> heap_in_use{0};
+static thread_local uint32_t thread_allocs = 0;
+
+void *operator new(size_t size) {
+    size_t *block = (size_t *)malloc(size + sizeof(max_align_t));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *block = size;
+    heap_in_use += size;
+    thread_allocs++;
+    return (uint8_t *)block + sizeof(max_align_t);
+}
+
+void operator delete(void *data) noexcept {
+    if (data != nullptr) {
+        size_t *block = (size_t *)((uint8_t *)data - sizeof(max_align_t));
+        heap_in_use -= *block;
+        free(block);
+    }
+}
+
+void operator delete(void *data, size_t size) noexcept {
+    operator delete(data);
+}
+
+// Function ClientImage: the payload with a tag after it, unique per client and job
+static uint16_t ClientImage(const uint8_t *app_image, const uint16_t app_size, const uint8_t client, const uint8_t job, uint8_t *image) {
+    memcpy(image, app_image, app_size);
+    const uint8_t tag[LOAD_TAG_SIZE] = {0xA5, client, job, 0x5A};
+    memcpy(&image[app_size], tag, LOAD_TAG_SIZE);
+    return app_size + LOAD_TAG_SIZE;
+}
+
+// Function ReadLine: blocking read of a reply line, false if the server closed first
+static bool ReadLine(const int fd, char *line, const size_t size) {
+    size_t ix = 0;
+    while (ix < size - 1) {
+        char c;
+        if (recv(fd, &c, 1, 0) != 1) {
+            break;
+        }
+        if (c == '\n') {
+            line[ix] = '\0';
+            return true;
+        }
+        line[ix++] = c;
+    }
+    line[ix] = '\0';
+    return false;
+}
+
+// Function Submit: send one image as "plan" says and wait for the last reply line
+static void Submit(const uint16_t port, ClientPlan *plan, const uint8_t *image, const uint16_t size, const bool run,
+                   char *reply, const size_t reply_size) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    reply[0] = '\0';
+    if (connect(fd, (sockaddr *)&addr, sizeof(addr)) < 0) {
+        snprintf(reply, reply_size, "ERR connect");
+        close(fd);
+        return;
+    }
+    uint16_t crc = Crc16(0xFFFF, image, size);
+    if (plan->kind == CLIENT_BAD_CRC) {
+        crc ^= 0x0101;
+    }
+    uint8_t header[INGEST_HEADER_SIZE] = {'T', 'M', 'N', 'L', INGEST_VERSION, (uint8_t)(run ? INGEST_RUN : 0), 0x00, 0x00,
+                                          (uint8_t)(size & 0xFF), (uint8_t)(size >> 8), (uint8_t)(crc & 0xFF), (uint8_t)(crc >> 8)};
+    if (plan->kind == CLIENT_BAD_HEADER) {
+        header[6] = 0x10; /* Not page aligned */
+    }
+    uint8_t body[MCU_TOTAL_MEM]; /* No heap in the clients: it would blur the server's */
+    memcpy(body, image, size);
+    if (plan->kind == CLIENT_BAD_VECTOR) {
+        body[1] = 0x94; /* jmp, not rjmp */
+    }
+    send(fd, header, sizeof(header), MSG_NOSIGNAL);
+    uint16_t sent = 0;
+    uint16_t piece = (plan->kind == CLIENT_NORMAL) ? size : 64;
+    uint16_t limit = (plan->kind == CLIENT_STALLED) ? size / 2 : size;
+    while (sent < limit) {
+        uint16_t chunk = ((limit - sent) < piece) ? (limit - sent) : piece;
+        if (send(fd, &body[sent], chunk, MSG_NOSIGNAL) <= 0) {
+            break; /* Refused: the reply says why */
+        }
+        sent += chunk;
+        if (plan->kind == CLIENT_SLOW) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    while (ReadLine(fd, reply, reply_size)) {
+        if (strncmp(reply, "WAIT", 4) == 0) {
+            plan->waits++;
+        } else if (strncmp(reply, "QUEUED", 6) != 0) {
+            break; /* DONE or ERR */
+        }
+    }
+    close(fd);
+}
+
+// Function RunClient: submit every job of the plan, retrying while the server is busy
+static void RunClient(const uint16_t port, const uint8_t client, ClientPlan *plan, const uint8_t *app_image, const uint16_t app_size) {
+    uint8_t image[MCU_TOTAL_MEM];
+    char reply[48];
+    while (!start_clients.load()) {
+        std::this_thread::yield();
+    }
+    for (uint8_t job = 0; job < plan->jobs; job++) {
+        uint16_t size = ClientImage(app_image, app_size, client, job, image);
+        bool run = ((client + job) % 3) == 2;
+        do {
+            Submit(port, plan, image, size, run, reply, sizeof(reply));
+            if (strcmp(reply, "ERR busy") == 0) {
+                plan->refused++;
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        } while (strcmp(reply, "ERR busy") == 0);
+        unsigned long id = 0, status = 1, ms = 0;
+        if ((sscanf(reply, "DONE %lu %lu %lu", &id, &status, &ms) == 3) && (status == 0)) {
+            plan->done_ok++;
+        } else if (strncmp(reply, "DONE", 4) == 0) {
+            plan->done_failed++;
+        } else {
+            snprintf(plan->error, sizeof(plan->error), "%s", reply);
+        }
+    }
+    plan->finished = std::chrono::steady_clock::now();
+}
+
+// Load round result
+struct LoadResult {
+    uint32_t jobs = 0, flash_errors = 0;
+    uint64_t bus_us = 0;      /* Engine time spent on jobs (virtual) */
+    double wall_s = 0;        /* Real time of the whole round */
+    int64_t heap_peak = 0;    /* Largest heap growth seen while serving, whole process */
+    uint32_t server_allocs = 0; /* Allocations made by the server thread */
+    IngestStats stats;
+};
+
+// Function RunLoad: serve the clients of "plans" until they all finish, flashing every queued job
+static LoadResult RunLoad(const BenchOptions &options, std::vector<ClientPlan> *plans, const uint8_t *app_image, const uint16_t app_size) {
+    TcpIngest *ingest = new TcpIngest(); /* A global on the target, made before the heap baseline here */
+    LoadResult result;
+    TimonelSlave tiny85;
+    BenchSetup(options, &tiny85);
+    Timonel *timonel = new Timonel(SIM_BOOT_ADDR);
+    bool app_mode = false;
+    DeviceCache cache;
+    HostTarget target = {&timonel, &app_mode, &cache, 0, 0};
+    ingest->Begin(0, LOAD_TIMEOUT_MS);
+    uint16_t port = ingest->GetPort();
+
+    std::atomic<uint32_t> clients_left{(uint32_t)plans->size()};
+    std::atomic<bool> stop_server{false};
+    std::atomic<int64_t> heap_peak{0};
+    std::atomic<uint32_t> server_allocs{0};
+    std::vector<std::thread> clients;
+    for (uint8_t ix = 0; ix < plans->size(); ix++) {
+        clients.emplace_back([&, ix]() {
+            RunClient(port, ix, &(*plans)[ix], app_image, app_size);
+            clients_left--;
+        });
+    }
+    int64_t heap_base = heap_in_use.load();
+    // Ingest task stand-in: its virtual clock follows the real one while idle, for the timeouts
+    std::thread server([&]() {
+        uint32_t passes = 0;
+        thread_allocs = 0;
+        while (!stop_server.load()) {
+            if (ingest->Service() == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(LOAD_STEP_US));
+                SimClock::Advance(LOAD_STEP_US);
+            }
+            if ((passes++ % 16) == 0) {
+                int64_t heap = heap_in_use.load() - heap_base;
+                if (heap > heap_peak.load()) {
+                    heap_peak.store(heap);
+                }
+            }
+        }
+        server_allocs = thread_allocs;
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    start_clients.store(true);
+    while ((clients_left.load() > 0) || (ingest->GetQueued() > 0)) {
+        IngestJob *job = ingest->TakeJob();
+        if (job == nullptr) {
+            std::this_thread::sleep_for(std::chrono::microseconds(LOAD_STEP_US));
+            continue;
+        }
+        uint64_t job_start = SimClock::Now();
+        uint8_t status = FlashIngestJob(&target, job);
+        uint64_t job_us = SimClock::Now() - job_start;
+        result.bus_us += job_us;
+        result.jobs++;
+        // Everything but the reset vector (the trampoline keeps Timonel in charge) must be in flash
+        bool flash_ok = (status == 0);
+        for (uint16_t i = 2; flash_ok && (i < job->size); i++) {
+            flash_ok = (tiny85.GetFlash()[job->start_addr + i] == job->image[i]);
+        }
+        flash_ok &= !job->run || (tiny85.GetMode() == TimonelSlave::APPLICATION);
+        result.flash_errors += !flash_ok;
+        ingest->FinishJob(job, status, job_us / 1000);
+    }
+    result.wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (std::thread &client : clients) {
+        client.join();
+    }
+    // Let the server report the last results before stopping it
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    stop_server.store(true);
+    server.join();
+    start_clients.store(false);
+    result.heap_peak = heap_peak.load();
+    result.server_allocs = server_allocs.load();
+    result.stats = ingest->GetStats();
+    ingest->End();
+    delete ingest;
+    delete timonel;
+    SimBus::Get(0)->Detach(&tiny85);
+    return result;
+}
+
+// TCP firmware ingest under load: N client threads connect to the ingest
+// server over loopback sockets and each submits a few images (a unique
+// tag in every one, some asking to run the application afterwards). A
+// server thread stands in for the ingest task, the main thread is the
+// I2C engine: it takes the queued jobs and flashes them on the simulated
+// Tiny85, checking the flash after every job. Clients that are refused
+// for being over INGEST_CLIENTS retry. Reported per N: jobs/minute on the
+// virtual bus time, the deepest the queue got, and the heap: operator
+// new is counted per thread, the server thread must not allocate at all
+// and the peak growth of the whole process is shown next to it.
+// A second round mixes well behaved clients with a slow one (trickling
+// its image), a stalled one (must time out), and broken images (bad CRC,
+// bad reset vector, bad header): the others must keep being flashed
+// while the slow one is still sending, and the bad ones must be refused.
+int main(int argc, char *argv[]) {
+    BenchOptions options = BenchParse(argc, argv);
+    unsigned long clients_max = 8, jobs = 3;
+    for (int i = 1; i < argc; i++) {
+        sscanf(argv[i], "--clients=%lu", &clients_max);
+        sscanf(argv[i], "--jobs=%lu", &jobs);
+    }
+    BenchBanner(options);
+    uint8_t app_image[MCU_TOTAL_MEM];
+    uint16_t app_size = BenchImage(image::payload, sizeof(image::payload), payload_packed, app_image);
+    printf("Ingest: %d connections, %d image slots of %d bytes, read chunk %d, TCP window %d | image %d bytes\n",
+           INGEST_CLIENTS, INGEST_SLOTS, INGEST_IMAGE_MAX, INGEST_READ_CHUNK, SIM_TCP_WINDOW, app_size + LOAD_TAG_SIZE);
+    printf("Server static footprint: %lu bytes\n\n", (unsigned long)sizeof(TcpIngest));
+    printf("%7s %5s %6s %9s %8s %7s %7s %6s %7s %8s %11s %10s %s\n", "clients", "jobs", "ok", "jobs/min", "job ms", "wall s",
+           "refused", "waits", "peak q", "peak cl", "srv allocs", "heap peak", "");
+    bool all_ok = true;
+    for (unsigned long n = 1; n <= clients_max; n *= 2) {
+        std::vector<ClientPlan> plans(n);
+        for (ClientPlan &plan : plans) {
+            plan.jobs = jobs;
+        }
+        LoadResult result = RunLoad(options, &plans, app_image, app_size);
+        uint32_t ok = 0;
+        for (const ClientPlan &plan : plans) {
+            ok += plan.done_ok;
+        }
+        bool round_ok = (ok == n * jobs) && (result.jobs == n * jobs) && (result.flash_errors == 0) && (result.server_allocs == 0) &&
+                        (result.stats.peak_clients <= INGEST_CLIENTS);
+        all_ok &= round_ok;
+        printf("%7lu %5lu %6lu %9.1f %8.1f %7.2f %7lu %6lu %7u %8u %11lu %10lld %s\n", n, (unsigned long)result.jobs, (unsigned long)ok,
+               result.jobs * 60000000.0 / result.bus_us, result.bus_us / 1000.0 / result.jobs, result.wall_s,
+               (unsigned long)result.stats.refused, (unsigned long)result.stats.waits, result.stats.peak_queued,
+               result.stats.peak_clients, (unsigned long)result.server_allocs, (long long)result.heap_peak, round_ok ? "verified" : "LOAD FAILURE");
+    }
+
+    // Mixed round: two normal clients, a slow and a stalled one, then broken images
+    std::vector<ClientPlan> plans(6);
+    const ClientKind kinds[] = {CLIENT_NORMAL, CLIENT_SLOW, CLIENT_NORMAL, CLIENT_STALLED, CLIENT_BAD_CRC, CLIENT_BAD_VECTOR};
+    for (uint8_t ix = 0; ix < plans.size(); ix++) {
+        plans[ix].kind = kinds[ix];
+        plans[ix].jobs = (kinds[ix] == CLIENT_NORMAL) ? jobs : 1;
+    }
+    plans.push_back(ClientPlan());
+    plans.back().kind = CLIENT_BAD_HEADER;
+    LoadResult result = RunLoad(options, &plans, app_image, app_size);
+    bool mixed_ok = (result.flash_errors == 0) && (result.server_allocs == 0);
+    mixed_ok &= (plans[0].done_ok == jobs) && (plans[2].done_ok == jobs) && (plans[1].done_ok == 1);
+    mixed_ok &= (strcmp(plans[3].error, "ERR timeout") == 0) && (strcmp(plans[4].error, "ERR crc") == 0) &&
+                (strcmp(plans[5].error, "ERR reset vector") == 0) && (strcmp(plans[6].error, "ERR address") == 0);
+    bool not_stalled = (plans[0].finished < plans[1].finished) && (plans[2].finished < plans[1].finished);
+    mixed_ok &= not_stalled;
+    printf("\nMixed clients: %lu jobs flashed, slow client %s, stalled: \"%s\", bad CRC: \"%s\", bad vector: \"%s\","
+           " bad header: \"%s\"\n",
+           (unsigned long)result.jobs, not_stalled ? "overtaken by the others" : "HELD THE OTHERS BACK", plans[3].error,
+           plans[4].error, plans[5].error, plans[6].error);
+    printf("  server: %lu accepted, %lu refused, %lu invalid, %lu timeouts, %lu waits, %lu server allocations\n",
+           (unsigned long)result.stats.accepted, (unsigned long)result.stats.refused, (unsigned long)result.stats.invalid,
+           (unsigned long)result.stats.timeouts, (unsigned long)result.stats.waits, (unsigned long)result.server_allocs);
+    all_ok &= mixed_ok;
+    printf("%s\n", all_ok ? "All ingest rounds verified" : "INGEST LOAD FAILURE");
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+//
+// avr-blink-tables
+// ----------------
+// Start Address: 0x0 
+// End Address: 0x9FF
+// Date: 2026-10-17
+//
+// Benchmark payload: avr-blink-twis at 0x0000, a 256-entry sine table at
+// 0x0600 and a 96-glyph 8x8 bitmap font at 0x0700, holes filled with 0xFF.
+// It stands for the sparse, table-heavy images where TPZ packing pays off.
+//
+// Produced from "blink-tables.hex" with payload-gen.py: 2560 bytes TPZ packed into 1270 (50%).
+//
+#define PAYLOAD_TABLES_PACKED
+
+const uint8_t payload_tables[1270] = {
+    0x54, 0x5a, 0x01, 0x00, 0x00, 0x0a, 0x00, 0x00,
+    0xff, 0x0e, 0xc0, 0x28, 0xc0, 0x27, 0xc0, 0x26,
+    0xc0, 0xff, 0x25, 0xc0, 0x24, 0xc0, 0x23, 0xc0,
+    0x22, 0xc0, 0xff, 0x21, 0xc0, 0x20, 0xc0, 0x1f,
+    0xc0, 0x1e, 0xc0, 0xff, 0x1d, 0xc0, 0xd4, 0xc0,
+    0x04, 0xc1, 0x11, 0x24, 0xff, 0x1f, 0xbe, 0xcf,
+    0xe5, 0xd2, 0xe0, 0xde, 0xbf, 0xff, 0xcd, 0xbf,
+    0x10, 0xe0, 0xa0, 0xe6, 0xb0, 0xe0, 0xff, 0xee,
+    0xe4, 0xf3, 0xe0, 0x02, 0xc0, 0x05, 0x90, 0xff,
+    0x0d, 0x92, 0xa4, 0x36, 0xb1, 0x07, 0xd9, 0xf7,
+    0xf7, 0x21, 0xe0, 0xa4, 0x15, 0x00, 0x01, 0xc0,
+    0x1d, 0x92, 0xff, 0xa1, 0x31, 0xb2, 0x07, 0xe1,
+    0xf7, 0x5b, 0xd0, 0xff, 0x7b, 0xc1, 0xd5, 0xcf,
+    0x81, 0xe0, 0x80, 0x93, 0xff, 0x64, 0x00, 0x08,
+    0x95, 0x0f, 0x93, 0x1f, 0x93, 0xff, 0xcf, 0x93,
+    0xdf, 0x93, 0x06, 0xe6, 0x10, 0xe0, 0xff, 0xc8,
+    0x2f, 0xd0, 0xe0, 0xca, 0x59, 0xdf, 0x4f, 0xff,
+    0x0c, 0x17, 0x1d, 0x07, 0x99, 0xf4, 0x80, 0x91,
+    0xff, 0x66, 0x00, 0x82, 0x39, 0xf9, 0xf0, 0x83,
+    0x39, 0xff, 0x91, 0xf0, 0x80, 0x38, 0x09, 0xf5,
+    0xc1, 0x98, 0xef, 0x8f, 0xe7, 0x7a, 0xd0, 0x37,
+    0x01, 0x65, 0x00, 0xdf, 0xff, 0x91, 0xcf, 0x91,
+    0x1f, 0x91, 0x0f, 0x91, 0x08, 0xff, 0x95, 0x80,
+    0xd0, 0xf8, 0x01, 0x81, 0x93, 0x8f, 0x7f, 0x01,
+    0xe5, 0xcf, 0xb9, 0x9a, 0xc1, 0x9a, 0x1d, 0x01,
+    0x6f, 0x62, 0x00, 0x8c, 0xe6, 0x1f, 0x05, 0x62,
+    0xc0, 0x15, 0x00, 0xff, 0x98, 0x10, 0x92, 0x62,
+    0x00, 0x8d, 0xe6, 0xf5, 0xff, 0xcf, 0x8f, 0xef,
+    0xf3, 0xcf, 0xf8, 0x94, 0x80, 0xff, 0xe8, 0x86,
+    0xbd, 0x83, 0xe0, 0x86, 0xbd, 0x78, 0xb7, 0x94,
+    0x08, 0x95, 0x0d, 0x03, 0x16, 0xbc, 0x0b, 0x01,
+    0x14, 0xff, 0xbe, 0x88, 0xe1, 0x81, 0xbd, 0x87,
+    0xe0, 0x81, 0xff, 0xbd, 0x08, 0x95, 0xc1, 0x98,
+    0x88, 0xe1, 0x98, 0xff, 0xe0, 0x0f, 0xb6, 0xf8,
+    0x94, 0xa8, 0x95, 0x81, 0xff, 0xbd, 0x0f, 0xbe,
+    0x91, 0xbd, 0xff, 0xcf, 0xef, 0xf7, 0xdf, 0xe1,
+    0xdf, 0x4d, 0x01, 0x2f, 0xe7, 0x8a, 0xe1, 0xff,
+    0x96, 0xe0, 0x21, 0x50, 0x80, 0x40, 0x90, 0x40,
+    0xff, 0xe1, 0xf7, 0x00, 0xc0, 0x00, 0x00, 0xdc,
+    0xdf, 0xff, 0x8f, 0xe2, 0x90, 0xe0, 0x90, 0x93,
+    0x8d, 0x00, 0x5f, 0x80, 0x93, 0x8c, 0x00, 0x8b,
+    0x0b, 0x02, 0x8f, 0x0b, 0x00, 0xff, 0x8e, 0x00,
+    0x8c, 0xe2, 0x60, 0xd0, 0x78, 0x94, 0xff, 0x42,
+    0xe0, 0x2f, 0xef, 0x3f, 0xef, 0x80, 0x91, 0xff,
+    0x65, 0x00, 0x81, 0x11, 0xd2, 0xdf, 0x80, 0x91,
+    0xff, 0x60, 0x00, 0x90, 0x91, 0x61, 0x00, 0xbc,
+    0x01, 0xff, 0x61, 0x50, 0x71, 0x09, 0x70, 0x93,
+    0x61, 0x00, 0xff, 0x60, 0x93, 0x60, 0x00, 0x89,
+    0x2b, 0x99, 0xf7, 0xff, 0x80, 0x91, 0x62, 0x00,
+    0x88, 0x23, 0x19, 0xf0, 0x7f, 0x88, 0xb3, 0x84,
+    0x27, 0x88, 0xbb, 0x30, 0x19, 0x00, 0xfd, 0x20,
+    0x19, 0x00, 0xe3, 0xcf, 0xe0, 0x91, 0x87, 0x00,
+    0x7f, 0xef, 0x5f, 0xef, 0x73, 0xe0, 0x93, 0x87,
+    0x39, 0x00, 0xff, 0x86, 0x00, 0xe9, 0x17, 0xf1,
+    0xf3, 0xf0, 0xe0, 0xff, 0xe0, 0x53, 0xff, 0x4f,
+    0x80, 0x83, 0x08, 0x95, 0xff, 0x80, 0x91, 0x8a,
+    0x00, 0x81, 0x50, 0x08, 0xf4, 0xff, 0x8e, 0xef,
+    0x80, 0x93, 0x8a, 0x00, 0xe0, 0x91, 0xad, 0x88,
+    0x2b, 0x04, 0x88, 0x00, 0x23, 0x00, 0x57, 0x23,
+    0x00, 0x81, 0xff, 0x08, 0x95, 0x1f, 0x92, 0x1f,
+    0xb6, 0x1f, 0x92, 0xff, 0x11, 0x24, 0x8f, 0x93,
+    0xb8, 0x98, 0x10, 0x92, 0xff, 0x10, 0x01, 0xb2,
+    0x9b, 0x02, 0xc0, 0xb0, 0x9b, 0xff, 0xfc, 0xcf,
+    0xb0, 0x99, 0x09, 0xc0, 0x88, 0xef, 0xff, 0x8d,
+    0xb9, 0x80, 0xef, 0x8e, 0xb9, 0x8f, 0x91, 0xff,
+    0x1f, 0x90, 0x1f, 0xbe, 0x1f, 0x90, 0x18, 0x95,
+    0xbf, 0x88, 0xea, 0xf6, 0xcf, 0x88, 0xea, 0x15,
+    0x00, 0xe7, 0xfb, 0x8e, 0xb9, 0x5f, 0x00, 0x93,
+    0x8b, 0x00, 0x10, 0x92, 0x55, 0x87, 0x03, 0x00,
+    0x86, 0x03, 0x00, 0x8a, 0x03, 0x00, 0x89, 0x03,
+    0x00, 0xff, 0x88, 0x00, 0x87, 0xb3, 0x85, 0x60,
+    0x87, 0xbb, 0xff, 0xc0, 0x9a, 0xc2, 0x9a, 0xb8,
+    0x98, 0xe8, 0xcf, 0x7f, 0x1f, 0x92, 0x0f, 0x92,
+    0x0f, 0xb6, 0x0f, 0x63, 0x00, 0xff, 0x2f, 0x93,
+    0x3f, 0x93, 0x4f, 0x93, 0x5f, 0x93, 0xff, 0x6f,
+    0x93, 0x7f, 0x93, 0x8f, 0x93, 0x9f, 0x93, 0xff,
+    0xaf, 0x93, 0xbf, 0x93, 0xef, 0x93, 0xff, 0x93,
+    0xff, 0x80, 0x91, 0x10, 0x01, 0x82, 0x30, 0x09,
+    0xf4, 0xff, 0x70, 0xc0, 0xb0, 0xf4, 0x88, 0x23,
+    0x61, 0xf1, 0xfd, 0x81, 0x0b, 0x00, 0x4e, 0xc0,
+    0xff, 0x91, 0xef, 0x91, 0xff, 0xbf, 0x91, 0xaf,
+    0x91, 0x9f, 0x91, 0x8f, 0x91, 0xff, 0x7f, 0x91,
+    0x6f, 0x91, 0x5f, 0x91, 0x4f, 0x91, 0xff, 0x3f,
+    0x91, 0x2f, 0x91, 0x0f, 0x90, 0x0f, 0xbe, 0xeb,
+    0x0f, 0x90, 0x8d, 0x01, 0x84, 0x27, 0x00, 0x5d,
+    0xc0, 0x70, 0xdf, 0xf1, 0x85, 0x30, 0x49, 0xf7,
+    0xeb, 0x01, 0x8f, 0x5f, 0x7a, 0xe7, 0x03, 0x89,
+    0xe7, 0x04, 0x89, 0x00, 0x8f, 0xb1, 0xe9, 0x04,
+    0xff, 0x83, 0x84, 0xe0, 0x15, 0xc0, 0x8f, 0xb1,
+    0x88, 0xff, 0x23, 0x31, 0xf0, 0x8f, 0xb1, 0x86,
+    0x95, 0x90, 0xff, 0x91, 0x8b, 0x00, 0x89, 0x13,
+    0x36, 0xc0, 0x78, 0xff, 0x9b, 0xf3, 0xcf, 0xe0,
+    0x91, 0x8c, 0x00, 0xf0, 0x7f, 0x91, 0x8d, 0x00,
+    0x30, 0x97, 0x19, 0xf0, 0x45, 0x01, 0xff, 0x09,
+    0x95, 0x81, 0xe0, 0x80, 0x93, 0x10, 0x01, 0xdf,
+    0x1f, 0xb8, 0xb8, 0x9a, 0x2c, 0x33, 0x02, 0x41,
+    0xf0, 0x5f, 0x85, 0xdf, 0xe0, 0x91, 0x8e, 0x25,
+    0x00, 0x8f, 0x25, 0x00, 0xff, 0x09, 0xf0, 0x09,
+    0x95, 0xe0, 0x91, 0x86, 0x00, 0xff, 0x80, 0x91,
+    0x87, 0x00, 0x8e, 0x17, 0x81, 0xf0, 0xd6, 0x6b,
+    0x03, 0x86, 0x00, 0x69, 0x00, 0x53, 0x69, 0x00,
+    0x81, 0x8f, 0xfb, 0xb9, 0x82, 0x3f, 0x02, 0xb8,
+    0x9a, 0x80, 0xe7, 0x8e, 0xb7, 0xb9, 0x9c, 0xcf,
+    0x47, 0x00, 0x98, 0x8e, 0x09, 0x00, 0x63, 0xcf,
+    0xdf, 0x96, 0xcf, 0x83, 0x59, 0x05, 0x11, 0x00,
+    0xf1, 0xcf, 0xfd, 0x85, 0x27, 0x03, 0x98, 0xeb,
+    0xcf, 0xf8, 0x94, 0xff, 0x3f, 0xcf, 0xff, 0xff,
+    0x01, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0xfe,
+    0x00, 0xa6, 0x7f, 0x82, 0x85, 0x88, 0x8b, 0x8f,
+    0x92, 0xff, 0x95, 0x98, 0x9b, 0x9e, 0xa1, 0xa4,
+    0xa7, 0xaa, 0xff, 0xad, 0xb0, 0xb3, 0xb6, 0xb8,
+    0xbb, 0xbe, 0xc1, 0xff, 0xc3, 0xc6, 0xc8, 0xcb,
+    0xcd, 0xd0, 0xd2, 0xd5, 0xff, 0xd7, 0xd9, 0xdb,
+    0xdd, 0xe0, 0xe2, 0xe4, 0xe5, 0xff, 0xe7, 0xe9,
+    0xeb, 0xec, 0xee, 0xef, 0xf1, 0xf2, 0xff, 0xf4,
+    0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0x5f,
+    0xfb, 0xfc, 0xfd, 0xfd, 0xfe, 0x00, 0x01, 0xff,
+    0x05, 0x02, 0xff, 0xfd, 0xfd, 0xfc, 0xfb, 0xfb,
+    0xfa, 0xf9, 0xf8, 0xff, 0xf7, 0xf6, 0xf5, 0xf4,
+    0xf2, 0xf1, 0xef, 0xee, 0xff, 0xec, 0xeb, 0xe9,
+    0xe7, 0xe5, 0xe4, 0xe2, 0xe0, 0xff, 0xdd, 0xdb,
+    0xd9, 0xd7, 0xd5, 0xd2, 0xd0, 0xcd, 0xff, 0xcb,
+    0xc8, 0xc6, 0xc3, 0xc1, 0xbe, 0xbb, 0xb8, 0xff,
+    0xb6, 0xb3, 0xb0, 0xad, 0xaa, 0xa7, 0xa4, 0xa1,
+    0xff, 0x9e, 0x9b, 0x98, 0x95, 0x92, 0x8f, 0x8b,
+    0x88, 0xff, 0x85, 0x82, 0x7f, 0x7c, 0x79, 0x76,
+    0x73, 0x6f, 0xff, 0x6c, 0x69, 0x66, 0x63, 0x60,
+    0x5d, 0x5a, 0x57, 0xff, 0x54, 0x51, 0x4e, 0x4b,
+    0x48, 0x46, 0x43, 0x40, 0xff, 0x3d, 0x3b, 0x38,
+    0x36, 0x33, 0x31, 0x2e, 0x2c, 0xff, 0x29, 0x27,
+    0x25, 0x23, 0x21, 0x1e, 0x1c, 0x1a, 0xff, 0x19,
+    0x17, 0x15, 0x13, 0x12, 0x10, 0x0f, 0x0d, 0xff,
+    0x0c, 0x0a, 0x09, 0x08, 0x07, 0x06, 0x05, 0x04,
+    0xbf, 0x03, 0x03, 0x02, 0x01, 0x01, 0x00, 0x00,
+    0x07, 0x01, 0xff, 0x01, 0x02, 0x03, 0x03, 0x04,
+    0x05, 0x06, 0x07, 0xff, 0x08, 0x09, 0x0a, 0x0c,
+    0x0d, 0x0f, 0x10, 0x12, 0xff, 0x13, 0x15, 0x17,
+    0x19, 0x1a, 0x1c, 0x1e, 0x21, 0xff, 0x23, 0x25,
+    0x27, 0x29, 0x2c, 0x2e, 0x31, 0x33, 0xff, 0x36,
+    0x38, 0x3b, 0x3d, 0x40, 0x43, 0x46, 0x48, 0xff,
+    0x4b, 0x4e, 0x51, 0x54, 0x57, 0x5a, 0x5d, 0x60,
+    0xff, 0x63, 0x66, 0x69, 0x6c, 0x6f, 0x73, 0x76,
+    0x79, 0xff, 0x7c, 0x3c, 0x18, 0x66, 0x3c, 0x3c,
+    0x81, 0x66, 0xff, 0x3c, 0x7e, 0x3c, 0x81, 0x7e,
+    0x18, 0x00, 0x18, 0xff, 0x7e, 0x81, 0x81, 0x81,
+    0x3c, 0x3c, 0x24, 0x7e, 0xff, 0x18, 0x66, 0x24,
+    0x00, 0x7e, 0x24, 0x3c, 0x00, 0xfd, 0x81, 0x07,
+    0x00, 0x42, 0x18, 0x7e, 0x24, 0x24, 0x66, 0xfe,
+    0x0d, 0x00, 0x3c, 0x66, 0x24, 0x42, 0x24, 0x81,
+    0x81, 0x3d, 0x18, 0x12, 0x00, 0x66, 0x3c, 0x24,
+    0x00, 0x12, 0x00, 0x00, 0x00, 0xff, 0x42, 0x66,
+    0x42, 0x24, 0x42, 0x00, 0x7e, 0x18, 0xcf, 0x24,
+    0x42, 0x3c, 0x7e, 0x47, 0x00, 0x04, 0x00, 0x42,
+    0x3c, 0xff, 0x42, 0x81, 0x66, 0x81, 0x24, 0x81,
+    0x42, 0x81, 0xdb, 0x3c, 0x24, 0x5a, 0x01, 0x66,
+    0x18, 0x39, 0x00, 0x18, 0x00, 0xd9, 0x00, 0x55,
+    0x00, 0x04, 0x01, 0x42, 0x81, 0x06, 0x01, 0x18,
+    0x42, 0x0f, 0x24, 0x00, 0x00, 0x3c, 0x54, 0x00,
+    0x7f, 0xff, 0x7f, 0xff, 0x7f, 0x78
+};
@@ -0,0 +1,200 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: stress-queues.cpp (Native stress test)
+  ............................................................................
+  The DUAL_CORE plumbing under real concurrency.
+  Usage: stress-queues [--items=n] [--lines=n]
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include <SimClock.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "console-ring.h"
+#include "core-tasks.h"
+#include "spsc-queue.h"
+
+// Message passed between the tasks by value, checked on arrival
+struct Message {
+    uint32_t sequence;
+    uint8_t data[20];
+    uint16_t check;
+};
+
+static uint16_t MessageCheck(const Message &message) {
+    uint16_t check = message.sequence & 0xFFFF;
+    for (uint8_t i = 0; i < sizeof(message.data); i++) {
+        check = (check << 1 | check >> 15) ^ message.data[i];
+    }
+    return check;
+}
+
+static double Seconds(const std::chrono::steady_clock::time_point &start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Function StressSequence: one thread pushes 0..items-1 (single and bulk pushes), the other checks the order
+bool StressSequence(const uint32_t items) {
+    static SpscQueue<uint32_t, 256> queue;
+    uint32_t errors = 0, received = 0;
+    auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&]() {
+        uint32_t expected = 0, batch[32];
+        while (expected < items) {
+            uint32_t count = (expected & 1) ? queue.Pop(batch, 32) : (queue.Pop(batch) ? 1 : 0);
+            for (uint32_t i = 0; i < count; i++) {
+                errors += (batch[i] != expected++);
+            }
+            if (count == 0) {
+                TaskPause();
+            }
+        }
+        received = expected;
+    });
+    uint32_t batch[16];
+    for (uint32_t sent = 0; sent < items;) {
+        uint32_t pushed = 0;
+        if (sent % 3 == 0) {
+            pushed = queue.Push(sent) ? 1 : 0;
+        } else {
+            uint32_t count = (items - sent < 16) ? items - sent : 16;
+            for (uint32_t i = 0; i < count; i++) {
+                batch[i] = sent + i;
+            }
+            pushed = queue.Push(batch, count);
+        }
+        sent += pushed;
+        if (pushed == 0) {
+            TaskPause();
+        }
+    }
+    consumer.join();
+    double seconds = Seconds(start);
+    printf("Sequence: %lu items through a %lu slot queue, %lu out of order, %.1f M items/s\n", (unsigned long)received,
+           (unsigned long)queue.Capacity(), (unsigned long)errors, received / seconds / 1e6);
+    return (errors == 0) && (received == items) && queue.IsEmpty();
+}
+
+// Function StressMessages: structs by value, torn copies would break the check
+bool StressMessages(const uint32_t items) {
+    static SpscQueue<Message, 64> queue;
+    uint32_t errors = 0;
+    std::thread consumer([&]() {
+        Message message;
+        for (uint32_t expected = 0; expected < items;) {
+            if (!queue.Pop(&message)) {
+                TaskPause();
+                continue;
+            }
+            errors += (message.sequence != expected++) || (MessageCheck(message) != message.check);
+        }
+    });
+    Message message;
+    for (uint32_t sent = 0; sent < items;) {
+        message.sequence = sent;
+        for (uint8_t i = 0; i < sizeof(message.data); i++) {
+            message.data[i] = (uint8_t)(sent * 7 + i);
+        }
+        message.check = MessageCheck(message);
+        if (queue.Push(message)) {
+            sent++;
+        } else {
+            TaskPause();
+        }
+    }
+    consumer.join();
+    printf("Messages: %lu %d-byte messages, %lu damaged or out of order\n", (unsigned long)items, (int)sizeof(Message),
+           (unsigned long)errors);
+    return errors == 0;
+}
+
+// Function StressConsole: engine thread prints lines, console thread serves the ring into the UART
+bool StressConsole(const uint32_t lines) {
+    static ConsoleRing console;
+    std::string capture;
+    std::atomic<bool> done(false);
+    Serial.SetEcho(false);
+    Serial.setTxBufferSize(1024);
+    Serial.begin(115200);
+    Serial.SetCapture(&capture);
+    Serial.Inject("abcdefghij");
+    uint64_t start_us = SimClock::Now();
+    // The console thread is the only one using Serial (and so the virtual clock)
+    std::thread console_task([&]() {
+        while (!done.load() || (console.available() > 0) || (console.availableForWrite() < CONSOLE_OUT_SIZE)) {
+            if (console.Service(&Serial) == 0) {
+                SimClock::Advance(100); /* UART time goes by while the console task rests */
+                TaskPause();
+            }
+        }
+    });
+    std::string keys;
+    for (uint32_t line = 0; line < lines; line++) {
+        console.printf("Line %06lu: the engine does not wait for the UART\n\r", (unsigned long)line);
+        int key = console.read();
+        if (key >= 0) {
+            keys += (char)key;
+        }
+    }
+    while (keys.size() < 10) {
+        int key = console.read();
+        if (key >= 0) {
+            keys += (char)key;
+        } else {
+            TaskPause();
+        }
+    }
+    console.flush();
+    done = true;
+    console_task.join();
+    Serial.flush();
+    Serial.SetCapture(nullptr);
+    // Every line once and in order
+    uint32_t errors = 0;
+    size_t pos = 0;
+    char expected[64];
+    for (uint32_t line = 0; line < lines; line++) {
+        int size = snprintf(expected, sizeof(expected), "Line %06lu: the engine does not wait for the UART\n\r", (unsigned long)line);
+        if (capture.compare(pos, size, expected) != 0) {
+            errors++;
+            size_t next = capture.find(expected, pos);
+            pos = (next == std::string::npos) ? pos : next;
+        }
+        pos += size;
+    }
+    errors += (pos != capture.size());
+    double uart_s = (SimClock::Now() - start_us) / 1e6;
+    printf("Console: %lu lines, %lu bytes through a %d byte ring, %lu engine stalls on a full ring, %.1f s of UART time\n",
+           (unsigned long)lines, (unsigned long)capture.size(), CONSOLE_OUT_SIZE, (unsigned long)console.GetStalls(), uart_s);
+    printf("Console: keys typed \"abcdefghij\", engine read \"%s\", %lu lines damaged or out of order\n", keys.c_str(),
+           (unsigned long)errors);
+    return (errors == 0) && (keys == "abcdefghij");
+}
+
+// The DUAL_CORE plumbing under real concurrency: host threads stand in
+// for the two ESP32 cores. The lock-free queue carries sequence numbers
+// and checksummed messages between a producer and a consumer thread that
+// never lock, and the console ring takes numbered lines printed by an
+// "engine" thread while a "console" thread drains it into the modelled
+// UART and feeds typed keys back. Every item has to arrive once, in
+// order and intact. Build it with -fsanitize=thread to have the data
+// races checked too.
+int main(int argc, char *argv[]) {
+    unsigned long items = 5000000, lines = 20000;
+    for (int i = 1; i < argc; i++) {
+        sscanf(argv[i], "--items=%lu", &items);
+        sscanf(argv[i], "--lines=%lu", &lines);
+    }
+    printf("Host threads: %u\n", std::thread::hardware_concurrency());
+    bool all_ok = StressSequence(items);
+    all_ok &= StressMessages(items / 5);
+    all_ok &= StressConsole(lines);
+    printf("\n%s\n", all_ok ? "All queues passed" : "QUEUE ERRORS");
+    return all_ok ? 0 : 1;
+}
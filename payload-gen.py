@@ -0,0 +1,256 @@
+#!/usr/bin/env python3
+#
+# Timonel payload generator
+# ..........................................................................
+# Converts an AVR application (Intel HEX, raw binary or a Timonel Hex Parser
+# payload header) into a payload header for this I2C master. By default the
+# image is TPZ packed (LZSS, 256-byte window, see include/payload-stream.h),
+# which the master unpacks one flash page at a time while uploading, if that
+# makes it smaller: dense code is written as a raw array instead.
+# A manifest follows the array: start, size, reset vector, fingerprint and
+# the CRC-16 of every flash page, checked at build time and used by the
+# upload paths instead of working them out (see include/payload-manifest.h).
+#
+# Usage:
+#   payload-gen.py app.hex -o payloads/payload.h
+#   payload-gen.py app.hex --name blink_fast -o payloads/blink-fast.h
+#   payload-gen.py app.hex --raw -o payload.h   (Timonel Hex Parser format)
+#   payload-gen.py payload.h --manifest >> payload.h   (manifest only, for a
+#       Timonel Hex Parser header kept byte for byte)
+# ..........................................................................
+#
+
+import argparse
+import datetime
+import os
+import re
+import sys
+
+TPZ_VERSION = 1
+TPZ_WINDOW = 256
+TPZ_MIN_MATCH = 3
+TPZ_MAX_MATCH = 258
+TPZ_STORED = 0x01
+
+SPM_PAGESIZE = 64
+FNV_OFFSET = 0x811C9DC5
+FNV_PRIME = 0x01000193
+
+
+def read_hex(path):
+    """Returns (start address, image bytes), holes are filled with 0xFF."""
+    memory = {}
+    base = 0
+    with open(path) as hex_file:
+        for line_num, line in enumerate(hex_file, 1):
+            line = line.strip()
+            if not line:
+                continue
+            if not line.startswith(":"):
+                sys.exit("%s:%d: not an Intel HEX record" % (path, line_num))
+            record = bytes.fromhex(line[1:])
+            if sum(record) & 0xFF:
+                sys.exit("%s:%d: checksum error" % (path, line_num))
+            size, addr, rec_type = record[0], (record[1] << 8) | record[2], record[3]
+            data = record[4:4 + size]
+            if rec_type == 0x00:
+                for i, value in enumerate(data):
+                    memory[base + addr + i] = value
+            elif rec_type == 0x01:
+                break
+            elif rec_type == 0x02:
+                base = ((data[0] << 8) | data[1]) << 4
+            elif rec_type == 0x04:
+                base = ((data[0] << 8) | data[1]) << 16
+    if not memory:
+        sys.exit("%s: no data records" % path)
+    start, end = min(memory), max(memory) + 1
+    return start, bytes(memory.get(addr, 0xFF) for addr in range(start, end))
+
+
+def read_header(path):
+    """Returns (start address, image bytes) of a payload header, raw (Timonel Hex Parser output) or TPZ."""
+    with open(path) as header_file:
+        text = header_file.read()
+    body = text[text.index("{") + 1:text.index("}")]
+    data = bytes(int(value, 16) for value in re.findall(r"0x[0-9a-fA-F]{1,2}", body))
+    if data[:3] == b"TZ" + bytes([TPZ_VERSION]):
+        return data[6] | (data[7] << 8), tpz_unpack(data)
+    return 0, data
+
+
+def tpz_pack(image, start):
+    packed = bytearray(b"TZ" + bytes([TPZ_VERSION, 0]))
+    packed += len(image).to_bytes(2, "little") + start.to_bytes(2, "little")
+    i = 0
+    while i < len(image):
+        control_ix = len(packed)
+        packed.append(0)
+        for bit in range(8):
+            if i >= len(image):
+                break
+            best_length, best_distance = 0, 0
+            for distance in range(1, min(TPZ_WINDOW, i) + 1):
+                length = 0
+                while (length < TPZ_MAX_MATCH and i + length < len(image)
+                       and image[i + length - distance] == image[i + length]):
+                    length += 1
+                if length > best_length:
+                    best_length, best_distance = length, distance
+            if best_length >= TPZ_MIN_MATCH:
+                packed += bytes([best_distance - 1, best_length - TPZ_MIN_MATCH])
+                i += best_length
+            else:
+                packed[control_ix] |= 1 << bit
+                packed.append(image[i])
+                i += 1
+    if len(packed) >= 8 + len(image):
+        # Dense code (most small AVR programs): storing it is cheaper
+        packed = bytearray(b"TZ" + bytes([TPZ_VERSION, TPZ_STORED]))
+        packed += len(image).to_bytes(2, "little") + start.to_bytes(2, "little") + image
+    return bytes(packed)
+
+
+def tpz_unpack(packed):
+    size = packed[4] | (packed[5] << 8)
+    if packed[3] & TPZ_STORED:
+        return bytes(packed[8:8 + size])
+    image = bytearray()
+    i, control, bits = 8, 0, 0
+    while len(image) < size:
+        if bits == 0:
+            control, bits = packed[i], 8
+            i += 1
+        literal = control & 1
+        control >>= 1
+        bits -= 1
+        if literal:
+            image.append(packed[i])
+            i += 1
+        else:
+            distance, length = packed[i] + 1, packed[i + 1] + TPZ_MIN_MATCH
+            i += 2
+            for _ in range(length):
+                image.append(image[-distance])
+    return bytes(image)
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT (poly 0x1021), same as Crc16() on the master."""
+    for value in data:
+        crc ^= value << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def fingerprint(image, start):
+    """FNV-1a of the image, then its start and size (LE), same as PayloadFingerprint() on the master."""
+    value = FNV_OFFSET
+    for byte in image + start.to_bytes(2, "little") + len(image).to_bytes(2, "little"):
+        value = ((value ^ byte) * FNV_PRIME) & 0xFFFFFFFF
+    return value
+
+
+def manifest(name, image, start):
+    """Manifest of an image: page table, hash and reset vector (see include/payload-manifest.h)."""
+    pages = [image[i:i + SPM_PAGESIZE].ljust(SPM_PAGESIZE, b"\xff") for i in range(0, len(image), SPM_PAGESIZE)]
+    lines = [
+        "#define %s_MANIFEST" % name.upper(),
+        "",
+        "constexpr uint16_t %s_start = 0x%04X;" % (name, start),
+        "constexpr uint16_t %s_image_size = %d;" % (name, len(image)),
+        "constexpr uint16_t %s_reset_vector = 0x%04X;" % (name, image[0] | (image[1] << 8) if len(image) > 1 else 0xFFFF),
+        "constexpr uint32_t %s_fingerprint = 0x%08X;" % (name, fingerprint(image, start)),
+        "const uint16_t %s_page_crc[%d] = {" % (name, len(pages)),
+    ]
+    crcs = [crc16(page) for page in pages]
+    for i in range(0, len(crcs), 8):
+        lines.append("    " + ", ".join("0x%04x" % value for value in crcs[i:i + 8]) + ",")
+    lines[-1] = lines[-1].rstrip(",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def c_array(name, data, const):
+    lines = ["%suint8_t %s[%d] = {" % ("const " if const else "", name, len(data))]
+    for i in range(0, len(data), 8):
+        lines.append("    " + ", ".join("0x%02x" % value for value in data[i:i + 8]) + ",")
+    lines[-1] = lines[-1].rstrip(",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Timonel payload generator")
+    parser.add_argument("input", help="Intel HEX (.hex), binary (.bin) or raw payload header (.h)")
+    parser.add_argument("-o", "--output", help="output header (default: stdout)")
+    parser.add_argument("--name", default="payload", help="C array name (default: payload)")
+    parser.add_argument("--title", help="application name for the header comment")
+    parser.add_argument("--raw", action="store_true", help="emit an unpacked array (Timonel Hex Parser format) even if TPZ is smaller")
+    parser.add_argument("--manifest", action="store_true", help="emit only the manifest, to append to the input header")
+    args = parser.parse_args()
+
+    extension = os.path.splitext(args.input)[1].lower()
+    if extension == ".hex":
+        start, image = read_hex(args.input)
+    elif extension == ".h":
+        start, image = read_header(args.input)
+    else:
+        with open(args.input, "rb") as bin_file:
+            start, image = 0, bin_file.read()
+    if start + len(image) > 0xFFFF:
+        sys.exit("%s: image doesn't fit a Tiny85" % args.input)
+    if start % SPM_PAGESIZE:
+        sys.exit("%s: image doesn't start on a flash page boundary" % args.input)
+
+    if args.manifest:
+        if extension != ".h":
+            sys.exit("%s: --manifest appends to a payload header" % args.input)
+        text = "\n" + manifest(args.name, image, start) + "\n"
+        if args.output:
+            with open(args.output, "w") as out_file:
+                out_file.write(text)
+        else:
+            sys.stdout.write(text)
+        return
+
+    title = args.title or os.path.splitext(os.path.basename(args.input))[0]
+    comment = [
+        "//",
+        "// %s" % title,
+        "// %s" % ("-" * len(title)),
+        "// Start Address: 0x%X " % start,
+        "// End Address: 0x%X" % (start + len(image) - 1),
+        "// Date: %s" % datetime.date.today().isoformat(),
+        "//",
+        "// This is a payload file to include in the Timonel I2C-master demo applications.",
+        "//",
+    ]
+    if args.raw:
+        comment.append("// Produced from \"%s\" with payload-gen.py." % os.path.basename(args.input))
+        body = c_array(args.name, image, False)
+    else:
+        packed = tpz_pack(image, start)
+        if tpz_unpack(packed) != image:
+            sys.exit("TPZ round trip failed")
+        if len(packed) >= len(image):
+            # TPZ header and control bytes cost more than the matches save, the raw array is smaller
+            comment.append("// Produced from \"%s\" with payload-gen.py: %d bytes kept raw, TPZ would take %d (%.0f%%)." %
+                           (os.path.basename(args.input), len(image), len(packed), 100.0 * len(packed) / len(image)))
+            body = c_array(args.name, image, False)
+        else:
+            comment.append("// Produced from \"%s\" with payload-gen.py: %d bytes TPZ packed into %d (%.0f%%)." %
+                           (os.path.basename(args.input), len(image), len(packed), 100.0 * len(packed) / len(image)))
+            body = "#define %s_PACKED\n\n%s" % (args.name.upper(), c_array(args.name, packed, True))
+    text = "\n".join(comment) + "\n//\n" + body + "\n\n" + manifest(args.name, image, start) + "\n"
+    if args.output:
+        with open(args.output, "w") as out_file:
+            out_file.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -126,3 +126,14 @@ uint8_t payload[851] = {
 //
 // Timonel Hex Parser done. Thank you!
 //
+
+#define PAYLOAD_MANIFEST
+
+constexpr uint16_t payload_start = 0x0000;
+constexpr uint16_t payload_image_size = 851;
+constexpr uint16_t payload_reset_vector = 0xC00E;
+constexpr uint32_t payload_fingerprint = 0x3DBB17BF;
+const uint16_t payload_page_crc[14] = {
+    0xd1a4, 0x0981, 0xf9be, 0x90b6, 0xa0fe, 0x9406, 0x656d, 0xf5c2,
+    0xc811, 0xf3d6, 0x26e0, 0xb0c1, 0x3106, 0x155f
+};
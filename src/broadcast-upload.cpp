@@ -0,0 +1,196 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: broadcast-upload.cpp (Application)
+  ............................................................................
+  One image to every device of the bus at once (see broadcast-upload.h).
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifdef BROADCAST_UPLOAD
+
+#include "broadcast-upload.h"
+
+#include <Wire.h>
+
+#include "flash-sync.h"
+#include "perf-stats.h"
+#include "reconnect.h"
+
+// Function BroadcastCmd: send a command to every device taking the general call, there is no reply
+static uint8_t BroadcastCmd(const uint8_t *cmd, const uint8_t cmd_size) {
+    Wire.beginTransmission(BROADCAST_ADDR);
+    Wire.write(cmd, cmd_size);
+    return (Wire.endTransmission() == 0) ? 0 : ERR_01;
+}
+
+// Function WaitBootloader: true once the device answers again after a flash deletion
+static bool WaitBootloader(const uint8_t twi_addr) {
+    unsigned long start = millis();
+    while (!ProbeAddress(twi_addr)) {
+        if ((millis() - start) > BROADCAST_REAPPEAR_MS) {
+            return false;
+        }
+        delay(BROADCAST_POLL_MS);
+    }
+    return true;
+}
+
+// Function FlashAlone: erase one device and upload the whole image to it
+static uint8_t FlashAlone(const uint8_t twi_addr, PageSource *source) {
+    Timonel timonel(twi_addr);
+    PerfTimer timer(PERF_DELETE);
+    uint8_t twi_errors = timer.Stop(timonel.DeleteApplication());
+    if (twi_errors != 0) {
+        return twi_errors;
+    }
+    if (!WaitBootloader(twi_addr)) {
+        return ERR_01;
+    }
+    Timonel erased(twi_addr); /* Initialized again after the reset */
+    return UploadPages(&erased, source);
+}
+
+// Function BroadcastPages: send every block of the image to all devices at once. Returns false
+// if it had to stop: nobody took the general call, or a block needs a page address they lack.
+static bool BroadcastPages(PageSource *source, const bool set_page_addr) {
+    uint16_t flash_addr = 0, size = 0;
+    uint16_t next_addr = 0x0000; /* Timonel starts at page 0 after a reset */
+    uint8_t *data = nullptr;
+    uint8_t packet[MST_PACKET_SIZE + 2] = {WRITPAGE};
+    source->Rewind();
+    while (source->NextBlock(&flash_addr, &data, &size)) {
+        if (flash_addr != next_addr) {
+            if (!set_page_addr) {
+                return false;
+            }
+            uint8_t cmd[] = {STPGADDR, (uint8_t)((flash_addr & 0xFF00) >> 8), (uint8_t)(flash_addr & 0xFF), 0};
+            cmd[3] = (uint8_t)(cmd[1] + cmd[2]);
+            if (BroadcastCmd(cmd, sizeof(cmd)) != 0) {
+                return false;
+            }
+            delay(DLY_SET_ADDR);
+        }
+        uint16_t padded_size = ((size + SPM_PAGESIZE - 1) / SPM_PAGESIZE) * SPM_PAGESIZE;
+        for (uint16_t offset = 0; offset < padded_size; offset += MST_PACKET_SIZE) {
+            uint8_t checksum = 0;
+            for (uint8_t i = 0; i < MST_PACKET_SIZE; i++) {
+                packet[i + 1] = ((offset + i) < size) ? data[offset + i] : 0xFF;
+                checksum += packet[i + 1];
+            }
+            packet[MST_PACKET_SIZE + 1] = checksum;
+            if (BroadcastCmd(packet, sizeof(packet)) != 0) {
+                return false;
+            }
+            delay(DLY_PKT_SEND);
+            if (((offset + MST_PACKET_SIZE) % SPM_PAGESIZE) == 0) {
+                delay(DLY_FLASH_PG);
+            }
+        }
+        next_addr = ((size % SPM_PAGESIZE) == 0) ? (flash_addr + size) : 0xFFFF;
+    }
+    return true;
+}
+
+// Function FindBootloaders: addresses of the Timonel bootloaders on the bus, returns how many
+uint8_t FindBootloaders(uint8_t *addresses, const uint8_t max_count) {
+    uint8_t count = 0;
+    for (uint8_t twi_addr = LOW_TWI_ADDR; (twi_addr < APP_TWI_ADDR) && (count < max_count); twi_addr++) {
+        if (ProbeAddress(twi_addr)) {
+            addresses[count++] = twi_addr;
+        }
+    }
+    return count;
+}
+
+// Function BroadcastUpload: flash "source" on every device listed, broadcasting what they have in common.
+// Returns the first device error, 0 if all of them were flashed.
+uint8_t BroadcastUpload(PageSource *source, const uint8_t *addresses, const uint8_t count, BroadcastReport *report) {
+    *report = BroadcastReport();
+    report->devices = (count < BROADCAST_DEVICES) ? count : BROADCAST_DEVICES;
+    // The image must fit every device, and its features decide what can be broadcast
+    uint16_t flash_addr = 0, size = 0, image_end = 0;
+    uint8_t *data = nullptr;
+    source->Rewind();
+    while (source->NextBlock(&flash_addr, &data, &size)) {
+        image_end = ((flash_addr + size) > image_end) ? (flash_addr + size) : image_end;
+        report->pages += (size + SPM_PAGESIZE - 1) / SPM_PAGESIZE;
+    }
+    if (!source->IsValid() || (image_end == 0)) {
+        return ERR_BAD_PAYLOAD;
+    }
+    uint8_t features_all = 0xFF, features_any = 0;
+    for (uint8_t ix = 0; ix < report->devices; ix++) {
+        report->device[ix].address = addresses[ix];
+        Timonel timonel(addresses[ix]);
+        PerfTimer timer(PERF_STATUS);
+        Timonel::Status sts = timonel.GetStatus();
+        timer.Stop((sts.signature == T_SIGNATURE) ? 0 : ERR_02);
+        if (sts.signature != T_SIGNATURE) {
+            return ERR_01;
+        }
+        uint16_t app_limit = sts.bootloader_start;
+        if ((sts.features_code >> F_APP_USE_TPL_PG) & true) {
+            app_limit -= SPM_PAGESIZE; /* The trampoline page is reserved */
+        }
+        if (image_end > app_limit) {
+            return ERR_APP_OVF;
+        }
+        features_all &= sts.features_code;
+        features_any |= sts.features_code;
+    }
+    // Broadcast: one erase, one copy of every packet
+    unsigned long start = millis();
+    const uint8_t erase[] = {DELFLASH};
+    if (BroadcastCmd(erase, sizeof(erase)) == 0) {
+        delay(DLY_DEL_APP);
+        for (uint8_t ix = 0; ix < report->devices; ix++) {
+            WaitBootloader(addresses[ix]); /* One that doesn't come back fails its verification */
+        }
+        if ((features_any >> F_TWO_STEP_INIT) & true) {
+            const uint8_t init[] = {INITSOFT};
+            BroadcastCmd(init, sizeof(init));
+        }
+        BroadcastPages(source, (features_all >> F_CMD_SETPGADDR) & true);
+    }
+    report->broadcast_ms = millis() - start;
+    // Verification: each device is read back and gets its own copy of the pages that differ
+    start = millis();
+    uint8_t first_error = 0;
+    for (uint8_t ix = 0; ix < report->devices; ix++) {
+        BroadcastDevice *device = &report->device[ix];
+        uint8_t twi_errors = 0;
+        if (!ProbeAddress(device->address)) {
+            twi_errors = ERR_01;
+        } else {
+            Timonel timonel(device->address);
+            PerfTimer timer(PERF_STATUS);
+            Timonel::Status sts = timonel.GetStatus();
+            timer.Stop((sts.signature == T_SIGNATURE) ? 0 : ERR_02);
+            if (((sts.features_code >> F_CMD_READFLASH) & true) && ((sts.features_code >> F_CMD_SETPGADDR) & true)) {
+                DiffReport diff;
+                twi_errors = UploadDifferential(&timonel, source, &diff);
+                device->pages_resent = diff.pages_written;
+                if ((twi_errors == 0) && diff.needs_erase) {
+                    twi_errors = FlashAlone(device->address, source);
+                    device->pages_resent = report->pages;
+                    device->erased_again = true;
+                }
+                device->verified = (twi_errors == 0);
+            } else {
+                // No readback: the broadcast can't be checked, this one is flashed on its own
+                twi_errors = FlashAlone(device->address, source);
+                device->pages_resent = report->pages;
+                device->erased_again = true;
+            }
+        }
+        device->error = twi_errors;
+        first_error = (first_error == 0) ? twi_errors : first_error;
+    }
+    report->verify_ms = millis() - start;
+    return first_error;
+}
+
+#endif  // BROADCAST_UPLOAD
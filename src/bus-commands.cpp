@@ -0,0 +1,130 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: bus-commands.cpp (Application)
+  ............................................................................
+  Console commands on the I2C link (see bus-commands.h).
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "bus-commands.h"
+
+#include "flash-sync.h"
+#include "packet-size.h"
+#include "perf-stats.h"
+#include "timonel-mss-esp32.h"
+#include "twi-clock.h"
+#ifdef I2C_TRACE
+#include "i2c-trace.h"
+#endif  // I2C_TRACE
+
+// Function NegotiateLink: 'c', the I2C clock first, then the packet sizes at that clock
+void NegotiateLink(void) {
+    NegotiateAndPrint(p_timonel);
+    NegotiatePacketsAndPrint(p_timonel);
+}
+
+// Function NegotiateAndPrint: probe the device's I2C clock rates, show each one and the rate kept
+void NegotiateAndPrint(Timonel *timonel) {
+    USE_SERIAL.printf_P("\n\rBootloader Cmd >>> I2C clock negotiation ...\n\r");
+    ClockReport report;
+    NegotiateClock(timonel, &report);
+    USE_SERIAL.printf_P("  %lu kHz: base rate%s\n\r", (unsigned long)(CLOCK_BASE / 1000), report.flash_test ? "" : ", status test only (no READFLSH)");
+    for (uint8_t ix = 0; ix < report.probes; ix++) {
+        const ClockProbe &probe = report.probe[ix];
+        if (probe.error == 0) {
+            USE_SERIAL.printf_P("  %lu kHz: %d rounds passed\n\r", (unsigned long)(probe.hz / 1000), probe.rounds);
+        } else if (probe.error == ERR_VERIFY) {
+            USE_SERIAL.printf_P("  %lu kHz: data differs after %d rounds\n\r", (unsigned long)(probe.hz / 1000), probe.rounds);
+        } else {
+            USE_SERIAL.printf_P("  %lu kHz: [ command error! %d ] after %d rounds\n\r", (unsigned long)(probe.hz / 1000), probe.error, probe.rounds);
+        }
+    }
+    if (report.ceiling_hz <= CLOCK_RC_CEILING) {
+        USE_SERIAL.printf_P("  Faster rates skipped: the bootloader runs at 8 MHz (no PLL clock, no AUTO_CLK_TWEAK)\n\r");
+    }
+    USE_SERIAL.printf_P("  I2C clock: %lu kHz (probed in %lu ms)\n\n\r", (unsigned long)(report.chosen_hz / 1000),
+                        (unsigned long)(report.probe_us / 1000));
+}
+
+// Function NegotiatePacketsAndPrint: probe the device's readback packet size, show the sizes kept
+void NegotiatePacketsAndPrint(Timonel *timonel) {
+    USE_SERIAL.printf_P("Bootloader Cmd >>> Packet size negotiation ...\n\r");
+    PacketReport report;
+    uint8_t twi_errors = NegotiatePackets(timonel, device_cache.GetStatus(timonel, false), &report);
+    USE_SERIAL.printf_P("  Slave to master: %d bytes%s\n\r", report.rx_size, report.rx_probed ? "" : " (compiled, no READFLSH to probe with)");
+    if (twi_errors != 0) {
+        USE_SERIAL.printf_P("  [ command error! %d ] on the smallest size, compiled size kept\n\r", twi_errors);
+    }
+    USE_SERIAL.printf_P("  %d probe packets in %lu ms\n\n\r", report.probes, (unsigned long)(report.probe_us / 1000));
+}
+
+// Function PrintPerfStats: performance counters and latency histograms since boot
+void PrintPerfStats(void) {
+    USE_SERIAL.printf_P("\n\r Performance counters (since boot)\n\r");
+    USE_SERIAL.printf_P(" ====================================\n\r");
+    USE_SERIAL.printf_P(" %-10s %8s %7s %7s %10s %10s %10s %8s\n\r", "operation", "calls", "errors", "retries", "avg ms", "min ms",
+                        "max ms", "bytes/s");
+    for (uint8_t op = 0; op < PERF_OPS; op++) {
+        const PerfCounter &counter = PerfGet((PerfOp)op);
+        uint32_t calls = counter.calls.load(std::memory_order_relaxed);
+        USE_SERIAL.printf_P(" %-10s %8lu %7lu %7lu ", PerfName((PerfOp)op), (unsigned long)calls,
+                            (unsigned long)counter.errors.load(std::memory_order_relaxed),
+                            (unsigned long)counter.retries.load(std::memory_order_relaxed));
+        if (calls == 0) {
+            USE_SERIAL.printf_P("%10s %10s %10s %8s\n\r", "-", "-", "-", "-");
+            continue;
+        }
+        uint64_t total_us = counter.total_us.load(std::memory_order_relaxed);
+        uint32_t bytes = counter.bytes.load(std::memory_order_relaxed);
+        PrintMillis(total_us / calls);
+        PrintMillis(counter.min_us.load(std::memory_order_relaxed) - 1); /* Stored + 1 */
+        PrintMillis(counter.max_us.load(std::memory_order_relaxed));
+        if ((bytes != 0) && (total_us != 0)) {
+            USE_SERIAL.printf_P("%8lu\n\r", (unsigned long)(((uint64_t)bytes * 1000000) / total_us));
+        } else {
+            USE_SERIAL.printf_P("%8s\n\r", "-");
+        }
+    }
+    USE_SERIAL.printf_P("\n\r Latency histogram (calls below each limit, ms)\n\r");
+    for (uint8_t op = 0; op < PERF_OPS; op++) {
+        const PerfCounter &counter = PerfGet((PerfOp)op);
+        if (counter.calls.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+        USE_SERIAL.printf_P(" %-10s", PerfName((PerfOp)op));
+        for (uint8_t bucket = 0; bucket < PERF_BUCKETS; bucket++) {
+            uint32_t count = counter.histogram[bucket].load(std::memory_order_relaxed);
+            if (count == 0) {
+                continue;
+            }
+            uint32_t limit_us = PerfBucketLimit(bucket);
+            if (limit_us != 0) {
+                USE_SERIAL.printf_P(" <%lu.%lu:%lu", (unsigned long)(limit_us / 1000), (unsigned long)((limit_us % 1000) / 100),
+                                    (unsigned long)count);
+            } else {
+                USE_SERIAL.printf_P(" more:%lu", (unsigned long)count);
+            }
+        }
+        USE_SERIAL.printf_P("\n\r");
+    }
+    USE_SERIAL.printf_P("\n\r");
+}
+
+// Function PrintMillis: a time in ms with one decimal, in a 10-character column
+void PrintMillis(const uint64_t us) {
+    USE_SERIAL.printf_P("%8lu.%lu ", (unsigned long)(us / 1000), (unsigned long)((us % 1000) / 100));
+}
+
+#ifdef I2C_TRACE
+// Function PrintTrace: the I2C trace as Chrome trace JSON, between marker lines to cut it out of a console log
+void PrintTrace(void) {
+    USE_SERIAL.printf_P("\n\r I2C trace: %lu events (%lu lost), save the JSON below as a .json file for ui.perfetto.dev\n\r",
+                        (unsigned long)TraceCount(), (unsigned long)TraceLost());
+    USE_SERIAL.printf_P("-----8<-----\n");
+    TraceExport(&USE_SERIAL);
+    USE_SERIAL.printf_P("-----8<-----\n\r");
+}
+#endif  // I2C_TRACE
@@ -0,0 +1,262 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: console-job.cpp (Application)
+  ............................................................................
+  Console jobs.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "console-job.h"
+
+#include "eeprom-commands.h"
+#include "flash-commands.h"
+#include "host-link.h"
+#include "perf-stats.h"
+#include "selective-erase.h"
+#include "timonel-mss-esp32.h"
+#include "twi-clock.h"
+
+static ConsoleJob job;
+
+// Function JobPercent: share of the pages done
+static uint8_t JobPercent(void) {
+    return (job.done < job.total) ? (uint8_t)(((uint32_t)job.done * 100) / job.total) : 100;
+}
+
+// Function JobBegin: start a job on "console", with "total" pages to go through (0: unknown)
+void JobBegin(Stream *console, const char *name, const uint16_t total, const bool cancellable) {
+    job = ConsoleJob();
+    job.name = name;
+    job.console = console;
+    job.total = total;
+    job.cancellable = cancellable;
+    job.start_ms = millis();
+    job.polled_us = micros();
+    job.shown_ms = job.start_ms;
+    if (job.total != 0) {
+        job.console->printf_P("%3d%%", 0);
+    }
+}
+
+// Function JobProgress: pages done so far
+void JobProgress(const uint16_t done) {
+    job.done = done;
+}
+
+// Function JobActive: true while a job runs
+bool JobActive(void) {
+    return job.name != nullptr;
+}
+
+// Function JobCancelled: true once the running job was asked to stop
+bool JobCancelled(void) {
+    return job.cancel;
+}
+
+// Function JobKey: a key typed while the job runs
+void JobKey(const char key) {
+    if (job.name == nullptr) {
+        return;
+    }
+    unsigned long elapsed_ms = millis() - job.start_ms;
+    if (job.total != 0) {
+        job.shown_percent = JobPercent(); /* Shown again after the answer */
+    }
+    if (key == JOB_STATUS_KEY) {
+        if (job.total != 0) {
+            job.console->printf_P("\n\r  [ %s: %d of %d pages, %lu ms%s ]\n\r%3d%%", job.name, job.done, job.total, elapsed_ms,
+                                  job.cancellable ? ", 'q' cancels" : "", job.shown_percent);
+        } else {
+            job.console->printf_P("\n\r  [ %s: %lu ms%s ]\n\r", job.name, elapsed_ms, job.cancellable ? ", 'q' cancels" : "");
+        }
+        job.queries++;
+    } else if (key == JOB_CANCEL_KEY) {
+        if (job.cancellable) {
+            job.cancel = true;
+            job.console->printf_P("\n\r  [ %s: cancelling ... ]\n\r%3d%%", job.name, job.shown_percent);
+        } else {
+            job.console->printf_P("\n\r  [ %s: can't be cancelled ]\n\r", job.name);
+        }
+    }
+}
+
+// Function JobService: read the keys typed since the last look and update the progress shown.
+// Called from device waits, it only looks at the console every JOB_POLL_US.
+void JobService(void) {
+    if ((job.name == nullptr) || ((micros() - job.polled_us) < JOB_POLL_US)) {
+        return;
+    }
+    job.polled_us = micros();
+    while (job.console->available() > 0) {
+        JobKey(job.console->read());
+    }
+    if ((job.total == 0) || ((millis() - job.shown_ms) < JOB_PROGRESS_MS)) {
+        return;
+    }
+    uint8_t percent = JobPercent();
+    if (percent != job.shown_percent) {
+        job.console->printf_P("\b\b\b\b%3d%%", percent);
+        job.shown_percent = percent;
+        job.shown_ms = millis();
+    }
+}
+
+// Function JobEnd: the job is over, its progress is taken off the console
+void JobEnd(void) {
+    if ((job.name != nullptr) && (job.total != 0)) {
+        job.console->printf_P("\b\b\b\b");
+    }
+    job.name = nullptr;
+}
+
+// Function JobGet: the running job, or the last one
+const ConsoleJob &JobGet(void) {
+    return job;
+}
+
+// Function EngineLoop: run the command for the last key, or hand the key to the command waiting for it,
+// then read the next one. Returns false if there was nothing to do.
+bool EngineLoop(void) {
+    if (line_mode) {
+        return StepLine();
+    }
+    bool served = new_key;
+    if (new_key && JobActive()) {
+        new_key = false;
+        JobKey(key); /* Progress and cancel only, until the job is over */
+    } else if (new_key && (prompt != PROMPT_NONE)) {
+        new_key = false;
+        uint16_t word = 0;
+        if (ReadWord(key, &word)) {
+            AnswerPrompt(word);
+            if (prompt == PROMPT_NONE) {
+                FinishCommand();
+            }
+        }
+    } else if (new_key == true) {
+        new_key = false;
+        if (!device_cache.CheckAlive(p_timonel)) {
+            USE_SERIAL.printf_P("\n\rDevice lost, waiting for it   ");
+            uint8_t slave_address = DiscoverDevice(p_app_mode, SDA, SCL);
+            p_timonel = timonel_slot.Build(slave_address, SDA, SCL);
+            device_cache.Invalidate();
+            ShowHeader(*p_app_mode);
+        }
+        USE_SERIAL.printf_P("\b\n\r");
+        RunCommand();
+        if ((prompt == PROMPT_NONE) && !JobActive()) {
+            FinishCommand();
+        }
+    }
+    served |= StepErase();
+    ReadChar();
+    if (new_key && (key == HOST_DELIMITER) && (prompt == PROMPT_NONE) && !JobActive()) {
+        // A frame delimiter instead of a key: a host program takes over until it quits
+        new_key = false;
+        FlushEeprom(false);
+        HostTarget host_target = {&p_timonel, p_app_mode, &device_cache, SDA, SCL};
+        HostLink host_link(&USE_SERIAL, &host_target);
+        host_link.Serve();
+        eeprom_mirror.Invalidate(); /* The host may have written the EEPROM */
+        ShowMenu(*p_app_mode);
+        served = true;
+    }
+    if (!new_key && !JobActive()) {
+        device_cache.Poll(p_timonel);
+    }
+#ifdef TCP_INGEST
+#ifndef DUAL_CORE
+    tcp_ingest.Service();
+#endif  // DUAL_CORE
+    if (!new_key && (prompt == PROMPT_NONE) && !JobActive()) {
+        IngestJob *job = tcp_ingest.TakeJob();
+        if (job != nullptr) {
+            RunIngestJob(job);
+            device_cache.StartCommand();
+            ShowMenu(*p_app_mode);
+            served = true;
+        }
+    }
+#endif  // TCP_INGEST
+    return served || new_key;
+}
+
+// Function StartErase: send DELFLASH and leave the rest to the engine passes (see StepErase). The reply
+// isn't read now: the Tiny85 holds SCL low while it erases, so a read sent now would hold the console
+// for the whole erase. False if the command wasn't taken, the erase is over then.
+bool StartErase(const bool then_upload) {
+    const Timonel::Status sts = device_cache.GetStatus(p_timonel);
+    const bool known_start = (sts.bootloader_start <= MCU_TOTAL_MEM) && (sts.bootloader_start >= (SPM_PAGESIZE * 2));
+    const uint32_t pages = (known_start ? sts.bootloader_start : MCU_TOTAL_MEM) / SPM_PAGESIZE;
+    erase_job = EraseJob();
+    erase_job.start_us = micros();
+    erase_job.probe_ms = millis() + ((pages * SPM_ERASE_US) / 1000) + 1; /* Every application page erased by then */
+    erase_job.then_upload = then_upload;
+    PerfTimer timer(PERF_XMIT);
+    Wire.beginTransmission(p_timonel->GetTwiAddress());
+    Wire.write(DELFLASH);
+    uint8_t cmd_errors = timer.Stop((Wire.endTransmission() == 0) ? 0 : ERR_01);
+    if (cmd_errors != 0) {
+        FinishErase(cmd_errors);
+        return false;
+    }
+    erase_job.running = true;
+    JobBegin(&USE_SERIAL, "erase", 0, false);
+    return true;
+}
+
+// Function StepErase: the DELFLASH reply once the erase should be over, then one poll of the device per
+// pass, the command ends once it answers again. Returns true if the bus was used.
+bool StepErase(void) {
+    if (!erase_job.running || ((long)(millis() - erase_job.probe_ms) < 0)) {
+        return false;
+    }
+    if (!erase_job.replied) {
+        // A slower erase stretches this read for what is left of it only. No reply: the bootloader
+        // restarted already, the polls find it.
+        erase_job.replied = true;
+        erase_job.probe_ms = millis() + CLOCK_POLL_MS;
+        PerfTimer timer(PERF_XMIT);
+        if ((Wire.requestFrom(p_timonel->GetTwiAddress(), (uint8_t)1) == 1) && (Wire.read() != AKDLFLSH)) {
+            timer.Stop(ERR_02);
+            erase_job.running = false;
+            JobEnd();
+            FinishErase(ERR_02);
+            FinishCommand();
+        } else {
+            timer.Stop(0);
+        }
+        return true;
+    }
+    erase_job.polls++;
+    bool back = ProbeAddress(p_timonel->GetTwiAddress());
+    if (!back && ((micros() - erase_job.start_us) < ((DLY_DEL_APP + CLOCK_REAPPEAR_MS) * 1000UL))) {
+        erase_job.probe_ms = millis() + CLOCK_POLL_MS;
+        return true;
+    }
+    erase_job.running = false;
+    JobEnd();
+    FinishErase(back ? 0 : ERR_01);
+    if (back && erase_job.then_upload) {
+        UploadSelected(); /* The rest of a 'd' that had to erase */
+    }
+    FinishCommand();
+    return true;
+}
+
+// Function FinishErase: show how the deletion went and find the bootloader again
+void FinishErase(const uint8_t cmd_errors) {
+    PerfRecord(PERF_DELETE, micros() - erase_job.start_us, (cmd_errors != 0), 0, erase_job.polls);
+    USE_SERIAL.printf_P("\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b");
+    if (cmd_errors == 0) {
+        USE_SERIAL.printf_P(" successful (%lu ms)  ", (unsigned long)((micros() - erase_job.start_us) / 1000));
+    } else {
+        USE_SERIAL.printf_P(" [ command error! %d ]", cmd_errors);
+    }
+    USE_SERIAL.printf_P("\n\r");
+    device_cache.InvalidateAppStart();
+    DiscoverDevice(p_app_mode, SDA, SCL, MODE_BOOTLOADER);
+}
@@ -0,0 +1,80 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: console-ring.cpp (Application)
+  ............................................................................
+  Console output ring and input queue between the engine and console tasks.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "console-ring.h"
+
+#include "core-tasks.h"
+
+// Class ConsoleRing: Queue one output byte, waiting for room if the ring is full
+size_t ConsoleRing::write(uint8_t data) {
+    return write(&data, 1);
+}
+
+// Class ConsoleRing: Queue output bytes, waiting for room if the ring is full
+size_t ConsoleRing::write(const uint8_t *data, size_t size) {
+    size_t written = out_.Push(data, size);
+    while (written < size) {
+        stalls_.fetch_add(1, std::memory_order_relaxed);
+        TaskPause();
+        written += out_.Push(&data[written], size - written);
+    }
+    return size;
+}
+
+// Class ConsoleRing: Wait until the console task has taken all the output
+void ConsoleRing::flush(void) {
+    while (!out_.IsEmpty()) {
+        TaskPause();
+    }
+}
+
+// Class ConsoleRing: Next typed key, -1 if none
+int ConsoleRing::read(void) {
+    uint8_t key = 0;
+    return in_.Pop(&key) ? key : -1;
+}
+
+// Class ConsoleRing: Next typed key without taking it, -1 if none
+int ConsoleRing::peek(void) {
+    uint8_t key = 0;
+    return in_.Peek(&key) ? key : -1;
+}
+
+// Class ConsoleRing: Move typed keys to the engine and as much output as the UART takes
+uint32_t ConsoleRing::Service(HardwareSerial *serial) {
+    uint32_t moved = 0;
+    while ((serial->available() > 0) && (in_.Size() < CONSOLE_IN_SIZE)) {
+        in_.Push((uint8_t)serial->read());
+        moved++;
+    }
+    uint8_t chunk[CONSOLE_CHUNK];
+    int room = serial->availableForWrite();
+    while (room > 0) {
+        uint32_t size = out_.Pop(chunk, (room < CONSOLE_CHUNK) ? room : CONSOLE_CHUNK);
+        if (size == 0) {
+            break;
+        }
+        serial->write(chunk, size);
+        moved += size;
+        room -= size;
+    }
+    return moved;
+}
+
+// Function ConsoleTask: serve the console ring forever, resting a tick when there is nothing to move
+void ConsoleTask(void *console_ring) {
+    ConsoleRing *console = (ConsoleRing *)console_ring;
+    for (;;) {
+        if (console->Service(&Serial) == 0) {
+            TaskPause();
+        }
+    }
+}
@@ -0,0 +1,51 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: core-tasks.cpp (Application)
+  ............................................................................
+  Tasks pinned to a core.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "core-tasks.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Function StartTask: FreeRTOS task pinned to "core"
+bool StartTask(TaskEntry entry, const char *name, const uint32_t stack_size, void *arg, const uint8_t priority, const uint8_t core) {
+    return xTaskCreatePinnedToCore(entry, name, stack_size, arg, priority, nullptr, core) == pdPASS;
+}
+
+// Function TaskPause: let lower priority tasks (and the idle task watchdog) run for a tick
+void TaskPause(void) {
+    vTaskDelay(1);
+}
+#else
+#include <SimClock.h>
+
+#include <thread>
+
+// Function StartTask: detached host thread, stack size, priority and core are not applied.
+// The thread's virtual clock starts at its creator's time.
+bool StartTask(TaskEntry entry, const char *name, const uint32_t stack_size, void *arg, const uint8_t priority, const uint8_t core) {
+    (void)name;
+    (void)stack_size;
+    (void)priority;
+    (void)core;
+    uint64_t now_us = SimClock::Now();
+    std::thread([entry, arg, now_us]() {
+        SimClock::Set(now_us);
+        entry(arg);
+    }).detach();
+    return true;
+}
+
+// Function TaskPause: give the other threads a chance
+void TaskPause(void) {
+    std::this_thread::yield();
+}
+#endif  // ARDUINO_ARCH_ESP32
@@ -0,0 +1,107 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: device-cache.cpp (Application)
+  ............................................................................
+  Device state cache.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "device-cache.h"
+
+#include "perf-stats.h"
+#include "upload-checkpoint.h"
+
+// Class DeviceCache: Timonel status, queried only when stale
+Timonel::Status DeviceCache::GetStatus(Timonel *timonel, const bool need_app_start) {
+    if (enabled_ && status_valid_ && (app_start_valid_ || !need_app_start)) {
+        Saved(QUERY_TRANSACTIONS);
+        return status_;
+    }
+    PerfTimer timer(PERF_STATUS);
+    status_ = timonel->GetStatus();
+    status_valid_ = (status_.signature == T_SIGNATURE);
+    timer.Stop(status_valid_ ? 0 : ERR_02);
+    app_start_valid_ = status_valid_;
+    return status_;
+}
+
+// Class DeviceCache: Device settings (fuses, lock bits, signature), they don't change while running
+Timonel::DevSettings DeviceCache::GetDevSettings(Timonel *timonel) {
+    if (enabled_ && settings_valid_) {
+        Saved(QUERY_TRANSACTIONS);
+        return settings_;
+    }
+    settings_ = timonel->GetDevSettings();
+    settings_valid_ = (settings_.signature_byte_0 == AVR_SIGNATURE_0);
+    return settings_;
+}
+
+// Class DeviceCache: Drop everything
+void DeviceCache::Invalidate(void) {
+    status_valid_ = false;
+    app_start_valid_ = false;
+    settings_valid_ = false;
+    lost_ = false;
+    last_alive_ = millis();
+    generation_++;
+}
+
+// Class DeviceCache: The application start changes when the flash is erased or written
+void DeviceCache::InvalidateAppStart(void) {
+    app_start_valid_ = false;
+}
+
+// Class DeviceCache: Whether the device still answers, probing it only if the last check is old. A device
+// that answers but isn't the one cached drops the cache, and its address's upload checkpoint.
+bool DeviceCache::CheckAlive(Timonel *timonel) {
+    if (enabled_ && !lost_ && ((millis() - last_alive_) < CACHE_ALIVE_MS)) {
+        Saved(1);
+        return true;
+    }
+    const uint8_t twi_addr = timonel->GetTwiAddress();
+    lost_ = !ProbeAddress(twi_addr);
+    last_alive_ = millis();
+    if (lost_) {
+        Invalidate();
+        ClearCheckpoint(twi_addr); /* Whatever answers there next may be another board */
+        lost_ = true;
+    } else if (!SameDevice(timonel)) {
+        swaps_++;
+        Invalidate();
+        ClearCheckpoint(twi_addr);
+    }
+    return !lost_;
+}
+
+// Class DeviceCache: Background liveness check, call it from the idle loop
+void DeviceCache::Poll(Timonel *timonel) {
+    if (enabled_ && !lost_ && ((millis() - last_alive_) >= CACHE_ALIVE_MS)) {
+        poll_probes_++;
+        CheckAlive(timonel);
+    }
+}
+
+// Class DeviceCache: Whether the bootloader answering has the status cached, true if none is cached
+// (e.g. in application mode, where there is no status to compare) or the cache is off
+bool DeviceCache::SameDevice(Timonel *timonel) {
+    if (!enabled_ || !status_valid_) {
+        return true;
+    }
+    poll_probes_ += QUERY_TRANSACTIONS; /* Not a query the console asked for */
+    PerfTimer timer(PERF_STATUS);
+    Timonel::Status sts = timonel->GetStatus();
+    timer.Stop((sts.signature == T_SIGNATURE) ? 0 : ERR_02);
+    return (sts.signature == status_.signature) && (sts.version_major == status_.version_major) &&
+           (sts.version_minor == status_.version_minor) && (sts.features_code == status_.features_code) &&
+           (sts.ext_features_code == status_.ext_features_code) && (sts.bootloader_start == status_.bootloader_start) &&
+           (!app_start_valid_ || (sts.application_start == status_.application_start));
+}
+
+// Class DeviceCache: Count transactions answered from the cache
+void DeviceCache::Saved(const uint8_t transactions) {
+    saved_command_ += transactions;
+    saved_total_ += transactions;
+}
@@ -0,0 +1,167 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: eeprom-commands.cpp (Application)
+  ............................................................................
+  Console commands on the device EEPROM (see eeprom-commands.h).
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "eeprom-commands.h"
+
+#include "eeprom-image.h"
+#include "timonel-mss-esp32.h"
+
+#if ((defined FEATURES_CODE) && ((FEATURES_CODE >> F_CMD_READFLASH) & true))
+#if ((defined EXT_FEATURES) && ((EXT_FEATURES >> E_EEPROM_ACCESS) & true))
+// Function AskEepromAddr: 'p', ask for the EEPROM address, then the byte to write there (WRITEEPR)
+void AskEepromAddr(void) {
+    USE_SERIAL.printf_P("\n\rPlease enter the EEPROM memory address: ");
+    prompt = PROMPT_EEPROM_ADDR;
+}
+
+// Function SetEepromAddr: the EEPROM address typed for 'p'
+void SetEepromAddr(const uint16_t word) {
+    eeprom_addr = word;
+    if (eeprom_addr > EEPROM_TOP) {
+        USE_SERIAL.printf_P("\n\rWarning: The highest EEPROM address available is %d (0x%X), please correct it !!!\n\n\r", EEPROM_TOP, EEPROM_TOP);
+        return;
+    }
+    USE_SERIAL.printf_P("\n\rPlease enter EEPROM data: ");
+    prompt = PROMPT_EEPROM_DATA;
+}
+
+// Function WriteEepromByte: the byte typed for 'p', left pending in the mirror
+void WriteEepromByte(const uint16_t word) {
+    uint8_t eeprom_data = (uint8_t)word;
+    ReportEepromDropped();
+    USE_SERIAL.printf_P("\n\r\n\rWriting %d to EEPROM address 0x%04X", eeprom_data, eeprom_addr);
+    EepromTransfer eeprom(p_timonel, device_cache.GetStatus(p_timonel, false));
+    uint8_t cmd_errors = eeprom_mirror.Write(&eeprom, eeprom_addr, &eeprom_data, 1);
+    if (cmd_errors != 0) {
+        USE_SERIAL.printf_P(" [ command error! %d ]\n\n\r", cmd_errors);
+    } else {
+        USE_SERIAL.printf_P(" > %s, %d bytes pending ('n' or the next command writes them)\n\n\r",
+                            eeprom_mirror.IsDirty(eeprom_addr) ? "pending" : "unchanged", eeprom_mirror.GetDirty());
+    }
+}
+
+// Function ShowEeprom: 'o', the whole EEPROM, from the mirror once it was read (READEEPR)
+void ShowEeprom(void) {
+    bool mirrored = eeprom_mirror.IsLoaded();
+    ReportEepromDropped();
+    USE_SERIAL.printf_P("\n\r");
+    EepromTransfer eeprom(p_timonel, device_cache.GetStatus(p_timonel, false));
+    uint8_t eeprom_data[EEPROM_TOP + 1];
+    unsigned long read_start = millis();
+    uint8_t cmd_errors = eeprom_mirror.Read(&eeprom, 0, eeprom_data, sizeof(eeprom_data));
+    unsigned long read_ms = millis() - read_start;
+    if (cmd_errors != 0) {
+        USE_SERIAL.printf_P("[ command error! %d ]\n\n\r", cmd_errors);
+        return;
+    }
+    for (uint16_t ee_addr = 0; ee_addr <= EEPROM_TOP; ee_addr++) {
+        USE_SERIAL.printf_P("%03d=%02d%c", ee_addr, eeprom_data[ee_addr], eeprom_mirror.IsDirty(ee_addr) ? '*' : ' ');
+    }
+    if (mirrored) {
+        USE_SERIAL.printf_P("\n\n\r[ %d bytes from the mirror, %d pending ('*', 'n' writes them) ]\n\n\r", (int)sizeof(eeprom_data),
+                            eeprom_mirror.GetDirty());
+    } else {
+        USE_SERIAL.printf_P("\n\n\r[ %d bytes read in %lu ms, %s commands, mirrored until the device resets ]\n\n\r",
+                            (int)sizeof(eeprom_data), read_ms, eeprom.UsesBlocks() ? "block" : "single byte");
+    }
+}
+
+// Function FlushPendingEeprom: 'n', write the pending mirror bytes now
+void FlushPendingEeprom(void) {
+    FlushEeprom(true);
+}
+
+// Function SaveEepromImage: 'k', the whole EEPROM to a file in the payload store
+void SaveEepromImage(void) {
+    USE_SERIAL.printf_P("\n\rBootloader Cmd >>> Saving the EEPROM to %s ...", EEPROM_EXPORT_PATH);
+    EepromTransfer eeprom(p_timonel, device_cache.GetStatus(p_timonel, false));
+    uint8_t cmd_errors = EepromExport(&eeprom, EEPROM_EXPORT_PATH, EEPROM_TOP + 1);
+    if (cmd_errors == 0) {
+        USE_SERIAL.printf_P(" %d bytes saved\n\n\r", EEPROM_TOP + 1);
+    } else {
+        USE_SERIAL.printf_P(" [ command error! %d ]\n\n\r", cmd_errors);
+    }
+}
+
+// Function PickEepromImage: 'l', list the EEPROM images and ask which one to write
+void PickEepromImage(void) {
+    USE_SERIAL.printf_P("\n\rEEPROM images available:\n\r");
+    uint8_t file_count = StoreList(EEPROM_DIR, false, PrintEepromFile);
+    if (file_count == 0) {
+        USE_SERIAL.printf_P("  none, please add .bin files to %s\n\n\r", EEPROM_DIR);
+        return;
+    }
+    USE_SERIAL.printf_P("\n\rPlease select the image to write: ");
+    prompt_choices = file_count;
+    prompt = PROMPT_EEPROM_IMAGE;
+}
+
+// Function LoadEepromImage: the image number typed for 'l', written and verified
+void LoadEepromImage(const uint16_t word) {
+    char image_path[MAX_PAYLOAD_PATH];
+    if ((word == 0) || (word > prompt_choices) || !StorePath(EEPROM_DIR, false, word, image_path, sizeof(image_path))) {
+        USE_SERIAL.printf_P("\n\rWarning: There is no image %d, please correct it !!!\n\n\r", word);
+        return;
+    }
+    USE_SERIAL.printf_P("\n\rBootloader Cmd >>> Writing %s to the EEPROM, \x1b[5mPLEASE WAIT\x1b[0m ...", image_path);
+    EepromTransfer eeprom(p_timonel, device_cache.GetStatus(p_timonel, false));
+    EepromReport report;
+    unsigned long write_start = millis();
+    uint8_t cmd_errors = EepromImport(&eeprom, image_path, EEPROM_TOP + 1, &report);
+    eeprom_mirror.Invalidate(); /* Written behind its back, nothing is pending (flushed before 'l') */
+    unsigned long write_ms = millis() - write_start;
+    USE_SERIAL.printf_P("\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b");
+    if (cmd_errors == 0) {
+        USE_SERIAL.printf_P(" verified: %d bytes, %d changed, %lu ms\n\n\r", report.bytes, report.bytes_written, write_ms);
+    } else {
+        USE_SERIAL.printf_P(" [ command error! %d ]\n\n\r", cmd_errors);
+    }
+}
+
+// Function PrintEepromFile
+void PrintEepromFile(const uint8_t index, const char *name, const size_t size) {
+    USE_SERIAL.printf_P("  %d) %s/%s (%d bytes)\n\r", index, EEPROM_DIR, name, (int)size);
+}
+#endif  // EXT_FEATURES >> E_EEPROM_ACCESS
+#endif  // F_CMD_READFLASH
+
+// Function FlushEeprom: write the EEPROM bytes pending in the mirror, only if there are any unless "asked" ('n')
+uint8_t FlushEeprom(const bool asked) {
+    bool loaded = eeprom_mirror.IsLoaded(); /* Drops the mirror if the device reset since it was loaded */
+    ReportEepromDropped();
+    if (!asked && (eeprom_mirror.GetDirty() == 0)) {
+        return 0;
+    }
+    if (!loaded || (eeprom_mirror.GetDirty() == 0)) {
+        USE_SERIAL.printf_P("\n\rNo EEPROM bytes pending\n\n\r");
+        return 0;
+    }
+    USE_SERIAL.printf_P("\n\rWriting %d pending EEPROM bytes ...", eeprom_mirror.GetDirty());
+    EepromTransfer eeprom(p_timonel, device_cache.GetStatus(p_timonel, false));
+    EepromReport report;
+    unsigned long write_start = millis();
+    uint8_t cmd_errors = eeprom_mirror.Flush(&eeprom, &report);
+    unsigned long write_ms = millis() - write_start;
+    if (cmd_errors == 0) {
+        USE_SERIAL.printf_P(" verified: %d bytes in %d commands, %lu ms\n\n\r", report.bytes_written, report.commands, write_ms);
+    } else {
+        USE_SERIAL.printf_P(" [ command error! %d ], %d bytes still pending\n\n\r", cmd_errors, eeprom_mirror.GetDirty());
+    }
+    return cmd_errors;
+}
+
+// Function ReportEepromDropped: warn about pending EEPROM bytes the mirror dropped on a device reset
+void ReportEepromDropped(void) {
+    uint16_t dropped = eeprom_mirror.TakeDropped();
+    if (dropped != 0) {
+        USE_SERIAL.printf_P("\n\rWarning: %d pending EEPROM bytes dropped, the device reset before they were written\n\r", dropped);
+    }
+}
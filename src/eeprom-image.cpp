@@ -0,0 +1,201 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: eeprom-image.cpp (Application)
+  ............................................................................
+  Device EEPROM block transfers and binary images.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "eeprom-image.h"
+
+#include "packet-size.h"
+#include "perf-stats.h"
+
+// Class constructor: block commands only if built for them and the bootloader reports them
+EepromTransfer::EepromTransfer(Timonel *timonel, const Timonel::Status &status)
+    : timonel_(timonel),
+#ifdef EEPROM_BLOCKS_EXPERIMENTAL
+      blocks_((status.ext_features_code >> E_EEPROM_BLOCKS) & true),
+#else
+      blocks_(false),
+#endif  // EEPROM_BLOCKS_EXPERIMENTAL
+      rx_packet_(GetRxPacket(timonel->GetTwiAddress())) {}
+
+// Class EepromTransfer: Read an EEPROM area, a negotiated slave-to-master packet per READEEBK or one byte per READEEPR
+uint8_t EepromTransfer::Read(const uint16_t eeprom_addr, uint8_t *data, const uint16_t size) {
+    uint8_t twi_cmd_arr[5] = {READEEPR, 0, 0, 0, 0};
+    uint8_t twi_reply_arr[PACKET_MAX + 2];
+    const uint8_t max_packet = blocks_ ? rx_packet_ : 1;
+    for (uint16_t offset = 0; offset < size; offset += max_packet) {
+        uint16_t addr = eeprom_addr + offset;
+        twi_cmd_arr[1] = ((addr & 0xFF00) >> 8);
+        twi_cmd_arr[2] = (addr & 0xFF);
+        uint8_t twi_errors = 0;
+        commands_++;
+        if (!blocks_) {
+            PerfTimer timer(PERF_XMIT);
+            twi_errors = timer.Stop(timonel_->TwiCmdXmit(twi_cmd_arr, 3, ACKRDEEP, twi_reply_arr, 2), 1);
+            data[offset] = twi_reply_arr[1];
+            if (twi_errors != 0) {
+                return twi_errors;
+            }
+            continue;
+        }
+#ifdef EEPROM_BLOCKS_EXPERIMENTAL
+        uint8_t packet_size = ((size - offset) < max_packet) ? (size - offset) : max_packet;
+        twi_cmd_arr[0] = READEEBK;
+        twi_cmd_arr[3] = packet_size;
+        twi_cmd_arr[4] = (uint8_t)(twi_cmd_arr[1] + twi_cmd_arr[2] + twi_cmd_arr[3]);
+        PerfTimer timer(PERF_XMIT);
+        twi_errors = timer.Stop(timonel_->TwiCmdXmit(twi_cmd_arr, 5, ACKRDEBK, twi_reply_arr, packet_size + 2), packet_size);
+        if (twi_errors != 0) {
+            return twi_errors;
+        }
+        uint8_t checksum = 0;
+        for (uint8_t i = 0; i < packet_size; i++) {
+            data[offset + i] = twi_reply_arr[i + 1];
+            checksum += twi_reply_arr[i + 1];
+        }
+        if (checksum != twi_reply_arr[packet_size + 1]) {
+            return ERR_04;
+        }
+#endif  // EEPROM_BLOCKS_EXPERIMENTAL
+    }
+    return 0;
+}
+
+// Class EepromTransfer: Write an EEPROM area, an MST_PACKET_SIZE packet per WRITEEBK or one byte per
+// WRITEEPR. The WRITEEBK reply is ready once the block is in EEPROM, WRITEEPR needs the DLY_EEPROM wait.
+uint8_t EepromTransfer::Write(const uint16_t eeprom_addr, const uint8_t *data, const uint16_t size) {
+    uint8_t twi_cmd_arr[MST_PACKET_SIZE + 5] = {WRITEEPR};
+    const uint8_t max_packet = blocks_ ? MST_PACKET_SIZE : 1;
+    for (uint16_t offset = 0; offset < size; offset += max_packet) {
+        uint16_t addr = eeprom_addr + offset;
+        twi_cmd_arr[1] = ((addr & 0xFF00) >> 8);
+        twi_cmd_arr[2] = (addr & 0xFF);
+        commands_++;
+        if (!blocks_) {
+            twi_cmd_arr[3] = data[offset];
+            PerfTimer timer(PERF_XMIT);
+            uint8_t twi_errors = timer.Stop(timonel_->TwiCmdXmit(twi_cmd_arr, 4, ACKWTEEP), 1);
+            delay(DLY_EEPROM);
+            if (twi_errors != 0) {
+                return twi_errors;
+            }
+            continue;
+        }
+#ifdef EEPROM_BLOCKS_EXPERIMENTAL
+        uint8_t packet_size = ((size - offset) < max_packet) ? (size - offset) : max_packet;
+        uint8_t twi_reply_arr[2] = {0};
+        uint8_t checksum = 0;
+        twi_cmd_arr[0] = WRITEEBK;
+        twi_cmd_arr[3] = packet_size;
+        for (uint8_t i = 0; i < packet_size; i++) {
+            twi_cmd_arr[4 + i] = data[offset + i];
+            checksum += data[offset + i];
+        }
+        twi_cmd_arr[4 + packet_size] = checksum;
+        PerfTimer timer(PERF_XMIT);
+        uint8_t twi_errors = timer.Stop(timonel_->TwiCmdXmit(twi_cmd_arr, packet_size + 5, ACKWTEBK, twi_reply_arr, 2), packet_size);
+        if (twi_errors != 0) {
+            return twi_errors;
+        }
+        if (twi_reply_arr[1] != checksum) {
+            return ERR_04;
+        }
+#endif  // EEPROM_BLOCKS_EXPERIMENTAL
+    }
+    return 0;
+}
+
+// Class EepromTransfer: Write only the bytes that differ from the device EEPROM, then verify them
+uint8_t EepromTransfer::Program(const uint16_t eeprom_addr, const uint8_t *data, const uint16_t size, EepromReport *report) {
+    *report = EepromReport();
+    report->bytes = size;
+    report->blocks = blocks_;
+    uint16_t commands_start = commands_;
+    uint8_t device[EEPROM_CHUNK];
+    for (uint16_t offset = 0; offset < size; offset += EEPROM_CHUNK) {
+        uint16_t chunk_size = ((size - offset) < EEPROM_CHUNK) ? (size - offset) : EEPROM_CHUNK;
+        const uint8_t *target = &data[offset];
+        uint8_t twi_errors = Read(eeprom_addr + offset, device, chunk_size);
+        if (twi_errors != 0) {
+            return twi_errors;
+        }
+        report->bytes_read += chunk_size;
+        bool written = false;
+        uint16_t i = 0;
+        while (i < chunk_size) {
+            if (device[i] == target[i]) {
+                i++;
+                continue;
+            }
+            uint16_t run_start = i;
+            while ((i < chunk_size) && (device[i] != target[i])) {
+                i++;
+            }
+            twi_errors = Write(eeprom_addr + offset + run_start, &target[run_start], i - run_start);
+            if (twi_errors != 0) {
+                return twi_errors;
+            }
+            report->bytes_written += (i - run_start);
+            written = true;
+        }
+        if (written) {
+            twi_errors = Read(eeprom_addr + offset, device, chunk_size);
+            if (twi_errors != 0) {
+                return twi_errors;
+            }
+            report->bytes_read += chunk_size;
+            if (memcmp(device, target, chunk_size) != 0) {
+                return ERR_EEPROM_VERIFY;
+            }
+        }
+    }
+    report->commands = commands_ - commands_start;
+    return 0;
+}
+
+// Function EepromExport: save the first "size" EEPROM bytes as a binary image
+uint8_t EepromExport(EepromTransfer *eeprom, const char *path, const uint16_t size) {
+    uint8_t chunk[EEPROM_CHUNK];
+    LittleFS.mkdir(EEPROM_DIR);
+    File file = LittleFS.open(path, "w");
+    if (!file) {
+        return ERR_EEPROM_IMAGE;
+    }
+    for (uint16_t offset = 0; offset < size; offset += EEPROM_CHUNK) {
+        uint16_t chunk_size = ((size - offset) < EEPROM_CHUNK) ? (size - offset) : EEPROM_CHUNK;
+        uint8_t twi_errors = eeprom->Read(offset, chunk, chunk_size);
+        if (twi_errors != 0) {
+            file.close();
+            return twi_errors;
+        }
+        if (file.write(chunk, chunk_size) != chunk_size) {
+            file.close();
+            return ERR_EEPROM_IMAGE;
+        }
+    }
+    file.close();
+    return 0;
+}
+
+// Function EepromImport: program a binary image from address 0, up to "max_size" bytes
+uint8_t EepromImport(EepromTransfer *eeprom, const char *path, const uint16_t max_size, EepromReport *report) {
+    *report = EepromReport();
+    File file = LittleFS.open(path, "r");
+    if (!file || file.isDirectory() || (file.size() == 0) || (file.size() > max_size) || (file.size() > EEPROM_IMAGE_MAX)) {
+        return ERR_EEPROM_IMAGE;
+    }
+    uint8_t image[EEPROM_IMAGE_MAX];
+    uint16_t image_size = file.size();
+    bool read_ok = (file.read(image, image_size) == image_size);
+    file.close();
+    if (!read_ok) {
+        return ERR_EEPROM_IMAGE;
+    }
+    return eeprom->Program(0, image, image_size, report);
+}
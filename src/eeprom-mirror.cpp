@@ -0,0 +1,140 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: eeprom-mirror.cpp (Application)
+  ............................................................................
+  Write-back mirror of the device EEPROM (see eeprom-mirror.h).
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "eeprom-mirror.h"
+
+// Class constructor: mirror the first "size" EEPROM bytes
+EepromMirror::EepromMirror(DeviceCache *cache, const uint16_t size)
+    : cache_(cache), size_((size < EEPROM_IMAGE_MAX) ? size : EEPROM_IMAGE_MAX) {}
+
+// Class EepromMirror: Whether the mirror holds the device EEPROM, drops it if the device cache was invalidated since the load
+bool EepromMirror::IsLoaded(void) {
+    if (loaded_ && (generation_ != cache_->GetGeneration())) {
+        Invalidate();
+    }
+    return loaded_;
+}
+
+// Class EepromMirror: Drop the mirror, pending bytes included (e.g. the EEPROM was written behind its back)
+void EepromMirror::Invalidate(void) {
+    dropped_ += dirty_count_;
+    stats_.dropped += dirty_count_;
+    memset(dirty_, 0, sizeof(dirty_));
+    dirty_count_ = 0;
+    loaded_ = false;
+}
+
+// Class EepromMirror: Dirty bytes dropped since the last call
+uint16_t EepromMirror::TakeDropped(void) {
+    uint16_t dropped = dropped_;
+    dropped_ = 0;
+    return dropped;
+}
+
+// Class EepromMirror: Read the whole EEPROM
+uint8_t EepromMirror::Load(EepromTransfer *eeprom) {
+    uint8_t twi_errors = eeprom->Read(0, device_, size_);
+    if (twi_errors != 0) {
+        return twi_errors;
+    }
+    memcpy(image_, device_, size_);
+    generation_ = cache_->GetGeneration();
+    loaded_ = true;
+    stats_.loads++;
+    return 0;
+}
+
+// Class EepromMirror: Read an EEPROM area, from the device only the first time
+uint8_t EepromMirror::Read(EepromTransfer *eeprom, const uint16_t eeprom_addr, uint8_t *data, const uint16_t size) {
+    if ((eeprom_addr + size) > size_) {
+        return ERR_EEPROM_IMAGE;
+    }
+    uint8_t twi_errors = IsLoaded() ? 0 : Load(eeprom);
+    if (twi_errors != 0) {
+        return twi_errors;
+    }
+    memcpy(data, &image_[eeprom_addr], size);
+    stats_.local_reads += size;
+    return 0;
+}
+
+// Class EepromMirror: Write an EEPROM area to the mirror, the bytes that now differ from the device wait for Flush
+uint8_t EepromMirror::Write(EepromTransfer *eeprom, const uint16_t eeprom_addr, const uint8_t *data, const uint16_t size) {
+    if ((eeprom_addr + size) > size_) {
+        return ERR_EEPROM_IMAGE;
+    }
+    uint8_t twi_errors = IsLoaded() ? 0 : Load(eeprom);
+    if (twi_errors != 0) {
+        return twi_errors;
+    }
+    for (uint16_t i = 0; i < size; i++) {
+        uint16_t addr = eeprom_addr + i;
+        stats_.absorbed += (IsDirty(addr) || (data[i] == device_[addr])) ? 1 : 0; /* Rewritten, reverted or unchanged */
+        image_[addr] = data[i];
+        SetDirty(addr, image_[addr] != device_[addr]);
+    }
+    stats_.writes += size;
+    return 0;
+}
+
+// Class EepromMirror: Write the dirty bytes to the device, a run of consecutive ones at a time, and verify each run
+uint8_t EepromMirror::Flush(EepromTransfer *eeprom, EepromReport *report) {
+    *report = EepromReport();
+    report->blocks = eeprom->UsesBlocks();
+    if (!IsLoaded() || (dirty_count_ == 0)) {
+        return 0;
+    }
+    report->bytes = dirty_count_;
+    uint16_t commands_start = eeprom->GetCommands();
+    uint8_t readback[EEPROM_IMAGE_MAX];
+    uint16_t addr = 0;
+    while (addr < size_) {
+        if (!IsDirty(addr)) {
+            addr++;
+            continue;
+        }
+        uint16_t run_start = addr;
+        while ((addr < size_) && IsDirty(addr)) {
+            addr++;
+        }
+        uint16_t run_size = addr - run_start;
+        uint8_t twi_errors = eeprom->Write(run_start, &image_[run_start], run_size);
+        if (twi_errors == 0) {
+            twi_errors = eeprom->Read(run_start, readback, run_size);
+        }
+        if ((twi_errors == 0) && (memcmp(readback, &image_[run_start], run_size) != 0)) {
+            twi_errors = ERR_EEPROM_VERIFY;
+        }
+        if (twi_errors != 0) {
+            report->commands = eeprom->GetCommands() - commands_start;
+            return twi_errors; /* The run stays dirty */
+        }
+        memcpy(&device_[run_start], &image_[run_start], run_size);
+        for (uint16_t i = run_start; i < addr; i++) {
+            SetDirty(i, false);
+        }
+        report->bytes_written += run_size;
+        report->bytes_read += run_size;
+        stats_.flushed += run_size;
+        stats_.runs++;
+    }
+    report->commands = eeprom->GetCommands() - commands_start;
+    return 0;
+}
+
+// Class EepromMirror: Mark or clear a byte, keeping the count
+void EepromMirror::SetDirty(const uint16_t eeprom_addr, const bool dirty) {
+    if (IsDirty(eeprom_addr) == dirty) {
+        return;
+    }
+    dirty_[eeprom_addr >> 3] ^= (uint8_t)(1 << (eeprom_addr & 7));
+    dirty_count_ = dirty ? (dirty_count_ + 1) : (dirty_count_ - 1);
+}
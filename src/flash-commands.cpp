@@ -0,0 +1,217 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: flash-commands.cpp (Application)
+  ............................................................................
+  Console commands on the device flash (see flash-commands.h).
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "flash-commands.h"
+
+#include <Wire.h>
+
+#include "console-job.h"
+#include "flash-dump.h"
+#include "flash-sync.h"
+#include "perf-stats.h"
+#include "selective-erase.h"
+#include "timonel-mss-esp32.h"
+#include "twi-clock.h"
+
+// Function EraseApplication: delete the application, only the pages it occupies if "selective" ('u')
+// and the bootloader erases pages before writing them and that beats DELFLASH
+static void EraseApplication(const bool selective) {
+    USE_SERIAL.printf_P("\n\rBootloader Cmd >>> Delete app firmware from flash memory, \x1b[5mPLEASE WAIT\x1b[0m ...");
+    EraseReport report;
+    if (selective && CanEraseSelective(device_cache.GetStatus(p_timonel), SelectedManifest())) {
+        Timonel::Status sts = device_cache.GetStatus(p_timonel);
+        uint8_t cmd_errors = EraseOccupied(p_timonel, sts, SelectedManifest(), &report);
+        if (cmd_errors != ERR_NO_SELECTIVE) {
+            PerfRecord(PERF_DELETE, report.erase_us, (cmd_errors != 0), (uint32_t)report.pages * SPM_PAGESIZE, 0);
+            device_cache.InvalidateAppStart();
+            USE_SERIAL.printf_P("\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b");
+            if (cmd_errors == 0) {
+                USE_SERIAL.printf_P(" successful, %d of %d pages erased, %d read%s (%lu ms)  \n\r", report.pages, report.full_pages,
+                                    report.pages_read,
+                                    report.partial ? ", PARTIAL: the pages past the known extent weren't checked" : "",
+                                    (unsigned long)(report.erase_us / 1000));
+            } else {
+                USE_SERIAL.printf_P(" [ command error! %d ], %d pages erased\n\r", cmd_errors, report.pages);
+            }
+            return;
+        }
+    }
+    if (report.slower) {
+        USE_SERIAL.printf_P(" DELFLASH is faster (%lu ms of page erases), the whole application area ...",
+                            (unsigned long)(report.estimate_us / 1000));
+    } else if (selective) {
+        USE_SERIAL.printf_P(" can't erase page by page, the whole application area ...");
+    }
+    // DELFLASH now, the engine polls for the device on its next passes (see StepErase)
+    StartErase(false);
+}
+
+// Function EraseFlash: 'e', the whole application area (DELFLASH)
+void EraseFlash(void) {
+    EraseApplication(false);
+}
+
+// Function ErasePages: 'u', only the pages the application occupies when that can be done
+void ErasePages(void) {
+    EraseApplication(true);
+}
+
+// Function AskPageAddr: 'b', ask for the flash page base address (STPGADDR)
+void AskPageAddr(void) {
+    Timonel::Status sts = device_cache.GetStatus(p_timonel, false);
+    if (((sts.features_code >> F_CMD_SETPGADDR) & true) == false) {
+        USE_SERIAL.printf_P("\n\rSet address command not supported by current Timonel features ...\n\r");
+        return;
+    }
+    USE_SERIAL.printf_P("\n\rPlease enter the flash memory page base address: ");
+    prompt = PROMPT_PAGE_ADDR;
+}
+
+// Function SetPageAddr: the page base address typed for 'b'
+void SetPageAddr(const uint16_t word) {
+    Timonel::Status sts = device_cache.GetStatus(p_timonel, false);
+    flash_page_addr = word;
+    USE_SERIAL.printf_P("\n\rFlash memory page base address: %d\r\n", flash_page_addr);
+    USE_SERIAL.printf_P("Address high byte: %d (<< 8) + Address low byte: %d\n\r", (flash_page_addr & 0xFF00) >> 8,
+                        flash_page_addr & 0xFF);
+    if (sts.bootloader_start > MCU_TOTAL_MEM) {
+        USE_SERIAL.printf_P("\n\n\rWarning: Timonel bootloader start address unknown, please run 'version' command to find it !\n\r");
+        return;
+    }
+    if ((flash_page_addr > (sts.bootloader_start - SPM_PAGESIZE)) | (flash_page_addr == 0xFFFF)) {
+        USE_SERIAL.printf_P("\n\rWarning: The highest flash page address available is %d (0x%X), please correct it !!!\n\n\r",
+                            sts.bootloader_start - SPM_PAGESIZE, sts.bootloader_start - SPM_PAGESIZE);
+        flash_page_addr = 0x0000;
+    }
+}
+
+// Function PickPayload: 'f', list the payload library and ask which one to flash
+void PickPayload(void) {
+    USE_SERIAL.printf_P("\n\rPayloads available:\n\r");
+    USE_SERIAL.printf_P("  0) built-in payload.h%s\n\r", (payload_file[0] == '\0') ? " [selected]" : "");
+    prompt_choices = PayloadStoreList(PrintPayloadFile);
+    USE_SERIAL.printf_P("\n\rPlease select the payload to flash: ");
+    prompt = PROMPT_PAYLOAD;
+}
+
+// Function SelectPayload: the payload number typed for 'f', 0 = built-in payload.h
+void SelectPayload(const uint16_t word) {
+    if (word == 0) {
+        payload_file[0] = '\0';
+        USE_SERIAL.printf_P("\n\rPayload: built-in payload.h\n\n\r");
+    } else if ((word <= prompt_choices) && PayloadStorePath(word, payload_file, sizeof(payload_file))) {
+        USE_SERIAL.printf_P("\n\rPayload: %s\n\n\r", payload_file);
+    } else {
+        USE_SERIAL.printf_P("\n\rWarning: There is no payload %d, please correct it !!!\n\n\r", word);
+    }
+}
+
+// Function PrintPayloadFile
+void PrintPayloadFile(const uint8_t index, const char *name, const size_t size) {
+    char path[MAX_PAYLOAD_PATH];
+    snprintf(path, sizeof(path), "%s/%s", PAYLOAD_DIR, name);
+    USE_SERIAL.printf_P("  %d) %s (%d bytes)%s\n\r", index, path, (int)size, (strcmp(path, payload_file) == 0) ? " [selected]" : "");
+}
+
+// Function UploadSelected: 'w', the selected payload through the adaptive verified upload (see twi-clock.h),
+// serving the console from its write delays
+void UploadSelected(void) {
+    USE_SERIAL.printf_P("\n\rBootloader Cmd >>> Firmware upload to flash memory ('%c' progress, '%c' cancels) ...",
+                        JOB_STATUS_KEY, JOB_CANCEL_KEY);
+    // The GetStatus command below is to ensure that the remote device is properly initialized
+    // before running this case's command (e.g. when running after a firmware deletion)
+    // p_timonel->GetStatus();
+    FilePayload payload_file_image;
+    PageSource *source = OpenSelectedPayload(&payload_file_image);
+    VerifyReport verify;
+    uint8_t fallbacks = 0;
+    uint8_t cmd_errors = ERR_BAD_PAYLOAD;
+    if (source != nullptr) {
+        // The upload serves the console from its write delays: progress, '?' and 'q'
+        JobBegin(&USE_SERIAL, "upload", (source->GetImageSize() + SPM_PAGESIZE - 1) / SPM_PAGESIZE, true);
+        cmd_errors = UploadAdaptive(p_timonel, source, device_cache.GetStatus(p_timonel, false), &verify, &fallbacks);
+        JobEnd();
+    }
+    device_cache.InvalidateAppStart();
+    if ((fallbacks != 0) && verify.checkpointed) {
+        USE_SERIAL.printf_P(" bus errors, went on at %lu kHz ...", (unsigned long)(Wire.getClock() / 1000));
+    } else if (fallbacks != 0) {
+        USE_SERIAL.printf_P(" bus errors, erased and written again at %lu kHz ...", (unsigned long)(Wire.getClock() / 1000));
+    }
+    if (verify.resumed != 0) {
+        USE_SERIAL.printf_P(" resumed after %d confirmed pages ...", verify.resumed);
+    }
+    if ((cmd_errors == 0) && verify.readback) {
+        USE_SERIAL.printf_P(" successful at %lu kHz, %d pages verified (readback %lu ms, %lu ms after the upload), press 'r' to run the user app",
+                            (unsigned long)(Wire.getClock() / 1000), verify.pages_verified, (unsigned long)(verify.readback_us / 1000),
+                            (unsigned long)(verify.tail_us / 1000));
+    } else if (cmd_errors == 0) {
+        USE_SERIAL.printf_P(" successful, NOT verified (no READFLSH), press 'r' to run the user app");
+    } else if (cmd_errors == ERR_VERIFY) {
+        USE_SERIAL.printf_P(" [ verify error! page 0x%04X differs ]", verify.first_bad_page);
+    } else if (cmd_errors == ERR_NO_ROOM) {
+        USE_SERIAL.printf_P(" [ no room! the payload overlaps the bootloader, nothing written ]");
+    } else if (cmd_errors == ERR_CANCELLED) {
+        USE_SERIAL.printf_P(" [ cancelled ]");
+    } else {
+        USE_SERIAL.printf_P(" [ command error! %d ]", cmd_errors);
+    }
+    if ((cmd_errors != 0) && verify.checkpointed) {
+        USE_SERIAL.printf_P(", %d pages confirmed, 'w' goes on from there", verify.confirmed);
+    }
+    USE_SERIAL.printf_P("\n\n\r");
+}
+
+#if ((defined FEATURES_CODE) && ((FEATURES_CODE >> F_CMD_READFLASH) & true))
+// Function UploadChanged: 'd', rewrite only the pages that differ from the selected payload
+void UploadChanged(void) {
+    USE_SERIAL.printf_P("\n\rBootloader Cmd >>> Differential firmware upload, \x1b[5mPLEASE WAIT\x1b[0m ...");
+    DiffReport diff;
+    FilePayload payload_file_image;
+    PageSource *source = OpenSelectedPayload(&payload_file_image);
+    uint8_t cmd_errors = (source != nullptr) ? UploadDifferential(p_timonel, source, &diff) : ERR_BAD_PAYLOAD;
+    device_cache.InvalidateAppStart();
+    USE_SERIAL.printf_P("\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b");
+    if ((cmd_errors == 0) && diff.needs_erase) {
+        // Pages can't be patched in place without FORCE_ERASE_PG, start over: the erase runs as
+        // an 'e' does and the upload follows once the device is back (see StepErase)
+        USE_SERIAL.printf_P(" device pages can't be patched in place, erasing first ...");
+        StartErase(true);
+        return;
+    }
+    if (cmd_errors == ERR_NO_ROOM) {
+        USE_SERIAL.printf_P(" [ no room! the payload overlaps the bootloader, nothing written ]");
+    } else if (cmd_errors != 0) {
+        USE_SERIAL.printf_P(" [ command error! %d ]", cmd_errors);
+    } else if (diff.full_upload) {
+        USE_SERIAL.printf_P(" successful (no flash readback, full upload)");
+    } else if (diff.pages_written == 0) {
+        USE_SERIAL.printf_P(" flash already up to date, %d pages checked, nothing written", diff.pages);
+    } else {
+        USE_SERIAL.printf_P(" successful, %d of %d pages rewritten", diff.pages_written, diff.pages);
+    }
+    USE_SERIAL.printf_P("\n\n\r");
+}
+
+// Function DumpFlash: 'm', binary frames, run "flash-dump.py --port <console port> -o backup.hex" to get
+// a file or "flash-dump.py --port <console port> --hexdump" to see the old text dump
+void DumpFlash(void) {
+    USE_SERIAL.printf_P("\n\rBootloader Cmd >>> Binary flash dump, decode it with flash-dump.py ...\n\r");
+    DumpReport report;
+    uint8_t cmd_errors = StreamFlash(p_timonel, &USE_SERIAL, 0x0000, MCU_TOTAL_MEM, &report);
+    if (cmd_errors == 0) {
+        USE_SERIAL.printf_P("\n\r[ %d chunks, %lu bytes in %lu ms, CRC-16 %04X ]\n\n\r", report.chunks,
+                            (unsigned long)report.bytes_sent, (unsigned long)(report.total_us / 1000), report.crc);
+    } else {
+        USE_SERIAL.printf_P("\n\r[ command error! %d ]\n\n\r", cmd_errors);
+    }
+}
+#endif  // F_CMD_READFLASH
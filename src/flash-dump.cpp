@@ -0,0 +1,91 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: flash-dump.cpp (Application)
+  ............................................................................
+  Binary flash dump streamed over the serial console.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "flash-dump.h"
+
+#include "flash-sync.h"
+
+// Function Crc16: CRC-16/CCITT (poly 0x1021), start with 0xFFFF
+uint16_t Crc16(uint16_t crc, const uint8_t *data, const uint16_t size) {
+    for (uint16_t i = 0; i < size; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Function SendFrame: frame a payload and queue it on the console, returns the time blocked on it
+static uint32_t SendFrame(Print *out, const uint8_t type, const uint8_t *payload, const uint8_t size, DumpReport *report) {
+    uint8_t frame[DUMP_FRAME_MAX];
+    frame[0] = DUMP_SYNC_0;
+    frame[1] = DUMP_SYNC_1;
+    frame[2] = type;
+    frame[3] = size;
+    memcpy(&frame[4], payload, size);
+    uint16_t crc = Crc16(0xFFFF, &frame[2], size + 2);
+    frame[4 + size] = (crc & 0xFF);
+    frame[5 + size] = (crc >> 8);
+    unsigned long write_start = micros();
+    out->write(frame, size + 6);
+    report->bytes_sent += size + 6;
+    return micros() - write_start;
+}
+
+// Function StreamFlash: send a flash area as binary frames. With "overlap", chunk n+1 is read over
+// I2C while chunk n drains from the serial TX buffer; otherwise each frame is flushed before going on.
+uint8_t StreamFlash(Timonel *timonel, Print *out, const uint16_t flash_addr, const uint16_t size, DumpReport *report,
+                    const bool overlap) {
+    *report = DumpReport();
+    unsigned long dump_start = micros();
+    uint8_t chunks[2][DUMP_CHUNK + 2]; /* Address + data, read ahead into the other one */
+    const uint8_t header[] = {DUMP_VERSION, (uint8_t)(flash_addr & 0xFF), (uint8_t)(flash_addr >> 8),
+                              (uint8_t)(size & 0xFF), (uint8_t)(size >> 8), DUMP_CHUNK};
+    report->serial_wait_us += SendFrame(out, DUMP_HEADER, header, sizeof(header), report);
+    uint8_t twi_errors = 0;
+    uint8_t ix = 0;
+    uint16_t chunk_size = (size < DUMP_CHUNK) ? size : DUMP_CHUNK;
+    unsigned long read_start = micros();
+    if (size > 0) {
+        twi_errors = ReadFlash(timonel, flash_addr, &chunks[ix][2], chunk_size);
+    }
+    report->i2c_us += micros() - read_start;
+    for (uint16_t offset = 0; (offset < size) && (twi_errors == 0); offset += DUMP_CHUNK) {
+        uint16_t addr = flash_addr + offset;
+        chunks[ix][0] = (addr & 0xFF);
+        chunks[ix][1] = (addr >> 8);
+        report->crc = Crc16(report->crc, &chunks[ix][2], chunk_size);
+        report->serial_wait_us += SendFrame(out, DUMP_DATA, chunks[ix], chunk_size + 2, report);
+        report->chunks++;
+        if (!overlap) {
+            unsigned long flush_start = micros();
+            out->flush();
+            report->serial_wait_us += micros() - flush_start;
+        }
+        uint16_t next_offset = offset + DUMP_CHUNK;
+        if (next_offset < size) {
+            ix ^= 1;
+            chunk_size = ((size - next_offset) < DUMP_CHUNK) ? (size - next_offset) : DUMP_CHUNK;
+            read_start = micros();
+            twi_errors = ReadFlash(timonel, flash_addr + next_offset, &chunks[ix][2], chunk_size);
+            report->i2c_us += micros() - read_start;
+        }
+    }
+    const uint8_t end[] = {(uint8_t)(report->chunks & 0xFF), (uint8_t)(report->chunks >> 8), twi_errors,
+                           (uint8_t)(report->crc & 0xFF), (uint8_t)(report->crc >> 8)};
+    report->serial_wait_us += SendFrame(out, DUMP_END, end, sizeof(end), report);
+    unsigned long flush_start = micros();
+    out->flush();
+    report->serial_wait_us += micros() - flush_start;
+    report->total_us = micros() - dump_start;
+    return twi_errors;
+}
@@ -0,0 +1,485 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: flash-sync.cpp (Application)
+  ............................................................................
+  Flash readback and differential upload.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "flash-sync.h"
+
+#include <Wire.h>
+#include <limits.h>
+
+#include "console-job.h"
+#include "flash-dump.h"
+#include "packet-size.h"
+#include "perf-stats.h"
+#include "twi-clock.h"
+
+#define VERIFY_MIN_PACKET 8  // Smallest READFLSH packet read during a write delay (bytes)
+
+#ifdef VERIFY_OVERLAP
+#define VERIFY_HOOK VerifyStep  // Pages are read during the next page's packet and write delays
+#else
+#define VERIFY_HOOK nullptr  // Pages are read once their write delay is over, before the next one is sent
+#endif  // VERIFY_OVERLAP
+
+// Pages written and waiting to be read back, in write order
+struct PageChecks {
+    Timonel *timonel;
+    uint16_t addr[MAX_FLASH_PAGES];
+    uint16_t crc[MAX_FLASH_PAGES];  /* Expected CRC-16 of each page as Timonel stores it */
+    uint16_t count = 0;             /* Pages queued */
+    uint16_t committed = 0;         /* Pages whose write delay is over: they can be read */
+    uint16_t next = 0;              /* Page being read */
+    uint8_t offset = 0;             /* Next READFLSH packet within it */
+    uint16_t running_crc = 0xFFFF;
+    uint8_t twi_errors = 0;
+    VerifyReport *report;
+    UploadCheckpoint *checkpoint;   /* Confirmed pages go here, nullptr if not recorded */
+};
+
+// Whether an upload can go on from its checkpoint
+enum ResumeState {
+    RESUME_OK,       /* The confirmed pages are there, go on from them */
+    RESUME_RESTART,  /* They aren't, start from the first page */
+    RESUME_ERASE     /* A page the failed attempt left can't be written over without an erase */
+};
+
+// Function ReadFlash: read a flash memory block with READFLSH, in the packet size negotiated for the
+// device (see packet-size.h), checking every packet checksum. A packet that fails is read again up to
+// "retries" times.
+uint8_t ReadFlash(Timonel *timonel, const uint16_t flash_addr, uint8_t *data, const uint16_t data_size, const uint8_t retries) {
+    const uint8_t cmd_size = 5;
+    const uint8_t max_packet = GetRxPacket(timonel->GetTwiAddress());
+    uint8_t twi_cmd_arr[cmd_size] = {READFLSH, 0, 0, 0, 0};
+    uint8_t twi_reply_arr[PACKET_MAX + 2];
+    for (uint16_t offset = 0; offset < data_size; offset += max_packet) {
+        uint16_t addr = flash_addr + offset;
+        uint8_t packet_size = ((data_size - offset) < max_packet) ? (data_size - offset) : max_packet;
+        twi_cmd_arr[1] = ((addr & 0xFF00) >> 8);
+        twi_cmd_arr[2] = (addr & 0xFF);
+        twi_cmd_arr[3] = packet_size;
+        twi_cmd_arr[4] = (uint8_t)(twi_cmd_arr[1] + twi_cmd_arr[2] + twi_cmd_arr[3]);
+        uint8_t twi_errors = 0;
+        for (uint8_t attempt = 0; attempt <= retries; attempt++) {
+            PerfTimer timer(PERF_XMIT);
+            twi_errors = timonel->TwiCmdXmit(twi_cmd_arr, cmd_size, ACKRDFSH, twi_reply_arr, packet_size + 2);
+            uint8_t checksum = 0;
+            for (uint8_t i = 0; (twi_errors == 0) && (i < packet_size); i++) {
+                data[offset + i] = twi_reply_arr[i + 1];
+                checksum += twi_reply_arr[i + 1];
+            }
+            if ((twi_errors == 0) && (checksum != twi_reply_arr[packet_size + 1])) {
+                twi_errors = ERR_04;
+            }
+            timer.Stop(twi_errors, packet_size, attempt);
+            if (twi_errors == 0) {
+                break;
+            }
+        }
+        if (twi_errors != 0) {
+            return twi_errors;
+        }
+    }
+    return 0;
+}
+
+// Function TrampolineFor: the "application start" value Timonel reports once an
+// application with this reset vector (rjmp) is flashed at address 0
+uint16_t TrampolineFor(const uint8_t *reset_vector, const uint16_t bootloader_start) {
+    if ((reset_vector[0] == 0xFF) && (reset_vector[1] == 0xFF)) {
+        return 0xFFFF;
+    }
+    uint16_t app_target = ((((reset_vector[1] << 8) | reset_vector[0]) + 1) & 0xFFF);
+    uint16_t tpl_jump = ((app_target - (bootloader_start >> 1)) & 0xFFF);
+    return ((tpl_jump & 0xFF) << 8) | (0xC0 | (tpl_jump >> 8));
+}
+
+// Function ManifestAppStart: the "application start" Timonel reports once a manifest's image is flashed,
+// worked out at build time for the usual bootloader start
+uint16_t ManifestAppStart(const ImageManifest &manifest, const uint16_t bootloader_start) {
+    if (bootloader_start == TIMONEL_START) {
+        return manifest.application_start;
+    }
+    uint8_t reset_vector[2] = {(uint8_t)(manifest.reset_vector & 0xFF), (uint8_t)(manifest.reset_vector >> 8)};
+    return TrampolineFor(reset_vector, bootloader_start);
+}
+
+// Function PayloadFits: false if a manifest's image reaches the bootloader, or its trampoline page when
+// Timonel relocates the reset vector. True if the bootloader start is unknown.
+bool PayloadFits(const ImageManifest &manifest, const Timonel::Status &sts) {
+    if (sts.bootloader_start > MCU_TOTAL_MEM) {
+        return true;
+    }
+    uint16_t limit = sts.bootloader_start - (((sts.features_code >> F_APP_USE_TPL_PG) & true) ? SPM_PAGESIZE : 0);
+    return ((uint32_t)manifest.start + manifest.image_size) <= limit;
+}
+
+// Function UploadDifferential: rewrite only the payload pages that differ from the device flash
+uint8_t UploadDifferential(Timonel *timonel, PageSource *source, DiffReport *report) {
+    *report = DiffReport();
+    PerfTimer timer(PERF_STATUS);
+    Timonel::Status sts = timonel->GetStatus();
+    timer.Stop((sts.signature == T_SIGNATURE) ? 0 : ERR_02);
+    if ((source->GetManifest() != nullptr) && !PayloadFits(*source->GetManifest(), sts)) {
+        return ERR_NO_ROOM;
+    }
+    if ((((sts.features_code >> F_CMD_READFLASH) & true) == false) || (((sts.features_code >> F_CMD_SETPGADDR) & true) == false)) {
+        report->full_upload = true;
+        return UploadPages(timonel, source);
+    }
+    // Page 0 reset vector is relocated by Timonel, its copy lives in the trampoline
+    const bool relocates = ((sts.features_code >> F_APP_USE_TPL_PG) & true);
+    const bool force_erase = ((sts.ext_features_code >> E_FORCE_ERASE_PG) & true);
+    uint8_t dirty_map[(MAX_FLASH_PAGES + 7) / 8] = {0};
+    uint8_t device_page[SPM_PAGESIZE];
+    uint8_t target_page[SPM_PAGESIZE];
+    uint16_t block_addr = 0, block_size = 0;
+    uint8_t *block = nullptr;
+    source->Rewind();
+    while (source->NextBlock(&block_addr, &block, &block_size)) {
+        for (uint16_t offset = 0; offset < block_size; offset += SPM_PAGESIZE) {
+            uint16_t page_addr = block_addr + offset;
+            uint16_t page = page_addr / SPM_PAGESIZE;
+            uint16_t page_bytes = ((block_size - offset) < SPM_PAGESIZE) ? (block_size - offset) : SPM_PAGESIZE;
+            uint8_t twi_errors = ReadFlash(timonel, page_addr, device_page, SPM_PAGESIZE);
+            if (twi_errors != 0) {
+                return twi_errors;
+            }
+            report->pages++;
+            report->bytes_read += SPM_PAGESIZE;
+            memset(target_page, 0xFF, SPM_PAGESIZE);
+            memcpy(target_page, &block[offset], page_bytes);
+            bool same = true;
+            bool writable = true; /* Without an erase, SPM can only clear bits */
+            uint8_t first_byte = 0;
+            if (relocates && (page_addr == 0)) {
+                same = (sts.application_start == TrampolineFor(target_page, sts.bootloader_start));
+                first_byte = 2;
+            }
+            for (uint8_t i = first_byte; i < SPM_PAGESIZE; i++) {
+                if (device_page[i] != target_page[i]) {
+                    same = false;
+                    writable &= ((device_page[i] & target_page[i]) == target_page[i]);
+                }
+            }
+            if (!same) {
+                dirty_map[page >> 3] |= (1 << (page & 7));
+                if (!writable && !force_erase) {
+                    report->needs_erase = true;
+                }
+            }
+        }
+    }
+    if (report->needs_erase) {
+        return 0;
+    }
+    // Consecutive dirty pages of a block go in a single upload to save page address setups
+    source->Rewind();
+    while (source->NextBlock(&block_addr, &block, &block_size)) {
+        uint16_t offset = 0;
+        while (offset < block_size) {
+            uint16_t page = (block_addr + offset) / SPM_PAGESIZE;
+            if (((dirty_map[page >> 3] >> (page & 7)) & true) == false) {
+                offset += SPM_PAGESIZE;
+                continue;
+            }
+            uint16_t run_end = offset;
+            while ((run_end < block_size) && ((dirty_map[page >> 3] >> (page & 7)) & true)) {
+                run_end += SPM_PAGESIZE;
+                page++;
+            }
+            if (run_end > block_size) {
+                run_end = block_size;
+            }
+            uint8_t twi_errors = UploadAt(timonel, &block[offset], run_end - offset, block_addr + offset);
+            if (twi_errors != 0) {
+                return twi_errors;
+            }
+            report->pages_written += (run_end - offset + SPM_PAGESIZE - 1) / SPM_PAGESIZE;
+            offset = run_end;
+        }
+    }
+    return 0;
+}
+
+// Function ReadFitting: bytes of a READFLSH packet that fit in "budget_us" of bus time, at most "max_size".
+// The command takes 6 bytes on the bus (address included), the reply 3 more than its data, 9 bits each.
+static uint8_t ReadFitting(const unsigned long budget_us, const uint8_t max_size) {
+    uint32_t budget_bits = (uint32_t)(((uint64_t)budget_us * Wire.getClock()) / 1000000);
+    const uint32_t overhead_bits = (6 + 3) * 9 + 4; /* Plus start, restart and stop conditions */
+    if (budget_bits <= overhead_bits) {
+        return 0;
+    }
+    uint32_t fitting = (budget_bits - overhead_bits) / 9;
+    return (fitting < max_size) ? (uint8_t)(fitting & 0xFE) : max_size;
+}
+
+// Function VerifyStep: read a READFLSH packet of the oldest written page that fits in the time left
+// of the current write delay, compare the page once complete
+static void VerifyStep(void *page_checks, const unsigned long remaining_us) {
+    PageChecks *checks = (PageChecks *)page_checks;
+    CheckClock(); /* Too many errors so far: the rest goes slower */
+    if ((checks->next >= checks->committed) || (checks->twi_errors != 0)) {
+        return;
+    }
+    const uint8_t max_packet = GetRxPacket(checks->timonel->GetTwiAddress());
+    uint8_t page_left = ((SPM_PAGESIZE - checks->offset) < max_packet) ? (SPM_PAGESIZE - checks->offset) : max_packet;
+    uint8_t packet_size = ReadFitting(remaining_us, page_left);
+    if ((packet_size < page_left) && (packet_size < VERIFY_MIN_PACKET)) {
+        return; /* Not worth a packet, the next delay will do */
+    }
+    unsigned long read_start = micros();
+    uint8_t packet[PACKET_MAX];
+    uint16_t page_addr = checks->addr[checks->next];
+    checks->twi_errors = ReadFlash(checks->timonel, page_addr + checks->offset, packet, packet_size);
+    checks->report->readback_us += micros() - read_start;
+    if (checks->twi_errors != 0) {
+        return;
+    }
+    checks->running_crc = Crc16(checks->running_crc, packet, packet_size);
+    checks->offset += packet_size;
+    if (checks->offset >= SPM_PAGESIZE) {
+        if ((checks->running_crc != checks->crc[checks->next]) && (checks->report->first_bad_page == 0xFFFF)) {
+            checks->report->first_bad_page = page_addr;
+        } else if ((checks->checkpoint != nullptr) && (checks->report->first_bad_page == 0xFFFF)) {
+            UploadCheckpoint *checkpoint = checks->checkpoint;
+            checkpoint->confirmed = checks->report->resumed + checks->next + 1;
+            checks->report->confirmed = checkpoint->confirmed;
+            if ((checkpoint->confirmed % CHECKPOINT_EVERY) == 0) {
+                SaveCheckpoint(*checkpoint); /* UploadResumable saves the rest if the upload fails */
+            }
+        }
+        checks->report->pages_verified++;
+        checks->next++;
+        checks->offset = 0;
+        checks->running_crc = 0xFFFF;
+    }
+}
+
+// Function ExpectedCrc: CRC-16 of a payload page as the device stores it once written. Timonel points the
+// reset vector of page 0 to itself: "page" gets that jump and "reset_vector" the application's, which goes
+// to the trampoline.
+static uint16_t ExpectedCrc(uint8_t *page, const uint16_t page_addr, const ImageManifest *manifest, const Timonel::Status &sts,
+                            uint8_t *reset_vector) {
+    if (((sts.features_code >> F_APP_USE_TPL_PG) & true) && (page_addr == 0) && ((page[0] != 0xFF) || (page[1] != 0xFF))) {
+        uint16_t boot_jump = ((sts.bootloader_start >> 1) - 1) & 0xFFF;
+        reset_vector[0] = page[0];
+        reset_vector[1] = page[1];
+        page[0] = (uint8_t)(boot_jump & 0xFF);
+        page[1] = (uint8_t)(0xC0 | (boot_jump >> 8));
+        return Crc16(0xFFFF, page, SPM_PAGESIZE);
+    }
+    uint16_t manifest_ix = (manifest != nullptr) ? ((page_addr - manifest->start) / SPM_PAGESIZE) : 0xFFFF;
+    if ((manifest != nullptr) && (page_addr >= manifest->start) && (manifest_ix < manifest->pages)) {
+        return manifest->page_crc[manifest_ix];
+    }
+    return Crc16(0xFFFF, page, SPM_PAGESIZE);
+}
+
+// Function UploadVerified: upload every block of a payload source, reading each page back once it is
+// written (while the next one is, with VERIFY_OVERLAP). Returns ERR_VERIFY if a page differs (see report), the payload is only written
+// if the bootloader can't read its flash. With a checkpoint, the pages it confirmed are skipped and
+// the ones confirmed now are saved into it.
+uint8_t UploadVerified(Timonel *timonel, PageSource *source, const Timonel::Status &sts, VerifyReport *report,
+                       UploadCheckpoint *checkpoint) {
+    *report = VerifyReport();
+    const ImageManifest *manifest = source->GetManifest();
+    if ((manifest != nullptr) && !PayloadFits(*manifest, sts)) {
+        return ERR_NO_ROOM;
+    }
+    if (((sts.features_code >> F_CMD_READFLASH) & true) == false) {
+        return UploadPages(timonel, source);
+    }
+    report->readback = true;
+    WatchClock(timonel->GetTwiAddress());
+    uint8_t page[SPM_PAGESIZE];
+    static PageChecks checks; /* Kept off the task stack */
+    checks = PageChecks();
+    checks.timonel = timonel;
+    checks.report = report;
+    checks.checkpoint = checkpoint;
+    report->resumed = (checkpoint != nullptr) ? checkpoint->confirmed : 0;
+    report->confirmed = report->resumed;
+    report->checkpointed = (checkpoint != nullptr);
+    uint8_t reset_vector[2] = {0xFF, 0xFF};
+    uint16_t flash_addr = 0, size = 0, sent = 0, page_ix = 0;
+    uint16_t next_addr = 0xFFFF;
+    uint8_t *data = nullptr;
+    source->Rewind();
+    while (source->NextBlock(&flash_addr, &data, &size)) {
+        for (uint16_t offset = 0; offset < size; offset += SPM_PAGESIZE) {
+            uint16_t page_addr = flash_addr + offset;
+            uint16_t page_bytes = ((size - offset) < SPM_PAGESIZE) ? (size - offset) : SPM_PAGESIZE;
+            if (checks.count >= MAX_FLASH_PAGES) {
+                return ERR_BAD_PAYLOAD;
+            }
+            memset(page, 0xFF, SPM_PAGESIZE);
+            memcpy(page, &data[offset], page_bytes);
+            if (page_ix++ < report->resumed) {
+                // Confirmed by an earlier attempt and checked before resuming, only its reset vector is needed
+                ExpectedCrc(page, page_addr, manifest, sts, reset_vector);
+                sent += page_bytes;
+                continue;
+            }
+            if (JobCancelled()) {
+                return ERR_CANCELLED; /* The pages confirmed so far stay in the checkpoint */
+            }
+            checks.committed = checks.count; /* Every page sent so far is written: read them meanwhile */
+#ifndef VERIFY_OVERLAP
+            // The last page had its whole write delay: read it before the next one goes into the page buffer
+            while ((checks.next < checks.committed) && (checks.twi_errors == 0)) {
+                VerifyStep(&checks, ULONG_MAX);
+                JobService();
+            }
+            if (checks.twi_errors != 0) {
+                return checks.twi_errors;
+            }
+#endif  // VERIFY_OVERLAP
+            uint8_t twi_errors = 0;
+            if (page_addr == next_addr) {
+                twi_errors = WritePages(timonel, page, SPM_PAGESIZE, VERIFY_HOOK, &checks);
+            } else {
+                twi_errors = UploadAt(timonel, page, SPM_PAGESIZE, page_addr);
+            }
+            if ((twi_errors == 0) && (checks.twi_errors != 0)) {
+                twi_errors = checks.twi_errors;
+            }
+            if (twi_errors != 0) {
+                return twi_errors;
+            }
+            checks.addr[checks.count] = page_addr;
+            checks.crc[checks.count] = ExpectedCrc(page, page_addr, manifest, sts, reset_vector);
+            checks.count++;
+            sent += page_bytes;
+            next_addr = page_addr + SPM_PAGESIZE;
+            JobProgress(page_ix);
+        }
+    }
+    report->pages = checks.count;
+    if (report->resumed > page_ix) {
+        return ERR_BAD_PAYLOAD; /* The checkpoint has more pages than the payload */
+    }
+    if (!source->IsValid() || (sent != source->GetImageSize())) {
+        return ERR_BAD_PAYLOAD;
+    }
+    // The last page (and any the delays were too short for) is read once the upload is over
+    unsigned long tail_start = micros();
+    checks.committed = checks.count;
+    while ((checks.next < checks.count) && (checks.twi_errors == 0)) {
+        VerifyStep(&checks, ULONG_MAX);
+        JobService();
+    }
+    if (checks.twi_errors != 0) {
+        return checks.twi_errors;
+    }
+    if ((reset_vector[0] != 0xFF) || (reset_vector[1] != 0xFF)) {
+        PerfTimer timer(PERF_STATUS);
+        Timonel::Status now = timonel->GetStatus();
+        timer.Stop((now.signature == T_SIGNATURE) ? 0 : ERR_02);
+        uint16_t app_start = (manifest != nullptr) ? ManifestAppStart(*manifest, sts.bootloader_start) : TrampolineFor(reset_vector, sts.bootloader_start);
+        if ((now.application_start != app_start) && (report->first_bad_page == 0xFFFF)) {
+            report->first_bad_page = 0;
+        }
+    }
+    report->tail_us = micros() - tail_start;
+    return (report->first_bad_page == 0xFFFF) ? 0 : ERR_VERIFY;
+}
+
+// Function CheckResume: whether an upload can go on from a checkpoint. Every page it confirmed is read back
+// and compared with the payload, the device may have been swapped or flashed meanwhile. Without FORCE_ERASE_PG
+// the pages past them, up to the first one the failed attempt didn't reach, must be writable over again.
+static uint8_t CheckResume(Timonel *timonel, PageSource *source, const Timonel::Status &sts, const UploadCheckpoint &stored,
+                           ResumeState *state) {
+    *state = RESUME_RESTART;
+    if (stored.confirmed == 0) {
+        return 0;
+    }
+    const ImageManifest *manifest = source->GetManifest();
+    const bool force_erase = ((sts.ext_features_code >> E_FORCE_ERASE_PG) & true);
+    uint8_t page[SPM_PAGESIZE];
+    uint8_t device_page[SPM_PAGESIZE];
+    uint8_t reset_vector[2] = {0xFF, 0xFF};
+    uint16_t flash_addr = 0, size = 0, page_ix = 0;
+    uint8_t *data = nullptr;
+    source->Rewind();
+    while (source->NextBlock(&flash_addr, &data, &size)) {
+        for (uint16_t offset = 0; offset < size; offset += SPM_PAGESIZE) {
+            uint16_t page_addr = flash_addr + offset;
+            uint16_t page_bytes = ((size - offset) < SPM_PAGESIZE) ? (size - offset) : SPM_PAGESIZE;
+            if ((page_ix >= stored.confirmed) && force_erase) {
+                *state = RESUME_OK; /* Every page is erased before it is written again */
+                return 0;
+            }
+            memset(page, 0xFF, SPM_PAGESIZE);
+            memcpy(page, &data[offset], page_bytes);
+            uint8_t twi_errors = ReadFlash(timonel, page_addr, device_page, SPM_PAGESIZE);
+            if (twi_errors != 0) {
+                return twi_errors;
+            }
+            if (page_ix++ < stored.confirmed) {
+                if (Crc16(0xFFFF, device_page, SPM_PAGESIZE) != ExpectedCrc(page, page_addr, manifest, sts, reset_vector)) {
+                    return 0; /* Not the pages that were confirmed */
+                }
+                continue;
+            }
+            bool device_blank = true, payload_blank = true, writable = true;
+            for (uint8_t i = 0; i < SPM_PAGESIZE; i++) {
+                device_blank &= (device_page[i] == 0xFF);
+                payload_blank &= (page[i] == 0xFF);
+                writable &= ((device_page[i] & page[i]) == page[i]);
+            }
+            if (!writable) {
+                *state = RESUME_ERASE;
+                return 0;
+            }
+            if (device_blank && !payload_blank) {
+                *state = RESUME_OK; /* The failed attempt didn't get this far */
+                return 0;
+            }
+        }
+    }
+    *state = (page_ix >= stored.confirmed) ? RESUME_OK : RESUME_RESTART;
+    return 0;
+}
+
+// Function UploadResumable: verified upload that goes on from the pages an earlier attempt of this payload
+// confirmed on this device, if they are still there. The progress is kept until the payload is verified.
+// Returns ERR_NEEDS_ERASE, with nothing written, if a page the failed attempt left can't be written over.
+uint8_t UploadResumable(Timonel *timonel, PageSource *source, const Timonel::Status &sts, VerifyReport *report) {
+    if ((((sts.features_code >> F_CMD_READFLASH) & true) == false) || (((sts.features_code >> F_CMD_SETPGADDR) & true) == false)) {
+        return UploadVerified(timonel, source, sts, report); /* Can't check the pages or start past the first one */
+    }
+    UploadCheckpoint checkpoint, stored;
+    checkpoint.twi_addr = timonel->GetTwiAddress();
+    checkpoint.fingerprint = PayloadFingerprint(source);
+    if (LoadCheckpoint(checkpoint.twi_addr, checkpoint.fingerprint, &stored)) {
+        ResumeState state = RESUME_RESTART;
+        uint8_t twi_errors = CheckResume(timonel, source, sts, stored, &state);
+        if (twi_errors != 0) {
+            return twi_errors;
+        }
+        if (state == RESUME_OK) {
+            checkpoint = stored;
+        } else {
+            ClearCheckpoint(checkpoint.twi_addr); /* Erased, swapped or flashed with something else meanwhile */
+            if (state == RESUME_ERASE) {
+                *report = VerifyReport();
+                return ERR_NEEDS_ERASE;
+            }
+        }
+    }
+    uint16_t resumed = checkpoint.confirmed;
+    uint8_t twi_errors = UploadVerified(timonel, source, sts, report, &checkpoint);
+    if (twi_errors == 0) {
+        ClearCheckpoint(checkpoint.twi_addr);
+    } else if ((checkpoint.confirmed != resumed) && ((checkpoint.confirmed % CHECKPOINT_EVERY) != 0)) {
+        SaveCheckpoint(checkpoint); /* The pages confirmed since the last save */
+    }
+    return twi_errors;
+}
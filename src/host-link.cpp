@@ -0,0 +1,414 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: host-link.cpp (Application)
+  ............................................................................
+  Framed binary host protocol: COBS framing, request dispatch and the
+  pipelined page upload.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "host-link.h"
+
+#include "core-tasks.h"
+#include "eeprom-image.h"
+#include "flash-dump.h"
+#include "flash-sync.h"
+#include "in-place.h"
+#include "payload-stream.h"
+#include "perf-stats.h"
+#include "twi-clock.h"
+
+// Function CobsEncode: consistent overhead byte stuffing, the result has no zeros. Returns its size.
+uint8_t CobsEncode(const uint8_t *data, const uint8_t size, uint8_t *encoded) {
+    uint8_t code_ix = 0, out_ix = 1, code = 1;
+    for (uint8_t i = 0; i < size; i++) {
+        if (data[i] != 0) {
+            encoded[out_ix++] = data[i];
+            code++;
+        }
+        if ((data[i] == 0) || (code == 0xFF)) {
+            encoded[code_ix] = code;
+            code_ix = out_ix++;
+            code = 1;
+        }
+    }
+    encoded[code_ix] = code;
+    return out_ix;
+}
+
+// Function CobsDecode: undo CobsEncode, returns the data size or 0 if the frame is malformed
+uint8_t CobsDecode(const uint8_t *encoded, const uint8_t size, uint8_t *data) {
+    uint8_t in_ix = 0, out_ix = 0;
+    while (in_ix < size) {
+        uint8_t code = encoded[in_ix++];
+        if ((code == 0) || ((in_ix + code - 1) > size)) {
+            return 0;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            if (encoded[in_ix] == 0) {
+                return 0;
+            }
+            data[out_ix++] = encoded[in_ix++];
+        }
+        if ((code != 0xFF) && (in_ix < size)) {
+            data[out_ix++] = 0;
+        }
+    }
+    return out_ix;
+}
+
+// Class constructor
+HostLink::HostLink(Stream *port, HostTarget *target) : port_(port), target_(target) {}
+
+// Class HostLink: Answer requests until QUIT or HOST_IDLE_MS without any
+void HostLink::Serve(void) {
+    unsigned long last_frame = millis();
+    quit_ = false;
+    while (!quit_ && ((millis() - last_frame) < HOST_IDLE_MS)) {
+        Poll();
+        if (slot_count_ == 0) {
+#ifdef DUAL_CORE
+            TaskPause(); /* Keys and output move through the console task */
+#else
+            delayMicroseconds(HOST_POLL_US);
+#endif  // DUAL_CORE
+            continue;
+        }
+        Slot *slot = &slots_[slot_head_];
+        Dispatch(slot->body, slot->size);
+        slot_head_ = (slot_head_ + 1) % HOST_SLOTS;
+        slot_count_--;
+        last_frame = millis();
+    }
+}
+
+// Class HostLink: WaitHook for the page write delays, decodes the next requests meanwhile
+void HostLink::OnWait(void *host_link, const unsigned long remaining_us) {
+    ((HostLink *)host_link)->Poll();
+}
+
+// Class HostLink: Decode serial input into free slots. With all slots taken, the bytes stay in the UART buffer.
+void HostLink::Poll(void) {
+    while ((slot_count_ < HOST_SLOTS) && (port_->available() > 0)) {
+        uint8_t data = port_->read();
+        if (data != HOST_DELIMITER) {
+            if (raw_size_ < HOST_ENCODED_MAX) {
+                raw_[raw_size_++] = data;
+            } else {
+                raw_overflow_ = true;
+            }
+            continue;
+        }
+        if ((raw_size_ == 0) && !raw_overflow_) {
+            continue; /* Leading delimiter */
+        }
+        Slot *slot = &slots_[(slot_head_ + slot_count_) % HOST_SLOTS];
+        slot->size = raw_overflow_ ? 0 : CobsDecode(raw_, raw_size_, slot->body);
+        raw_size_ = 0;
+        raw_overflow_ = false;
+        slot_count_++;
+        stats_.frames_rx++;
+        if (writing_) {
+            stats_.overlapped++;
+        }
+    }
+}
+
+// Class HostLink: Check a request frame and answer it
+void HostLink::Dispatch(const uint8_t *body, const uint8_t size) {
+    const uint8_t id = (size > 2) ? body[2] : 0;
+    if ((size < 5) || (Crc16(0xFFFF, body, size - 2) != (body[size - 2] | (body[size - 1] << 8)))) {
+        stats_.bad_frames++;
+        Reply(HOST_NAK, id, HOST_BAD_FRAME, nullptr, 0);
+        return;
+    }
+    const uint8_t opcode = body[1];
+    if (body[0] != HOST_VERSION) {
+        Reply(opcode, id, HOST_BAD_VERSION, nullptr, 0);
+        return;
+    }
+    if ((last_reply_size_ != 0) && (opcode == last_opcode_) && (id == last_id_)) {
+        stats_.repeats++;
+        port_->write(last_reply_, last_reply_size_);
+        stats_.frames_tx++;
+        return;
+    }
+    uint8_t data[HOST_DATA_MAX + 2];
+    uint8_t data_size = 0;
+    uint8_t status = Run(opcode, &body[3], size - 5, data, &data_size);
+    Reply(opcode, id, status, data, data_size);
+}
+
+// Function PutLe32: store "value" little-endian, returns the bytes used
+static uint8_t PutLe32(uint8_t *data, const uint32_t value) {
+    for (uint8_t i = 0; i < 4; i++) {
+        data[i] = (uint8_t)(value >> (i * 8));
+    }
+    return 4;
+}
+
+// Function PerfFrame: reply data of a 'P' request, returns its size (at most HOST_DATA_MAX + 2)
+static uint8_t PerfFrame(const PerfOp op, const uint8_t part, uint8_t *data) {
+    static_assert((2 + (PERF_BUCKETS * 4)) <= (HOST_DATA_MAX + 2), "The histogram must fit a reply");
+    const PerfCounter &counter = PerfGet(op);
+    uint8_t size = 0;
+    data[size++] = op;
+    data[size++] = PERF_OPS;
+    if (part == 1) {
+        for (uint8_t bucket = 0; bucket < PERF_BUCKETS; bucket++) {
+            size += PutLe32(&data[size], counter.histogram[bucket].load(std::memory_order_relaxed));
+        }
+        return size;
+    }
+    uint64_t total_us = counter.total_us.load(std::memory_order_relaxed);
+    uint32_t min_us = counter.min_us.load(std::memory_order_relaxed);
+    data[size++] = PERF_BUCKETS;
+    data[size++] = PERF_BUCKET_SHIFT;
+    size += PutLe32(&data[size], counter.calls.load(std::memory_order_relaxed));
+    size += PutLe32(&data[size], counter.errors.load(std::memory_order_relaxed));
+    size += PutLe32(&data[size], counter.retries.load(std::memory_order_relaxed));
+    size += PutLe32(&data[size], counter.bytes.load(std::memory_order_relaxed));
+    size += PutLe32(&data[size], (uint32_t)total_us);
+    size += PutLe32(&data[size], (uint32_t)(total_us >> 32));
+    size += PutLe32(&data[size], (min_us != 0) ? (min_us - 1) : 0); /* Stored + 1 */
+    size += PutLe32(&data[size], counter.max_us.load(std::memory_order_relaxed));
+    return size;
+}
+
+// Class HostLink: Run a request, returns its status and fills the reply data
+uint8_t HostLink::Run(const uint8_t opcode, const uint8_t *args, const uint8_t args_size, uint8_t *data, uint8_t *data_size) {
+    Timonel *timonel = *target_->timonel;
+    const bool app_mode = *target_->app_mode;
+    const uint16_t addr = (args_size >= 2) ? (args[0] | (args[1] << 8)) : 0;
+    const uint16_t size = (args_size >= 4) ? (args[2] | (args[3] << 8)) : 0;
+    Timonel::Status sts;
+    if (!app_mode && (opcode != HOST_QUIT)) {
+        sts = target_->cache->GetStatus(timonel, false);
+    }
+    if (app_mode && (opcode != HOST_HELLO) && (opcode != HOST_PERF) && (opcode != HOST_QUIT)) {
+        return HOST_BAD_MODE;
+    }
+    switch (opcode) {
+        case HOST_HELLO: {
+            const uint8_t hello[] = {HOST_VERSION, app_mode, timonel->GetTwiAddress(), HOST_SLOTS, SPM_PAGESIZE, HOST_DATA_MAX,
+                                     (uint8_t)(MCU_TOTAL_MEM & 0xFF), (uint8_t)(MCU_TOTAL_MEM >> 8), sts.features_code,
+                                     sts.ext_features_code, (uint8_t)(sts.bootloader_start & 0xFF),
+                                     (uint8_t)(sts.bootloader_start >> 8), sts.version_major, sts.version_minor};
+            memcpy(data, hello, sizeof(hello));
+            *data_size = sizeof(hello);
+            return 0;
+        }
+        case HOST_ERASE: {
+            PerfTimer timer(PERF_DELETE);
+            uint8_t cmd_errors = timer.Stop(timonel->DeleteApplication());
+            target_->cache->InvalidateAppStart();
+            upload_ = false;
+            uint8_t twi_errors = ReconnectTarget(target_, MODE_BOOTLOADER);
+            return (cmd_errors != 0) ? cmd_errors : twi_errors;
+        }
+        case HOST_BEGIN: {
+            if ((args_size != 4) || (size == 0) || (((uint32_t)addr + size) > sts.bootloader_start) || ((addr % SPM_PAGESIZE) != 0)) {
+                return HOST_BAD_ARGS;
+            }
+            upload_ = true;
+            upload_start_ = upload_next_ = addr;
+            upload_end_ = addr + size;
+            contiguous_addr_ = 0xFFFF;
+            upload_crc_ = 0xFFFF;
+            return 0;
+        }
+        case HOST_PAGE: {
+            uint8_t page_size = args_size - 2;
+            if ((args_size < 3) || (page_size > SPM_PAGESIZE) || ((addr % SPM_PAGESIZE) != 0)) {
+                return HOST_BAD_ARGS;
+            }
+            data[0] = args[0];
+            data[1] = args[1];
+            *data_size = 2;
+            if (upload_ && (addr >= upload_start_) && ((addr + page_size) <= upload_next_)) {
+                stats_.repeats++; /* Written already, the host missed the reply */
+                return 0;
+            }
+            if (!upload_ || (addr != upload_next_) || ((addr + page_size) > upload_end_)) {
+                return HOST_SEQUENCE;
+            }
+            uint8_t twi_errors = WritePage(addr, &args[2], page_size);
+            if (twi_errors != 0) {
+                upload_ = false;
+                return twi_errors;
+            }
+            upload_crc_ = Crc16(upload_crc_, &args[2], page_size);
+            upload_next_ += page_size;
+            return 0;
+        }
+        case HOST_FINISH: {
+            target_->cache->InvalidateAppStart();
+            data[0] = (upload_crc_ & 0xFF);
+            data[1] = (upload_crc_ >> 8);
+            *data_size = 2;
+            bool complete = upload_ && (args_size == 2) && (upload_next_ == upload_end_) && (addr == upload_crc_);
+            upload_ = false;
+            return complete ? 0 : HOST_BAD_IMAGE;
+        }
+        case HOST_VERIFY: {
+            if (((sts.features_code >> F_CMD_READFLASH) & true) == false) {
+                return HOST_UNSUPPORTED;
+            }
+            if ((args_size != 8) || (((uint32_t)addr + size) > sts.bootloader_start)) {
+                return HOST_BAD_ARGS;
+            }
+            uint16_t crc = 0xFFFF;
+            uint8_t twi_errors = Verify(addr, size, &args[6], &crc);
+            data[0] = (crc & 0xFF);
+            data[1] = (crc >> 8);
+            *data_size = 2;
+            if (twi_errors != 0) {
+                return twi_errors;
+            }
+            return (crc == (args[4] | (args[5] << 8))) ? 0 : HOST_MISMATCH;
+        }
+        case HOST_READ:
+        case HOST_EE_READ: {
+            const uint8_t read_size = (args_size == 3) ? args[2] : 0;
+            const uint32_t limit = (opcode == HOST_READ) ? MCU_TOTAL_MEM : EEPROM_IMAGE_MAX;
+            if ((read_size == 0) || (read_size > HOST_DATA_MAX) || (((uint32_t)addr + read_size) > limit)) {
+                return HOST_BAD_ARGS;
+            }
+            data[0] = args[0];
+            data[1] = args[1];
+            *data_size = read_size + 2;
+            if (opcode == HOST_READ) {
+                if (((sts.features_code >> F_CMD_READFLASH) & true) == false) {
+                    return HOST_UNSUPPORTED;
+                }
+                return ReadFlash(timonel, addr, &data[2], read_size);
+            }
+            if (((sts.ext_features_code >> E_EEPROM_ACCESS) & true) == false) {
+                return HOST_UNSUPPORTED;
+            }
+            EepromTransfer eeprom(timonel, sts);
+            return eeprom.Read(addr, &data[2], read_size);
+        }
+        case HOST_EE_WRITE: {
+            const uint8_t write_size = args_size - 2;
+            if ((args_size < 3) || (((uint32_t)addr + write_size) > EEPROM_IMAGE_MAX)) {
+                return HOST_BAD_ARGS;
+            }
+            if (((sts.ext_features_code >> E_EEPROM_ACCESS) & true) == false) {
+                return HOST_UNSUPPORTED;
+            }
+            EepromTransfer eeprom(timonel, sts);
+            EepromReport report;
+            uint8_t cmd_errors = eeprom.Program(addr, &args[2], write_size, &report);
+            data[0] = (uint8_t)report.bytes_written;
+            *data_size = 1;
+            return cmd_errors;
+        }
+        case HOST_RUN: {
+            uint8_t cmd_errors = timonel->RunApplication();
+            upload_ = false;
+            uint8_t twi_errors = ReconnectTarget(target_, MODE_APPLICATION);
+            data[0] = (*target_->timonel)->GetTwiAddress();
+            data[1] = *target_->app_mode;
+            *data_size = 2;
+            return (cmd_errors != 0) ? cmd_errors : twi_errors;
+        }
+        case HOST_PERF: {
+            if ((args_size != 2) || (args[0] >= PERF_OPS) || (args[1] > 1)) {
+                return HOST_BAD_ARGS;
+            }
+            *data_size = PerfFrame((PerfOp)args[0], args[1], data);
+            return 0;
+        }
+        case HOST_QUIT: {
+            quit_ = true;
+            return 0;
+        }
+        default: {
+            return HOST_UNKNOWN;
+        }
+    }
+}
+
+// Class HostLink: Write one upload page. Pages following the previous one go straight on, the device keeps
+// incrementing its page address; meanwhile the next request frames are decoded from the serial port.
+uint8_t HostLink::WritePage(const uint16_t addr, const uint8_t *data, const uint8_t size) {
+    uint8_t twi_errors = 0;
+    writing_ = true;
+    if (addr == contiguous_addr_) {
+        twi_errors = WritePages(*target_->timonel, data, size, OnWait, this);
+    } else {
+        uint8_t page[SPM_PAGESIZE];
+        memcpy(page, data, size);
+        twi_errors = UploadAt(*target_->timonel, page, size, addr);
+    }
+    writing_ = false;
+    stats_.pages++;
+    contiguous_addr_ = (size == SPM_PAGESIZE) ? (addr + size) : 0xFFFF;
+    return twi_errors;
+}
+
+// Class HostLink: CRC-16 of a flash area as the host sent it: Timonel keeps the application reset vector
+// in its trampoline, so page 0 counts the host's vector if the trampoline matches it.
+uint8_t HostLink::Verify(const uint16_t addr, const uint16_t size, const uint8_t *reset_vector, uint16_t *crc) {
+    Timonel *timonel = *target_->timonel;
+    const Timonel::Status sts = target_->cache->GetStatus(timonel);
+    const bool relocates = ((sts.features_code >> F_APP_USE_TPL_PG) & true);
+    uint8_t chunk[DUMP_CHUNK];
+    *crc = 0xFFFF;
+    for (uint16_t offset = 0; offset < size; offset += DUMP_CHUNK) {
+        uint16_t chunk_size = ((size - offset) < DUMP_CHUNK) ? (size - offset) : DUMP_CHUNK;
+        uint8_t twi_errors = ReadFlash(timonel, addr + offset, chunk, chunk_size);
+        if (twi_errors != 0) {
+            return twi_errors;
+        }
+        if (relocates && ((addr + offset) == 0) && (chunk_size >= 2) &&
+            (sts.application_start == TrampolineFor(reset_vector, sts.bootloader_start))) {
+            chunk[0] = reset_vector[0];
+            chunk[1] = reset_vector[1];
+        }
+        *crc = Crc16(*crc, chunk, chunk_size);
+    }
+    return 0;
+}
+
+// Class HostLink: Frame a reply and keep it in case the request comes again
+void HostLink::Reply(const uint8_t opcode, const uint8_t id, const uint8_t status, const uint8_t *data, const uint8_t size) {
+    uint8_t body[HOST_FRAME_MAX];
+    body[0] = HOST_VERSION;
+    body[1] = opcode | HOST_REPLY;
+    body[2] = id;
+    body[3] = status;
+    if (size > 0) {
+        memcpy(&body[4], data, size);
+    }
+    uint16_t crc = Crc16(0xFFFF, body, size + 4);
+    body[size + 4] = (crc & 0xFF);
+    body[size + 5] = (crc >> 8);
+    last_reply_[0] = HOST_DELIMITER;
+    last_reply_size_ = CobsEncode(body, size + 6, &last_reply_[1]) + 1;
+    last_reply_[last_reply_size_++] = HOST_DELIMITER;
+    port_->write(last_reply_, last_reply_size_);
+    stats_.frames_tx++;
+    last_opcode_ = opcode;
+    last_id_ = id;
+    if (opcode == HOST_NAK) {
+        last_reply_size_ = 0; /* Never repeated */
+    }
+}
+
+// Function ReconnectTarget: find the device again after a mode switch, quietly (the console may carry frames)
+uint8_t ReconnectTarget(HostTarget *target, const DeviceMode expect) {
+    SwitchReport report;
+    SetBaseClock();
+    uint8_t slave_address = FindDevice(BusScanner(target->sda, target->scl), expect, &report);
+    SetDeviceClock(slave_address);
+    *target->app_mode = report.app_mode;
+    *target->timonel = Rebuild(*target->timonel, slave_address, target->sda, target->scl);
+    target->cache->Invalidate();
+    bool expected = (expect == MODE_ANY) || (report.app_mode == (expect == MODE_APPLICATION));
+    return expected ? 0 : HOST_BAD_MODE;
+}
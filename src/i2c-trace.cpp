@@ -0,0 +1,194 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: i2c-trace.cpp (Source)
+  ............................................................................
+  I2C transaction trace: HAL wrappers, ring and Chrome JSON export (see
+  i2c-trace.h).
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#ifdef I2C_TRACE
+
+#include "i2c-trace.h"
+
+#include <esp32-hal-i2c.h>
+#include <nb-twi-cmd.h>
+
+#include <atomic>
+
+#include "timonel-ext-cmd.h"
+
+// NB command and reply codes, transfers are named after their first byte
+static const struct {
+    uint8_t code;
+    const char *name;
+} trace_codes[] = {
+    {RESETMCU, "RESETMCU"}, {ACKRESET, "ACKRESET"}, {INITSOFT, "INITSOFT"}, {AKINITS, "AKINITS"},   {GETTMNLV, "GETTMNLV"},
+    {AKTMNLV, "AKTMNLV"},   {DELFLASH, "DELFLASH"}, {AKDLFLSH, "AKDLFLSH"}, {STPGADDR, "STPGADDR"}, {AKPGADDR, "AKPGADDR"},
+    {WRITPAGE, "WRITPAGE"}, {AKWTPAGE, "AKWTPAGE"}, {EXITTMNL, "EXITTMNL"}, {AKEXITTM, "AKEXITTM"}, {READFLSH, "READFLSH"},
+    {ACKRDFSH, "ACKRDFSH"}, {READDEVS, "READDEVS"}, {AKRDEVS, "AKRDEVS"},   {READEEPR, "READEEPR"}, {ACKRDEEP, "ACKRDEEP"},
+    {WRITEEPR, "WRITEEPR"}, {ACKWTEEP, "ACKWTEEP"},
+#ifdef EEPROM_BLOCKS_EXPERIMENTAL
+    {READEEBK, "READEEBK"}, {ACKRDEBK, "ACKRDEBK"}, {WRITEEBK, "WRITEEBK"}, {ACKWTEBK, "ACKWTEBK"},
+#endif  // EEPROM_BLOCKS_EXPERIMENTAL
+    {SETIO1_1, "SETIO1_1"}, {ACKIO1_1, "ACKIO1_1"}, {SETIO1_0, "SETIO1_0"}, {ACKIO1_0, "ACKIO1_0"}, {UNKNOWNC, "UNKNOWNC"}};
+
+static TraceEvent trace_ring[TRACE_EVENTS];
+static std::atomic<uint32_t> trace_head(0); /* Events recorded since the last clear */
+
+// Function TraceRecord: take the next slot of the ring, overwriting the oldest event
+static void TraceRecord(const TraceEvent &event) {
+    uint32_t slot = trace_head.fetch_add(1, std::memory_order_relaxed) % TRACE_EVENTS;
+    trace_ring[slot] = event;
+}
+
+// Function TraceTransfer: one HAL call that started at "start_us" and returned "err"
+static void TraceTransfer(const TraceKind kind, const uint8_t i2c_num, const uint16_t address, const uint8_t *data,
+                          const size_t size, const size_t count, const unsigned long start_us, const esp_err_t err) {
+    TraceEvent event;
+    event.start_us = start_us;
+    event.duration_us = micros() - start_us;
+    event.kind = kind;
+    event.bus = i2c_num;
+    event.address = (uint8_t)address;
+    event.result = (err == ESP_OK) ? 0 : ((err == ESP_FAIL) ? 1 : 2);
+    event.length = (uint16_t)size;
+    uint32_t frequency = 0;
+    i2cGetClock(i2c_num, &frequency);
+    event.khz = (uint16_t)(frequency / 1000);
+    size_t kept = (count < TRACE_DATA) ? count : TRACE_DATA;
+    memcpy(event.data, data, kept);
+    memset(&event.data[kept], 0, TRACE_DATA - kept);
+    TraceRecord(event);
+}
+
+extern "C" {
+esp_err_t __real_i2cWrite(uint8_t i2c_num, uint16_t address, const uint8_t *buff, size_t size, uint32_t timeOutMillis);
+esp_err_t __real_i2cRead(uint8_t i2c_num, uint16_t address, uint8_t *buff, size_t size, uint32_t timeOutMillis, size_t *readCount);
+
+// Function __wrap_i2cWrite: every TwoWire::endTransmission comes through here (-Wl,--wrap=i2cWrite)
+esp_err_t __wrap_i2cWrite(uint8_t i2c_num, uint16_t address, const uint8_t *buff, size_t size, uint32_t timeOutMillis) {
+    unsigned long start_us = micros();
+    esp_err_t err = __real_i2cWrite(i2c_num, address, buff, size, timeOutMillis);
+    TraceTransfer(TRACE_WRITE, i2c_num, address, buff, size, size, start_us, err);
+    return err;
+}
+
+// Function __wrap_i2cRead: every TwoWire::requestFrom comes through here (-Wl,--wrap=i2cRead)
+esp_err_t __wrap_i2cRead(uint8_t i2c_num, uint16_t address, uint8_t *buff, size_t size, uint32_t timeOutMillis, size_t *readCount) {
+    unsigned long start_us = micros();
+    esp_err_t err = __real_i2cRead(i2c_num, address, buff, size, timeOutMillis, readCount);
+    TraceTransfer(TRACE_READ, i2c_num, address, buff, size, (err == ESP_OK) ? *readCount : 0, start_us, err);
+    return err;
+}
+}
+
+// Function TraceSpan: an operation timed by the performance counters (see PerfRecord)
+void TraceSpan(const PerfOp op, const uint32_t start_us, const uint32_t duration_us, const bool failed) {
+    TraceEvent event;
+    memset(&event, 0, sizeof(event));
+    event.start_us = start_us;
+    event.duration_us = duration_us;
+    event.kind = TRACE_SPAN;
+    event.address = (uint8_t)op;
+    event.result = failed ? 1 : 0;
+    TraceRecord(event);
+}
+
+// Function TraceCount: events held, up to TRACE_EVENTS
+uint32_t TraceCount(void) {
+    uint32_t head = trace_head.load(std::memory_order_relaxed);
+    return (head < TRACE_EVENTS) ? head : TRACE_EVENTS;
+}
+
+// Function TraceLost: events overwritten since the last clear
+uint32_t TraceLost(void) {
+    return trace_head.load(std::memory_order_relaxed) - TraceCount();
+}
+
+// Function TraceGet: the "index"-th event held, the oldest first
+bool TraceGet(const uint32_t index, TraceEvent *event) {
+    uint32_t count = TraceCount();
+    if (index >= count) {
+        return false;
+    }
+    uint32_t oldest = trace_head.load(std::memory_order_relaxed) - count;
+    *event = trace_ring[(oldest + index) % TRACE_EVENTS];
+    return true;
+}
+
+// Function TraceClear: start the ring over
+void TraceClear(void) {
+    trace_head.store(0, std::memory_order_relaxed);
+}
+
+// Function TraceName: an event's name, "scratch" (5 bytes) holds the unknown codes
+const char *TraceName(const TraceEvent &event, char *scratch) {
+    if (event.kind == TRACE_SPAN) {
+        return PerfName((PerfOp)event.address);
+    }
+    if ((event.kind == TRACE_WRITE) && (event.length == 0)) {
+        return "probe";
+    }
+    if ((event.kind == TRACE_READ) && (event.result != 0)) {
+        return "read";
+    }
+    for (uint8_t ix = 0; ix < (sizeof(trace_codes) / sizeof(trace_codes[0])); ix++) {
+        if (trace_codes[ix].code == event.data[0]) {
+            return trace_codes[ix].name;
+        }
+    }
+    snprintf(scratch, 5, "0x%02X", event.data[0]);
+    return scratch;
+}
+
+// Function TraceExport: the trace in the Chrome trace event format, times from the earliest event, then start over
+void TraceExport(Print *out) {
+    uint32_t count = TraceCount();
+    TraceEvent event;
+    uint32_t origin_us = 0;
+    for (uint32_t ix = 0; TraceGet(ix, &event); ix++) {
+        origin_us = ((ix == 0) || ((int32_t)(event.start_us - origin_us) < 0)) ? event.start_us : origin_us;
+    }
+    out->printf_P("{\"displayTimeUnit\":\"ms\",\"otherData\":{\"events\":%lu,\"lost\":%lu},\"traceEvents\":[\n",
+                  (unsigned long)count, (unsigned long)TraceLost());
+    out->printf_P("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"operations\"}}");
+    for (uint8_t bus = 0; bus < 2; bus++) {
+        out->printf_P(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"I2C bus %d\"}}", bus + 1, bus);
+    }
+    uint32_t bus_free_us[2] = {0, 0}; /* End of the last transfer on each bus */
+    bool bus_seen[2] = {false, false};
+    char scratch[5];
+    for (uint32_t ix = 0; TraceGet(ix, &event); ix++) {
+        uint32_t ts_us = event.start_us - origin_us;
+        const char *name = TraceName(event, scratch);
+        if (event.kind == TRACE_SPAN) {
+            out->printf_P(",\n{\"name\":\"%s\",\"cat\":\"op\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%lu,\"pid\":1,\"tid\":0,\"args\":{\"result\":%d}}",
+                          name, (unsigned long)ts_us, (unsigned long)event.duration_us, event.result);
+            continue;
+        }
+        uint8_t bus = event.bus & 1;
+        if (bus_seen[bus] && ((int32_t)(ts_us - bus_free_us[bus]) > TRACE_IDLE_US)) {
+            out->printf_P(",\n{\"name\":\"idle\",\"cat\":\"idle\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%lu,\"pid\":1,\"tid\":%d}",
+                          (unsigned long)bus_free_us[bus], (unsigned long)(ts_us - bus_free_us[bus]), bus + 1);
+        }
+        bus_seen[bus] = true;
+        bus_free_us[bus] = ts_us + event.duration_us;
+        out->printf_P(",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%lu,\"pid\":1,\"tid\":%d,\"args\":{\"addr\":%d,"
+                      "\"len\":%d,\"khz\":%d,\"result\":%d,\"data\":\"",
+                      name, (event.kind == TRACE_WRITE) ? "write" : "read", (unsigned long)ts_us, (unsigned long)event.duration_us,
+                      bus + 1, event.address, event.length, event.khz, event.result);
+        uint16_t kept = ((event.kind == TRACE_READ) && (event.result != 0)) ? 0 : ((event.length < TRACE_DATA) ? event.length : TRACE_DATA);
+        for (uint16_t byte_ix = 0; byte_ix < kept; byte_ix++) {
+            out->printf_P("%02x", event.data[byte_ix]);
+        }
+        out->printf_P("\"}}");
+    }
+    out->printf_P("\n]}\n");
+    TraceClear();
+}
+
+#endif  // I2C_TRACE
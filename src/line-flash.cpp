@@ -0,0 +1,304 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: line-flash.cpp (Application)
+  ............................................................................
+  Production line mode: selection in NVS, pass/fail log and statistics.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "line-flash.h"
+
+#include <Preferences.h>
+
+#include "flash-sync.h"
+#include "perf-stats.h"
+#include "selective-erase.h"
+#include "timonel-mss-esp32.h"
+#include "twi-clock.h"
+#include "upload-checkpoint.h"
+
+static const char *const stage_names[LINE_STAGES] = {"detect", "erase", "upload", "verify", "run", "check"};
+
+// Function LineStore: the NVS namespace, opened on first use and kept open
+static Preferences *LineStore(void) {
+    static Preferences store;
+    static bool opened = false;
+    if (!opened) {
+        opened = store.begin(LINE_NAMESPACE, false);
+    }
+    return opened ? &store : nullptr;
+}
+
+// Function LoadLineSelection: the line mode selection, false if there is none
+bool LoadLineSelection(LineSelection *selection) {
+    Preferences *store = LineStore();
+    LineSelection stored;
+    if ((store == nullptr) || (store->getBytes("select", &stored, sizeof(stored)) != sizeof(stored)) ||
+        (stored.version != LINE_VERSION)) {
+        return false;
+    }
+    stored.payload[MAX_PAYLOAD_PATH - 1] = '\0';
+    *selection = stored;
+    return true;
+}
+
+// Function SaveLineSelection: commit the line mode selection, it takes effect on the next restart
+bool SaveLineSelection(const LineSelection &selection) {
+    Preferences *store = LineStore();
+    return (store != nullptr) && (store->putBytes("select", &selection, sizeof(selection)) == sizeof(selection));
+}
+
+// Function LineStageName
+const char *LineStageName(const LineStage stage) {
+    return (stage < LINE_STAGES) ? stage_names[stage] : "-";
+}
+
+// Class LineLog: Start logging to "log"
+void LineLog::Begin(Stream *log) {
+    *this = LineLog();
+    log_ = log;
+}
+
+// Class LineLog: One board done, its log line (and the summary every LINE_SUMMARY_UNITS boards)
+void LineLog::Record(const LineUnit &unit) {
+    first_ms_ = (GetUnits() == 0) ? unit.start_ms : first_ms_;
+    last_ms_ = unit.start_ms + (unit.total_us / 1000);
+    if (unit.error == 0) {
+        passed_++;
+        for (uint8_t stage = 0; stage < LINE_STAGES; stage++) {
+            stage_us_[stage] += unit.stage_us[stage];
+        }
+        total_us_ += unit.total_us;
+        log_->printf_P("#%04lu PASS TWI %02d, %d pages%s |", (unsigned long)unit.number, unit.address, unit.pages,
+                       unit.erased ? ", erased" : "");
+    } else {
+        failed_++;
+        log_->printf_P("#%04lu FAIL TWI %02d, %s error %d", (unsigned long)unit.number, unit.address, LineStageName(unit.failed), unit.error);
+        if (unit.bad_page != 0xFFFF) {
+            log_->printf_P(" at page 0x%04X", unit.bad_page);
+        }
+        log_->printf_P(" |");
+    }
+    for (uint8_t stage = 0; stage < LINE_STAGES; stage++) {
+        log_->printf_P(" %s %lu.%lu", stage_names[stage], (unsigned long)(unit.stage_us[stage] / 1000),
+                       (unsigned long)((unit.stage_us[stage] % 1000) / 100));
+    }
+    log_->printf_P(" | %lu ms\n\r", (unsigned long)(unit.total_us / 1000));
+    if ((GetUnits() % LINE_SUMMARY_UNITS) == 0) {
+        PrintSummary();
+    }
+}
+
+// Class LineLog: Boards per hour over the line time, from the first board found to the last one done (swaps included)
+uint32_t LineLog::GetUnitsPerHour(void) const {
+    unsigned long line_ms = last_ms_ - first_ms_;
+    return (line_ms != 0) ? (uint32_t)(((uint64_t)GetUnits() * 3600000UL) / line_ms) : 0;
+}
+
+// Class LineLog: Boards per hour if the next board were always ready, from the average pipeline time of the good ones
+uint32_t LineLog::GetFlashPerHour(void) const {
+    return (total_us_ != 0) ? (uint32_t)(((uint64_t)passed_ * 3600000000ULL) / total_us_) : 0;
+}
+
+// Class LineLog: Boards, pass rate, throughput and average stage times
+void LineLog::PrintSummary(void) {
+    log_->printf_P("== %lu boards, %lu PASS, %lu FAIL | %lu units/h on the line, %lu flashing only | avg ms:",
+                   (unsigned long)GetUnits(), (unsigned long)passed_, (unsigned long)failed_, (unsigned long)GetUnitsPerHour(),
+                   (unsigned long)GetFlashPerHour());
+    for (uint8_t stage = 0; stage < LINE_STAGES; stage++) {
+        uint32_t avg_us = GetStageAvgUs((LineStage)stage);
+        log_->printf_P(" %s %lu.%lu", stage_names[stage], (unsigned long)(avg_us / 1000), (unsigned long)((avg_us % 1000) / 100));
+    }
+    log_->printf_P("\n\r");
+}
+
+// Function LineSetup: start the production line mode, no console rendering from here on
+void LineSetup(const LineSelection &selection) {
+    line_mode = true;
+    strncpy(payload_file, selection.payload, sizeof(payload_file) - 1);
+    flash_page_addr = selection.flash_page_addr;
+    line_log.Begin(&USE_SERIAL);
+    USE_SERIAL.printf_P("\n\rTimonel line flash v%d.%d.%d, payload %s at 0x%04X ('%c' summary", VER_MAJOR, VER_MINOR, VER_PATCH,
+                        (payload_file[0] == '\0') ? "payload.h" : payload_file, flash_page_addr, LINE_SUMMARY_KEY);
+#ifndef LINE_FLASH
+    USE_SERIAL.printf_P(", '%c' back to the console", LINE_EXIT_KEY);
+#endif  // LINE_FLASH
+    USE_SERIAL.printf_P(")\n\r");
+    if ((payload_file[0] != '\0') && !PayloadStoreBegin()) {
+        USE_SERIAL.printf_P("Payload store (LittleFS) not mounted, every board will fail\n\r");
+    }
+    USE_SERIAL.printf_P("Waiting for boards ...\n\r");
+}
+
+// Function StepLine: one engine pass in line mode. An empty fixture is scanned every LINE_SCAN_MS and a board
+// found is flashed right away; a finished one is probed every LINE_POLL_MS until it is taken out.
+// Returns false if there was nothing to do.
+bool StepLine(void) {
+    bool served = false;
+    ReadChar();
+    if (new_key) {
+        new_key = false;
+        served = true;
+        if (key == LINE_SUMMARY_KEY) {
+            line_log.PrintSummary();
+        }
+#ifndef LINE_FLASH
+        if (key == LINE_EXIT_KEY) {
+            LineSelection selection;
+            LoadLineSelection(&selection);
+            selection.enabled = false;
+            SaveLineSelection(selection);
+            line_log.PrintSummary();
+            USE_SERIAL.printf_P("Line mode off, restarting the master ...\n\r");
+            delay(MODE_SWITCH_DLY);
+            ESP.restart();
+        }
+#endif  // LINE_FLASH
+    }
+    if ((long)(millis() - line_fixture.next_ms) < 0) {
+        return served;
+    }
+    if (line_fixture.socket == SOCKET_DONE) {
+        line_fixture.next_ms = millis() + LINE_POLL_MS;
+        line_fixture.misses = ProbeAddress(line_fixture.address) ? 0 : (line_fixture.misses + 1);
+        if (line_fixture.misses >= LINE_GONE_POLLS) {
+            line_fixture.socket = SOCKET_EMPTY; /* Taken out, scan for the next one now */
+            line_fixture.next_ms = millis();
+        }
+        return served;
+    }
+    bool app_mode = false;
+    SetBaseClock(); /* Every device answers a scan at the base rate */
+    uint8_t slave_address = BusScanner(SDA, SCL)->ScanBus(&app_mode);
+    line_fixture.next_ms = millis() + LINE_SCAN_MS;
+    if (slave_address == 0) {
+        return served;
+    }
+    LineUnit unit;
+    unit.number = ++line_fixture.units;
+    FlashLineUnit(&unit);
+    line_log.Record(unit);
+    line_fixture.socket = SOCKET_DONE;
+    line_fixture.address = p_timonel->GetTwiAddress();
+    line_fixture.misses = 0;
+    line_fixture.next_ms = millis() + LINE_POLL_MS;
+    return true;
+}
+
+// Function FlashLineUnit: take the board in the fixture through the pipeline, until a stage fails
+void FlashLineUnit(LineUnit *unit) {
+    unit->start_ms = millis();
+    unsigned long unit_start = micros();
+    unsigned long stage_start = unit_start;
+    LineStage stage = LINE_DETECT;
+    uint8_t cmd_errors = 0;
+    // Detect: a board still running an application (an older firmware) is reset to the bootloader
+    uint8_t slave_address = DiscoverDevice(p_app_mode, SDA, SCL, MODE_ANY, nullptr, true);
+    p_timonel = timonel_slot.Build(slave_address, SDA, SCL);
+    device_cache.Invalidate();
+    if (*p_app_mode) {
+        PerfTimer timer(PERF_XMIT);
+        cmd_errors = timer.Stop(p_timonel->TwiCmdXmit(RESETMCU, ACKRESET));
+        slave_address = DiscoverDevice(p_app_mode, SDA, SCL, MODE_BOOTLOADER, nullptr, true);
+        p_timonel = timonel_slot.Build(slave_address, SDA, SCL);
+        device_cache.Invalidate();
+    }
+    unit->address = slave_address;
+    ClearCheckpoint(slave_address); /* A new board, nothing on it was confirmed */
+    unit->EndStage(stage, &stage_start);
+    // Erase, only if the board holds an application: Timonel doesn't erase a page before writing it.
+    // A bootloader that does (FORCE_ERASE_PG) gets the pages the application occupies erased only, when
+    // that beats DELFLASH.
+    if (cmd_errors == 0) {
+        stage = LINE_ERASE;
+        Timonel::Status sts = device_cache.GetStatus(p_timonel);
+        if ((sts.application_start != 0xFFFF) && CanEraseSelective(sts, SelectedManifest())) {
+            EraseReport report;
+            cmd_errors = EraseOccupied(p_timonel, sts, SelectedManifest(), &report);
+            unit->erased = (cmd_errors != ERR_NO_SELECTIVE);
+            if (unit->erased) {
+                device_cache.InvalidateAppStart();
+                PerfRecord(PERF_DELETE, report.erase_us, (cmd_errors != 0), (uint32_t)report.pages * SPM_PAGESIZE, 0);
+            } else {
+                cmd_errors = 0; /* DELFLASH is faster for this board */
+            }
+        }
+        if ((sts.application_start != 0xFFFF) && !unit->erased) {
+            unit->erased = true;
+            SwitchReport report;
+            PerfTimer timer(PERF_XMIT);
+            cmd_errors = timer.Stop(p_timonel->TwiCmdXmit(DELFLASH, AKDLFLSH));
+            device_cache.InvalidateAppStart();
+            if (cmd_errors == 0) {
+                slave_address = DiscoverDevice(p_app_mode, SDA, SCL, MODE_BOOTLOADER, &report, true);
+                p_timonel = timonel_slot.Build(slave_address, SDA, SCL);
+                device_cache.Invalidate();
+            }
+            PerfRecord(PERF_DELETE, micros() - stage_start, (cmd_errors != 0), 0, report.polls);
+        }
+        unit->EndStage(stage, &stage_start);
+    }
+    // Upload and verify: the readback overlaps the upload, only its tail is a stage of its own
+    if (cmd_errors == 0) {
+        stage = LINE_UPLOAD;
+        FilePayload payload_file_image;
+        PageSource *source = OpenSelectedPayload(&payload_file_image);
+        VerifyReport verify;
+        uint8_t fallbacks = 0;
+        cmd_errors = ERR_BAD_PAYLOAD;
+        if (source != nullptr) {
+            cmd_errors = UploadAdaptive(p_timonel, source, device_cache.GetStatus(p_timonel, false), &verify, &fallbacks);
+        }
+        device_cache.InvalidateAppStart();
+        if ((cmd_errors == 0) && !verify.readback) {
+            cmd_errors = ERR_VERIFY; /* No READFLSH: a board can't pass unchecked */
+        }
+        unit->pages = verify.pages_verified;
+        unit->bad_page = verify.first_bad_page;
+        unit->EndStage(stage, &stage_start);
+        unit->stage_us[LINE_VERIFY] = verify.tail_us;
+        unit->stage_us[LINE_UPLOAD] -= (verify.tail_us < unit->stage_us[LINE_UPLOAD]) ? verify.tail_us : unit->stage_us[LINE_UPLOAD];
+        stage = (cmd_errors == ERR_VERIFY) ? LINE_VERIFY : stage;
+    }
+    // Run: the application must answer at its own address
+    if (cmd_errors == 0) {
+        stage = LINE_RUN;
+        cmd_errors = p_timonel->RunApplication();
+        if (cmd_errors == 0) {
+            slave_address = DiscoverDevice(p_app_mode, SDA, SCL, MODE_APPLICATION, nullptr, true);
+            p_timonel = timonel_slot.Build(slave_address, SDA, SCL);
+            device_cache.Invalidate();
+            cmd_errors = (*p_app_mode) ? 0 : ERR_NO_APP;
+        }
+        unit->EndStage(stage, &stage_start);
+    }
+    // Check: the application takes a command, its LED blinks on a good board
+    if (cmd_errors == 0) {
+        stage = LINE_CHECK;
+        PerfTimer timer(PERF_XMIT);
+        cmd_errors = timer.Stop(p_timonel->TwiCmdXmit(SETIO1_1, ACKIO1_1));
+        unit->EndStage(stage, &stage_start);
+    }
+    unit->error = cmd_errors;
+    unit->failed = (cmd_errors != 0) ? stage : LINE_STAGES;
+    unit->total_us = micros() - unit_start;
+}
+
+// Function SelectLineMode: record the production line mode and the payload picked in NVS, and restart into it
+void SelectLineMode(void) {
+    LineSelection selection;
+    selection.enabled = true;
+    selection.flash_page_addr = flash_page_addr;
+    strncpy(selection.payload, payload_file, sizeof(selection.payload) - 1);
+    if (!SaveLineSelection(selection)) {
+        USE_SERIAL.printf_P("\n\rProduction line mode >>> [ can't save the selection in NVS ]\n\n\r");
+        return;
+    }
+    USE_SERIAL.printf_P("\n\rProduction line mode >>> every board put in gets %s, restarting the master ...\n\r",
+                        (payload_file[0] == '\0') ? "payload.h" : payload_file);
+    delay(MODE_SWITCH_DLY);
+    ESP.restart();
+}
@@ -0,0 +1,455 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: multi-flash.cpp (Source)
+  ............................................................................
+  Multi-slave flashing over both I2C controllers (see multi-flash.h).
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "multi-flash.h"
+
+#include "broadcast-upload.h"
+#include "core-tasks.h"
+#include "perf-stats.h"
+#include "timonel-mss-esp32.h"
+#include "twi-clock.h"
+
+// Class TwiPort: Start the controller on its pins
+void TwiPort::Begin(void) {
+    wire_->begin(sda_, scl_);
+}
+
+// Class TwiPort: True if something acknowledges the address
+bool TwiPort::Probe(const uint8_t twi_addr) {
+    wire_->beginTransmission(twi_addr);
+    return wire_->endTransmission() == 0;
+}
+
+// Class TwiPort: Send a command and check its reply, like NbMicro::TwiCmdXmit on this controller
+uint8_t TwiPort::Command(const uint8_t twi_addr, const uint8_t *cmd, const uint8_t cmd_size, const uint8_t reply_code,
+                         uint8_t *reply, const uint8_t reply_size) {
+    uint8_t reply_byte = 0;
+    uint8_t *reply_arr = (reply_size == 0) ? &reply_byte : reply;
+    uint8_t reply_length = (reply_size == 0) ? 1 : reply_size;
+    wire_->beginTransmission(twi_addr);
+    wire_->write(cmd, cmd_size);
+    if (wire_->endTransmission() != 0) {
+        return ERR_01;
+    }
+    if (wire_->requestFrom(twi_addr, reply_length) != reply_length) {
+        return ERR_01;
+    }
+    for (uint8_t i = 0; i < reply_length; i++) {
+        reply_arr[i] = wire_->read();
+    }
+    return (reply_arr[0] == reply_code) ? 0 : ERR_02;
+}
+
+// Class TwiPort: Ask a bootloader for its version and status (GETTMNLV)
+uint8_t TwiPort::QueryStatus(const uint8_t twi_addr, Timonel::Status *status) {
+    const uint8_t cmd[] = {GETTMNLV};
+    uint8_t reply[12] = {0};
+    uint8_t twi_errors = Command(twi_addr, cmd, sizeof(cmd), AKTMNLV, reply, sizeof(reply));
+    if ((twi_errors == 0) && (reply[1] != T_SIGNATURE)) {
+        twi_errors = ERR_02;
+    }
+    if (twi_errors != 0) {
+        return twi_errors;
+    }
+    status->signature = reply[1];
+    status->version_major = reply[2];
+    status->version_minor = reply[3];
+    status->features_code = reply[4];
+    status->ext_features_code = reply[5];
+    status->bootloader_start = (reply[6] << 8) | reply[7];
+    status->application_start = (reply[8] << 8) | reply[9];
+    status->low_fuse_setting = reply[10];
+    status->oscillator_cal = reply[11];
+    if ((status->features_code >> F_TWO_STEP_INIT) & true) {
+        const uint8_t init[] = {INITSOFT};
+        twi_errors = Command(twi_addr, init, sizeof(init), AKINITS);
+    }
+    return twi_errors;
+}
+
+// Class MultiFlash: Constructor, bus 0 is the controller the NB libraries use (Wire)
+MultiFlash::MultiFlash(const uint8_t sda_0, const uint8_t scl_0, const uint8_t sda_1, const uint8_t scl_1) {
+    ports_[0] = TwiPort(&Wire, sda_0, scl_0);
+    ports_[1] = TwiPort(&Wire1, sda_1, scl_1);
+    for (uint8_t bus = 0; bus < MULTI_BUSES; bus++) {
+        workers_[bus].owner = this;
+        workers_[bus].bus = bus;
+    }
+}
+
+// Class MultiFlash: Find the bootloaders on both buses, returns how many. Applications are only counted.
+uint8_t MultiFlash::Enumerate(void) {
+    app_devices_ = 0;
+    for (uint8_t bus = 0; bus < MULTI_BUSES; bus++) {
+        ports_[bus].Begin();
+        count_[bus] = 0;
+        for (uint8_t twi_addr = LOW_TWI_ADDR; twi_addr <= HIG_TWI_ADDR; twi_addr++) {
+            if (!ports_[bus].Probe(twi_addr)) {
+                continue;
+            }
+            Timonel::Status status;
+            if (twi_addr >= APP_TWI_ADDR) {
+                app_devices_++;
+                continue;
+            }
+            PerfTimer timer(PERF_STATUS);
+            if ((count_[bus] < MULTI_DEVICES) && (timer.Stop(ports_[bus].QueryStatus(twi_addr, &status)) == 0)) {
+                SlaveFlash *device = &devices_[bus][count_[bus]++];
+                device->bus = bus;
+                device->address = twi_addr;
+                device->status = status;
+            }
+        }
+    }
+    return GetCount();
+}
+
+// Class MultiFlash: Flash "image" on every device found, one worker per bus. Returns at once.
+bool MultiFlash::Start(const uint8_t *image, const uint16_t image_size, const uint16_t start_addr, const bool run) {
+    image_ = image;
+    image_size_ = image_size;
+    start_addr_ = start_addr;
+    run_ = run;
+    bool started = true;
+    for (uint8_t bus = 0; bus < MULTI_BUSES; bus++) {
+        for (uint8_t ix = 0; ix < count_[bus]; ix++) {
+            SlaveFlash *device = &devices_[bus][ix];
+            device->step.store(STEP_FOUND);
+            device->pages_done.store(0);
+            device->error = 0;
+            device->elapsed_ms = 0;
+            device->polls = 0;
+        }
+        workers_[bus].running.store(count_[bus] > 0);
+        workers_[bus].start_us = workers_[bus].finish_us = 0;
+        if (count_[bus] > 0) {
+            // One worker per core: bus 0 next to the engine, bus 1 next to the console
+            const char *name = (bus == 0) ? "flash-bus0" : "flash-bus1";
+            started &= StartTask(Worker, name, MULTI_WORKER_STACK, &workers_[bus], ENGINE_PRIORITY, (bus == 0) ? ENGINE_CORE : CONSOLE_CORE);
+        }
+    }
+    return started;
+}
+
+// Class MultiFlash: True once every bus worker has finished
+bool MultiFlash::IsDone(void) const {
+    for (uint8_t bus = 0; bus < MULTI_BUSES; bus++) {
+        if (workers_[bus].running.load()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Class MultiFlash: Time from the first worker start to the last worker end
+uint32_t MultiFlash::GetElapsedMs(void) const {
+    unsigned long first = 0, last = 0;
+    bool any = false;
+    for (uint8_t bus = 0; bus < MULTI_BUSES; bus++) {
+        if (count_[bus] == 0) {
+            continue;
+        }
+        if (!any || ((long)(workers_[bus].start_us - first) < 0)) {
+            first = workers_[bus].start_us;
+        }
+        if (!any || ((long)(workers_[bus].finish_us - last) > 0)) {
+            last = workers_[bus].finish_us;
+        }
+        any = true;
+    }
+    return (last - first) / 1000;
+}
+
+// Function MultiFlash::Worker: bus worker task entry
+void MultiFlash::Worker(void *bus_worker) {
+    BusWorker *worker = (BusWorker *)bus_worker;
+    worker->owner->RunBus(worker);
+#ifdef ARDUINO_ARCH_ESP32
+    vTaskDelete(nullptr);
+#endif  // ARDUINO_ARCH_ESP32
+}
+
+// Class MultiFlash: Serve the devices of one bus, always the one that can be addressed soonest
+void MultiFlash::RunBus(BusWorker *worker) {
+    SlaveFlash *devices = devices_[worker->bus];
+    TwiPort *port = &ports_[worker->bus];
+    worker->start_us = micros();
+    for (uint8_t ix = 0; ix < count_[worker->bus]; ix++) {
+        devices[ix].start_us = devices[ix].ready_at_us = worker->start_us;
+    }
+    for (;;) {
+        SlaveFlash *next = nullptr;
+        for (uint8_t ix = 0; ix < count_[worker->bus]; ix++) {
+            uint8_t step = devices[ix].step.load(std::memory_order_relaxed);
+            if ((step != STEP_DONE) && (step != STEP_FAILED) &&
+                ((next == nullptr) || ((long)(devices[ix].ready_at_us - next->ready_at_us) < 0))) {
+                next = &devices[ix];
+            }
+        }
+        if (next == nullptr) {
+            break;
+        }
+        long wait_us = (long)(next->ready_at_us - micros());
+        if (wait_us >= 1000) {
+            delay(wait_us / 1000); /* Lets the other tasks of this core run */
+            wait_us = (long)(next->ready_at_us - micros());
+        }
+        if (wait_us > 0) {
+            delayMicroseconds(wait_us);
+        }
+        Step(port, next);
+    }
+    worker->finish_us = micros();
+    worker->running.store(false);
+}
+
+// Class MultiFlash: Move one device on by one command, then set when it can be addressed again
+bool MultiFlash::Step(TwiPort *port, SlaveFlash *device) {
+    const uint8_t twi_addr = device->address;
+    const uint16_t padded_size = GetPages() * SPM_PAGESIZE;
+    uint8_t twi_errors = 0;
+    switch (device->step.load(std::memory_order_relaxed)) {
+        case STEP_FOUND: {
+            uint16_t app_limit = device->status.bootloader_start;
+            if ((device->status.features_code >> F_APP_USE_TPL_PG) & true) {
+                app_limit -= SPM_PAGESIZE; /* The trampoline page is reserved */
+            }
+            if (((uint32_t)start_addr_ + image_size_) > app_limit) {
+                Fail(device, ERR_APP_OVF);
+                return false;
+            }
+            const uint8_t cmd[] = {DELFLASH};
+            PerfTimer timer(PERF_DELETE);
+            twi_errors = timer.Stop(port->Command(twi_addr, cmd, sizeof(cmd), AKDLFLSH));
+            if (twi_errors != 0) {
+                Fail(device, twi_errors);
+                return false;
+            }
+            device->ready_at_us = micros() + (DLY_DEL_APP * 1000UL);
+            device->deadline_us = device->ready_at_us + (MULTI_REAPPEAR_MS * 1000UL);
+            device->step.store(STEP_ERASING);
+            return true;
+        }
+        case STEP_ERASING: {
+            // Deleting the application resets the device: poll until it answers again
+            PerfTimer status_timer(PERF_STATUS);
+            if (port->QueryStatus(twi_addr, &device->status) != 0) {
+                if ((long)(micros() - device->deadline_us) > 0) {
+                    status_timer.Stop(ERR_01, 0, device->polls);
+                    Fail(device, ERR_01);
+                    return false;
+                }
+                device->polls++;
+                device->ready_at_us = micros() + (MULTI_POLL_MS * 1000UL);
+                return true;
+            }
+            status_timer.Stop(0, 0, device->polls);
+            device->offset = 0;
+            device->ready_at_us = micros();
+            if ((device->status.features_code >> F_CMD_SETPGADDR) & true) {
+                uint8_t cmd[] = {STPGADDR, (uint8_t)((start_addr_ & 0xFF00) >> 8), (uint8_t)(start_addr_ & 0xFF), 0};
+                uint8_t reply[2] = {0};
+                cmd[3] = (uint8_t)(cmd[1] + cmd[2]);
+                PerfTimer timer(PERF_XMIT);
+                twi_errors = timer.Stop(port->Command(twi_addr, cmd, sizeof(cmd), AKPGADDR, reply, sizeof(reply)));
+                if ((twi_errors == 0) && (reply[1] != cmd[3])) {
+                    twi_errors = ERR_04;
+                }
+                if (twi_errors != 0) {
+                    Fail(device, twi_errors);
+                    return false;
+                }
+                device->ready_at_us += (DLY_SET_ADDR * 1000UL);
+            }
+            device->step.store(STEP_WRITING);
+            return true;
+        }
+        case STEP_WRITING: {
+            if (device->offset >= padded_size) {
+                // The last page has been written
+                if (run_) {
+                    const uint8_t cmd[] = {EXITTMNL};
+                    PerfTimer timer(PERF_XMIT);
+                    twi_errors = timer.Stop(port->Command(twi_addr, cmd, sizeof(cmd), AKEXITTM));
+                    if (twi_errors != 0) {
+                        Fail(device, twi_errors);
+                        return false;
+                    }
+                }
+                device->elapsed_ms = (micros() - device->start_us) / 1000;
+                device->step.store(STEP_DONE);
+                return true;
+            }
+            uint8_t cmd[MST_PACKET_SIZE + 2] = {WRITPAGE};
+            uint8_t reply[2] = {0};
+            uint8_t checksum = 0;
+            for (uint8_t i = 0; i < MST_PACKET_SIZE; i++) {
+                uint16_t ix = device->offset + i;
+                cmd[i + 1] = (ix < image_size_) ? image_[ix] : 0xFF;
+                checksum += cmd[i + 1];
+            }
+            cmd[MST_PACKET_SIZE + 1] = checksum;
+            PerfTimer timer(PERF_XMIT);
+            twi_errors = timer.Stop(port->Command(twi_addr, cmd, sizeof(cmd), AKWTPAGE, reply, sizeof(reply)), MST_PACKET_SIZE);
+            if ((twi_errors == 0) && (reply[1] != checksum)) {
+                twi_errors = ERR_04;
+            }
+            if (twi_errors != 0) {
+                Fail(device, twi_errors);
+                return false;
+            }
+            device->offset += MST_PACKET_SIZE;
+            device->ready_at_us = micros() + (DLY_PKT_SEND * 1000UL);
+            if ((device->offset % SPM_PAGESIZE) == 0) {
+                device->ready_at_us += (DLY_FLASH_PG * 1000UL);
+                device->pages_done.fetch_add(1);
+            }
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+// Class MultiFlash: Stop flashing a device, keeping the first error
+void MultiFlash::Fail(SlaveFlash *device, const uint8_t error) {
+    device->error = error;
+    device->elapsed_ms = (micros() - device->start_us) / 1000;
+    device->step.store(STEP_FAILED);
+}
+
+// Function LoadImage: lay a payload out in "image" by flash address, holes filled with 0xFF.
+// Returns the size from the first page used (its address in "start_addr"), 0 if the payload is broken or too big.
+uint16_t LoadImage(PageSource *source, uint8_t *image, const uint16_t image_max, uint16_t *start_addr) {
+    uint16_t flash_addr = 0, size = 0;
+    uint16_t first = 0xFFFF, end = 0;
+    uint8_t *data = nullptr;
+    memset(image, 0xFF, image_max);
+    source->Rewind();
+    while (source->NextBlock(&flash_addr, &data, &size)) {
+        if (((uint32_t)flash_addr + size) > image_max) {
+            return 0;
+        }
+        memcpy(&image[flash_addr], data, size);
+        first = (flash_addr < first) ? flash_addr : first;
+        end = ((flash_addr + size) > end) ? (flash_addr + size) : end;
+    }
+    if (!source->IsValid() || (end == 0)) {
+        return 0;
+    }
+    *start_addr = first - (first % SPM_PAGESIZE);
+    return end - *start_addr;
+}
+
+// Function FlashAllDevices: flash the selected payload on every bootloader of both I2C buses at once
+void FlashAllDevices(void) {
+    static uint8_t image[MCU_TOTAL_MEM];                   /* The payload laid out by flash address */
+    static MultiFlash multi_flash(SDA, SCL, SDA_1, SCL_1);  /* Device table and bus workers */
+    FilePayload payload_file_image;
+    PageSource *source = OpenSelectedPayload(&payload_file_image);
+    uint16_t start_addr = 0;
+    uint16_t image_size = (source != nullptr) ? LoadImage(source, image, sizeof(image), &start_addr) : 0;
+    if (image_size == 0) {
+        USE_SERIAL.printf_P("\n\rMulti-slave >>> [ command error! %d ]\n\n\r", ERR_BAD_PAYLOAD);
+        return;
+    }
+    USE_SERIAL.printf_P("\n\rMulti-slave >>> Scanning both I2C buses ...");
+    SetBaseClock(); /* The other devices may not keep up with the console device's rate */
+    uint8_t count = multi_flash.Enumerate();
+    USE_SERIAL.printf_P(" %d bootloader(s), %d application(s) left alone\n\r", count, multi_flash.GetAppDevices());
+    if (count == 0) {
+        USE_SERIAL.printf_P("\n\r");
+        return;
+    }
+    for (uint8_t ix = 0; ix < count; ix++) {
+        SlaveFlash &device = multi_flash.GetDevice(ix);
+        USE_SERIAL.printf_P("  Bus %d, TWI %02d: Timonel v%d.%d, bootloader at 0x%X\n\r", device.bus, device.address,
+                            device.status.version_major, device.status.version_minor, device.status.bootloader_start);
+    }
+    uint16_t pages = (image_size + SPM_PAGESIZE - 1) / SPM_PAGESIZE;
+    USE_SERIAL.printf_P("\n\rMulti-slave >>> Flashing %d bytes (%d pages) at 0x%04X, \x1b[5mPLEASE WAIT\x1b[0m ...\n\r", image_size, pages, start_addr);
+    if (!multi_flash.Start(&image[start_addr], image_size, start_addr, false)) {
+        USE_SERIAL.printf_P("\n\rMulti-slave >>> can't start the bus workers\n\n\r");
+        return;
+    }
+    // Progress: one line per device step or 10% of its pages
+    uint8_t shown[MULTI_BUSES * MULTI_DEVICES];
+    memset(shown, 0xFF, sizeof(shown));
+    bool done = false;
+    while (!done) {
+        done = multi_flash.IsDone(); /* Read before the devices, so the last changes are shown */
+        for (uint8_t ix = 0; ix < count; ix++) {
+            SlaveFlash &device = multi_flash.GetDevice(ix);
+            uint8_t step = device.step.load();
+            uint8_t decile = (device.pages_done.load() * 10) / pages;
+            uint8_t state = (step << 4) | decile;
+            if (state == shown[ix]) {
+                continue;
+            }
+            shown[ix] = state;
+            if (step == STEP_ERASING) {
+                USE_SERIAL.printf_P("  Bus %d, TWI %02d: erasing\n\r", device.bus, device.address);
+            } else if (step == STEP_WRITING) {
+                USE_SERIAL.printf_P("  Bus %d, TWI %02d: %3d%%\n\r", device.bus, device.address, decile * 10);
+            }
+        }
+        if (!done) {
+            TaskPause();
+        }
+    }
+    uint8_t failed = 0;
+    USE_SERIAL.printf_P("\n\r");
+    for (uint8_t ix = 0; ix < count; ix++) {
+        SlaveFlash &device = multi_flash.GetDevice(ix);
+        if (device.step.load() == STEP_DONE) {
+            USE_SERIAL.printf_P("  Bus %d, TWI %02d: successful (%lu ms)\n\r", device.bus, device.address, (unsigned long)device.elapsed_ms);
+        } else {
+            USE_SERIAL.printf_P("  Bus %d, TWI %02d: [ command error! %d ] (%lu ms)\n\r", device.bus, device.address, device.error,
+                                (unsigned long)device.elapsed_ms);
+            failed++;
+        }
+    }
+    USE_SERIAL.printf_P("\n\rMulti-slave >>> %d of %d devices flashed in %lu ms\n\r", count - failed, count, (unsigned long)multi_flash.GetElapsedMs());
+    ReconnectConsole();
+}
+
+#ifdef BROADCAST_UPLOAD
+// Function BroadcastAll: flash the selected payload on every bootloader of the console bus, each page sent once
+void BroadcastAll(void) {
+    uint8_t addresses[BROADCAST_DEVICES];
+    SetBaseClock(); /* A general call reaches every device, the slowest sets the rate */
+    uint8_t count = FindBootloaders(addresses, BROADCAST_DEVICES);
+    USE_SERIAL.printf_P("\n\rBroadcast >>> Firmware upload to %d device(s), \x1b[5mPLEASE WAIT\x1b[0m ...", count);
+    FilePayload payload_file_image;
+    PageSource *source = OpenSelectedPayload(&payload_file_image);
+    BroadcastReport report;
+    uint8_t cmd_errors = (source != nullptr) ? BroadcastUpload(source, addresses, count, &report) : ERR_BAD_PAYLOAD;
+    USE_SERIAL.printf_P("\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b");
+    if (cmd_errors == 0) {
+        USE_SERIAL.printf_P(" successful, %d pages\n\r", report.pages);
+    } else {
+        USE_SERIAL.printf_P(" [ command error! %d ]\n\r", cmd_errors);
+    }
+    for (uint8_t ix = 0; ix < report.devices; ix++) {
+        BroadcastDevice &device = report.device[ix];
+        if (device.error != 0) {
+            USE_SERIAL.printf_P("  TWI %02d: [ command error! %d ]\n\r", device.address, device.error);
+        } else if (device.erased_again) {
+            USE_SERIAL.printf_P("  TWI %02d: missed the broadcast, flashed on its own%s\n\r", device.address, device.verified ? "" : " (no readback)");
+        } else {
+            USE_SERIAL.printf_P("  TWI %02d: verified, %d page(s) sent again\n\r", device.address, device.pages_resent);
+        }
+    }
+    USE_SERIAL.printf_P("  Broadcast %lu ms, verification %lu ms\n\r", (unsigned long)report.broadcast_ms, (unsigned long)report.verify_ms);
+    ReconnectConsole();
+}
+#endif  // BROADCAST_UPLOAD
@@ -0,0 +1,107 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: packet-size.cpp (Application)
+  ............................................................................
+  Negotiated packet sizes.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "packet-size.h"
+
+// Sizes probed, descending: each one divides a flash page, so page reads never straddle two pages
+static const uint8_t packet_sizes[PACKET_SIZES] = {PACKET_MAX, PACKET_MAX / 2, PACKET_MAX / 4, PACKET_MAX / 8, PACKET_MAX / 16};
+
+// Sizes kept for a device, by bootloader address
+struct DevicePackets {
+    uint8_t twi_addr = 0;  /* 0 = free */
+    uint8_t rx_size = SLV_PACKET_SIZE;
+};
+
+static DevicePackets device_packets[PACKET_DEVICES];
+static uint8_t oldest_packets = 0;  // Entry replaced when the table is full
+
+// Function FindPackets: a device's table entry, nullptr if its sizes are unknown
+static DevicePackets *FindPackets(const uint8_t twi_addr) {
+    for (uint8_t ix = 0; ix < PACKET_DEVICES; ix++) {
+        if ((twi_addr != 0) && (device_packets[ix].twi_addr == twi_addr)) {
+            return &device_packets[ix];
+        }
+    }
+    return nullptr;
+}
+
+// Function KeepPackets: remember a device's sizes, replacing the oldest entry if the table is full
+static void KeepPackets(const uint8_t twi_addr, const PacketReport &report) {
+    DevicePackets *entry = FindPackets(twi_addr);
+    for (uint8_t ix = 0; (ix < PACKET_DEVICES) && (entry == nullptr); ix++) {
+        if (device_packets[ix].twi_addr == 0) {
+            entry = &device_packets[ix];
+        }
+    }
+    if (entry == nullptr) {
+        entry = &device_packets[oldest_packets];
+        oldest_packets = (oldest_packets + 1) % PACKET_DEVICES;
+    }
+    entry->twi_addr = twi_addr;
+    entry->rx_size = report.rx_size;
+}
+
+// Function ProbeRead: one READFLSH packet of "size" bytes, 0 if its reply and checksum are good. Not
+// counted by the performance counters: a refused size is no bus fault (see CheckClock).
+static uint8_t ProbeRead(Timonel *timonel, const uint8_t size) {
+    uint8_t twi_cmd_arr[5] = {READFLSH, 0, 0, size, size};
+    uint8_t twi_reply_arr[PACKET_MAX + 2];
+    uint8_t twi_errors = timonel->TwiCmdXmit(twi_cmd_arr, 5, ACKRDFSH, twi_reply_arr, size + 2);
+    uint8_t checksum = 0;
+    for (uint8_t i = 1; (twi_errors == 0) && (i <= size); i++) {
+        checksum += twi_reply_arr[i];
+    }
+    if ((twi_errors == 0) && (checksum != twi_reply_arr[size + 1])) {
+        twi_errors = ERR_04;
+    }
+    return twi_errors;
+}
+
+// Function NegotiatePackets: probe the largest READFLSH packet the device sends and keep it for it.
+// Returns the error of the smallest size probed if none passed.
+uint8_t NegotiatePackets(Timonel *timonel, const Timonel::Status &sts, PacketReport *report) {
+    *report = PacketReport();
+    unsigned long start = micros();
+    uint8_t twi_errors = 0;
+    if ((sts.features_code >> F_CMD_READFLASH) & true) {
+        report->rx_probed = true;
+        for (uint8_t ix = 0; ix < PACKET_SIZES; ix++) {
+            report->probes++;
+            twi_errors = ProbeRead(timonel, packet_sizes[ix]);
+            if (twi_errors == 0) {
+                report->rx_size = packet_sizes[ix];
+                break;
+            }
+        }
+    }
+    KeepPackets(timonel->GetTwiAddress(), *report);
+    report->probe_us = micros() - start;
+    return twi_errors;
+}
+
+// Function PacketsKnown: whether a device's sizes were negotiated
+bool PacketsKnown(const uint8_t twi_addr) {
+    return (FindPackets(twi_addr) != nullptr);
+}
+
+// Function GetRxPacket: slave-to-master data bytes per packet for a device, SLV_PACKET_SIZE if not negotiated
+uint8_t GetRxPacket(const uint8_t twi_addr) {
+    DevicePackets *entry = FindPackets(twi_addr);
+    return (entry != nullptr) ? entry->rx_size : SLV_PACKET_SIZE;
+}
+
+// Function ForgetPackets: drop every device's sizes, the next upload negotiates again
+void ForgetPackets(void) {
+    for (uint8_t ix = 0; ix < PACKET_DEVICES; ix++) {
+        device_packets[ix] = DevicePackets();
+    }
+    oldest_packets = 0;
+}
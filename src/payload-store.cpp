@@ -0,0 +1,284 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: payload-store.cpp (Application)
+  ............................................................................
+  Payload library on LittleFS and streaming HEX/binary file reader.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "payload-store.h"
+
+#include <strings.h>
+
+#define NO_PAGE 0xFFFFFFFF
+
+// Function HasExtension: case-insensitive file name extension check
+static bool HasExtension(const char *name, const char *extension) {
+    size_t name_len = strlen(name), ext_len = strlen(extension);
+    return (name_len > ext_len) && (strcasecmp(&name[name_len - ext_len], extension) == 0);
+}
+
+// Class FilePayload: Open a payload file, binaries are flashed from "bin_start_address"
+bool FilePayload::Open(const char *path, const uint16_t bin_start_address) {
+    Close();
+    file_ = LittleFS.open(path, "r");
+    if (!file_ || file_.isDirectory()) {
+        Close();
+        return false;
+    }
+    hex_ = HasExtension(path, ".hex");
+    bin_start_address_ = bin_start_address;
+    if (!hex_ && (((uint32_t)bin_start_address_ + file_.size()) > 0xFFFF)) {
+        Close();
+        return false;
+    }
+    Rewind();
+    return true;
+}
+
+// Class FilePayload: Close the file
+void FilePayload::Close(void) {
+    file_.close();
+    valid_ = false;
+}
+
+// Class FilePayload: Start over from the beginning of the file
+void FilePayload::Rewind(void) {
+    valid_ = (bool)file_;
+    if (valid_) {
+        file_.seek(0);
+    }
+    done_ = false;
+    image_size_ = 0;
+    read_ix_ = 0;
+    read_size_ = 0;
+    base_address_ = 0;
+    next_page_ = 0;
+    record_size_ = 0;
+    record_ix_ = 0;
+}
+
+// Class FilePayload: Next page of the image
+bool FilePayload::NextBlock(uint16_t *flash_addr, uint8_t **data, uint16_t *size) {
+    if (!valid_ || done_) {
+        return false;
+    }
+    *data = page_;
+    if (hex_) {
+        if (!NextHexPage(flash_addr, size)) {
+            return false;
+        }
+    } else {
+        *flash_addr = bin_start_address_ + image_size_;
+        *size = file_.read(page_, SPM_PAGESIZE);
+        if (*size == 0) {
+            done_ = true;
+            return false;
+        }
+    }
+    image_size_ += *size;
+    return true;
+}
+
+// Class FilePayload: Next byte of the file, -1 at the end
+int FilePayload::ReadByte(void) {
+    if (read_ix_ >= read_size_) {
+        read_size_ = file_.read(read_buffer_, FILE_READ_BUFFER);
+        read_ix_ = 0;
+        if (read_size_ == 0) {
+            return -1;
+        }
+    }
+    return read_buffer_[read_ix_++];
+}
+
+// Class FilePayload: Next two hex digits of a record as a byte, -1 if they aren't
+int FilePayload::ReadHexByte(void) {
+    int value = 0;
+    for (uint8_t i = 0; i < 2; i++) {
+        int digit = ReadByte();
+        if ((digit >= '0') && (digit <= '9')) {
+            digit -= '0';
+        } else if ((digit >= 'A') && (digit <= 'F')) {
+            digit -= 'A' - 10;
+        } else if ((digit >= 'a') && (digit <= 'f')) {
+            digit -= 'a' - 10;
+        } else {
+            return -1;
+        }
+        value = (value << 4) | digit;
+    }
+    return value;
+}
+
+// Class FilePayload: Read the next Intel HEX record, false at the end of the image or on errors
+bool FilePayload::ReadRecord(void) {
+    int value = 0;
+    do {
+        value = ReadByte();
+        if (value < 0) {
+            done_ = true; /* No EOF record, take the file end as one */
+            return false;
+        }
+    } while (value != ':');
+    int header[4];
+    uint8_t checksum = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        header[i] = ReadHexByte();
+        if (header[i] < 0) {
+            valid_ = false;
+            return false;
+        }
+        checksum += header[i];
+    }
+    uint8_t data_size = header[0];
+    for (uint16_t i = 0; i <= data_size; i++) { /* Data bytes and the record checksum */
+        value = ReadHexByte();
+        if (value < 0) {
+            valid_ = false;
+            return false;
+        }
+        if (i < data_size) {
+            record_[i] = value;
+        }
+        checksum += value;
+    }
+    if (checksum != 0) {
+        valid_ = false;
+        return false;
+    }
+    switch (header[3]) {
+        case 0x00: { /* Data */
+            record_addr_ = base_address_ + ((header[1] << 8) | header[2]);
+            record_size_ = data_size;
+            record_ix_ = 0;
+            if ((record_addr_ + data_size) > 0x10000) {
+                valid_ = false;
+                return false;
+            }
+            break;
+        }
+        case 0x01: { /* End of file */
+            done_ = true;
+            return false;
+        }
+        case 0x02:   /* Extended segment address */
+        case 0x04: { /* Extended linear address */
+            if (data_size != 2) {
+                valid_ = false;
+                return false;
+            }
+            base_address_ = ((record_[0] << 8) | record_[1]);
+            base_address_ <<= (header[3] == 0x02) ? 4 : 16;
+            break;
+        }
+        case 0x03:   /* Start segment address */
+        case 0x05: { /* Start linear address */
+            break;
+        }
+        default: {
+            valid_ = false;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Class FilePayload: Gather HEX data into the next page with data, 0xFF where there is none
+bool FilePayload::NextHexPage(uint16_t *flash_addr, uint16_t *size) {
+    uint32_t page_addr = NO_PAGE;
+    uint16_t used = 0;
+    memset(page_, 0xFF, SPM_PAGESIZE);
+    for (;;) {
+        if (record_ix_ >= record_size_) {
+            if (done_ || !ReadRecord()) {
+                break;
+            }
+            continue;
+        }
+        uint32_t addr = record_addr_ + record_ix_;
+        if (page_addr == NO_PAGE) {
+            page_addr = addr & ~((uint32_t)SPM_PAGESIZE - 1);
+            if (page_addr < next_page_) {
+                valid_ = false; /* Records out of address order */
+                return false;
+            }
+        }
+        if (addr < page_addr) {
+            valid_ = false;
+            return false;
+        }
+        if (addr >= (page_addr + SPM_PAGESIZE)) {
+            used = SPM_PAGESIZE; /* Page done, more data follows */
+            break;
+        }
+        page_[addr - page_addr] = record_[record_ix_++];
+        if ((addr - page_addr) >= used) {
+            used = addr - page_addr + 1;
+        }
+    }
+    if (!valid_ || (page_addr == NO_PAGE)) {
+        return false;
+    }
+    next_page_ = page_addr + SPM_PAGESIZE;
+    *flash_addr = page_addr;
+    *size = used;
+    return true;
+}
+
+// Function PayloadStoreBegin: mount the payload file system
+bool PayloadStoreBegin(void) {
+    return LittleFS.begin(false);
+}
+
+// Function StoreList: call "on_file" for every .bin (and .hex if "hex_files") file in "dir" (1, 2, ...), return how many there are
+uint8_t StoreList(const char *dir_path, const bool hex_files, void (*on_file)(const uint8_t index, const char *name, const size_t size)) {
+    uint8_t count = 0;
+    File dir = LittleFS.open(dir_path, "r");
+    if (!dir || !dir.isDirectory()) {
+        return 0;
+    }
+    File file = dir.openNextFile();
+    while (file) {
+        if (!file.isDirectory() && ((hex_files && HasExtension(file.name(), ".hex")) || HasExtension(file.name(), ".bin"))) {
+            count++;
+            if (on_file != nullptr) {
+                on_file(count, file.name(), file.size());
+            }
+        }
+        file = dir.openNextFile();
+    }
+    return count;
+}
+
+// Function StorePath: full path of the file number "index" as listed by StoreList
+bool StorePath(const char *dir_path, const bool hex_files, const uint8_t index, char *path, const size_t path_size) {
+    uint8_t count = 0;
+    File dir = LittleFS.open(dir_path, "r");
+    if (!dir || !dir.isDirectory()) {
+        return false;
+    }
+    File file = dir.openNextFile();
+    while (file) {
+        if (!file.isDirectory() && ((hex_files && HasExtension(file.name(), ".hex")) || HasExtension(file.name(), ".bin"))) {
+            if (++count == index) {
+                return (snprintf(path, path_size, "%s/%s", dir_path, file.name()) < (int)path_size);
+            }
+        }
+        file = dir.openNextFile();
+    }
+    return false;
+}
+
+// Function PayloadStoreList: call "on_file" for every payload file (1, 2, ...), return how many there are
+uint8_t PayloadStoreList(void (*on_file)(const uint8_t index, const char *name, const size_t size)) {
+    return StoreList(PAYLOAD_DIR, true, on_file);
+}
+
+// Function PayloadStorePath: full path of the payload file number "index" as listed
+bool PayloadStorePath(const uint8_t index, char *path, const size_t path_size) {
+    return StorePath(PAYLOAD_DIR, true, index, path, path_size);
+}
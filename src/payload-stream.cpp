@@ -0,0 +1,221 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: payload-stream.cpp (Application)
+  ............................................................................
+  Payload sources for the upload paths.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "payload-stream.h"
+
+#include "console-job.h"
+#include "perf-stats.h"
+
+// Class RawPayload: Constructor
+RawPayload::RawPayload(uint8_t payload[], const uint16_t payload_size, const uint16_t start_address)
+    : payload_(payload), payload_size_(payload_size), start_address_(start_address) {
+}
+
+// Class RawPayload: The whole array is one block
+bool RawPayload::NextBlock(uint16_t *flash_addr, uint8_t **data, uint16_t *size) {
+    if (done_ || (payload_size_ == 0)) {
+        return false;
+    }
+    *flash_addr = start_address_;
+    *data = payload_;
+    *size = payload_size_;
+    done_ = true;
+    return true;
+}
+
+// Class RawPayload: Start over
+void RawPayload::Rewind(void) {
+    done_ = false;
+}
+
+// Class PackedPayload: Constructor, a start address of 0xFFFF keeps the one in the TPZ header
+PackedPayload::PackedPayload(const uint8_t packed[], const uint16_t packed_size, const uint16_t start_address)
+    : packed_(packed), packed_size_(packed_size) {
+    if ((packed_size_ >= TPZ_HEADER_SIZE) && (packed_[0] == 'T') && (packed_[1] == 'Z') && (packed_[2] == TPZ_VERSION)) {
+        stored_ = (packed_[3] & TPZ_STORED);
+        image_size_ = packed_[4] | (packed_[5] << 8);
+        start_address_ = (start_address != 0xFFFF) ? start_address : (packed_[6] | (packed_[7] << 8));
+        valid_ = true;
+    }
+    Rewind();
+}
+
+// Class PackedPayload: Unpack the next page into the page buffer
+bool PackedPayload::NextBlock(uint16_t *flash_addr, uint8_t **data, uint16_t *size) {
+    if (!valid_ || (out_count_ >= image_size_)) {
+        return false;
+    }
+    *flash_addr = start_address_ + out_count_;
+    *size = Unpack(page_, SPM_PAGESIZE);
+    *data = page_;
+    if ((*size < SPM_PAGESIZE) && (out_count_ < image_size_)) {
+        valid_ = false; /* Truncated stream */
+        return false;
+    }
+    return (*size > 0);
+}
+
+// Class PackedPayload: Start over
+void PackedPayload::Rewind(void) {
+    src_ix_ = TPZ_HEADER_SIZE;
+    out_count_ = 0;
+    control_ = 0;
+    control_bits_ = 0;
+    match_left_ = 0;
+    window_ix_ = 0;
+}
+
+// Class PackedPayload: Unpack up to "size" bytes, return how many were produced
+uint16_t PackedPayload::Unpack(uint8_t *data, const uint16_t size) {
+    uint16_t produced = 0;
+    if (stored_) {
+        while ((produced < size) && (out_count_ < image_size_) && (src_ix_ < packed_size_)) {
+            data[produced++] = packed_[src_ix_++];
+            out_count_++;
+        }
+        return produced;
+    }
+    while ((produced < size) && (out_count_ < image_size_)) {
+        uint8_t value = 0;
+        if (match_left_ > 0) {
+            value = window_[(uint8_t)(window_ix_ - match_distance_ - 1)];
+            match_left_--;
+        } else {
+            if (control_bits_ == 0) {
+                if (src_ix_ >= packed_size_) {
+                    break;
+                }
+                control_ = packed_[src_ix_++];
+                control_bits_ = 8;
+            }
+            bool literal = (control_ & 1);
+            control_ >>= 1;
+            control_bits_--;
+            if (!literal) {
+                if ((src_ix_ + 2) > packed_size_) {
+                    break;
+                }
+                match_distance_ = packed_[src_ix_++];
+                match_left_ = packed_[src_ix_++] + TPZ_MIN_MATCH;
+                continue;
+            }
+            if (src_ix_ >= packed_size_) {
+                break;
+            }
+            value = packed_[src_ix_++];
+        }
+        window_[window_ix_++] = value;
+        data[produced++] = value;
+        out_count_++;
+    }
+    return produced;
+}
+
+// Function WaitFor: delay "ms", calling "on_wait" all along if there is one and serving the console
+// if a job runs from it
+static void WaitFor(const unsigned long ms, WaitHook on_wait, void *context) {
+    if ((on_wait == nullptr) && !JobActive()) {
+        delay(ms);
+        return;
+    }
+    unsigned long wait_start = micros();
+    unsigned long elapsed = 0;
+    do {
+        if (on_wait != nullptr) {
+            on_wait(context, (ms * 1000) - elapsed);
+        }
+        JobService();
+        delayMicroseconds(WAIT_STEP_US);
+        elapsed = micros() - wait_start;
+    } while (elapsed < (ms * 1000));
+}
+
+// Function WritePages: send whole pages at the current device page address (no STPGADDR), in
+// MST_PACKET_SIZE packets
+uint8_t WritePages(Timonel *timonel, const uint8_t *data, const uint16_t data_size, WaitHook on_wait, void *context) {
+    PerfTimer timer(PERF_UPLOAD);
+    const uint8_t packet_size = MST_PACKET_SIZE;
+    const uint8_t cmd_size = packet_size + 2;
+    uint8_t twi_cmd_arr[MST_PACKET_SIZE + 2] = {WRITPAGE};
+    uint8_t twi_reply_arr[2] = {0};
+    uint16_t padded_size = ((data_size + SPM_PAGESIZE - 1) / SPM_PAGESIZE) * SPM_PAGESIZE;
+    for (uint16_t offset = 0; offset < padded_size; offset += packet_size) {
+        uint8_t checksum = 0;
+        for (uint8_t i = 0; i < packet_size; i++) {
+            twi_cmd_arr[i + 1] = ((offset + i) < data_size) ? data[offset + i] : 0xFF;
+            checksum += twi_cmd_arr[i + 1];
+        }
+        twi_cmd_arr[cmd_size - 1] = checksum;
+        PerfTimer xmit_timer(PERF_XMIT);
+        uint8_t twi_errors = timonel->TwiCmdXmit(twi_cmd_arr, cmd_size, AKWTPAGE, twi_reply_arr, 2);
+        if ((twi_errors == 0) && (twi_reply_arr[1] != checksum)) {
+            twi_errors = ERR_04;
+        }
+        if (xmit_timer.Stop(twi_errors, packet_size) != 0) {
+            return timer.Stop(twi_errors, offset);
+        }
+        WaitFor(DLY_PKT_SEND, on_wait, context);
+        if (((offset + packet_size) % SPM_PAGESIZE) == 0) {
+            WaitFor(DLY_FLASH_PG, on_wait, context);
+            if (JobCancelled() && ((offset + packet_size) < padded_size)) {
+                timer.Stop(0, offset + packet_size);
+                return ERR_CANCELLED; /* Stopped from the console between two pages */
+            }
+        }
+    }
+    return timer.Stop(0, data_size);
+}
+
+// Function SendPageAddress: STPGADDR, the next page written goes to "page_addr"
+uint8_t SendPageAddress(Timonel *timonel, const uint16_t page_addr) {
+    uint8_t twi_cmd_arr[4] = {STPGADDR, (uint8_t)((page_addr & 0xFF00) >> 8), (uint8_t)(page_addr & 0xFF), 0};
+    uint8_t twi_reply_arr[2] = {0};
+    twi_cmd_arr[3] = (uint8_t)(twi_cmd_arr[1] + twi_cmd_arr[2]);
+    uint8_t twi_errors = timonel->TwiCmdXmit(twi_cmd_arr, 4, AKPGADDR, twi_reply_arr, 2);
+    if ((twi_errors == 0) && (twi_reply_arr[1] != twi_cmd_arr[3])) {
+        twi_errors = ERR_04;
+    }
+    return twi_errors;
+}
+
+// Function UploadAt: write pages from a new page address through the library upload, which sets the
+// page address, checks the application room and relocates the reset vector of page 0
+uint8_t UploadAt(Timonel *timonel, uint8_t *data, const uint16_t data_size, const uint16_t flash_addr) {
+    PerfTimer timer(PERF_UPLOAD);
+    return timer.Stop(timonel->UploadApplication(data, data_size, flash_addr), data_size);
+}
+
+// Function UploadPages: upload every block of a payload source. Blocks that follow the
+// previous one go straight on, the device keeps incrementing its page address.
+uint8_t UploadPages(Timonel *timonel, PageSource *source) {
+    uint16_t flash_addr = 0, size = 0, sent = 0;
+    uint16_t next_addr = 0xFFFF;
+    uint8_t *data = nullptr;
+    source->Rewind();
+    while (source->NextBlock(&flash_addr, &data, &size)) {
+        if (JobCancelled()) {
+            return ERR_CANCELLED;
+        }
+        uint8_t twi_errors = 0;
+        if (flash_addr == next_addr) {
+            twi_errors = WritePages(timonel, data, size);
+        } else {
+            twi_errors = UploadAt(timonel, data, size, flash_addr);
+        }
+        if (twi_errors != 0) {
+            return twi_errors;
+        }
+        sent += size;
+        next_addr = ((size % SPM_PAGESIZE) == 0) ? (flash_addr + size) : 0xFFFF;
+        JobProgress((sent + SPM_PAGESIZE - 1) / SPM_PAGESIZE);
+    }
+    return (source->IsValid() && (sent == source->GetImageSize())) ? 0 : ERR_BAD_PAYLOAD;
+}
@@ -0,0 +1,71 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: perf-stats.cpp (Application)
+  ............................................................................
+  Performance counters (see perf-stats.h).
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "perf-stats.h"
+
+#ifdef I2C_TRACE
+#include "i2c-trace.h"
+#endif  // I2C_TRACE
+
+static PerfCounter perf_counters[PERF_OPS]; /* Zeroed at startup, static storage */
+
+static const char *const perf_names[PERF_OPS] = {"upload", "delete", "status", "scan", "reconnect", "xmit"};
+
+// Class PerfTimer: Record the operation, returns "errors" so a call can be wrapped in place
+uint8_t PerfTimer::Stop(const uint8_t errors, const uint32_t bytes, const uint32_t retries) {
+    PerfRecord(op_, micros() - start_us_, errors != 0, bytes, retries);
+    return errors;
+}
+
+// Function PerfRecord: count one call of "op" that took "elapsed_us"
+void PerfRecord(const PerfOp op, const uint32_t elapsed_us, const bool failed, const uint32_t bytes, const uint32_t retries) {
+    PerfCounter *counter = &perf_counters[op];
+    counter->calls.fetch_add(1, std::memory_order_relaxed);
+    if (failed) {
+        counter->errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (retries != 0) {
+        counter->retries.fetch_add(retries, std::memory_order_relaxed);
+    }
+    if (bytes != 0) {
+        counter->bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    counter->total_us.fetch_add(elapsed_us, std::memory_order_relaxed);
+    uint32_t seen = counter->max_us.load(std::memory_order_relaxed);
+    while ((elapsed_us > seen) && !counter->max_us.compare_exchange_weak(seen, elapsed_us, std::memory_order_relaxed)) {
+    }
+    const uint32_t stored = (elapsed_us < 0xFFFFFFFF) ? (elapsed_us + 1) : elapsed_us;
+    seen = counter->min_us.load(std::memory_order_relaxed);
+    while (((seen == 0) || (stored < seen)) && !counter->min_us.compare_exchange_weak(seen, stored, std::memory_order_relaxed)) {
+    }
+    uint32_t scaled = elapsed_us >> PERF_BUCKET_SHIFT;
+    uint8_t bucket = (scaled == 0) ? 0 : (32 - __builtin_clz(scaled));
+    bucket = (bucket < PERF_BUCKETS) ? bucket : (PERF_BUCKETS - 1);
+    counter->histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+#ifdef I2C_TRACE
+    TraceSpan(op, micros() - elapsed_us, elapsed_us, failed);
+#endif  // I2C_TRACE
+}
+
+// Function PerfGet: counters of an operation
+const PerfCounter &PerfGet(const PerfOp op) {
+    return perf_counters[op];
+}
+
+// Function PerfName: short name of an operation
+const char *PerfName(const PerfOp op) {
+    return perf_names[op];
+}
+
+// Function PerfBucketLimit: times in "bucket" are below this (us), 0 for the last one, which has no limit
+uint32_t PerfBucketLimit(const uint8_t bucket) {
+    return (bucket < (PERF_BUCKETS - 1)) ? (1UL << (bucket + PERF_BUCKET_SHIFT)) : 0;
+}
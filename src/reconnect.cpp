@@ -0,0 +1,139 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: reconnect.cpp (Application)
+  ............................................................................
+  Fast reconnect after mode switches.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "reconnect.h"
+
+#include <NbMicro.h>
+#include <nb-twi-cmd.h>
+
+#include "in-place.h"
+#include "perf-stats.h"
+#include "upload-checkpoint.h"
+
+// Last addresses seen for each running mode, 0 = unknown
+static uint8_t known_boot_addr = 0;
+static uint8_t known_app_addr = 0;
+
+// Function ProbeAddress: true when a device acknowledges "twi_addr"
+bool ProbeAddress(const uint8_t twi_addr) {
+    Wire.beginTransmission(twi_addr);
+    return (Wire.endTransmission() == 0);
+}
+
+// Function BusScanner: the TwiBus of the console controller's pins, built on first use and kept (it only
+// wraps Wire), built again in place if other pins are asked for
+TwiBus *BusScanner(const uint8_t sda, const uint8_t scl) {
+    static InPlace<TwiBus> scanner;
+    static uint8_t scanner_sda = 0, scanner_scl = 0;
+    if ((scanner.Get() == nullptr) || (sda != scanner_sda) || (scl != scanner_scl)) {
+        scanner.Build(sda, scl);
+        scanner_sda = sda;
+        scanner_scl = scl;
+    }
+    return scanner.Get();
+}
+
+// Function BootloaderAnswers: true when "twi_addr" answers GETTMNLV with AKTMNLV, which only Timonel does
+static bool BootloaderAnswers(const uint8_t twi_addr) {
+    const uint8_t reply_size = 12;
+    Wire.beginTransmission(twi_addr);
+    Wire.write(GETTMNLV);
+    if ((Wire.endTransmission() != 0) || (Wire.requestFrom(twi_addr, reply_size) != reply_size)) {
+        return false;
+    }
+    uint8_t reply = Wire.read();
+    for (uint8_t i = 1; i < reply_size; i++) {
+        Wire.read();
+    }
+    return (reply == AKTMNLV);
+}
+
+// Function ModeSettled: whether a device answering at "twi_addr" is done switching. An address of the mode
+// expected is; at one of the other mode it may still be answering before its reset: a bootloader must answer
+// GETTMNLV, an application (no command tells it apart) is only taken after RECONNECT_GRACE_MS.
+static bool ModeSettled(const uint8_t twi_addr, const DeviceMode expect, const unsigned long elapsed_us) {
+    const bool app_addr = (twi_addr >= APP_TWI_ADDR);
+    if ((expect == MODE_ANY) || (app_addr == (expect == MODE_APPLICATION))) {
+        return true;
+    }
+    if (app_addr) {
+        return (elapsed_us >= (RECONNECT_GRACE_MS * 1000UL));
+    }
+    return BootloaderAnswers(twi_addr);
+}
+
+// Function FindDevice: wait for the device, probing the last known addresses before scanning the bus
+uint8_t FindDevice(TwiBus *twi_bus, const DeviceMode expect, SwitchReport *report, void (*on_poll)(void)) {
+    *report = SwitchReport();
+    // Candidates: the expected mode address first, then the other one
+    uint8_t candidates[2] = {known_boot_addr, known_app_addr};
+    if (expect == MODE_APPLICATION) {
+        candidates[0] = known_app_addr;
+        candidates[1] = known_boot_addr;
+    }
+    unsigned long start = micros();
+    unsigned long scan_us = 0; /* Last bus scan, from the call */
+    unsigned long poll_ms = RECONNECT_POLL_MIN;
+    uint8_t twi_addr = 0;
+    while (twi_addr == 0) {
+        report->polls++;
+        unsigned long elapsed_us = micros() - start;
+        bool probing = (elapsed_us < (RECONNECT_PROBE_MS * 1000UL));
+        for (uint8_t i = 0; probing && (i < 2) && (twi_addr == 0); i++) {
+            if ((candidates[i] == 0) || ((i == 1) && (expect != MODE_ANY) && (elapsed_us < (RECONNECT_CONFIRM_MS * 1000UL)))) {
+                continue;
+            }
+            report->probes++;
+            if (ProbeAddress(candidates[i]) && ModeSettled(candidates[i], expect, elapsed_us)) {
+                twi_addr = candidates[i];
+            }
+        }
+        // A scan finds an address not known yet, at most one every RECONNECT_SCAN_MS
+        bool known = (candidates[0] != 0) || ((expect == MODE_ANY) && (candidates[1] != 0));
+        bool scan_due = !report->scanned || ((elapsed_us - scan_us) >= (RECONNECT_SCAN_MS * 1000UL));
+        if ((twi_addr == 0) && (!known || !probing) && scan_due &&
+            ((expect == MODE_ANY) || (elapsed_us >= (RECONNECT_CONFIRM_MS * 1000UL)))) {
+            bool app_mode = false;
+            PerfTimer timer(PERF_SCAN);
+            uint8_t found = twi_bus->ScanBus(&app_mode);
+            timer.Stop((found != 0) ? 0 : ERR_01);
+            report->probes += (found != 0) ? (found - LOW_TWI_ADDR + 1) : (HIG_TWI_ADDR - LOW_TWI_ADDR + 1);
+            report->scanned = true;
+            scan_us = elapsed_us;
+            twi_addr = ((found != 0) && ModeSettled(found, expect, elapsed_us)) ? found : 0;
+        }
+        if (twi_addr == 0) {
+            if (on_poll != nullptr) {
+                on_poll();
+            }
+            delay(poll_ms);
+            poll_ms = ((poll_ms * 2) < RECONNECT_POLL_MAX) ? (poll_ms * 2) : RECONNECT_POLL_MAX;
+        }
+    }
+    report->found_us = micros();
+    report->latency_us = report->found_us - start;
+    PerfRecord(PERF_RECONNECT, report->latency_us, false, 0, report->polls - 1);
+    report->address = twi_addr;
+    report->app_mode = (twi_addr >= APP_TWI_ADDR);
+    uint8_t *known_addr = report->app_mode ? &known_app_addr : &known_boot_addr;
+    if ((*known_addr != 0) && (report->scanned || (twi_addr != *known_addr))) {
+        // Gone from where it was and found again: it may be another board, its upload progress is not trusted
+        ClearCheckpoint(twi_addr);
+    }
+    *known_addr = twi_addr;
+    return twi_addr;
+}
+
+// Function ForgetDevice: drop the known addresses, the next search scans the bus
+void ForgetDevice(void) {
+    known_boot_addr = 0;
+    known_app_addr = 0;
+}
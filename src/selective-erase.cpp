@@ -0,0 +1,145 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: selective-erase.cpp (Application)
+  ............................................................................
+  Selective erase of the pages an application occupies.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "selective-erase.h"
+
+#include <Wire.h>
+
+#include "flash-sync.h"
+#include "packet-size.h"
+#include "payload-stream.h"
+#include "upload-checkpoint.h"
+
+// Function ManifestMatches: whether the device holds the manifest's image, going by its application start
+static bool ManifestMatches(const Timonel::Status &sts, const ImageManifest *manifest) {
+    return (manifest != nullptr) && (manifest->start == 0) && PayloadFits(*manifest, sts) &&
+           (ManifestAppStart(*manifest, sts.bootloader_start) == sts.application_start);
+}
+
+// Function PageBlank: whether a page read back is erased
+static bool PageBlank(const uint8_t *page) {
+    for (uint8_t i = 0; i < SPM_PAGESIZE; i++) {
+        if (page[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function ErasePages: write 0xFF pages from "first_addr" up to "end_addr", the bootloader erases each one first
+static uint8_t ErasePages(Timonel *timonel, const uint16_t first_addr, const uint16_t end_addr, EraseReport *report) {
+    uint8_t twi_errors = SendPageAddress(timonel, first_addr);
+    if (twi_errors != 0) {
+        return twi_errors;
+    }
+    delay(DLY_SET_ADDR);
+    uint8_t blank[SPM_PAGESIZE];
+    memset(blank, 0xFF, SPM_PAGESIZE);
+    for (uint16_t page_addr = first_addr; (page_addr < end_addr) && (twi_errors == 0); page_addr += SPM_PAGESIZE) {
+        twi_errors = WritePages(timonel, blank, SPM_PAGESIZE);
+        report->pages += (twi_errors == 0) ? 1 : 0;
+    }
+    return twi_errors;
+}
+
+// Function CanEraseSelective: whether EraseOccupied can erase this device (see selective-erase.h)
+bool CanEraseSelective(const Timonel::Status &sts, const ImageManifest *manifest) {
+    const bool known_start = (sts.bootloader_start <= MCU_TOTAL_MEM) && (sts.bootloader_start >= (SPM_PAGESIZE * 2));
+    if (!known_start || (sts.application_start == 0xFFFF) || (((sts.ext_features_code >> E_FORCE_ERASE_PG) & true) == false) ||
+        (((sts.features_code >> F_CMD_SETPGADDR) & true) == false) || (((sts.features_code >> F_APP_USE_TPL_PG) & true) == false)) {
+        return false;
+    }
+    return ((sts.features_code >> F_CMD_READFLASH) & true) || ManifestMatches(sts, manifest);
+}
+
+// Function TransferUs: bus time of a command of "cmd_size" bytes and its reply of "reply_size" at the current clock
+static uint32_t TransferUs(const uint8_t cmd_size, const uint8_t reply_size) {
+    const uint32_t bits = ((uint32_t)cmd_size + reply_size + 2) * 9 + 4; /* Both addresses, start, restart and stop */
+    return (uint32_t)(((uint64_t)bits * 1000000) / Wire.getClock());
+}
+
+// Function EraseUs: expected time to write "pages" blank pages from two page addresses, after "reads" page reads
+static uint32_t EraseUs(const uint8_t twi_addr, const uint16_t pages, const uint16_t reads) {
+    const uint8_t rx_packet = GetRxPacket(twi_addr);
+    const uint32_t page_us = (SPM_PAGESIZE / MST_PACKET_SIZE) * (TransferUs(MST_PACKET_SIZE + 2, 2) + (DLY_PKT_SEND * 1000UL)) +
+                             (DLY_FLASH_PG * 1000UL) + (2 * SPM_ERASE_US);
+    const uint32_t read_us = ((SPM_PAGESIZE + rx_packet - 1) / rx_packet) * TransferUs(5, rx_packet + 2);
+    const uint32_t address_us = TransferUs(4, 2) + (DLY_SET_ADDR * 1000UL);
+    return (pages * page_us) + (reads * read_us) + (2 * address_us);
+}
+
+// Function EraseOccupied: erase the pages the application occupies, then the trampoline page. The device stays
+// in the bootloader, no reset. Returns ERR_NO_SELECTIVE if it can't be done or DELFLASH would be faster (nothing
+// written), ERR_VERIFY if the device still reports an application start.
+uint8_t EraseOccupied(Timonel *timonel, const Timonel::Status &sts, const ImageManifest *manifest, EraseReport *report) {
+    *report = EraseReport();
+    if (!CanEraseSelective(sts, manifest)) {
+        return ERR_NO_SELECTIVE;
+    }
+    unsigned long start = micros();
+    const uint8_t twi_addr = timonel->GetTwiAddress();
+    const uint16_t tpl_page = sts.bootloader_start - SPM_PAGESIZE;
+    report->full_pages = sts.bootloader_start / SPM_PAGESIZE;
+    // Known extent: page 0 always (the reset vector), the manifest's pages when it is the image on the device,
+    // the pages an upload of it confirmed
+    uint16_t extent_end = SPM_PAGESIZE;
+    if (ManifestMatches(sts, manifest)) {
+        report->from_manifest = true;
+        extent_end = (manifest->pages > 1) ? (manifest->pages * SPM_PAGESIZE) : SPM_PAGESIZE;
+    }
+    UploadCheckpoint checkpoint;
+    if ((manifest != nullptr) && (manifest->start == 0) && LoadCheckpoint(twi_addr, manifest->fingerprint, &checkpoint) &&
+        ((checkpoint.confirmed * SPM_PAGESIZE) > extent_end)) {
+        extent_end = checkpoint.confirmed * SPM_PAGESIZE;
+    }
+    extent_end = (extent_end < tpl_page) ? extent_end : tpl_page;
+    // Past it, pages are read up to the first blank one, as long as the erase still beats DELFLASH
+    const bool reads = ((sts.features_code >> F_CMD_READFLASH) & true);
+    report->partial = !reads && (extent_end < tpl_page);
+    const uint32_t full_erase_us = (report->full_pages * SPM_ERASE_US) + DELFLASH_RESET_US;
+    report->delflash_us = (full_erase_us > (DLY_DEL_APP * 1000UL)) ? full_erase_us : (DLY_DEL_APP * 1000UL);
+    uint8_t twi_errors = 0;
+    uint8_t page[SPM_PAGESIZE];
+    while (true) {
+        bool more = reads && (extent_end < tpl_page);
+        report->estimate_us = EraseUs(twi_addr, (extent_end / SPM_PAGESIZE) + 1, report->pages_read + (more ? 1 : 0));
+        if ((report->estimate_us + (report->estimate_us / 8)) >= report->delflash_us) { /* An eighth of margin for the estimate */
+            report->slower = true;
+            report->erase_us = micros() - start;
+            return ERR_NO_SELECTIVE;
+        }
+        if (!more) {
+            break;
+        }
+        twi_errors = ReadFlash(timonel, extent_end, page, SPM_PAGESIZE);
+        report->pages_read++;
+        if ((twi_errors != 0) || PageBlank(page)) {
+            break;
+        }
+        extent_end += SPM_PAGESIZE;
+    }
+    // Page 0 first, the trampoline page last: erasing page 0 rewrote it
+    if (twi_errors == 0) {
+        twi_errors = ErasePages(timonel, 0, extent_end, report);
+        report->extent_end = extent_end;
+    }
+    if (twi_errors == 0) {
+        twi_errors = ErasePages(timonel, tpl_page, tpl_page + SPM_PAGESIZE, report);
+    }
+    if ((twi_errors == 0) && (timonel->GetStatus().application_start != 0xFFFF)) {
+        twi_errors = ERR_VERIFY;
+    }
+    if (twi_errors == 0) {
+        ClearCheckpoint(twi_addr); /* Nothing it confirmed is left */
+    }
+    report->erase_us = micros() - start;
+    return twi_errors;
+}
@@ -0,0 +1,314 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: tcp-ingest.cpp (Source)
+  ............................................................................
+  TCP firmware ingest server and upload job queue (see tcp-ingest.h).
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "tcp-ingest.h"
+
+#include "core-tasks.h"
+#include "flash-dump.h"
+#include "flash-sync.h"
+#include "payload-stream.h"
+#include "perf-stats.h"
+#include "twi-clock.h"
+
+// Class TcpIngest: Listen for clients, false if the port can't be opened
+bool TcpIngest::Begin(const uint16_t port, const uint32_t timeout_ms) {
+    timeout_ms_ = timeout_ms;
+    for (uint8_t ix = 0; ix < INGEST_SLOTS; ix++) {
+        slot_conn_[ix] = -1;
+    }
+    server_.setNoDelay(true);
+    server_.begin(port);
+    return (bool)server_;
+}
+
+// Class TcpIngest: Close every connection and stop listening
+void TcpIngest::End(void) {
+    for (uint8_t ix = 0; ix < INGEST_CLIENTS; ix++) {
+        conns_[ix].client.stop();
+        conns_[ix].state = CONN_FREE;
+    }
+    server_.end();
+}
+
+// Class TcpIngest: One non-blocking pass over the finished jobs, new connections and clients.
+// Returns the amount of work done (0: idle, the caller may rest).
+uint32_t TcpIngest::Service(void) {
+    uint32_t work = Finished() + Accept();
+    for (uint8_t ix = 0; ix < INGEST_CLIENTS; ix++) {
+        if (conns_[ix].state != CONN_FREE) {
+            work += ServeConn(&conns_[ix]);
+        }
+    }
+    return work;
+}
+
+// Class TcpIngest: Engine side, the oldest queued job or nullptr
+IngestJob *TcpIngest::TakeJob(void) {
+    uint8_t slot;
+    return ready_.Pop(&slot) ? &jobs_[slot] : nullptr;
+}
+
+// Class TcpIngest: Engine side, hand a job back with its result
+void TcpIngest::FinishJob(IngestJob *job, const uint8_t status, const uint32_t upload_ms) {
+    job->status = status;
+    job->upload_ms = upload_ms;
+    done_.Push((uint8_t)(job - jobs_)); /* Never full: it holds every slot */
+}
+
+// Class TcpIngest: Report finished jobs to their clients and free the slots
+uint32_t TcpIngest::Finished(void) {
+    uint32_t count = 0;
+    uint8_t slot;
+    while (done_.Pop(&slot)) {
+        IngestJob *job = &jobs_[slot];
+        if (job->status == 0) {
+            stats_.done++;
+        } else {
+            stats_.failed++;
+        }
+        if (slot_conn_[slot] >= 0) {
+            Conn *conn = &conns_[slot_conn_[slot]];
+            Reply(conn, "DONE %lu %u %lu\n", (unsigned long)job->id, job->status, (unsigned long)job->upload_ms);
+            conn->client.stop();
+            conn->state = CONN_FREE;
+        }
+        slot_conn_[slot] = -1;
+        slot_busy_[slot] = false;
+        count++;
+    }
+    return count;
+}
+
+// Class TcpIngest: Take new connections while there is room, refuse the rest at once
+uint32_t TcpIngest::Accept(void) {
+    uint32_t count = 0;
+    for (WiFiClient client = server_.accept(); client; client = server_.accept()) {
+        count++;
+        Conn *conn = nullptr;
+        uint8_t active = 0;
+        for (uint8_t ix = 0; ix < INGEST_CLIENTS; ix++) {
+            if (conns_[ix].state == CONN_FREE) {
+                conn = (conn == nullptr) ? &conns_[ix] : conn;
+            } else {
+                active++;
+            }
+        }
+        if (conn == nullptr) {
+            stats_.refused++;
+            client.print("ERR busy\n");
+            client.stop();
+            continue;
+        }
+        *conn = Conn();
+        conn->client = client;
+        conn->state = CONN_HEADER;
+        conn->last_data = millis();
+        stats_.accepted++;
+        if (active + 1 > stats_.peak_clients) {
+            stats_.peak_clients = active + 1;
+        }
+    }
+    return count;
+}
+
+// Class TcpIngest: Move one client on by at most INGEST_READ_CHUNK bytes
+uint32_t TcpIngest::ServeConn(Conn *conn) {
+    if (conn->state == CONN_QUEUED) {
+        // Nothing more to read: the job runs even if the client leaves, it just can't be told
+        if (!conn->client.connected()) {
+            slot_conn_[conn->slot] = -1;
+            conn->client.stop();
+            conn->state = CONN_FREE;
+        }
+        return 0;
+    }
+    if (conn->state == CONN_WAIT_SLOT) {
+        if (!conn->client.connected()) {
+            conn->client.stop();
+            conn->state = CONN_FREE;
+            return 1;
+        }
+        if (!ReserveSlot(conn)) {
+            return 0; /* Not read: its data stays in the TCP window */
+        }
+    }
+    int got = -1;
+    if (conn->state == CONN_HEADER) {
+        got = conn->client.read(&conn->header[conn->header_size], INGEST_HEADER_SIZE - conn->header_size);
+        if (got > 0) {
+            conn->header_size += got;
+            if ((conn->header_size == INGEST_HEADER_SIZE) && CheckHeader(conn) && !ReserveSlot(conn)) {
+                conn->state = CONN_WAIT_SLOT;
+                stats_.waits++;
+                Reply(conn, "WAIT %lu\n", (unsigned long)ready_.Size());
+            }
+        }
+    } else if (conn->state == CONN_BODY) {
+        IngestJob *job = &jobs_[conn->slot];
+        uint16_t want = conn->size - conn->received;
+        want = (want > INGEST_READ_CHUNK) ? INGEST_READ_CHUNK : want;
+        got = conn->client.read(&job->image[conn->received], want);
+        if (got > 0) {
+            uint8_t *data = &job->image[conn->received];
+            conn->running_crc = Crc16(conn->running_crc, data, got);
+            conn->received += got;
+            stats_.bytes += got;
+            // The reset vector must be a relative jump, Timonel points it to itself and chains this one
+            if ((conn->start_addr == 0) && (conn->received >= 2) && (conn->received - got < 2) && ((job->image[1] & 0xF0) != 0xC0)) {
+                stats_.invalid++;
+                Drop(conn, "reset vector");
+                return 1;
+            }
+            if (conn->received == conn->size) {
+                if (conn->running_crc != conn->crc) {
+                    stats_.invalid++;
+                    Drop(conn, "crc");
+                    return 1;
+                }
+                job->id = next_id_++;
+                job->start_addr = conn->start_addr;
+                job->size = conn->size;
+                job->run = conn->run;
+                job->status = 0;
+                job->upload_ms = 0;
+                uint32_t ahead = ready_.Size();
+                ready_.Push(conn->slot);
+                conn->state = CONN_QUEUED;
+                stats_.queued++;
+                if (ahead + 1 > stats_.peak_queued) {
+                    stats_.peak_queued = ahead + 1;
+                }
+                Reply(conn, "QUEUED %lu %lu\n", (unsigned long)job->id, (unsigned long)ahead);
+            }
+        }
+    }
+    if (got > 0) {
+        conn->last_data = millis();
+        return got;
+    }
+    if (!conn->client.connected()) {
+        Drop(conn, "closed"); /* Unfinished image: nobody to tell, just free its slot */
+        return 1;
+    }
+    if ((conn->state != CONN_WAIT_SLOT) && ((millis() - conn->last_data) > timeout_ms_)) {
+        stats_.timeouts++;
+        Drop(conn, "timeout");
+        return 1;
+    }
+    return 0;
+}
+
+// Class TcpIngest: Validate a complete header, refuse the client if it is wrong
+bool TcpIngest::CheckHeader(Conn *conn) {
+    const uint8_t *header = conn->header;
+    conn->run = (header[5] & INGEST_RUN) != 0;
+    conn->start_addr = header[6] | (header[7] << 8);
+    conn->size = header[8] | (header[9] << 8);
+    conn->crc = header[10] | (header[11] << 8);
+    if (memcmp(header, "TMNL", 4) != 0) {
+        Drop(conn, "magic");
+    } else if (header[4] != INGEST_VERSION) {
+        Drop(conn, "version");
+    } else if ((conn->size == 0) || (conn->size > INGEST_IMAGE_MAX) || ((uint32_t)conn->start_addr + conn->size > MCU_TOTAL_MEM)) {
+        Drop(conn, "size");
+    } else if ((conn->start_addr % SPM_PAGESIZE) != 0) {
+        Drop(conn, "address");
+    } else {
+        return true;
+    }
+    stats_.invalid++;
+    return false;
+}
+
+// Class TcpIngest: Give the client a free image slot, false if there is none
+bool TcpIngest::ReserveSlot(Conn *conn) {
+    for (uint8_t slot = 0; slot < INGEST_SLOTS; slot++) {
+        if (!slot_busy_[slot]) {
+            slot_busy_[slot] = true;
+            slot_conn_[slot] = conn - conns_;
+            conn->slot = slot;
+            conn->received = 0;
+            conn->running_crc = 0xFFFF;
+            conn->state = CONN_BODY;
+            conn->last_data = millis(); /* The wait for a slot doesn't count as silence */
+            return true;
+        }
+    }
+    return false;
+}
+
+// Class TcpIngest: Send a text line to the client
+void TcpIngest::Reply(Conn *conn, const char *format, ...) {
+    char line[40];
+    va_list args;
+    va_start(args, format);
+    int size = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (size > 0) {
+        conn->client.write((const uint8_t *)line, (size < (int)sizeof(line)) ? size : sizeof(line) - 1);
+    }
+}
+
+// Class TcpIngest: Refuse the client, freeing its image slot if it had one
+void TcpIngest::Drop(Conn *conn, const char *reason) {
+    if (conn->state == CONN_BODY) {
+        slot_conn_[conn->slot] = -1;
+        slot_busy_[conn->slot] = false;
+    }
+    Reply(conn, "ERR %s\n", reason);
+    conn->client.stop();
+    conn->state = CONN_FREE;
+}
+
+// Function FlashIngestJob: erase and flash a job image, then run it if asked. Returns the first error.
+uint8_t FlashIngestJob(HostTarget *target, IngestJob *job) {
+    uint8_t cmd_errors = 0, twi_errors = 0;
+    if (*target->app_mode) {
+        PerfTimer timer(PERF_XMIT);
+        cmd_errors = timer.Stop((*target->timonel)->TwiCmdXmit(RESETMCU, ACKRESET));
+        twi_errors = ReconnectTarget(target, MODE_BOOTLOADER);
+        if ((cmd_errors != 0) || (twi_errors != 0)) {
+            return (cmd_errors != 0) ? cmd_errors : twi_errors;
+        }
+    }
+    Timonel::Status sts = target->cache->GetStatus(*target->timonel, false);
+    if (((uint32_t)job->start_addr + job->size) > sts.bootloader_start) {
+        return HOST_BAD_ARGS;
+    }
+    PerfTimer timer(PERF_DELETE);
+    cmd_errors = timer.Stop((*target->timonel)->DeleteApplication());
+    target->cache->InvalidateAppStart();
+    twi_errors = ReconnectTarget(target, MODE_BOOTLOADER);
+    if ((cmd_errors != 0) || (twi_errors != 0)) {
+        return (cmd_errors != 0) ? cmd_errors : twi_errors;
+    }
+    RawPayload payload(job->image, job->size, job->start_addr);
+    VerifyReport verify;
+    uint8_t fallbacks = 0;
+    cmd_errors = UploadAdaptive(*target->timonel, &payload, target->cache->GetStatus(*target->timonel, false), &verify, &fallbacks);
+    target->cache->InvalidateAppStart();
+    if ((cmd_errors != 0) || !job->run) {
+        return cmd_errors;
+    }
+    cmd_errors = (*target->timonel)->RunApplication();
+    twi_errors = ReconnectTarget(target, MODE_APPLICATION);
+    return (cmd_errors != 0) ? cmd_errors : twi_errors;
+}
+
+// Function IngestTask: serve the TCP clients forever, resting a tick when idle
+void IngestTask(void *tcp_ingest) {
+    TcpIngest *ingest = (TcpIngest *)tcp_ingest;
+    for (;;) {
+        if (ingest->Service() == 0) {
+            delay(1);
+        }
+    }
+}
@@ -13,16 +13,61 @@
 
 #include "timonel-mss-esp32.h"
 
+#include "broadcast-upload.h"
+#include "bus-commands.h"
+#include "console-job.h"
+#include "core-tasks.h"
+#include "device-cache.h"
+#include "eeprom-commands.h"
+#include "eeprom-mirror.h"
+#include "flash-commands.h"
+#include "flash-dump.h"
+#include "flash-sync.h"
+#include "host-link.h"
+#include "i2c-trace.h"
+#include "in-place.h"
+#include "line-flash.h"
+#include "multi-flash.h"
+#include "packet-size.h"
+#include "payload-store.h"
+#include "perf-stats.h"
+#include "twi-clock.h"
 #include "payload.h"
+#include "payload-manifest.h"
 
 // Global variables
 bool new_key = false;
-bool new_word = false;
 bool *p_app_mode = nullptr;
 char key = '\0';
 uint16_t flash_page_addr = 0x0000;
 uint16_t eeprom_addr = 0x0000;
+#ifdef PAYLOAD_PACKED
+typedef PackedPayload PayloadImage;  // payload.h made by payload-gen.py, unpacked page by page
+#else
+typedef RawPayload PayloadImage;  // payload.h made by the Timonel Hex Parser
+#endif
+char payload_file[MAX_PAYLOAD_PATH] = "";  // Payload picked with 'f', empty = built-in payload.h
+#ifdef PAYLOAD_MANIFEST
+// payload.h is checked against the target when this is built (see payload-manifest.h)
+typedef PayloadLayout<payload_start, payload_image_size, payload_reset_vector, sizeof(payload_page_crc) / sizeof(payload_page_crc[0])> PayloadChecks;
+const ImageManifest payload_manifest = PayloadChecks::Make(payload_fingerprint, payload_page_crc);
+#endif  // PAYLOAD_MANIFEST
+Prompt prompt = PROMPT_NONE;  // Command waiting for the number it asked for
+uint8_t prompt_choices = 0;   // Files listed for a PROMPT_PAYLOAD or PROMPT_EEPROM_IMAGE answer
+EraseJob erase_job;           // 'e' waiting for the device to come back
+bool line_mode = false;       // Production line mode: headless, every board put in is flashed (see line-flash.h)
+LineFixture line_fixture;     // Board in the fixture, in line mode
+LineLog line_log;             // Pass/fail log and line statistics, in line mode
 Timonel *p_timonel = nullptr;  // Pointer to a bootloader objetct
+InPlace<Timonel> timonel_slot;  // Static storage of *p_timonel, rebuilt there for every device found
+DeviceCache device_cache;      // Status, settings and liveness of the device behind p_timonel
+EepromMirror eeprom_mirror(&device_cache, EEPROM_TOP + 1);  // Its EEPROM, 'p' writes wait there for a flush
+#ifdef DUAL_CORE
+ConsoleRing console_ring;  // Engine task console: output ring and typed keys, served by the console task
+#endif  // DUAL_CORE
+#ifdef TCP_INGEST
+TcpIngest tcp_ingest;  // Firmware images from TCP clients, flashed by the engine between commands
+#endif  // TCP_INGEST
 // If the user application only needs simple I2C commands, it is enough to create just a
 // Timonel object. Since it inherits from NbMicro, so the "TwiCmdXmit" method is available.
 
@@ -32,301 +77,340 @@ Timonel *p_timonel = nullptr;  // Pointer to a bootloader objetct
   |___________________|
 */
 void setup() {
-    bool app_mode = false;         // This holds the slave device running mode info: bootloader or application
+    Serial.setTxBufferSize(DUMP_TX_BUFFER);  // Lets binary dump frames drain during I2C reads (before begin)
+    Serial.begin(SERIAL_BPS);                // Initialize the serial port for debugging
+#ifdef TCP_INGEST
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);  // Joins in the background, clients can connect once it is up
+    tcp_ingest.Begin(INGEST_PORT);
+#endif  // TCP_INGEST
+#ifdef DUAL_CORE
+    // I2C engine on the protocol core, console on the Arduino core: the UART is served while I2C blocks
+    StartTask(ConsoleTask, "console", CONSOLE_STACK, &console_ring, CONSOLE_PRIORITY, CONSOLE_CORE);
+#ifdef TCP_INGEST
+    // TCP clients are served next to the console, images keep coming in while the engine flashes
+    StartTask(IngestTask, "ingest", INGEST_STACK, &tcp_ingest, CONSOLE_PRIORITY, CONSOLE_CORE);
+#endif  // TCP_INGEST
+    StartTask(EngineTask, "engine", ENGINE_STACK, nullptr, ENGINE_PRIORITY, ENGINE_CORE);
+#else
+    EngineSetup();
+#endif  // DUAL_CORE
+}
+
+/* _________________
+  |                 | 
+  |    Main loop    |
+  |_________________|
+*/
+void loop() {
+#ifdef DUAL_CORE
+    delay(1000);  // Everything runs in the engine and console tasks
+#else
+    if (!EngineLoop()) {
+        delay(ENGINE_IDLE_MS);  // Nothing to do: let the idle task run instead of spinning on the UART
+    }
+#endif  // DUAL_CORE
+}
+
+// Function EngineTask: run the command engine forever on its own core
+void EngineTask(void *param) {
+    EngineSetup();
+    for (;;) {
+        EngineLoop();
+        TaskPause();
+    }
+}
+
+// Function EngineSetup: find the device and show the menu
+void EngineSetup(void) {
+    static bool app_mode = false;  // This holds the slave device running mode info: bootloader or application
     p_app_mode = &app_mode;        // This is to take different actions depending on whether the bootloader or the application is active
-    USE_SERIAL.begin(SERIAL_BPS);  // Initialize the serial port for debugging
+    LineSelection selection;
+    bool line_selected = LoadLineSelection(&selection) && selection.enabled;
+#ifdef LINE_FLASH
+    line_selected = true;  // Built in, a payload picked from the console is still used
+#endif  // LINE_FLASH
+    if (line_selected) {
+        LineSetup(selection);
+        return;
+    }
     ClrScr();
     PrintLogo();
+    if (!PayloadStoreBegin()) {
+        USE_SERIAL.printf_P("\n\rPayload store (LittleFS) not mounted, only the built-in payload is available\n\r");
+    }
+#ifdef TCP_INGEST
+    USE_SERIAL.printf_P("\n\rTCP firmware ingest on port %d (WiFi \"%s\")\n\r", tcp_ingest.GetPort(), WIFI_SSID);
+#endif  // TCP_INGEST
     uint8_t slave_address = 0;
     USE_SERIAL.printf_P("\n\rWaiting until a TWI slave device is detected on the bus   ");
     slave_address = DiscoverDevice(p_app_mode, SDA, SCL);
     ShowHeader(*p_app_mode);
-    p_timonel = new Timonel(slave_address, SDA, SCL);
+    p_timonel = timonel_slot.Build(slave_address, SDA, SCL);
+    device_cache.Invalidate();
     if (!(*p_app_mode)) {
-        p_timonel->GetStatus();
         PrintStatus(p_timonel);
     }
     ShowMenu(*p_app_mode);
+    device_cache.StartCommand();
 }
 
-/* _________________
-  |                 | 
-  |    Main loop    |
-  |_________________|
-*/
-void loop() {
-    if (new_key == true) {
-        new_key = false;
-        DiscoverDevice(p_app_mode, SDA, SCL);
-        USE_SERIAL.printf_P("\b\n\r");
-        if (*p_app_mode) {
-            // ....................
-            // . APPLICATION MODE .
-            // ....................
-            switch (key) {
-                // *********************************
-                // * Test app ||| STDPB1_1 Command *
-                // *********************************
-                case 'a':
-                case 'A': {
-                    USE_SERIAL.printf_P("\n\rApplication Cmd >>> Starting blink");
-                    byte ret = p_timonel->TwiCmdXmit(SETIO1_1, ACKIO1_1);
-                    if (ret) {
-                        USE_SERIAL.printf_P(" > Error: %d\n\n\r", ret);
-                    } else {
-                        USE_SERIAL.printf_P(" > OK!\n\n\r");
-                    }
-                    break;
-                }
-                // *********************************
-                // * Test app ||| STDPB1_0 Command *
-                // *********************************
-                case 's':
-                case 'S': {
-                    USE_SERIAL.printf_P("\n\rApplication Cmd >>> Stopping blink");
-                    byte ret = p_timonel->TwiCmdXmit(SETIO1_0, ACKIO1_0);
-                    if (ret) {
-                        USE_SERIAL.printf_P(" > Error: %d\n\n\r", ret);
-                    } else {
-                        USE_SERIAL.printf_P(" > OK!\n\n\r");
-                    }
-                    break;
-                }
-                // *********************************
-                // * Test app ||| RESETINY Command *
-                // *********************************
-                case 'z':
-                case 'Z': {
-                    byte ret = p_timonel->TwiCmdXmit(RESETMCU, ACKRESET);
-                    USE_SERIAL.printf_P("\n  .\n\r . .\n\r. . .\n\n\r");
-                    if (ret) {
-                        USE_SERIAL.printf_P(" > Error: %d\n\n\r", ret);
-                    } else {
-                        USE_SERIAL.printf_P(" > OK Resetting Tiny85, going back to bootloader!\n\r");
-                    }
-                    delay(MODE_SWITCH_DLY);
-                    // ESP.restart();
-                    delete p_timonel;
-                    USE_SERIAL.printf_P("\n\rWaiting for device   ");
-                    uint8_t slave_address = DiscoverDevice(p_app_mode, SDA, SCL);
-                    //USE_SERIAL.printf_P("\n\r");
-                    p_timonel = new Timonel(slave_address, SDA, SCL);
-                    ShowHeader(*p_app_mode);
-                    USE_SERIAL.printf_P("\n\r");
-                    break;
-                }
-                // ******************
-                // * ? Help command *
-                // ******************
-                case '?':
-                case 'h':
-                case 'H': {
-                    USE_SERIAL.printf_P("\n\r Help: Available application commands:\n\r");
-                    USE_SERIAL.printf_P(" =====================================\n\r");
-                    USE_SERIAL.printf_P(" a) Start LED blinking on device PB1.\n\r");
-                    USE_SERIAL.printf_P(" s) Stop LED blinking on device PB1.\n\r");
-                    USE_SERIAL.printf_P(" z) Reset Tiny85 and jump back to bootloader.\n\n\r");
-                    break;
-                }
-            }
-        } else {
-            // ...................
-            // . BOOTLOADER MODE .
-            // ...................
-            switch (key) {
-                // ******************
-                // * Restart master *
-                // ******************
-                case 'z':
-                case 'Z': {
-                    USE_SERIAL.printf_P("\nResetting TWI Master ...\n\r\n.\n.\n.\n");
-                    delay(MODE_SWITCH_DLY);
-                    ESP.restart();
-                    break;
-                }
-                // ********************************
-                // * Timonel ::: GETTMNLV command *
-                // ********************************
-                case 'v':
-                case 'V':
-                case 13: {
-                    USE_SERIAL.printf_P("\nBootloader Cmd >>> Get bootloader version ...\r\n");
-                    PrintStatus(p_timonel);
-                    //p_timonel->GetStatus();
-                    //Timonel::Status sts = p_timonel->GetStatus();
-                    //Timonel::Status sts = PrintStatus(p_timonel);
-                    // if ((sts.features_code >> F_CMD_SETPGADDR) & true) {
-                    //     p_timonel->InitMicro();
-                    // }
-                    TwiBus twi_bus(SDA, SCL);
-                    twi_bus.ScanBus(p_app_mode);
-                    break;
-                }
-                // ********************************
-                // * Timonel ::: EXITTMNL command *
-                // ********************************
-                case 'r':
-                case 'R': {
-                    USE_SERIAL.printf_P("\nBootloader Cmd >>> Run application ...\r\n");
-                    USE_SERIAL.printf_P("\n. . .\n\r . .\n\r  .\n\n\r");
-                    USE_SERIAL.printf_P("Please wait ...\n\n\r");
-                    // The GetStatus command below is to ensure that the remote device is properly initialized
-                    // before running this case's command (e.g. when running after a firmware deletion)
-                    // p_timonel->GetStatus();
-                    uint8_t cmd_errors = p_timonel->RunApplication();
-                    if (cmd_errors == 0) {
-                        USE_SERIAL.printf_P("Bootloader exit successful, running the user application (if there is one) ...\r\n");
-                    } else {
-                        USE_SERIAL.printf_P(" [ command error! %d ]", cmd_errors);
-                    }
-                    delay(MODE_SWITCH_DLY);
-                    delete p_timonel;
-                    USE_SERIAL.printf_P("\n\rWaiting for device   ");
-                    uint8_t slave_address = DiscoverDevice(p_app_mode, SDA, SCL);
-                    p_timonel = new Timonel(slave_address, SDA, SCL);
-                    ShowHeader(*p_app_mode);
-                    USE_SERIAL.printf_P("\n\r");
-                    break;
-                }
-                // ********************************
-                // * Timonel ::: DELFLASH command *
-                // ********************************
-                case 'e':
-                case 'E': {
-                    USE_SERIAL.printf_P("\n\rBootloader Cmd >>> Delete app firmware from flash memory, \x1b[5mPLEASE WAIT\x1b[0m ...");
-                    uint8_t cmd_errors = p_timonel->DeleteApplication();
-                    USE_SERIAL.printf_P("\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b");
-                    if (cmd_errors == 0) {
-                        USE_SERIAL.printf_P(" successful        ");
-                    } else {
-                        USE_SERIAL.printf_P(" [ command error! %d ]", cmd_errors);
-                    }
-                    USE_SERIAL.printf_P("\n\r");
-                    // USE_SERIAL.printf_P("\n\rDeleting firmware   ");
-                    DiscoverDevice(p_app_mode, SDA, SCL);
-                    // USE_SERIAL.printf_P("\n\r");
-                    break;
-                }
-                // ********************************
-                // * Timonel ::: STPGADDR command *
-                // ********************************
-                case 'b':
-                case 'B': {
-                    Timonel::Status sts = p_timonel->GetStatus();
-                    if (((sts.features_code >> F_CMD_SETPGADDR) & true) == false) {
-                        USE_SERIAL.printf_P("\n\rSet address command not supported by current Timonel features ...\n\r");
-                        break;
-                    }
-                    USE_SERIAL.printf_P("\n\rPlease enter the flash memory page base address: ");
-                    while (new_word == false) {
-                        flash_page_addr = ReadWord();
-                    }
-                    if (new_word == true) {
-                        USE_SERIAL.printf_P("\n\rFlash memory page base address: %d\r\n", flash_page_addr);
-                        USE_SERIAL.printf_P("Address high byte: %d (<< 8) + Address low byte: %d\n\r", (flash_page_addr & 0xFF00) >> 8,
-                                            flash_page_addr & 0xFF);
-                        if (sts.bootloader_start > MCU_TOTAL_MEM) {
-                            USE_SERIAL.printf_P("\n\n\rWarning: Timonel bootloader start address unknown, please run 'version' command to find it !\n\r");
-                            break;
-                        }
-                        if ((flash_page_addr > (sts.bootloader_start - SPM_PAGESIZE)) | (flash_page_addr == 0xFFFF)) {
-                            USE_SERIAL.printf_P("\n\rWarning: The highest flash page address available is %d (0x%X), please correct it !!!\n\n\r", sts.bootloader_start - SPM_PAGESIZE, sts.bootloader_start - SPM_PAGESIZE);
-                            flash_page_addr = 0x0000;
-                            break;
-                        }
-                    }
-                    new_word = false;
-                    break;
-                }
-                // ********************************
-                // * Timonel ::: WRITPAGE command *
-                // ********************************
-                case 'w':
-                case 'W': {
-                    USE_SERIAL.printf_P("\n\rBootloader Cmd >>> Firmware upload to flash memory, \x1b[5mPLEASE WAIT\x1b[0m ...");
-                    // The GetStatus command below is to ensure that the remote device is properly initialized
-                    // before running this case's command (e.g. when running after a firmware deletion)
-                    // p_timonel->GetStatus();
-                    uint8_t cmd_errors = p_timonel->UploadApplication(payload, sizeof(payload), flash_page_addr);
-                    USE_SERIAL.printf_P("\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b");
-                    if (cmd_errors == 0) {
-                        USE_SERIAL.printf_P(" successful, press 'r' to run the user app");
-                    } else {
-                        USE_SERIAL.printf_P(" [ command error! %d ]", cmd_errors);
-                    }
-                    USE_SERIAL.printf_P("\n\n\r");
-                    break;
-                }
+// Application mode commands
+const ConsoleCommand app_commands[] = {
+    {'a', StartBlink},
+    {'s', StopBlink},
+    {'z', ResetDevice},
+    {'t', PrintPerfStats},
+#ifdef I2C_TRACE
+    {TRACE_KEY, PrintTrace},
+#endif  // I2C_TRACE
+    {'?', ShowAppHelp},
+    {'h', ShowAppHelp},
+};
+
+// Bootloader mode commands, the ones with a module of their own are there (see flash-commands.h,
+// eeprom-commands.h, bus-commands.h, multi-flash.h and line-flash.h)
+const ConsoleCommand boot_commands[] = {
+    {'z', RestartMaster},
+    {'v', ShowVersion},
+    {13, ShowVersion},
+    {'r', RunApp},
+    {'e', EraseFlash},
+    {'u', ErasePages},
+    {'b', AskPageAddr},
+    {'f', PickPayload},
+    {'w', UploadSelected},
+    {'y', SelectLineMode},
+    {'c', NegotiateLink},
+#ifdef BROADCAST_UPLOAD
+    {'g', BroadcastAll},
+#endif  // BROADCAST_UPLOAD
+    {'x', FlashAllDevices},
+    {'t', PrintPerfStats},
+#ifdef I2C_TRACE
+    {TRACE_KEY, PrintTrace},
+#endif  // I2C_TRACE
 #if ((defined FEATURES_CODE) && ((FEATURES_CODE >> F_CMD_READFLASH) & true))
-                // ********************************
-                // * Timonel ::: READFLSH command *
-                // ********************************
-                case 'm':
-                case 'M': {
-                    // (uint16_t) flash_size: MCU flash memory size
-                    // (uint8_t) slave_data_size: slave-to-master Xmit packet size
-                    // (uint8_t) values_per_line: MCU memory values shown per line
-                    p_timonel->DumpMemory(MCU_TOTAL_MEM, SLV_PACKET_SIZE, 32);
-                    break;
-                }
+    {'d', UploadChanged},
+    {'m', DumpFlash},
 #if ((defined EXT_FEATURES) && ((EXT_FEATURES >> E_EEPROM_ACCESS) & true))
-                // ********************************
-                // * Timonel ::: WRITEEPR command *
-                // ********************************
-                case 'p':
-                case 'P': {
-                    new_word = false;
-                    uint8_t eeprom_data = 0;
-                    USE_SERIAL.printf_P("\n\rPlease enter the EEPROM memory address: ");
-                    while (new_word == false) {
-                        eeprom_addr = ReadWord();
-                    }
-                    if (eeprom_addr > EEPROM_TOP) {
-                        USE_SERIAL.printf_P("\n\rWarning: The highest EEPROM address available is %d (0x%X), please correct it !!!", EEPROM_TOP, EEPROM_TOP);
-                        new_word = false;
-                        break;
-                    }
-                    USE_SERIAL.printf_P("\n\rPlease enter EEPROM data: ");
-                    //new_key = false;
-                    new_word = false;
-                    while (new_word == false) {
-                        eeprom_data = ReadWord();
-                    }
-                    if (new_word == true) {
-                        USE_SERIAL.printf_P("\n\r");
-                        new_key = false;
-                    }
-                    USE_SERIAL.printf_P("\n\rWriting %d to EEPROM address 0x%04X\n\n\r", eeprom_data, eeprom_addr);
-                    p_timonel->WriteEeprom(eeprom_addr, eeprom_data);
-                    break;
-                }
-                // ********************************
-                // * Timonel ::: READEEPR command *
-                // ********************************
-                case 'o':
-                case 'O': {
-                    USE_SERIAL.printf_P("\n\r");
-                    for (uint16_t ee_addr = 0; ee_addr <= EEPROM_TOP; ee_addr++) {
-                        USE_SERIAL.printf_P("%03d=%02d ", ee_addr, p_timonel->ReadEeprom(ee_addr));
-                    }
-                    USE_SERIAL.printf_P("\n\n\r");
-                    break;
-                }
+    {'p', AskEepromAddr},
+    {'o', ShowEeprom},
+    {'n', FlushPendingEeprom},
+    {'k', SaveEepromImage},
+    {'l', PickEepromImage},
 #endif  // EXT_FEATURES >> E_EEPROM_ACCESS
-#endif  /* CMD_READFLASH) */
-                // *******************
-                // * Unknown command *
-                // *******************
-                default: {
-                    USE_SERIAL.printf_P("Command '%d' unknown ...\n\r", key);
-                    break;
-                }
-                    USE_SERIAL.printf_P("\n\r");
-            }
+#endif  // F_CMD_READFLASH
+};
+
+// Function RunCommand: run the command for the last key typed, the application's or the bootloader's
+void RunCommand(void) {
+    const ConsoleCommand *commands = app_commands;
+    uint8_t count = sizeof(app_commands) / sizeof(app_commands[0]);
+    if (!(*p_app_mode)) {
+        if ((eeprom_mirror.GetDirty() != 0) && (strchr("oOpPnN", key) == nullptr)) {
+            FlushEeprom(false); /* The command may reset the device or switch its mode */
+        }
+        commands = boot_commands;
+        count = sizeof(boot_commands) / sizeof(boot_commands[0]);
+    }
+    char command_key = tolower(key);
+    for (uint8_t ix = 0; ix < count; ix++) {
+        if (commands[ix].key == command_key) {
+            commands[ix].run();
+            return;
         }
-        ShowMenu(*p_app_mode);
     }
-    ReadChar();
+    if (!(*p_app_mode)) {
+        USE_SERIAL.printf_P("Command '%d' unknown ...\n\r", key);
+    }
+}
+
+// Function StartBlink: 'a', test app STDPB1_1 command
+void StartBlink(void) {
+    USE_SERIAL.printf_P("\n\rApplication Cmd >>> Starting blink");
+    PerfTimer timer(PERF_XMIT);
+    byte ret = timer.Stop(p_timonel->TwiCmdXmit(SETIO1_1, ACKIO1_1));
+    if (ret) {
+        USE_SERIAL.printf_P(" > Error: %d\n\n\r", ret);
+    } else {
+        USE_SERIAL.printf_P(" > OK!\n\n\r");
+    }
+}
+
+// Function StopBlink: 's', test app STDPB1_0 command
+void StopBlink(void) {
+    USE_SERIAL.printf_P("\n\rApplication Cmd >>> Stopping blink");
+    PerfTimer timer(PERF_XMIT);
+    byte ret = timer.Stop(p_timonel->TwiCmdXmit(SETIO1_0, ACKIO1_0));
+    if (ret) {
+        USE_SERIAL.printf_P(" > Error: %d\n\n\r", ret);
+    } else {
+        USE_SERIAL.printf_P(" > OK!\n\n\r");
+    }
+}
+
+// Function ResetDevice: 'z' in application mode, test app RESETINY command, back to the bootloader
+void ResetDevice(void) {
+    PerfTimer timer(PERF_XMIT);
+    byte ret = timer.Stop(p_timonel->TwiCmdXmit(RESETMCU, ACKRESET));
+    unsigned long switch_start = micros();
+    USE_SERIAL.printf_P("\n  .\n\r . .\n\r. . .\n\n\r");
+    if (ret) {
+        USE_SERIAL.printf_P(" > Error: %d\n\n\r", ret);
+    } else {
+        USE_SERIAL.printf_P(" > OK Resetting Tiny85, going back to bootloader!\n\r");
+    }
+    // ESP.restart();
+    USE_SERIAL.printf_P("\n\rWaiting for device   ");
+    SwitchReport report;
+    uint8_t slave_address = DiscoverDevice(p_app_mode, SDA, SCL, MODE_BOOTLOADER, &report);
+    //USE_SERIAL.printf_P("\n\r");
+    p_timonel = timonel_slot.Build(slave_address, SDA, SCL);
+    device_cache.Invalidate();
+    ShowHeader(*p_app_mode);
+    report.latency_us = report.found_us - switch_start;
+    PrintSwitch(report);
+}
+
+// Function ShowAppHelp: '?' in application mode
+void ShowAppHelp(void) {
+    USE_SERIAL.printf_P("\n\r Help: Available application commands:\n\r");
+    USE_SERIAL.printf_P(" =====================================\n\r");
+    USE_SERIAL.printf_P(" a) Start LED blinking on device PB1.\n\r");
+    USE_SERIAL.printf_P(" s) Stop LED blinking on device PB1.\n\r");
+    USE_SERIAL.printf_P(" t) Show the I2C performance counters.\n\r");
+#ifdef I2C_TRACE
+    USE_SERIAL.printf_P(" j) Dump the I2C trace (Chrome trace JSON, ui.perfetto.dev).\n\r");
+#endif  // I2C_TRACE
+    USE_SERIAL.printf_P(" z) Reset Tiny85 and jump back to bootloader.\n\n\r");
+}
+
+// Function RestartMaster: 'z' in bootloader mode
+void RestartMaster(void) {
+    USE_SERIAL.printf_P("\nResetting TWI Master ...\n\r\n.\n.\n.\n");
+    delay(MODE_SWITCH_DLY);
+    ESP.restart();
+}
+
+// Function ShowVersion: 'v', Timonel GETTMNLV command, read again even if cached
+void ShowVersion(void) {
+    USE_SERIAL.printf_P("\nBootloader Cmd >>> Get bootloader version ...\r\n");
+    device_cache.Invalidate(); /* Asked for, so read it again */
+    PrintStatus(p_timonel);
+    //p_timonel->GetStatus();
+    //Timonel::Status sts = p_timonel->GetStatus();
+    //Timonel::Status sts = PrintStatus(p_timonel);
+    // if ((sts.features_code >> F_CMD_SETPGADDR) & true) {
+    //     p_timonel->InitMicro();
+    // }
+    PerfTimer timer(PERF_SCAN);
+    timer.Stop((BusScanner(SDA, SCL)->ScanBus(p_app_mode) != 0) ? 0 : ERR_01);
+}
+
+// Function RunApp: 'r', Timonel EXITTMNL command, then wait for the application
+void RunApp(void) {
+    USE_SERIAL.printf_P("\nBootloader Cmd >>> Run application ...\r\n");
+    USE_SERIAL.printf_P("\n. . .\n\r . .\n\r  .\n\n\r");
+    USE_SERIAL.printf_P("Please wait ...\n\n\r");
+    // The GetStatus command below is to ensure that the remote device is properly initialized
+    // before running this case's command (e.g. when running after a firmware deletion)
+    // p_timonel->GetStatus();
+    uint8_t cmd_errors = p_timonel->RunApplication();
+    unsigned long switch_start = micros();
+    if (cmd_errors == 0) {
+        USE_SERIAL.printf_P("Bootloader exit successful, running the user application (if there is one) ...\r\n");
+    } else {
+        USE_SERIAL.printf_P(" [ command error! %d ]", cmd_errors);
+    }
+    USE_SERIAL.printf_P("\n\rWaiting for device   ");
+    SwitchReport report;
+    uint8_t slave_address = DiscoverDevice(p_app_mode, SDA, SCL, MODE_APPLICATION, &report);
+    p_timonel = timonel_slot.Build(slave_address, SDA, SCL);
+    device_cache.Invalidate();
+    ShowHeader(*p_app_mode);
+    report.latency_us = report.found_us - switch_start;
+    PrintSwitch(report);
+}
+
+// Function FinishCommand: the command is over, show the menu for the next one
+void FinishCommand(void) {
+    if (device_cache.GetSavedCommand() > 0) {
+        USE_SERIAL.printf_P("[ Device cache: %d I2C transactions saved, %lu in total ]\n\r", device_cache.GetSavedCommand(),
+                            (unsigned long)device_cache.GetSavedTotal());
+    }
+    device_cache.StartCommand();
+    ShowMenu(*p_app_mode);
+}
+
+// Function CommandPending: true while the last command goes on by itself (an erase waiting for the device)
+bool CommandPending(void) {
+    return erase_job.running;
+}
+
+// Function AnswerPrompt: go on with the command that asked for a number, now that it was typed
+void AnswerPrompt(const uint16_t word) {
+    Prompt asked = prompt;
+    prompt = PROMPT_NONE;
+    switch (asked) {
+        case PROMPT_PAGE_ADDR: {
+            SetPageAddr(word);
+            break;
+        }
+        case PROMPT_PAYLOAD: {
+            SelectPayload(word);
+            break;
+        }
+#if ((defined FEATURES_CODE) && ((FEATURES_CODE >> F_CMD_READFLASH) & true))
+#if ((defined EXT_FEATURES) && ((EXT_FEATURES >> E_EEPROM_ACCESS) & true))
+        case PROMPT_EEPROM_ADDR: {
+            SetEepromAddr(word);
+            break;
+        }
+        case PROMPT_EEPROM_DATA: {
+            WriteEepromByte(word);
+            break;
+        }
+        case PROMPT_EEPROM_IMAGE: {
+            LoadEepromImage(word);
+            break;
+        }
+#endif  // EXT_FEATURES >> E_EEPROM_ACCESS
+#endif  // F_CMD_READFLASH
+        default: {
+            break;
+        }
+    }
+}
+
+#ifdef TCP_INGEST
+// Function RunIngestJob: flash an image received over TCP and hand the result back to its client
+void RunIngestJob(IngestJob *job) {
+    USE_SERIAL.printf_P("\n\rTCP job %lu >>> Firmware upload, %d bytes at 0x%04X%s, \x1b[5mPLEASE WAIT\x1b[0m ...",
+                        (unsigned long)job->id, job->size, job->start_addr, job->run ? " + run" : "");
+    HostTarget host_target = {&p_timonel, p_app_mode, &device_cache, SDA, SCL};
+    unsigned long job_start = millis();
+    uint8_t cmd_errors = FlashIngestJob(&host_target, job);
+    unsigned long job_ms = millis() - job_start;
+    tcp_ingest.FinishJob(job, cmd_errors, job_ms);
+    USE_SERIAL.printf_P("\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b");
+    if (cmd_errors == 0) {
+        USE_SERIAL.printf_P(" successful (%lu ms)", job_ms);
+    } else {
+        USE_SERIAL.printf_P(" [ command error! %d ]", cmd_errors);
+    }
+    USE_SERIAL.printf_P("\n\r");
+    ShowHeader(*p_app_mode);
+}
+#endif  // TCP_INGEST
+
+// Function ReconnectConsole: find the console device again after it was flashed along with others
+void ReconnectConsole(void) {
+    USE_SERIAL.printf_P("\n\rWaiting until a TWI slave device is detected on the bus   ");
+    uint8_t slave_address = DiscoverDevice(p_app_mode, SDA, SCL);
+    p_timonel = timonel_slot.Build(slave_address, SDA, SCL);
+    device_cache.Invalidate();
+    ShowHeader(*p_app_mode);
 }
 
 // Function ReadChar
@@ -337,54 +421,96 @@ void ReadChar(void) {
     }
 }
 
-// Function ReadWord
-uint16_t ReadWord(void) {
+// Function ReadWord: add a typed character to the number being entered, true once a CR ends it
+bool ReadWord(const char rc, uint16_t *word) {
     const uint8_t data_length = 16;
-    char serial_data[data_length];  // an array to store the received data
+    static char serial_data[data_length];  // the characters received so far
     static uint8_t ix = 0;
-    char rc, endMarker = 0xD;  //standard is: char endMarker = '\n'
-    while (USE_SERIAL.available() > 0 && new_word == false) {
-        rc = USE_SERIAL.read();
-        if (rc != endMarker) {
-            serial_data[ix] = rc;
-            USE_SERIAL.printf_P("%c", serial_data[ix]);
-            ix++;
-            if (ix >= data_length) {
-                ix = data_length - 1;
-            }
-        } else {
-            serial_data[ix] = '\0';  // terminate the string
-            ix = 0;
-            new_word = true;
+    const char end_marker = 0xD;  //standard is: char endMarker = '\n'
+    if (rc != end_marker) {
+        serial_data[ix] = rc;
+        USE_SERIAL.printf_P("%c", serial_data[ix]);
+        ix++;
+        if (ix >= data_length) {
+            ix = data_length - 1;
         }
+        return false;
     }
-    return ((uint16_t)atoi(serial_data));
+    serial_data[ix] = '\0';  // terminate the string
+    ix = 0;
+    *word = (uint16_t)atoi(serial_data);
+    return true;
+}
+
+// Function OpenSelectedPayload: the payload picked with 'f', or payload.h at the page base address ('b').
+// nullptr if the file can't be opened.
+PageSource *OpenSelectedPayload(FilePayload *file) {
+    static InPlace<PayloadImage> payload_slot; /* payload.h is only defined here */
+    return OpenPayload(payload_slot.Build(payload, sizeof(payload), flash_page_addr), file);
+}
+
+// Function OpenPayload: the payload to flash, built-in unless a file was picked with 'f'
+PageSource *OpenPayload(PageSource *builtin, FilePayload *file) {
+    if (payload_file[0] == '\0') {
+#ifdef PAYLOAD_MANIFEST
+        // The manifest describes payload.h at its own start address only
+        builtin->SetManifest((flash_page_addr == payload_start) ? &payload_manifest : nullptr);
+#endif  // PAYLOAD_MANIFEST
+        return builtin;
+    }
+    if (!file->Open(payload_file, flash_page_addr)) {
+        USE_SERIAL.printf_P(" can't open %s ...", payload_file);
+        return nullptr;
+    }
+    return file;
+}
+
+// Function SelectedManifest: the manifest of the payload picked, nullptr if it has none (files, other addresses)
+const ImageManifest *SelectedManifest(void) {
+#ifdef PAYLOAD_MANIFEST
+    if ((payload_file[0] == '\0') && (flash_page_addr == payload_start)) {
+        return &payload_manifest;
+    }
+#endif  // PAYLOAD_MANIFEST
+    return nullptr;
 }
 
 // Function DiscoverDevice
-uint8_t DiscoverDevice(bool *p_app_mode, const uint8_t sda, const uint8_t scl) {
-    uint8_t slave_address = 0;
-    unsigned long start_time = 0;
-    unsigned long now = millis();
-    uint8_t rotary_state = 1;
-    uint8_t *p_rotary = &rotary_state;
-    TwiBus twi_bus(sda, scl);
-    while (slave_address == 0) {
-        slave_address = twi_bus.ScanBus(p_app_mode);
-        now = millis();
-        if ((now - start_time) >= ROTATION_DLY) {
-            RotatingBar(p_rotary);
-            start_time = now;
-        }
+uint8_t DiscoverDevice(bool *p_app_mode, const uint8_t sda, const uint8_t scl, const DeviceMode expect, SwitchReport *report, const bool quiet) {
+    SwitchReport discovery;
+    if (report == nullptr) {
+        report = &discovery;
+    }
+    SetBaseClock(); /* Every device answers a scan at the base rate */
+    uint8_t slave_address = FindDevice(BusScanner(sda, scl), expect, report, quiet ? nullptr : WaitingBar);
+    SetDeviceClock(slave_address);
+    *p_app_mode = report->app_mode;
+    if (!quiet) {
+        USE_SERIAL.printf_P("\b\b>>> device active at address [%d]", slave_address);
+        USE_SERIAL.printf_P("\n\r");
     }
-    USE_SERIAL.printf_P("\b\b>>> device active at address [%d]", slave_address);
-    USE_SERIAL.printf_P("\n\r");
     return slave_address;
 }
 
+// Function WaitingBar: turn the rotating bar while waiting for a device
+void WaitingBar(void) {
+    static unsigned long last_turn = 0;
+    static uint8_t rotary_state = 1;
+    if ((millis() - last_turn) >= ROTATION_DLY) {
+        RotatingBar(&rotary_state);
+        last_turn = millis();
+    }
+}
+
+// Function PrintSwitch: mode switch latency
+void PrintSwitch(const SwitchReport &report) {
+    USE_SERIAL.printf_P(". Mode switch: %lu.%lu ms, %d probes%s\n\n\r", (unsigned long)(report.latency_us / 1000),
+                        (unsigned long)((report.latency_us % 1000) / 100), report.probes, report.scanned ? " (bus scan)" : "");
+}
+
 // Function print Timonel instance status
 Timonel::Status PrintStatus(Timonel *timonel) {
-    Timonel::Status tml_status = timonel->GetStatus(); /* Get the instance id parameters received from the ATTiny85 */
+    Timonel::Status tml_status = device_cache.GetStatus(timonel); /* Get the instance id parameters received from the ATTiny85 */
     uint8_t twi_address = timonel->GetTwiAddress();
     uint8_t version_major = tml_status.version_major;
     uint8_t version_minor = tml_status.version_minor;
@@ -394,7 +520,7 @@ Timonel::Status PrintStatus(Timonel *timonel) {
     uint16_t trampoline = ((~(((app_start_lsb << 8) | app_start_msb) & 0xFFF)) + 1);
     trampoline = ((((tml_status.bootloader_start >> 1) - trampoline) & 0xFFF) << 1);
     if ((tml_status.signature == T_SIGNATURE) && ((version_major != 0) || (version_minor != 0))) {
-        String version_mj_nick = "";
+        const char *version_mj_nick = "\"Unknown\"";
         switch (version_major) {
             case 0: {
                 version_mj_nick = "\"Pre-release\"";
@@ -405,11 +531,10 @@ Timonel::Status PrintStatus(Timonel *timonel) {
                 break;
             }
             default: {
-                version_mj_nick = "\"Unknown\"";
                 break;
             }
         }
-        USE_SERIAL.printf_P("\n\r Timonel v%d.%d %s ", version_major, version_minor, version_mj_nick.c_str());
+        USE_SERIAL.printf_P("\n\r Timonel v%d.%d %s ", version_major, version_minor, version_mj_nick);
         USE_SERIAL.printf_P("(TWI: %02d)\n\r", twi_address);
         USE_SERIAL.printf_P(" ====================================\n\r");
         USE_SERIAL.printf_P(" Bootloader address: 0x%X\n\r", tml_status.bootloader_start);
@@ -425,11 +550,28 @@ Timonel::Status PrintStatus(Timonel *timonel) {
             USE_SERIAL.printf_P("(Fixed)");
         }
         USE_SERIAL.printf_P("\n\r");
+        if (GetDeviceClock(twi_address) != 0) {
+            USE_SERIAL.printf_P("          I2C clock: %lu kHz (negotiated)\n\r", (unsigned long)(GetDeviceClock(twi_address) / 1000));
+        } else {
+            USE_SERIAL.printf_P("          I2C clock: %lu kHz (not negotiated yet, 'c' to probe)\n\r", (unsigned long)(CLOCK_BASE / 1000));
+        }
+        USE_SERIAL.printf_P("    Readback packet: %d bytes (%s)\n\r", GetRxPacket(twi_address),
+                            PacketsKnown(twi_address) ? "negotiated" : "compiled, 'c' to probe");
+#ifdef PAYLOAD_MANIFEST
+        USE_SERIAL.printf_P("          payload.h: %d pages, fingerprint 0x%08lX, ", payload_manifest.pages, (unsigned long)payload_manifest.fingerprint);
+        if (!PayloadFits(payload_manifest, tml_status)) {
+            USE_SERIAL.printf_P("overlaps the bootloader\n\r");
+        } else if ((app_start != 0xFFFF) && (app_start == ManifestAppStart(payload_manifest, tml_status.bootloader_start))) {
+            USE_SERIAL.printf_P("its application start matches\n\r");
+        } else {
+            USE_SERIAL.printf_P("not flashed\n\r");
+        }
+#endif  // PAYLOAD_MANIFEST
         USE_SERIAL.printf_P("           Low fuse: 0x%02X\n\r", tml_status.low_fuse_setting);
         USE_SERIAL.printf_P("             RC osc: 0x%02X", tml_status.oscillator_cal);
 #if ((defined EXT_FEATURES) && ((EXT_FEATURES >> E_CMD_READDEVS) & true))
         if ((tml_status.ext_features_code >> E_CMD_READDEVS) & true) {
-            Timonel::DevSettings dev_settings = timonel->GetDevSettings();
+            Timonel::DevSettings dev_settings = device_cache.GetDevSettings(timonel);
             USE_SERIAL.printf_P("\n\r ....................................\n\r");
             USE_SERIAL.printf_P(" Fuse settings: L=0x%02X H=0x%02X E=0x%02X\n\r", dev_settings.low_fuse_bits, dev_settings.high_fuse_bits, dev_settings.extended_fuse_bits);
             USE_SERIAL.printf_P(" Lock bits: 0x%02X\n\r", dev_settings.lock_bits);
@@ -448,7 +590,6 @@ Timonel::Status PrintStatus(Timonel *timonel) {
 
 // Function ShowHeader
 void ShowHeader(const bool app_mode) {
-    delay(125);
     USE_SERIAL.printf_P("\n\r............................................................\n\r");
     USE_SERIAL.printf_P(". Timonel I2C Bootloader and Application Test (v%d.%d.%d MSS) .\n\r", VER_MAJOR, VER_MINOR, VER_PATCH);
     USE_SERIAL.printf_P("............................................................\n\r");
@@ -465,10 +606,22 @@ void ShowHeader(const bool app_mode) {
 // Function ShowMenu
 void ShowMenu(const bool app_mode) {
     if (app_mode) {
-        USE_SERIAL.printf_P("Application command ('z' reset tiny, 'a' blink, 's' stop, '?' help): \x1b[5m_\x1b[0m");
+#ifdef I2C_TRACE
+        USE_SERIAL.printf_P("Application command ('z' reset tiny, 'a' blink, 's' stop, 't' perf, 'j' trace, '?' help): \x1b[5m_\x1b[0m");
+#else
+        USE_SERIAL.printf_P("Application command ('z' reset tiny, 'a' blink, 's' stop, 't' perf, '?' help): \x1b[5m_\x1b[0m");
+#endif  // I2C_TRACE
     } else {
-        Timonel::Status sts = p_timonel->GetStatus();
-        USE_SERIAL.printf_P("Timonel bootloader ('z' reset master, 'v' version, 'r' run app, 'e' erase flash, 'w' write flash");
+        Timonel::Status sts = device_cache.GetStatus(p_timonel, false);
+        USE_SERIAL.printf_P("Timonel bootloader ('z' reset master, 'v' version, 'r' run app, 't' perf, 'c' i2c clock and packets");
+#ifdef I2C_TRACE
+        USE_SERIAL.printf_P(", 'j' trace");
+#endif  // I2C_TRACE
+        USE_SERIAL.printf_P(",\n\r  'e' erase flash, 'u' erase used pages, 'f' pick payload, 'w' write flash,\n\r");
+        USE_SERIAL.printf_P("  'x' flash all, 'y' line mode");
+#ifdef BROADCAST_UPLOAD
+        USE_SERIAL.printf_P(", 'g' broadcast write");
+#endif  // BROADCAST_UPLOAD
 #if ((defined FEATURES_CODE) && ((FEATURES_CODE >> F_CMD_SETPGADDR) & true))
         if ((sts.features_code >> F_CMD_SETPGADDR) & true) {
             USE_SERIAL.printf_P(", 'b' set addr");
@@ -477,11 +630,14 @@ void ShowMenu(const bool app_mode) {
 #if ((defined FEATURES_CODE) && ((FEATURES_CODE >> F_CMD_READFLASH) & true))
         if ((sts.features_code >> F_CMD_READFLASH) & true) {
             USE_SERIAL.printf_P(", 'm' mem dump");
+            if ((sts.features_code >> F_CMD_SETPGADDR) & true) {
+                USE_SERIAL.printf_P(", 'd' diff write");
+            }
         }
 #endif  // F_CMD_READFLASH
 #if ((defined EXT_FEATURES) && ((EXT_FEATURES >> E_EEPROM_ACCESS) & true))
         if ((sts.ext_features_code >> E_EEPROM_ACCESS) & true) {
-            USE_SERIAL.printf_P(", 'o/p' read/write eeprom");
+            USE_SERIAL.printf_P(",\n\r  'o/p' read/write eeprom, 'n' flush eeprom, 'k/l' save/load eeprom image");
         }
 #endif  // EXT_FEATURES >> E_EEPROM_ACCESS
         USE_SERIAL.printf_P("): ");
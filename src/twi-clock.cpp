@@ -0,0 +1,255 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: twi-clock.cpp (Application)
+  ............................................................................
+  Adaptive I2C clock.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "twi-clock.h"
+
+#include <NbMicro.h>
+#include <Wire.h>
+
+#include "packet-size.h"
+#include "perf-stats.h"
+#include "reconnect.h"
+
+#define CLOCK_STATUS_SIZE 12  // GETTMNLV reply bytes
+#define CLOCK_PLL_CKSEL 0x01  // Low fuse CKSEL bits of the 16 MHz PLL clock
+
+// Rates probed, ascending: Standard-mode, Fast-mode, and two steps into Fast-mode Plus
+static const uint32_t clock_rates[CLOCK_RATES] = {CLOCK_BASE, CLOCK_RC_CEILING, 700000, 1000000};
+
+// Rate kept for a device, by bootloader address
+struct DeviceClock {
+    uint8_t twi_addr = 0;  /* 0 = free */
+    uint32_t hz = CLOCK_BASE;
+};
+
+static DeviceClock device_clocks[CLOCK_DEVICES];
+static uint8_t oldest_clock = 0;  // Entry replaced when the table is full
+
+// Upload error watch
+static uint8_t watched_addr = 0;
+static uint32_t watch_calls = 0;
+static uint32_t watch_errors = 0;
+
+// Function FindClock: a device's table entry, nullptr if its rate is unknown
+static DeviceClock *FindClock(const uint8_t twi_addr) {
+    for (uint8_t ix = 0; ix < CLOCK_DEVICES; ix++) {
+        if ((twi_addr != 0) && (device_clocks[ix].twi_addr == twi_addr)) {
+            return &device_clocks[ix];
+        }
+    }
+    return nullptr;
+}
+
+// Function KeepClock: remember a device's rate, replacing the oldest entry if the table is full
+static void KeepClock(const uint8_t twi_addr, const uint32_t hz) {
+    DeviceClock *entry = FindClock(twi_addr);
+    for (uint8_t ix = 0; (ix < CLOCK_DEVICES) && (entry == nullptr); ix++) {
+        if (device_clocks[ix].twi_addr == 0) {
+            entry = &device_clocks[ix];
+        }
+    }
+    if (entry == nullptr) {
+        entry = &device_clocks[oldest_clock];
+        oldest_clock = (oldest_clock + 1) % CLOCK_DEVICES;
+    }
+    entry->twi_addr = twi_addr;
+    entry->hz = hz;
+}
+
+// Function ReadStatus: the raw GETTMNLV reply
+static uint8_t ReadStatus(Timonel *timonel, uint8_t *reply) {
+    PerfTimer timer(PERF_STATUS);
+    return timer.Stop(timonel->TwiCmdXmit(GETTMNLV, AKTMNLV, reply, CLOCK_STATUS_SIZE));
+}
+
+// Function TestRound: one integrity test round at the current rate, 0 if every byte matches the base rate copies
+static uint8_t TestRound(Timonel *timonel, const uint8_t *status_copy, const uint8_t *flash_copy, const uint16_t flash_addr) {
+    uint8_t reply[CLOCK_STATUS_SIZE];
+    uint8_t twi_errors = ReadStatus(timonel, reply);
+    if (twi_errors != 0) {
+        return twi_errors;
+    }
+    if (memcmp(reply, status_copy, CLOCK_STATUS_SIZE) != 0) {
+        return ERR_VERIFY;
+    }
+    if (flash_copy == nullptr) {
+        return 0;
+    }
+    uint8_t packet[SLV_PACKET_SIZE];
+    twi_errors = ReadFlash(timonel, flash_addr, packet, SLV_PACKET_SIZE, 0); /* A retry would hide the error */
+    if (twi_errors != 0) {
+        return twi_errors;
+    }
+    return (memcmp(packet, flash_copy, SLV_PACKET_SIZE) == 0) ? 0 : ERR_VERIFY;
+}
+
+// Function NegotiateClock: probe the rates above the base one until one fails, keep and set the fastest
+// that passed. Returns it, the base rate if the device doesn't answer as a bootloader.
+uint32_t NegotiateClock(Timonel *timonel, ClockReport *report) {
+    *report = ClockReport();
+    unsigned long start = micros();
+    uint8_t twi_addr = timonel->GetTwiAddress();
+    uint8_t status_copy[CLOCK_STATUS_SIZE];
+    uint8_t flash_copy[SLV_PACKET_SIZE];
+    SetBaseClock();
+    if ((ReadStatus(timonel, status_copy) != 0) || (status_copy[1] != T_SIGNATURE)) {
+        report->probe_us = micros() - start;
+        return CLOCK_BASE;
+    }
+    uint8_t features_code = status_copy[4];
+    uint8_t ext_features_code = status_copy[5];
+    uint16_t bootloader_start = (status_copy[6] << 8) | status_copy[7];
+    uint8_t low_fuse_setting = status_copy[10];
+    // The bootloader runs at 16 MHz from the PLL, or faster than 8 MHz with the RC oscillator tweaked
+    bool fast_cpu = ((ext_features_code >> E_AUTO_CLK_TWEAK) & true) || ((low_fuse_setting & 0x0F) == CLOCK_PLL_CKSEL);
+    report->ceiling_hz = fast_cpu ? clock_rates[CLOCK_RATES - 1] : CLOCK_RC_CEILING;
+    // The bootloader's own code is a test pattern that never changes
+    report->flash_test = ((features_code >> F_CMD_READFLASH) & true) && (bootloader_start <= (MCU_TOTAL_MEM - SLV_PACKET_SIZE)) &&
+                         (ReadFlash(timonel, bootloader_start, flash_copy, SLV_PACKET_SIZE) == 0);
+    for (uint8_t ix = 1; (ix < CLOCK_RATES) && (clock_rates[ix] <= report->ceiling_hz); ix++) {
+        ClockProbe &probe = report->probe[report->probes++];
+        probe.hz = clock_rates[ix];
+        Wire.setClock(probe.hz);
+        while ((probe.rounds < CLOCK_PROBE_ROUNDS) && (probe.error == 0)) {
+            probe.error = TestRound(timonel, status_copy, report->flash_test ? flash_copy : nullptr, bootloader_start);
+            probe.rounds += (probe.error == 0) ? 1 : 0;
+        }
+        if (probe.error != 0) {
+            break;
+        }
+        report->chosen_hz = probe.hz;
+    }
+    KeepClock(twi_addr, report->chosen_hz);
+    Wire.setClock(report->chosen_hz);
+    report->probe_us = micros() - start;
+    return report->chosen_hz;
+}
+
+// Function GetDeviceClock: the rate kept for a device, 0 if it wasn't negotiated
+uint32_t GetDeviceClock(const uint8_t twi_addr) {
+    DeviceClock *entry = FindClock(twi_addr);
+    return (entry != nullptr) ? entry->hz : 0;
+}
+
+// Function SetDeviceClock: switch the console bus to a device's rate (the base one if unknown), returns it
+uint32_t SetDeviceClock(const uint8_t twi_addr) {
+    DeviceClock *entry = FindClock(twi_addr);
+    uint32_t hz = (entry != nullptr) ? entry->hz : CLOCK_BASE;
+    Wire.setClock(hz);
+    return hz;
+}
+
+// Function SetBaseClock: switch the console bus to the rate every device takes
+void SetBaseClock(void) {
+    Wire.setClock(CLOCK_BASE);
+}
+
+// Function ForgetClocks: drop every device's rate, the next upload negotiates again
+void ForgetClocks(void) {
+    for (uint8_t ix = 0; ix < CLOCK_DEVICES; ix++) {
+        device_clocks[ix] = DeviceClock();
+    }
+    oldest_clock = 0;
+    watched_addr = 0;
+}
+
+// Function FallBackClock: step a device's rate down one and switch to it, false if it is at the base rate already
+bool FallBackClock(const uint8_t twi_addr) {
+    DeviceClock *entry = FindClock(twi_addr);
+    if ((entry == nullptr) || (entry->hz <= CLOCK_BASE)) {
+        return false;
+    }
+    uint8_t ix = CLOCK_RATES - 1;
+    while ((ix > 0) && (clock_rates[ix] >= entry->hz)) {
+        ix--;
+    }
+    entry->hz = clock_rates[ix];
+    Wire.setClock(entry->hz);
+    WatchClock(twi_addr);
+    return true;
+}
+
+// Function WatchClock: start counting a device's command transaction errors from now
+void WatchClock(const uint8_t twi_addr) {
+    const PerfCounter &counter = PerfGet(PERF_XMIT);
+    watched_addr = twi_addr;
+    watch_calls = counter.calls.load(std::memory_order_relaxed);
+    watch_errors = counter.errors.load(std::memory_order_relaxed);
+}
+
+// Function CheckClock: step the watched device's rate down when its transaction errors exceed the
+// limit within a window. Returns true if it did. Call it between transactions.
+bool CheckClock(void) {
+    if (watched_addr == 0) {
+        return false;
+    }
+    const PerfCounter &counter = PerfGet(PERF_XMIT);
+    uint32_t calls = counter.calls.load(std::memory_order_relaxed) - watch_calls;
+    uint32_t errors = counter.errors.load(std::memory_order_relaxed) - watch_errors;
+    if (errors > CLOCK_FAULT_LIMIT) {
+        if (FallBackClock(watched_addr)) {
+            return true;
+        }
+        WatchClock(watched_addr);
+    } else if (calls >= CLOCK_FAULT_WINDOW) {
+        WatchClock(watched_addr); /* Next window */
+    }
+    return false;
+}
+
+// Function UploadAdaptive: verified upload at the device's rate and packet sizes, negotiated first if unknown. When it fails
+// on the bus above the base rate, the upload goes on one rate lower from the last confirmed page, or, if
+// the device can't resume (or a page it left can't be written over), it is erased and the upload starts over.
+uint8_t UploadAdaptive(Timonel *timonel, PageSource *source, const Timonel::Status &sts, VerifyReport *report, uint8_t *fallbacks) {
+    uint8_t twi_addr = timonel->GetTwiAddress();
+    const bool resumable = ((sts.features_code >> F_CMD_READFLASH) & true) && ((sts.features_code >> F_CMD_SETPGADDR) & true);
+    *fallbacks = 0;
+    if (GetDeviceClock(twi_addr) == 0) {
+        ClockReport clock_report;
+        NegotiateClock(timonel, &clock_report);
+    }
+    SetDeviceClock(twi_addr);
+    if (!PacketsKnown(twi_addr)) {
+        PacketReport packet_report;
+        NegotiatePackets(timonel, sts, &packet_report);
+    }
+    uint8_t twi_errors = UploadResumable(timonel, source, sts, report);
+    bool erase = (twi_errors == ERR_NEEDS_ERASE);
+    while (erase || (((twi_errors == ERR_01) || (twi_errors == ERR_02) || (twi_errors == ERR_04)) && FallBackClock(twi_addr))) {
+        if (!erase) {
+            (*fallbacks)++;
+        }
+        if (resumable && !erase) {
+            twi_errors = UploadResumable(timonel, source, sts, report);
+            erase = (twi_errors == ERR_NEEDS_ERASE);
+            continue;
+        }
+        // The pages written so far can't be checked, nor rewritten in place without an erase
+        erase = false;
+        PerfTimer timer(PERF_DELETE);
+        twi_errors = timer.Stop(timonel->DeleteApplication());
+        unsigned long erased = millis();
+        while ((twi_errors == 0) && !ProbeAddress(twi_addr)) {
+            twi_errors = ((millis() - erased) < CLOCK_REAPPEAR_MS) ? 0 : ERR_01;
+            delay(CLOCK_POLL_MS);
+        }
+        if (twi_errors != 0) {
+            continue;
+        }
+        PerfTimer status_timer(PERF_STATUS);
+        Timonel::Status now = timonel->GetStatus();
+        twi_errors = status_timer.Stop((now.signature == T_SIGNATURE) ? 0 : ERR_02);
+        if (twi_errors == 0) {
+            twi_errors = resumable ? UploadResumable(timonel, source, now, report) : UploadVerified(timonel, source, now, report);
+        }
+    }
+    return twi_errors;
+}
@@ -0,0 +1,92 @@
+/*
+  Timonel bootloader I2C-master single slave application demo for ESP32
+  ............................................................................
+  File: upload-checkpoint.cpp (Application)
+  ............................................................................
+  Upload checkpoints in NVS.
+  ............................................................................
+  Version: 1.0.0 / 2026-10-17
+  ............................................................................
+*/
+
+#include "upload-checkpoint.h"
+
+#include <Preferences.h>
+
+#define FNV_OFFSET 0x811C9DC5  // FNV-1a 32-bit offset basis
+#define FNV_PRIME 0x01000193   // FNV-1a 32-bit prime
+
+// Function CheckpointStore: the NVS namespace, opened on first use and kept open
+static Preferences *CheckpointStore(void) {
+    static Preferences store;
+    static bool opened = false;
+    if (!opened) {
+        opened = store.begin(CHECKPOINT_NAMESPACE, false);
+    }
+    return opened ? &store : nullptr;
+}
+
+// Function CheckpointKey: NVS key of a slave address
+static void CheckpointKey(const uint8_t twi_addr, char *key, const size_t key_size) {
+    snprintf(key, key_size, "addr%02d", twi_addr);
+}
+
+// Function Fnv1a: fold bytes into an FNV-1a hash
+static uint32_t Fnv1a(uint32_t hash, const uint8_t *data, const uint16_t size) {
+    for (uint16_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// Function PayloadFingerprint: FNV-1a hash of a payload image, then its start address and size (LE). Taken
+// from the manifest if the source has one, otherwise one pass over the image.
+uint32_t PayloadFingerprint(PageSource *source) {
+    if (source->GetManifest() != nullptr) {
+        return source->GetManifest()->fingerprint;
+    }
+    uint32_t hash = FNV_OFFSET;
+    uint16_t flash_addr = 0, size = 0, start = 0xFFFF, total = 0;
+    uint8_t *data = nullptr;
+    source->Rewind();
+    while (source->NextBlock(&flash_addr, &data, &size)) {
+        start = (start == 0xFFFF) ? flash_addr : start;
+        hash = Fnv1a(hash, data, size);
+        total += size;
+    }
+    source->Rewind();
+    uint8_t trailer[4] = {(uint8_t)(start & 0xFF), (uint8_t)(start >> 8), (uint8_t)(total & 0xFF), (uint8_t)(total >> 8)};
+    return Fnv1a(hash, trailer, sizeof(trailer));
+}
+
+// Function LoadCheckpoint: the checkpoint of this payload on this device, false if there is none
+bool LoadCheckpoint(const uint8_t twi_addr, const uint32_t fingerprint, UploadCheckpoint *checkpoint) {
+    Preferences *store = CheckpointStore();
+    char key[16];
+    CheckpointKey(twi_addr, key, sizeof(key));
+    UploadCheckpoint stored;
+    if ((store == nullptr) || (store->getBytes(key, &stored, sizeof(stored)) != sizeof(stored)) ||
+        (stored.version != CHECKPOINT_VERSION) || (stored.twi_addr != twi_addr) || (stored.fingerprint != fingerprint)) {
+        return false;
+    }
+    *checkpoint = stored;
+    return true;
+}
+
+// Function SaveCheckpoint: commit a device's upload progress
+bool SaveCheckpoint(const UploadCheckpoint &checkpoint) {
+    Preferences *store = CheckpointStore();
+    char key[16];
+    CheckpointKey(checkpoint.twi_addr, key, sizeof(key));
+    return (store != nullptr) && (store->putBytes(key, &checkpoint, sizeof(checkpoint)) == sizeof(checkpoint));
+}
+
+// Function ClearCheckpoint: forget a device's upload progress
+void ClearCheckpoint(const uint8_t twi_addr) {
+    Preferences *store = CheckpointStore();
+    char key[16];
+    CheckpointKey(twi_addr, key, sizeof(key));
+    if ((store != nullptr) && store->isKey(key)) {
+        store->remove(key);
+    }
+}
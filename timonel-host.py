@@ -0,0 +1,377 @@
+#!/usr/bin/env python3
+#
+# Timonel host link client
+# ..........................................................................
+# Scripted flashing through the master's serial console with the framed
+# binary protocol in include/host-link.h: COBS frames with a CRC-16,
+# request ids, acks and retransmission. The first frame switches the
+# master from its menu to the host link, "quit" (sent at the end of every
+# command) switches it back. Page writes are pipelined: the next page is
+# already on the wire while the master writes the previous one over I2C.
+# Uses pyserial when installed, plain POSIX termios otherwise.
+#
+# Usage:
+#   timonel-host.py --port /dev/ttyUSB0 info
+#   timonel-host.py --port /dev/ttyUSB0 upload app.hex --run
+#   timonel-host.py --port /dev/ttyUSB0 verify app.hex
+#   timonel-host.py --port /dev/ttyUSB0 dump -o backup.hex
+#   timonel-host.py --port /dev/ttyUSB0 eeprom-read -o eeprom.bin
+#   timonel-host.py --port /dev/ttyUSB0 eeprom-write eeprom.bin --addr 0x20
+#   timonel-host.py --port /dev/ttyUSB0 perf [--json]
+#   timonel-host.py --port /dev/ttyUSB0 erase | run
+# ..........................................................................
+#
+
+import argparse
+import json
+import os
+import select
+import sys
+import time
+
+HOST_VERSION = 1
+HOST_REPLY = 0x80
+HOST_NAK = ord("N")
+OPCODES = {"hello": "H", "erase": "E", "begin": "B", "page": "W", "finish": "F", "verify": "V", "read": "D",
+           "eeprom-read": "r", "eeprom-write": "w", "run": "R", "perf": "P", "quit": "Q"}
+PERF_OPS = ["upload", "delete", "status", "scan", "reconnect", "xmit"]
+STATUS = {0xE0: "bad frame", 0xE1: "protocol version not supported", 0xE2: "unknown request", 0xE3: "address or size out of range",
+          0xE4: "page out of sequence", 0xE5: "not possible in this device mode", 0xE6: "not supported by the bootloader",
+          0xE7: "upload CRC or size mismatch", 0xE8: "verify CRC mismatch"}
+EEPROM_SIZE = 512
+RETRIES = 5
+
+
+class HostError(Exception):
+    pass
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT (poly 0x1021), same as Crc16() on the master."""
+    for value in data:
+        crc ^= value << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_ix, code = 0, 1
+    for value in data:
+        if value != 0:
+            out.append(value)
+            code += 1
+        if value == 0 or code == 0xFF:
+            out[code_ix] = code
+            code_ix, code = len(out), 1
+            out.append(0)
+    out[code_ix] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def le16(value):
+    return bytes([value & 0xFF, (value >> 8) & 0xFF])
+
+
+class Port:
+    """Serial port: pyserial if available, otherwise a raw POSIX terminal (also works on a pty)."""
+
+    def __init__(self, path, baud):
+        try:
+            import serial
+            self.serial = serial.Serial(path, baud, timeout=0)
+            self.fd = None
+        except ImportError:
+            import termios
+            import tty
+            self.serial = None
+            self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+            tty.setraw(self.fd)
+            attrs = termios.tcgetattr(self.fd)
+            speed = getattr(termios, "B%d" % baud)
+            attrs[4] = attrs[5] = speed
+            termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+
+    def write(self, data):
+        if self.serial:
+            self.serial.write(data)
+        else:
+            os.write(self.fd, data)
+
+    def read(self, timeout):
+        fileno = self.serial.fileno() if self.serial else self.fd
+        if not select.select([fileno], [], [], max(timeout, 0))[0]:
+            return b""
+        return self.serial.read(4096) if self.serial else os.read(self.fd, 4096)
+
+    def close(self):
+        if self.serial:
+            self.serial.close()
+        else:
+            os.close(self.fd)
+
+
+class HostLink:
+    def __init__(self, port, timeout):
+        self.port = port
+        self.timeout = timeout
+        self.next_id = 1
+        self.rx = bytearray()
+        self.resent = 0
+
+    def frame(self, opcode, payload):
+        body = bytes([HOST_VERSION, ord(opcode), self.next_id]) + bytes(payload)
+        self.next_id = (self.next_id + 1) & 0xFF
+        return body[2], b"\x00" + cobs_encode(body + le16(crc16(body))) + b"\x00"
+
+    def replies(self, deadline):
+        """Next good reply frame as (opcode, id, status, data), None on timeout. Console text is skipped."""
+        while True:
+            end = self.rx.find(b"\x00")
+            if end >= 0:
+                raw, self.rx = bytes(self.rx[:end]), self.rx[end + 1:]
+                body = cobs_decode(raw) if raw else None
+                if body and len(body) >= 6 and body[0] == HOST_VERSION and crc16(body[:-2]) == (body[-2] | (body[-1] << 8)):
+                    return body[1], body[2], body[3], body[4:-2]
+                continue
+            remaining = deadline - time.time()
+            if remaining <= 0:
+                return None
+            self.rx += self.port.read(remaining)
+
+    def pipeline(self, requests, window=1):
+        """Runs (opcode, payload) requests with up to "window" in flight, returns their (status, data).
+        NAKs and timeouts send everything in flight again (go-back-N)."""
+        frames = [(ord(opcode), *self.frame(opcode, payload)) for opcode, payload in requests]
+        results = []
+        oldest = sent = 0
+        retries = 0
+        deadline = 0
+        while oldest < len(frames):
+            while sent < len(frames) and sent - oldest < window:
+                self.port.write(frames[sent][2])
+                sent += 1
+                deadline = time.time() + self.timeout
+            reply = self.replies(deadline)
+            opcode, request_id, _ = frames[oldest]
+            if reply is None or reply[0] == (HOST_NAK | HOST_REPLY):
+                retries += 1
+                if retries > RETRIES:
+                    raise HostError("no reply from the master (request '%c')" % opcode)
+                self.resent += sent - oldest
+                sent = oldest
+                continue
+            if reply[0] != (opcode | HOST_REPLY) or reply[1] != request_id:
+                continue  # Stale reply to a request sent again
+            retries = 0
+            if reply[2] != 0:
+                raise HostError("'%c' failed: %s" % (opcode, STATUS.get(reply[2], "device error %d" % reply[2])))
+            results.append(reply[3])
+            oldest += 1
+        return results
+
+    def request(self, name, payload=b""):
+        return self.pipeline([(OPCODES[name], payload)])[0]
+
+
+def load_image(path, addr, page_size):
+    """Flash image from Intel HEX or binary, returns (start, data) padded to whole pages with 0xFF."""
+    memory = {}
+    if os.path.splitext(path)[1].lower() in (".hex", ".ihex"):
+        with open(path) as hex_file:
+            for line in hex_file:
+                line = line.strip()
+                if not line.startswith(":"):
+                    continue
+                record = bytes.fromhex(line[1:])
+                if sum(record) & 0xFF:
+                    raise HostError("%s: bad record checksum" % path)
+                if record[3] == 0:
+                    base = (record[1] << 8) | record[2]
+                    for offset, value in enumerate(record[4:4 + record[0]]):
+                        memory[base + offset] = value
+                elif record[3] == 1:
+                    break
+    else:
+        with open(path, "rb") as bin_file:
+            for offset, value in enumerate(bin_file.read()):
+                memory[addr + offset] = value
+    if not memory:
+        raise HostError("%s: empty image" % path)
+    start = min(memory) // page_size * page_size
+    end = (max(memory) // page_size + 1) * page_size
+    return start, bytes(memory.get(a, 0xFF) for a in range(start, end))
+
+
+def write_image(path, start, image):
+    if os.path.splitext(path)[1].lower() != ".hex":
+        with open(path, "wb") as bin_file:
+            bin_file.write(image)
+        return
+    with open(path, "w") as hex_file:
+        for offset in range(0, len(image), 16):
+            record = bytes([min(16, len(image) - offset), ((start + offset) >> 8) & 0xFF, (start + offset) & 0xFF, 0])
+            record += image[offset:offset + 16]
+            hex_file.write(":%s%02X\n" % (record.hex().upper(), -sum(record) & 0xFF))
+        hex_file.write(":00000001FF\n")
+
+
+def hello(link):
+    data = link.request("hello")
+    if data[0] != HOST_VERSION:
+        raise HostError("master speaks host link version %d" % data[0])
+    return {"app_mode": bool(data[1]), "address": data[2], "window": data[3], "page_size": data[4], "data_max": data[5],
+            "flash_size": data[6] | (data[7] << 8), "features": data[8], "ext_features": data[9],
+            "bootloader_start": data[10] | (data[11] << 8), "version": "%d.%d" % (data[12], data[13])}
+
+
+def verify(link, start, image):
+    payload = le16(start) + le16(len(image)) + le16(crc16(image)) + image[:2]
+    link.request("verify", payload)
+
+
+def read_area(link, name, start, size, data_max, window):
+    requests = [(OPCODES[name], le16(addr) + bytes([min(data_max, start + size - addr)])) for addr in range(start, start + size, data_max)]
+    return b"".join(reply[2:] for reply in link.pipeline(requests, window))
+
+
+def perf_counters(link):
+    """Performance counters of every operation the master times (include/perf-stats.h)."""
+    counters = {}
+    op_count = len(PERF_OPS)
+    op = 0
+    while op < op_count:
+        data = link.request("perf", bytes([op, 0]))
+        op_count = data[1]
+        values = [int.from_bytes(data[4 + i * 4:8 + i * 4], "little") for i in range(9)]
+        buckets, shift = data[2], data[3]
+        histogram = link.request("perf", bytes([op, 1]))[2:]
+        counts = [int.from_bytes(histogram[i * 4:i * 4 + 4], "little") for i in range(buckets)]
+        name = PERF_OPS[op] if op < len(PERF_OPS) else "op%d" % op
+        counters[name] = {"calls": values[0], "errors": values[1], "retries": values[2], "bytes": values[3],
+                          "total_us": values[4] | (values[5] << 32), "min_us": values[6], "max_us": values[7],
+                          "histogram": {("<%d" % (1 << (b + shift)) if b < buckets - 1 else "rest"): counts[b] for b in range(buckets)}}
+        op += 1
+    return counters
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Timonel host link client")
+    parser.add_argument("--port", required=True, help="master serial port")
+    parser.add_argument("--baud", type=int, default=115200, help="serial speed (default: 115200)")
+    parser.add_argument("--timeout", type=float, default=2, help="reply timeout in seconds (default: 2)")
+    parser.add_argument("--window", type=int, help="page frames in flight, 1 = receive then write (default: what the master offers)")
+    commands = parser.add_subparsers(dest="command", required=True)
+    commands.add_parser("info", help="device and bootloader details")
+    commands.add_parser("erase", help="delete the application")
+    upload = commands.add_parser("upload", help="erase, upload and verify an application")
+    upload.add_argument("image", help=".hex, or binary flashed at --addr")
+    upload.add_argument("--addr", type=lambda value: int(value, 0), default=0, help="binary image start address")
+    upload.add_argument("--no-erase", action="store_true", help="don't erase first")
+    upload.add_argument("--no-verify", action="store_true", help="don't read the flash back")
+    upload.add_argument("--run", action="store_true", help="start the application when done")
+    check = commands.add_parser("verify", help="compare the device flash with an image")
+    check.add_argument("image")
+    check.add_argument("--addr", type=lambda value: int(value, 0), default=0, help="binary image start address")
+    dump = commands.add_parser("dump", help="read the flash")
+    dump.add_argument("-o", "--output", required=True, help="Intel HEX if it ends in .hex, binary otherwise")
+    dump.add_argument("--size", type=lambda value: int(value, 0), help="bytes from address 0 (default: up to the bootloader)")
+    ee_read = commands.add_parser("eeprom-read", help="read the EEPROM")
+    ee_read.add_argument("-o", "--output", required=True)
+    ee_read.add_argument("--size", type=lambda value: int(value, 0), default=EEPROM_SIZE)
+    ee_write = commands.add_parser("eeprom-write", help="program (and verify) EEPROM bytes from a binary file")
+    ee_write.add_argument("image")
+    ee_write.add_argument("--addr", type=lambda value: int(value, 0), default=0)
+    commands.add_parser("run", help="start the application")
+    perf = commands.add_parser("perf", help="performance counters and latency histograms of the master")
+    perf.add_argument("--json", action="store_true", help="print them as JSON")
+    args = parser.parse_args()
+
+    port = Port(args.port, args.baud)
+    link = HostLink(port, args.timeout)
+    status = 0
+    try:
+        port.read(0.1)  # Drop menu text
+        info = hello(link)
+        window = args.window or info["window"]
+        if args.command == "info":
+            for key, value in info.items():
+                print("%-17s %s" % (key, ("0x%04X" % value) if key == "bootloader_start" else value))
+        elif args.command == "erase":
+            link.request("erase")
+        elif args.command in ("upload", "verify"):
+            start, image = load_image(args.image, args.addr, info["page_size"])
+            if args.command == "upload":
+                if not args.no_erase:
+                    link.request("erase")
+                upload_start = time.time()
+                link.request("begin", le16(start) + le16(len(image)))
+                pages = [(OPCODES["page"], le16(start + offset) + image[offset:offset + info["page_size"]])
+                         for offset in range(0, len(image), info["page_size"])]
+                link.pipeline(pages, window)
+                link.request("finish", le16(crc16(image)))
+                seconds = time.time() - upload_start
+                print("upload: %d bytes at 0x%04X in %.2f s, %.0f bytes/s, window %d, %d frames sent again" %
+                      (len(image), start, seconds, len(image) / seconds, window, link.resent), file=sys.stderr)
+            if args.command == "verify" or not args.no_verify:
+                verify(link, start, image)
+                print("verify: flash matches %s (CRC-16 %04X)" % (args.image, crc16(image)), file=sys.stderr)
+            if args.command == "upload" and args.run:
+                link.request("run")
+        elif args.command == "dump":
+            size = args.size or info["bootloader_start"]
+            write_image(args.output, 0, read_area(link, "read", 0, size, info["data_max"], window))
+            print("dump: %d bytes to %s" % (size, args.output), file=sys.stderr)
+        elif args.command == "eeprom-read":
+            with open(args.output, "wb") as bin_file:
+                bin_file.write(read_area(link, "eeprom-read", 0, args.size, info["data_max"], window))
+        elif args.command == "eeprom-write":
+            with open(args.image, "rb") as bin_file:
+                data = bin_file.read()
+            changed = 0
+            for offset in range(0, len(data), info["data_max"]):
+                changed += link.request("eeprom-write", le16(args.addr + offset) + data[offset:offset + info["data_max"]])[0]
+            print("eeprom-write: %d bytes, %d changed, verified" % (len(data), changed), file=sys.stderr)
+        elif args.command == "run":
+            link.request("run")
+        elif args.command == "perf":
+            counters = perf_counters(link)
+            if args.json:
+                print(json.dumps(counters, indent=2))
+            else:
+                print("%-10s %8s %7s %7s %10s %10s %10s" % ("operation", "calls", "errors", "retries", "avg ms", "max ms", "bytes/s"))
+                for name, counter in counters.items():
+                    calls, total_us = counter["calls"], counter["total_us"]
+                    print("%-10s %8d %7d %7d %10.1f %10.1f %10.0f" % (name, calls, counter["errors"], counter["retries"],
+                          total_us / calls / 1000 if calls else 0, counter["max_us"] / 1000,
+                          counter["bytes"] * 1e6 / total_us if total_us else 0))
+    except HostError as error:
+        print("timonel-host: %s" % error, file=sys.stderr)
+        status = 1
+    finally:
+        try:
+            link.request("quit")
+        except HostError:
+            pass
+        port.close()
+    sys.exit(status)
+
+
+if __name__ == "__main__":
+    main()